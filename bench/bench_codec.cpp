@@ -0,0 +1,76 @@
+/******************************************************************************
+**  libDXFrw - Text Codec Benchmark                                         **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+// Writes large CJK MTEXT in each double byte code page.
+// usage: bench_codec [characters per mtext] [mtext count]
+
+#include "libdxfrw.h"
+#include "drw_stats.h"
+#include "test_interface.h"
+#include <iostream>
+#include <cstdio>
+#include <cstdlib>
+
+class CJKWriter : public TestInterface {
+public:
+    virtual void writeHeader(DRW_Header& data) {
+        data.addStr("$DWGCODEPAGE", codePage, 3);
+    }
+    virtual void writeEntities() {
+        DRW_MText mtext;
+        mtext.text = text;
+        mtext.height = 2.5;
+        for (int i = 0; i < count; ++i)
+            dxfWriter->writeMText(&mtext);
+    }
+    dxfRW* dxfWriter;
+    std::string codePage;
+    std::string text;
+    int count;
+};
+
+//common CJK unified ideographs, a few are not in every code page
+static std::string cjkText(int chars) {
+    std::string r;
+    for (int i = 0; i < chars; ++i) {
+        int c = 0x4E00 + (i * 7) % 0x51A6;
+        r += (char)(0xE0 | (c >> 12));
+        r += (char)(0x80 | ((c >> 6) & 0x3F));
+        r += (char)(0x80 | (c & 0x3F));
+    }
+    return r;
+}
+
+int main(int argc, char* argv[]) {
+    int chars = argc > 1 ? atoi(argv[1]) : 20000;
+    int count = argc > 2 ? atoi(argv[2]) : 10;
+    const char *pages[] = {"ANSI_932", "ANSI_936", "ANSI_949", "ANSI_950"};
+    const char *filename = "bench_codec.dxf";
+
+    std::string text = cjkText(chars);
+    std::cout << count << " MTEXT of " << chars << " characters per code page" << std::endl;
+    for (int i = 0; i < 4; ++i) {
+        dxfRW dxf(filename);
+        CJKWriter writer;
+        writer.dxfWriter = &dxf;
+        writer.codePage = pages[i];
+        writer.text = text;
+        writer.count = count;
+        double start = DRW_ReadStats::now();
+        bool ok = dxf.write(&writer, DRW::AC1015, false);
+        double elapsed = DRW_ReadStats::now() - start;
+        std::cout << pages[i] << ": " << (ok ? "" : "write failed, ") << elapsed << " s, "
+                  << (chars * (double)count / elapsed / 1e6) << " Mchar/s" << std::endl;
+    }
+    std::remove(filename);
+    return 0;
+}
@@ -0,0 +1,113 @@
+/******************************************************************************
+**  libDXFrw - Entity Memory Benchmark                                      **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+// Reads a drawing with many entities on a few dozen layers and keeps them
+// all, reports the heap used by the kept entities.
+// usage: bench_names [line count]
+
+#include "libdxfrw.h"
+#include "test_interface.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#if defined(__GLIBC__)
+#include <malloc.h>
+#endif
+
+static const int LAYERS = 40;
+
+static std::string layerName(int i) {
+    std::ostringstream ss;
+    ss << "A-WALL-PARTITION-LEVEL-" << i; //typical names are longer than the string inline buffer
+    return ss.str();
+}
+
+static double heapMB() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+    struct mallinfo2 mi = mallinfo2();
+    return (mi.uordblks + mi.hblkhd) / 1e6;
+#else
+    return 0.0;
+#endif
+}
+
+class KeepInterface : public TestInterface {
+public:
+    virtual void addHeader(const DRW_Header* data) {}
+    virtual void addLine(const DRW_Line& data) { lines.push_back(data); }
+    virtual void addText(const DRW_Text& data) { texts.push_back(data); }
+    std::vector<DRW_Line> lines;
+    std::vector<DRW_Text> texts;
+};
+
+class Writer : public KeepInterface {
+public:
+    virtual void writeEntities() {
+        for (int i = 0; i < count; ++i) {
+            if (i % 10 == 9) {
+                DRW_Text text;
+                text.layer = layerName(i % LAYERS);
+                text.style = "ARCHITECTURAL-NOTES";
+                text.text = "note";
+                text.height = 2.5;
+                dxfWriter->writeText(&text);
+                continue;
+            }
+            DRW_Line line;
+            line.layer = layerName(i % LAYERS);
+            line.lineType = (i % 3) ? "CONTINUOUS" : "HIDDEN-FINE-DASHED";
+            line.secPoint.x = i;
+            dxfWriter->writeLine(&line);
+        }
+    }
+    dxfRW* dxfWriter;
+    int count;
+};
+
+int main(int argc, char* argv[]) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000000;
+    const char *filename = "bench_names.dxf";
+    {
+        dxfRW dxf(filename);
+        Writer writer;
+        writer.dxfWriter = &dxf;
+        writer.count = count;
+        if (!dxf.write(&writer, DRW::AC1015, false)) {
+            std::cout << "write failed" << std::endl;
+            return 1;
+        }
+    }
+
+    double before = heapMB();
+    KeepInterface reader;
+    reader.lines.reserve(count);
+    reader.texts.reserve(count / 10 + 1);
+    double reserved = heapMB();
+    dxfRW dxf(filename);
+    if (!dxf.read(&reader, false)) {
+        std::cout << "read failed" << std::endl;
+        return 1;
+    }
+    double after = heapMB();
+    std::remove(filename);
+
+    std::cout << reader.lines.size() << " lines, " << reader.texts.size() << " texts on "
+              << LAYERS << " layers" << std::endl;
+    std::cout << "sizeof(DRW_Line) " << sizeof(DRW_Line) << ", sizeof(DRW_Text) "
+              << sizeof(DRW_Text) << std::endl;
+    std::cout << "entity arrays: " << reserved - before << " MB" << std::endl;
+    std::cout << "name strings:  " << after - reserved << " MB" << std::endl;
+    std::cout << "total heap:    " << after - before << " MB" << std::endl;
+    return 0;
+}
@@ -0,0 +1,155 @@
+/******************************************************************************
+**  libDXFrw - Read-Ahead Benchmark                                         **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+// Reads a large DXF with and without read-ahead, from a cold page cache
+// (POSIX systems) and from a source throttled to a network bandwidth.
+// usage: bench_readahead [line count] [throttle MB/s]
+
+#include "libdxfrw.h"
+#include "drw_stats.h"
+#include "test_interface.h"
+#include <iostream>
+#include <fstream>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <chrono>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+class CountInterface : public TestInterface {
+public:
+    virtual void addHeader(const DRW_Header* data) {}
+    virtual void addLine(const DRW_Line& data) { lineCount++; }
+};
+
+class LineWriter : public CountInterface {
+public:
+    virtual void writeEntities() {
+        for (int i = 0; i < count; ++i) {
+            DRW_Line line;
+            line.basePoint.x = i * 0.25;
+            line.secPoint.x = i * 0.5;
+            line.secPoint.y = 1.0 / (i + 1);
+            dxfWriter->writeLine(&line);
+        }
+    }
+    dxfRW* dxfWriter;
+    int count;
+};
+
+//file read at a limited bandwidth, as cold network storage
+class ThrottledSource : public DRW_InputSource {
+public:
+    ThrottledSource(int f, double mbs) : fd(f), bytesPerSec(mbs * 1e6) {}
+    virtual size_t read(char *buf, size_t n) {
+        if (n > 65536)
+            n = 65536;
+        long r = ::read(fd, buf, n);
+        if (r <= 0)
+            return 0;
+        std::this_thread::sleep_for(std::chrono::duration<double>(r / bytesPerSec));
+        return r;
+    }
+    int fd;
+    double bytesPerSec;
+};
+
+//evicts the file from the page cache
+static void dropCache(const char *filename) {
+#if defined(POSIX_FADV_DONTNEED)
+    int fd = open(filename, O_RDONLY);
+    if (fd >= 0) {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#else
+    (void)filename;
+#endif
+}
+
+static double readFile(const char *filename, bool ahead, int expected) {
+    dropCache(filename);
+    dxfRW dxf(filename);
+    dxf.setReadAhead(ahead);
+    CountInterface reader;
+    double start = DRW_ReadStats::now();
+    bool ok = dxf.read(&reader, false);
+    double elapsed = DRW_ReadStats::now() - start;
+    if (!ok || reader.lineCount != expected)
+        std::cout << "read failed, " << reader.lineCount << " lines" << std::endl;
+    return elapsed;
+}
+
+static double readThrottled(const char *filename, bool ahead, double mbs, int expected) {
+    int fd = open(filename, O_RDONLY);
+    ThrottledSource source(fd, mbs);
+    dxfRW dxf(filename);
+    dxf.setReadAhead(ahead);
+    CountInterface reader;
+    double start = DRW_ReadStats::now();
+    bool ok = dxf.read(&source, &reader, false);
+    double elapsed = DRW_ReadStats::now() - start;
+    close(fd);
+    if (!ok || reader.lineCount != expected)
+        std::cout << "read failed, " << reader.lineCount << " lines" << std::endl;
+    return elapsed;
+}
+
+int main(int argc, char* argv[]) {
+    int lines = argc > 1 ? atoi(argv[1]) : 300000;
+    double mbs = argc > 2 ? atof(argv[2]) : 50.0;
+    const char *filename = "bench_readahead.dxf";
+
+    {
+        dxfRW dxf(filename);
+        LineWriter writer;
+        writer.dxfWriter = &dxf;
+        writer.count = lines;
+        if (!dxf.write(&writer, DRW::AC1015, false)) {
+            std::cout << "write failed" << std::endl;
+            return 1;
+        }
+    }
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    double mb = in.tellg() / 1e6;
+    in.close();
+    std::cout << lines << " lines, " << mb << " MB" << std::endl;
+
+    //warm cache parse time, the lower bound
+    dxfRW warm(filename);
+    CountInterface warmReader;
+    warm.read(&warmReader, false);
+    double parse = warm.getStats().totalTime;
+    std::cout << "parse only (warm cache): " << parse << " s" << std::endl;
+
+    double syncCold = readFile(filename, false, lines);
+    double aheadCold = readFile(filename, true, lines);
+    std::cout << "cold cache, synchronous: " << syncCold << " s" << std::endl;
+    std::cout << "cold cache, read-ahead:  " << aheadCold << " s" << std::endl;
+
+    double transfer = mb / mbs;
+    double syncSlow = readThrottled(filename, false, mbs, lines);
+    double aheadSlow = readThrottled(filename, true, mbs, lines);
+    std::cout << mbs << " MB/s source (" << transfer << " s transfer), synchronous: "
+              << syncSlow << " s" << std::endl;
+    std::cout << mbs << " MB/s source (" << transfer << " s transfer), read-ahead:  "
+              << aheadSlow << " s, overlap " << (syncSlow - aheadSlow) << " s" << std::endl;
+
+    std::remove(filename);
+    return 0;
+}
@@ -153,6 +153,86 @@ public:
         cData->images.push_back(img);
     }
 
+    //the reader gives up the entities, keeps them without copy
+    virtual void takePoint(DRW_Point&& data){
+        currentBlock->ent.push_back(new DRW_Point(std::move(data)));
+    }
+    virtual void takeLine(DRW_Line&& data){
+        currentBlock->ent.push_back(new DRW_Line(std::move(data)));
+    }
+    virtual void takeRay(DRW_Ray&& data){
+        currentBlock->ent.push_back(new DRW_Ray(std::move(data)));
+    }
+    virtual void takeXline(DRW_Xline&& data){
+        currentBlock->ent.push_back(new DRW_Xline(std::move(data)));
+    }
+    virtual void takeArc(DRW_Arc&& data){
+        currentBlock->ent.push_back(new DRW_Arc(std::move(data)));
+    }
+    virtual void takeCircle(DRW_Circle&& data){
+        currentBlock->ent.push_back(new DRW_Circle(std::move(data)));
+    }
+    virtual void takeEllipse(DRW_Ellipse&& data){
+        currentBlock->ent.push_back(new DRW_Ellipse(std::move(data)));
+    }
+    virtual void takeLWPolyline(DRW_LWPolyline&& data){
+        currentBlock->ent.push_back(new DRW_LWPolyline(std::move(data)));
+    }
+    virtual void takePolyline(DRW_Polyline&& data){
+        currentBlock->ent.push_back(new DRW_Polyline(std::move(data)));
+    }
+    virtual void takeSpline(DRW_Spline&& data){
+        currentBlock->ent.push_back(new DRW_Spline(std::move(data)));
+    }
+    virtual void takeInsert(DRW_Insert&& data){
+        currentBlock->ent.push_back(new DRW_Insert(std::move(data)));
+    }
+    virtual void takeTrace(DRW_Trace&& data){
+        currentBlock->ent.push_back(new DRW_Trace(std::move(data)));
+    }
+    virtual void take3dFace(DRW_3Dface&& data){
+        currentBlock->ent.push_back(new DRW_3Dface(std::move(data)));
+    }
+    virtual void takeSolid(DRW_Solid&& data){
+        currentBlock->ent.push_back(new DRW_Solid(std::move(data)));
+    }
+    virtual void takeMText(DRW_MText&& data){
+        currentBlock->ent.push_back(new DRW_MText(std::move(data)));
+    }
+    virtual void takeText(DRW_Text&& data){
+        currentBlock->ent.push_back(new DRW_Text(std::move(data)));
+    }
+    virtual void takeDimAlign(DRW_DimAligned&& data){
+        currentBlock->ent.push_back(new DRW_DimAligned(std::move(data)));
+    }
+    virtual void takeDimLinear(DRW_DimLinear&& data){
+        currentBlock->ent.push_back(new DRW_DimLinear(std::move(data)));
+    }
+    virtual void takeDimRadial(DRW_DimRadial&& data){
+        currentBlock->ent.push_back(new DRW_DimRadial(std::move(data)));
+    }
+    virtual void takeDimDiametric(DRW_DimDiametric&& data){
+        currentBlock->ent.push_back(new DRW_DimDiametric(std::move(data)));
+    }
+    virtual void takeDimAngular(DRW_DimAngular&& data){
+        currentBlock->ent.push_back(new DRW_DimAngular(std::move(data)));
+    }
+    virtual void takeDimAngular3P(DRW_DimAngular3p&& data){
+        currentBlock->ent.push_back(new DRW_DimAngular3p(std::move(data)));
+    }
+    virtual void takeDimOrdinate(DRW_DimOrdinate&& data){
+        currentBlock->ent.push_back(new DRW_DimOrdinate(std::move(data)));
+    }
+    virtual void takeLeader(DRW_Leader&& data){
+        currentBlock->ent.push_back(new DRW_Leader(std::move(data)));
+    }
+    virtual void takeHatch(DRW_Hatch&& data){
+        currentBlock->ent.push_back(new DRW_Hatch(std::move(data)));
+    }
+    virtual void takeViewport(DRW_Viewport&& data){
+        currentBlock->ent.push_back(new DRW_Viewport(std::move(data)));
+    }
+
     virtual void linkImage(const DRW_ImageDef *data){
         duint32 handle = data->handle;
         std::string path(data->name);
@@ -81,6 +81,21 @@ enum Version {
     AC1032        /*!< ACAD 2018. */
 };
 
+//! File formats, detected from the first bytes of the file.
+enum FileFormat {
+    UNKNOWN_FORMAT, /*!< empty or unreadable. */
+    DXF_ASCII,      /*!< anything not recognized as dxf binary or dwg. */
+    DXF_BINARY,     /*!< "AutoCAD Binary DXF" sentinel. */
+    DWG_FORMAT      /*!< "AC10xx" version string. */
+};
+
+//! Stream compression, detected from the magic bytes on read.
+enum Compression {
+    NO_COMPRESSION,
+    GZIP_COMPRESSION, /*!< gzip or zlib deflate stream, needs zlib. */
+    ZSTD_COMPRESSION  /*!< zstandard frames, needs libzstd. */
+};
+
 enum error {
 BAD_NONE,             /*!< No error. */
 BAD_UNKNOWN,          /*!< UNKNOWN. */
@@ -176,6 +191,161 @@ public:
     double z;
 };
 
+//! Axis aligned bounding box.
+/*!
+*  An empty box is not valid, the first point added sets both corners.
+*/
+class DRW_BBox {
+public:
+    DRW_BBox(): valid(false) {}
+    DRW_BBox(const DRW_Coord &p1, const DRW_Coord &p2): minPoint(p1), maxPoint(p1), valid(true) { add(p2); }
+
+    void add(double x, double y, double z) {
+        if (!valid) {
+            minPoint = maxPoint = DRW_Coord(x, y, z);
+            valid = true;
+            return;
+        }
+        if (x < minPoint.x) minPoint.x = x;
+        if (x > maxPoint.x) maxPoint.x = x;
+        if (y < minPoint.y) minPoint.y = y;
+        if (y > maxPoint.y) maxPoint.y = y;
+        if (z < minPoint.z) minPoint.z = z;
+        if (z > maxPoint.z) maxPoint.z = z;
+    }
+    void add(const DRW_Coord &p) { add(p.x, p.y, p.z); }
+    void add(const DRW_BBox &b) {
+        if (b.valid) {
+            add(b.minPoint);
+            add(b.maxPoint);
+        }
+    }
+    void clear() { valid = false; minPoint = maxPoint = DRW_Coord(); }
+    bool isValid() const { return valid; }
+    /** true if the boxes overlap or touch */
+    bool intersects(const DRW_BBox &b) const {
+        return valid && b.valid
+            && minPoint.x <= b.maxPoint.x && b.minPoint.x <= maxPoint.x
+            && minPoint.y <= b.maxPoint.y && b.minPoint.y <= maxPoint.y
+            && minPoint.z <= b.maxPoint.z && b.minPoint.z <= maxPoint.z;
+    }
+
+public:
+    DRW_Coord minPoint;     /*!< lower corner */
+    DRW_Coord maxPoint;     /*!< upper corner */
+    bool valid;             /*!< false if nothing was added */
+};
+
+//! Affine transformation of points, p' = m*p + t.
+/*!
+*  Row i of 'm' is m[i][0..2] and the translation is m[i][3].
+*  a*b applies b first.
+*/
+class DRW_Transform {
+public:
+    DRW_Transform() {
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 4; ++j)
+                m[i][j] = (i == j) ? 1.0 : 0.0;
+    }
+    /** maps the axes x, y & z to the given vectors and the origin to 'org' */
+    DRW_Transform(const DRW_Coord &ax, const DRW_Coord &ay, const DRW_Coord &az, const DRW_Coord &org) {
+        m[0][0] = ax.x; m[0][1] = ay.x; m[0][2] = az.x; m[0][3] = org.x;
+        m[1][0] = ax.y; m[1][1] = ay.y; m[1][2] = az.y; m[1][3] = org.y;
+        m[2][0] = ax.z; m[2][1] = ay.z; m[2][2] = az.z; m[2][3] = org.z;
+    }
+
+    static DRW_Transform translation(double x, double y, double z) {
+        DRW_Transform t;
+        t.m[0][3] = x; t.m[1][3] = y; t.m[2][3] = z;
+        return t;
+    }
+    static DRW_Transform scale(double x, double y, double z) {
+        DRW_Transform t;
+        t.m[0][0] = x; t.m[1][1] = y; t.m[2][2] = z;
+        return t;
+    }
+    /** rotation around z, angle in radians */
+    static DRW_Transform rotation(double angle) {
+        DRW_Transform t;
+        t.m[0][0] = t.m[1][1] = cos(angle);
+        t.m[1][0] = sin(angle);
+        t.m[0][1] = -t.m[1][0];
+        return t;
+    }
+    /** OCS to WCS of an extrusion, with the arbitrary axis algorithm */
+    static DRW_Transform ocs(const DRW_Coord &extrusion) {
+        DRW_Coord n = extrusion;
+        n.unitize();
+        if (fabs(n.x) < 1e-12 && fabs(n.y) < 1e-12 && n.z >= 0.0) //also a bad (0,0,0) extrusion
+            return DRW_Transform();
+        DRW_Coord ax;
+        if (fabs(n.x) < 0.015625 && fabs(n.y) < 0.015625)
+            ax = DRW_Coord(n.z, 0, -n.x);
+        else
+            ax = DRW_Coord(-n.y, n.x, 0);
+        ax.unitize();
+        DRW_Coord ay(n.y*ax.z - ax.y*n.z, n.z*ax.x - ax.z*n.x, n.x*ax.y - ax.x*n.y);
+        ay.unitize();
+        return DRW_Transform(ax, ay, n, DRW_Coord());
+    }
+
+    DRW_Coord apply(const DRW_Coord &p) const {
+        return DRW_Coord(m[0][0]*p.x + m[0][1]*p.y + m[0][2]*p.z + m[0][3],
+                         m[1][0]*p.x + m[1][1]*p.y + m[1][2]*p.z + m[1][3],
+                         m[2][0]*p.x + m[2][1]*p.y + m[2][2]*p.z + m[2][3]);
+    }
+    /** without the translation */
+    DRW_Coord applyVector(const DRW_Coord &v) const {
+        return DRW_Coord(m[0][0]*v.x + m[0][1]*v.y + m[0][2]*v.z,
+                         m[1][0]*v.x + m[1][1]*v.y + m[1][2]*v.z,
+                         m[2][0]*v.x + m[2][1]*v.y + m[2][2]*v.z);
+    }
+    DRW_Transform operator*(const DRW_Transform &b) const {
+        DRW_Transform r;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 4; ++j) {
+                r.m[i][j] = m[i][0]*b.m[0][j] + m[i][1]*b.m[1][j] + m[i][2]*b.m[2][j];
+                if (j == 3)
+                    r.m[i][j] += m[i][3];
+            }
+        }
+        return r;
+    }
+    double determinant() const {
+        return m[0][0]*(m[1][1]*m[2][2] - m[1][2]*m[2][1])
+             - m[0][1]*(m[1][0]*m[2][2] - m[1][2]*m[2][0])
+             + m[0][2]*(m[1][0]*m[2][1] - m[1][1]*m[2][0]);
+    }
+    /** the inverse, identity if it is singular */
+    DRW_Transform inverse() const {
+        DRW_Transform r;
+        double d = determinant();
+        if (d == 0.0)
+            return r;
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                //cofactor of m[j][i]
+                int r0 = (j + 1) % 3, r1 = (j + 2) % 3, c0 = (i + 1) % 3, c1 = (i + 2) % 3;
+                r.m[i][j] = (m[r0][c0]*m[r1][c1] - m[r0][c1]*m[r1][c0]) / d;
+            }
+        }
+        for (int i = 0; i < 3; ++i)
+            r.m[i][3] = -(r.m[i][0]*m[0][3] + r.m[i][1]*m[1][3] + r.m[i][2]*m[2][3]);
+        return r;
+    }
+    bool isIdentity() const {
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 4; ++j)
+                if (m[i][j] != ((i == j) ? 1.0 : 0.0))
+                    return false;
+        return true;
+    }
+
+public:
+    double m[3][4];
+};
+
 
 //! Class to handle vertex
 /*!
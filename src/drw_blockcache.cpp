@@ -0,0 +1,318 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_blockcache.h"
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include "libdxfrw.h"
+#include "intern/drw_entitycopy.h"
+
+namespace {
+
+//splitmix64 finalizer, the same as the fingerprints
+duint64 mix(duint64 v){
+    v ^= v >> 30;
+    v *= 0xbf58476d1ce4e5b9ULL;
+    v ^= v >> 27;
+    v *= 0x94d049bb133111ebULL;
+    v ^= v >> 31;
+    return v;
+}
+
+duint64 combine(duint64 h, duint64 v){
+    return (h ^ mix(v)) * 0x100000001b3ULL;
+}
+
+duint64 doubleBits(double v){
+    if (v == 0.0)
+        v = 0.0;  //-0
+    duint64 bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+/*hex name of a block saved to a file*/
+std::string keyName(duint64 key){
+    char buf[20];
+    snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(key));
+    return std::string(buf);
+}
+
+//! Writes the cached blocks with dxfRW.
+class BlockWriter : public DRW_BlockBuilder {
+public:
+    BlockWriter(dxfRW *w, const std::vector<std::shared_ptr<const DRW_BlockDef> > &d):
+        writer(w), defs(d) {}
+
+    virtual void writeBlockRecords() {
+        for (size_t i = 0; i < defs.size(); ++i)
+            writer->writeBlockRecord(keyName(defs[i]->key));
+    }
+    virtual void writeBlocks() {
+        for (size_t i = 0; i < defs.size(); ++i) {
+            const DRW_BlockDef &def = *defs[i];
+            DRW_Block b;
+            b.name = keyName(def.key);
+            b.basePoint = def.basePoint;
+            b.flags = def.flags;
+            writer->writeBlock(&b);
+            //the writer sets the handles, the shared entities are not changed
+            for (size_t j = 0; j < def.entities.size(); ++j) {
+                DRW_Entity *e = DRW::copyEntity(*def.entities[j]);
+                if (e != NULL) {
+                    writeEntity(e);
+                    DRW::destroyEntity(e);
+                }
+            }
+        }
+    }
+
+private:
+    void writeEntity(DRW_Entity *e) {
+        switch (e->eType) {
+        case DRW::POINT: writer->writePoint(static_cast<DRW_Point *>(e)); break;
+        case DRW::LINE: writer->writeLine(static_cast<DRW_Line *>(e)); break;
+        case DRW::RAY: writer->writeRay(static_cast<DRW_Ray *>(e)); break;
+        case DRW::XLINE: writer->writeXline(static_cast<DRW_Xline *>(e)); break;
+        case DRW::CIRCLE: writer->writeCircle(static_cast<DRW_Circle *>(e)); break;
+        case DRW::ARC: writer->writeArc(static_cast<DRW_Arc *>(e)); break;
+        case DRW::ELLIPSE: writer->writeEllipse(static_cast<DRW_Ellipse *>(e)); break;
+        case DRW::TRACE: writer->writeTrace(static_cast<DRW_Trace *>(e)); break;
+        case DRW::SOLID: writer->writeSolid(static_cast<DRW_Solid *>(e)); break;
+        case DRW::E3DFACE: writer->write3dface(static_cast<DRW_3Dface *>(e)); break;
+        case DRW::LWPOLYLINE: writer->writeLWPolyline(static_cast<DRW_LWPolyline *>(e)); break;
+        case DRW::POLYLINE: writer->writePolyline(static_cast<DRW_Polyline *>(e)); break;
+        case DRW::SPLINE: writer->writeSpline(static_cast<DRW_Spline *>(e)); break;
+        case DRW::INSERT: writer->writeInsert(static_cast<DRW_Insert *>(e)); break;
+        case DRW::TEXT: writer->writeText(static_cast<DRW_Text *>(e)); break;
+        case DRW::MTEXT: writer->writeMText(static_cast<DRW_MText *>(e)); break;
+        case DRW::HATCH: writer->writeHatch(static_cast<DRW_Hatch *>(e)); break;
+        default: break;
+        }
+    }
+
+    dxfRW *writer;
+    const std::vector<std::shared_ptr<const DRW_BlockDef> > &defs;
+};
+
+} //namespace
+
+void DRW_Interface::takeBlockDefinition(const DRW_Block& data, const std::shared_ptr<const DRW_BlockDef>& def){
+    addBlock(data);
+    def->replay(this);
+    endBlock();
+}
+
+DRW_BlockDef::~DRW_BlockDef(){
+    for (std::vector<DRW_Entity *>::iterator it = entities.begin(); it != entities.end(); ++it)
+        DRW::destroyEntity(*it);
+}
+
+void DRW_BlockDef::replay(DRW_Interface *iface) const {
+    for (std::vector<DRW_Entity *>::const_iterator it = entities.begin(); it != entities.end(); ++it) {
+        const DRW_Entity *e = *it;
+        switch (e->eType) {
+        case DRW::POINT: iface->addPoint(*static_cast<const DRW_Point *>(e)); break;
+        case DRW::LINE: iface->addLine(*static_cast<const DRW_Line *>(e)); break;
+        case DRW::RAY: iface->addRay(*static_cast<const DRW_Ray *>(e)); break;
+        case DRW::XLINE: iface->addXline(*static_cast<const DRW_Xline *>(e)); break;
+        case DRW::CIRCLE: iface->addCircle(*static_cast<const DRW_Circle *>(e)); break;
+        case DRW::ARC: iface->addArc(*static_cast<const DRW_Arc *>(e)); break;
+        case DRW::ELLIPSE: iface->addEllipse(*static_cast<const DRW_Ellipse *>(e)); break;
+        case DRW::TRACE: iface->addTrace(*static_cast<const DRW_Trace *>(e)); break;
+        case DRW::SOLID: iface->addSolid(*static_cast<const DRW_Solid *>(e)); break;
+        case DRW::E3DFACE: iface->add3dFace(*static_cast<const DRW_3Dface *>(e)); break;
+        case DRW::LWPOLYLINE: iface->addLWPolyline(*static_cast<const DRW_LWPolyline *>(e)); break;
+        case DRW::POLYLINE: iface->addPolyline(*static_cast<const DRW_Polyline *>(e)); break;
+        case DRW::SPLINE: iface->addSpline(static_cast<const DRW_Spline *>(e)); break;
+        case DRW::INSERT: iface->addInsert(*static_cast<const DRW_Insert *>(e)); break;
+        case DRW::TEXT: iface->addText(*static_cast<const DRW_Text *>(e)); break;
+        case DRW::MTEXT: iface->addMText(*static_cast<const DRW_MText *>(e)); break;
+        case DRW::HATCH: iface->addHatch(static_cast<const DRW_Hatch *>(e)); break;
+        case DRW::LEADER: iface->addLeader(static_cast<const DRW_Leader *>(e)); break;
+        case DRW::DIMALIGNED: iface->addDimAlign(static_cast<const DRW_DimAligned *>(e)); break;
+        case DRW::DIMLINEAR: iface->addDimLinear(static_cast<const DRW_DimLinear *>(e)); break;
+        case DRW::DIMRADIAL: iface->addDimRadial(static_cast<const DRW_DimRadial *>(e)); break;
+        case DRW::DIMDIAMETRIC: iface->addDimDiametric(static_cast<const DRW_DimDiametric *>(e)); break;
+        case DRW::DIMANGULAR: iface->addDimAngular(static_cast<const DRW_DimAngular *>(e)); break;
+        case DRW::DIMANGULAR3P: iface->addDimAngular3P(static_cast<const DRW_DimAngular3p *>(e)); break;
+        case DRW::DIMORDINATE: iface->addDimOrdinate(static_cast<const DRW_DimOrdinate *>(e)); break;
+        case DRW::VIEWPORT: iface->addViewport(*static_cast<const DRW_Viewport *>(e)); break;
+        case DRW::IMAGE: iface->addImage(static_cast<const DRW_Image *>(e)); break;
+        default: break;
+        }
+    }
+}
+
+void DRW_BlockBuilder::addBlock(const DRW_Block& data){
+    current = data;
+    def = std::make_shared<DRW_BlockDef>();
+    def->basePoint = data.basePoint;
+    def->flags = data.flags;
+}
+
+void DRW_BlockBuilder::endBlock(){
+    if (def == NULL)
+        return;
+    Built b;
+    b.block = current;
+    b.def = def;
+    blocks.push_back(b);
+    def.reset();
+}
+
+void DRW_BlockBuilder::store(const DRW_Entity &e){
+    DRW_Entity *c = DRW::copyEntity(e);
+    if (c != NULL)
+        keep(c);
+}
+
+void DRW_BlockBuilder::keep(DRW_Entity *e){
+    if (def != NULL)
+        def->entities.push_back(e);
+    else
+        DRW::destroyEntity(e);
+}
+
+DRW_BlockCache::DRW_BlockCache(): hitCount(0), missCount(0), unsharedCount(0) {
+    //exact values, the shared entities replace the ones read
+    hasher.setQuantum(0);
+    hasher.setProperties(true);
+}
+
+bool DRW_BlockCache::hashBlock(DRW_BlockDef *def) const {
+    duint64 h = 0xcbf29ce484222325ULL;
+    h = combine(h, doubleBits(def->basePoint.x));
+    h = combine(h, doubleBits(def->basePoint.y));
+    h = combine(h, doubleBits(def->basePoint.z));
+    h = combine(h, static_cast<duint64>(def->flags));
+    h = combine(h, def->entities.size());
+    def->prints.clear();
+    def->prints.reserve(def->entities.size());
+    for (size_t i = 0; i < def->entities.size(); ++i) {
+        const DRW_Entity &e = *def->entities[i];
+        //the prints leave out the extended & application data
+        if (!e.extData.empty() || !e.appData.empty())
+            return false;
+        duint64 print = hasher.hash(e);
+        if (print == 0)
+            return false;
+        def->prints.push_back(print);
+        h = combine(h, print);
+    }
+    def->key = mix(h);
+    //0 is for the blocks not shared
+    if (def->key == 0)
+        def->key = 1;
+    return true;
+}
+
+std::shared_ptr<const DRW_BlockDef> DRW_BlockCache::insert(const std::shared_ptr<DRW_BlockDef> &def){
+    std::lock_guard<std::mutex> guard(lock);
+    std::pair<std::unordered_map<duint64, std::shared_ptr<const DRW_BlockDef> >::iterator, bool> it =
+            defs.insert(std::make_pair(def->key, std::shared_ptr<const DRW_BlockDef>(def)));
+    if (it.second) {
+        ++missCount;
+        return def;
+    }
+    const DRW_BlockDef &cached = *it.first->second;
+    if (cached.prints == def->prints) {
+        ++hitCount;
+        return it.first->second;
+    }
+    //another block with the same key, not shared
+    ++unsharedCount;
+    def->key = 0;
+    return def;
+}
+
+std::shared_ptr<const DRW_BlockDef> DRW_BlockCache::share(const DRW_Block &b, const std::shared_ptr<DRW_BlockDef> &def){
+    def->basePoint = b.basePoint;
+    def->flags = b.flags;
+    if (!hashBlock(def.get())) {
+        def->key = 0;
+        std::lock_guard<std::mutex> guard(lock);
+        ++unsharedCount;
+        return def;
+    }
+    return insert(def);
+}
+
+std::shared_ptr<const DRW_BlockDef> DRW_BlockCache::find(duint64 key) const {
+    std::lock_guard<std::mutex> guard(lock);
+    std::unordered_map<duint64, std::shared_ptr<const DRW_BlockDef> >::const_iterator it = defs.find(key);
+    if (it == defs.end())
+        return std::shared_ptr<const DRW_BlockDef>();
+    return it->second;
+}
+
+size_t DRW_BlockCache::size() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return defs.size();
+}
+
+void DRW_BlockCache::clear(){
+    std::lock_guard<std::mutex> guard(lock);
+    defs.clear();
+    hitCount = missCount = unsharedCount = 0;
+}
+
+duint64 DRW_BlockCache::hits() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return hitCount;
+}
+
+duint64 DRW_BlockCache::misses() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return missCount;
+}
+
+duint64 DRW_BlockCache::unshared() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return unsharedCount;
+}
+
+bool DRW_BlockCache::save(const std::string &path) const {
+    std::vector<std::shared_ptr<const DRW_BlockDef> > list;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        list.reserve(defs.size());
+        for (std::unordered_map<duint64, std::shared_ptr<const DRW_BlockDef> >::const_iterator it = defs.begin();
+             it != defs.end(); ++it)
+            list.push_back(it->second);
+    }
+    //binary, the doubles are written exactly
+    dxfRW out(path.c_str());
+    BlockWriter w(&out, list);
+    return out.write(&w, DRW::AC1021, true);
+}
+
+bool DRW_BlockCache::load(const std::string &path){
+    dxfRW in(path.c_str());
+    DRW_BlockBuilder blocks;
+    if (!in.read(&blocks, false))
+        return false;
+    for (size_t i = 0; i < blocks.blocks.size(); ++i) {
+        const std::string &name = blocks.blocks[i].block.name;
+        if (name.size() != 16 || name.find_first_not_of("0123456789abcdef") != std::string::npos)
+            continue;
+        duint64 key = static_cast<duint64>(strtoull(name.c_str(), NULL, 16));
+        DRW_BlockDef *def = blocks.blocks[i].def.get();
+        //the blocks changed by writing are not loaded
+        if (!hashBlock(def) || def->key != key)
+            continue;
+        std::lock_guard<std::mutex> guard(lock);
+        defs.insert(std::make_pair(key, std::shared_ptr<const DRW_BlockDef>(blocks.blocks[i].def)));
+    }
+    return true;
+}
@@ -0,0 +1,205 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_BLOCKCACHE_H
+#define DRW_BLOCKCACHE_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include "drw_base.h"
+#include "drw_entities.h"
+#include "drw_interface.h"
+#include "drw_fingerprint.h"
+
+//! Entities of a block definition, without the name of the block.
+/*!
+*  Owns its entities & their lists. Once shared by DRW_BlockCache it is
+*  never changed, the entities keep the handles of the drawing read first.
+*/
+class DRW_BlockDef {
+public:
+    DRW_BlockDef(): key(0), flags(0) {}
+    ~DRW_BlockDef();
+    /** calls the add functions of 'iface' with the entities, in read order */
+    void replay(DRW_Interface *iface) const;
+
+public:
+    duint64 key;                         /*!< content key, 0 if the block is not shared */
+    DRW_Coord basePoint;                 /*!< base point of the block */
+    int flags;                           /*!< block type, code 70 */
+    std::vector<DRW_Entity *> entities;  /*!< in read order */
+    std::vector<duint64> prints;         /*!< fingerprint of each entity, set by DRW_BlockCache */
+
+private:
+    DRW_BlockDef(const DRW_BlockDef&);
+    DRW_BlockDef &operator=(const DRW_BlockDef&);
+};
+
+//! Collects the blocks & their entities, used by the readers with a cache.
+/*!
+*  The entities out of blocks are not kept.
+*/
+class DRW_BlockBuilder : public DRW_Interface {
+public:
+    struct Built {
+        DRW_Block block;
+        std::shared_ptr<DRW_BlockDef> def;
+    };
+
+    DRW_BlockBuilder() {}
+    std::vector<Built> blocks;  /*!< the blocks ended, in read order */
+
+    virtual void addBlock(const DRW_Block& data);
+    virtual void endBlock();
+    virtual void setBlock(const int) {}
+
+    virtual void addPoint(const DRW_Point& data) { store(data); }
+    virtual void addLine(const DRW_Line& data) { store(data); }
+    virtual void addRay(const DRW_Ray& data) { store(data); }
+    virtual void addXline(const DRW_Xline& data) { store(data); }
+    virtual void addArc(const DRW_Arc& data) { store(data); }
+    virtual void addCircle(const DRW_Circle& data) { store(data); }
+    virtual void addEllipse(const DRW_Ellipse& data) { store(data); }
+    virtual void addLWPolyline(const DRW_LWPolyline& data) { store(data); }
+    virtual void addPolyline(const DRW_Polyline& data) { store(data); }
+    virtual void addSpline(const DRW_Spline* data) { store(*data); }
+    virtual void addKnot(const DRW_Entity&) {}
+    virtual void addInsert(const DRW_Insert& data) { store(data); }
+    virtual void addTrace(const DRW_Trace& data) { store(data); }
+    virtual void add3dFace(const DRW_3Dface& data) { store(data); }
+    virtual void addSolid(const DRW_Solid& data) { store(data); }
+    virtual void addMText(const DRW_MText& data) { store(data); }
+    virtual void addText(const DRW_Text& data) { store(data); }
+    virtual void addDimAlign(const DRW_DimAligned *data) { store(*data); }
+    virtual void addDimLinear(const DRW_DimLinear *data) { store(*data); }
+    virtual void addDimRadial(const DRW_DimRadial *data) { store(*data); }
+    virtual void addDimDiametric(const DRW_DimDiametric *data) { store(*data); }
+    virtual void addDimAngular(const DRW_DimAngular *data) { store(*data); }
+    virtual void addDimAngular3P(const DRW_DimAngular3p *data) { store(*data); }
+    virtual void addDimOrdinate(const DRW_DimOrdinate *data) { store(*data); }
+    virtual void addLeader(const DRW_Leader *data) { store(*data); }
+    virtual void addHatch(const DRW_Hatch *data) { store(*data); }
+    virtual void addViewport(const DRW_Viewport& data) { store(data); }
+    virtual void addImage(const DRW_Image *data) { store(*data); }
+
+    virtual void takePoint(DRW_Point&& data) { keep(new DRW_Point(std::move(data))); }
+    virtual void takeLine(DRW_Line&& data) { keep(new DRW_Line(std::move(data))); }
+    virtual void takeRay(DRW_Ray&& data) { keep(new DRW_Ray(std::move(data))); }
+    virtual void takeXline(DRW_Xline&& data) { keep(new DRW_Xline(std::move(data))); }
+    virtual void takeArc(DRW_Arc&& data) { keep(new DRW_Arc(std::move(data))); }
+    virtual void takeCircle(DRW_Circle&& data) { keep(new DRW_Circle(std::move(data))); }
+    virtual void takeEllipse(DRW_Ellipse&& data) { keep(new DRW_Ellipse(std::move(data))); }
+    virtual void takeLWPolyline(DRW_LWPolyline&& data) { keep(new DRW_LWPolyline(std::move(data))); }
+    virtual void takePolyline(DRW_Polyline&& data) { keep(new DRW_Polyline(std::move(data))); }
+    virtual void takeSpline(DRW_Spline&& data) { keep(new DRW_Spline(std::move(data))); }
+    virtual void takeInsert(DRW_Insert&& data) { keep(new DRW_Insert(std::move(data))); }
+    virtual void takeTrace(DRW_Trace&& data) { keep(new DRW_Trace(std::move(data))); }
+    virtual void take3dFace(DRW_3Dface&& data) { keep(new DRW_3Dface(std::move(data))); }
+    virtual void takeSolid(DRW_Solid&& data) { keep(new DRW_Solid(std::move(data))); }
+    virtual void takeMText(DRW_MText&& data) { keep(new DRW_MText(std::move(data))); }
+    virtual void takeText(DRW_Text&& data) { keep(new DRW_Text(std::move(data))); }
+    virtual void takeDimAlign(DRW_DimAligned&& data) { keep(new DRW_DimAligned(std::move(data))); }
+    virtual void takeDimLinear(DRW_DimLinear&& data) { keep(new DRW_DimLinear(std::move(data))); }
+    virtual void takeDimRadial(DRW_DimRadial&& data) { keep(new DRW_DimRadial(std::move(data))); }
+    virtual void takeDimDiametric(DRW_DimDiametric&& data) { keep(new DRW_DimDiametric(std::move(data))); }
+    virtual void takeDimAngular(DRW_DimAngular&& data) { keep(new DRW_DimAngular(std::move(data))); }
+    virtual void takeDimAngular3P(DRW_DimAngular3p&& data) { keep(new DRW_DimAngular3p(std::move(data))); }
+    virtual void takeDimOrdinate(DRW_DimOrdinate&& data) { keep(new DRW_DimOrdinate(std::move(data))); }
+    virtual void takeLeader(DRW_Leader&& data) { keep(new DRW_Leader(std::move(data))); }
+    virtual void takeHatch(DRW_Hatch&& data) { keep(new DRW_Hatch(std::move(data))); }
+    virtual void takeViewport(DRW_Viewport&& data) { keep(new DRW_Viewport(std::move(data))); }
+    virtual void takeImage(DRW_Image&& data) { keep(new DRW_Image(std::move(data))); }
+
+    virtual void addHeader(const DRW_Header*) {}
+    virtual void addLType(const DRW_LType&) {}
+    virtual void addLayer(const DRW_Layer&) {}
+    virtual void addDimStyle(const DRW_Dimstyle&) {}
+    virtual void addVport(const DRW_Vport&) {}
+    virtual void addTextStyle(const DRW_Textstyle&) {}
+    virtual void addAppId(const DRW_AppId&) {}
+    virtual void linkImage(const DRW_ImageDef*) {}
+    virtual void addComment(const char*) {}
+
+    virtual void writeHeader(DRW_Header&) {}
+    virtual void writeBlocks() {}
+    virtual void writeBlockRecords() {}
+    virtual void writeEntities() {}
+    virtual void writeLTypes() {}
+    virtual void writeLayers() {}
+    virtual void writeTextstyles() {}
+    virtual void writeVports() {}
+    virtual void writeDimstyles() {}
+    virtual void writeAppId() {}
+
+private:
+    /** keeps a copy of 'e' with its own lists */
+    void store(const DRW_Entity &e);
+    /** keeps 'e' in the current block, frees it out of blocks */
+    void keep(DRW_Entity *e);
+
+    DRW_Block current;
+    std::shared_ptr<DRW_BlockDef> def;  /*!< entities of 'current', NULL out of blocks */
+};
+
+//! Block definitions shared by the drawings read, keyed by their content.
+/*!
+*  The key hashes the base point, the type & the entities of a block with
+*  DRW_Fingerprints (exact values & properties), the name & the handles are
+*  not part of it; blocks with the same content share one DRW_BlockDef in
+*  every drawing read with the cache. The readers still parse the blocks,
+*  the cache saves building & keeping a copy of the entities per drawing.
+*  Blocks with an entity not hashed (dimensions, leaders, viewports &
+*  images) or with extended or application data are not shared.
+*  It can be used by several readers in different threads at once, the
+*  definitions stay until clear(). save() & load() keep them in a binary
+*  DXF between sessions, the blocks that do not give the same key once
+*  written are not loaded.
+*/
+class DRW_BlockCache {
+public:
+    DRW_BlockCache();
+
+    /** the cached block with the content of 'def' or else 'def', cached if it can be shared */
+    std::shared_ptr<const DRW_BlockDef> share(const DRW_Block &b, const std::shared_ptr<DRW_BlockDef> &def);
+    /** the block with 'key', NULL if it is not cached */
+    std::shared_ptr<const DRW_BlockDef> find(duint64 key) const;
+    size_t size() const;
+    /** removes the blocks & clears the counts, the drawings keep the blocks shared */
+    void clear();
+
+    /** writes the blocks to a binary DXF file */
+    bool save(const std::string &path) const;
+    /** adds the blocks of a file written by save() */
+    bool load(const std::string &path);
+
+    duint64 hits() const;      /*!< blocks found in the cache */
+    duint64 misses() const;    /*!< blocks added to the cache */
+    duint64 unshared() const;  /*!< blocks that can not be shared */
+
+private:
+    /** sets the fingerprints & the key of 'def', false if it can not be shared */
+    bool hashBlock(DRW_BlockDef *def) const;
+    /** the cached block equal to 'def', adds 'def' if there is none */
+    std::shared_ptr<const DRW_BlockDef> insert(const std::shared_ptr<DRW_BlockDef> &def);
+
+    mutable std::mutex lock;
+    std::unordered_map<duint64, std::shared_ptr<const DRW_BlockDef> > defs;
+    DRW_Fingerprints hasher;
+    duint64 hitCount;
+    duint64 missCount;
+    duint64 unsharedCount;
+};
+
+#endif // DRW_BLOCKCACHE_H
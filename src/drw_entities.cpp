@@ -11,18 +11,48 @@
 ******************************************************************************/
 
 #include <cstdlib>
+#include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DRW_ENTITIES_SSE2
+#endif
 #include "drw_entities.h"
 #include "intern/dxfreader.h"
 #include "intern/dwgbuffer.h"
 #include "intern/drw_dbg.h"
 
+namespace {
+//! Arbitrary axes of an extrusion already calculated.
+struct ExtrusionAxes {
+    DRW_Coord normal;
+    DRW_Coord axisX;
+    DRW_Coord axisY;
+};
+//a drawing uses few extrusions, the last ones of each reading thread are kept
+const int AXES_CACHED = 8;
+thread_local ExtrusionAxes axesCache[AXES_CACHED];
+thread_local int axesCount = 0;
+thread_local int axesNext = 0;
+//vertices gathered in a batch to extrude
+const size_t EXTRUDE_BATCH = 256;
+}
+
 
 //! Calculate arbitary axis
 /*!
-*   Calculate arbitary axis for apply extrusions
+*   Calculate arbitary axis for apply extrusions, the axes of the last
+*   extrusions are cached
 *  @author Rallaz
 */
 void DRW_Entity::calculateAxis(DRW_Coord extPoint){
+    for (int i = 0; i < axesCount; ++i) {
+        const ExtrusionAxes &c = axesCache[i];
+        if (c.normal.x == extPoint.x && c.normal.y == extPoint.y && c.normal.z == extPoint.z) {
+            extAxisX = c.axisX;
+            extAxisY = c.axisY;
+            return;
+        }
+    }
     //Follow the arbitrary DXF definitions for extrusion axes.
     if (fabs(extPoint.x) < 0.015625 && fabs(extPoint.y) < 0.015625) {
         //If we get here, implement Ax = Wy x N where Wy is [0,1,0] per the DXF spec.
@@ -48,6 +78,14 @@ void DRW_Entity::calculateAxis(DRW_Coord extPoint){
     extAxisY.z = (extPoint.x * extAxisX.y) - (extAxisX.x * extPoint.y);
 
     extAxisY.unitize();
+
+    ExtrusionAxes &c = axesCache[axesNext];
+    c.normal = extPoint;
+    c.axisX = extAxisX;
+    c.axisY = extAxisY;
+    axesNext = (axesNext + 1) % AXES_CACHED;
+    if (axesCount < AXES_CACHED)
+        ++axesCount;
 }
 
 //! Extrude a point using arbitary axis
@@ -66,6 +104,34 @@ void DRW_Entity::extrudePoint(DRW_Coord extPoint, DRW_Coord *point){
     point->z = pz;
 }
 
+//! Extrude points using arbitary axis
+/*!
+*   same as extrudePoint() on coordinates in separate arrays, two points
+*   at a time with SSE2 and the same results
+*/
+void DRW_Entity::extrudePoints(const DRW_Coord &extPoint, double *x, double *y, double *z, size_t count){
+    size_t i = 0;
+#ifdef DRW_ENTITIES_SSE2
+    const __m128d axx = _mm_set1_pd(extAxisX.x), axy = _mm_set1_pd(extAxisX.y), axz = _mm_set1_pd(extAxisX.z);
+    const __m128d ayx = _mm_set1_pd(extAxisY.x), ayy = _mm_set1_pd(extAxisY.y), ayz = _mm_set1_pd(extAxisY.z);
+    const __m128d nx = _mm_set1_pd(extPoint.x), ny = _mm_set1_pd(extPoint.y), nz = _mm_set1_pd(extPoint.z);
+    for (; i + 2 <= count; i += 2) {
+        __m128d px = _mm_loadu_pd(x + i);
+        __m128d py = _mm_loadu_pd(y + i);
+        __m128d pz = _mm_loadu_pd(z + i);
+        _mm_storeu_pd(x + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(axx, px), _mm_mul_pd(ayx, py)), _mm_mul_pd(nx, pz)));
+        _mm_storeu_pd(y + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(axy, px), _mm_mul_pd(ayy, py)), _mm_mul_pd(ny, pz)));
+        _mm_storeu_pd(z + i, _mm_add_pd(_mm_add_pd(_mm_mul_pd(axz, px), _mm_mul_pd(ayz, py)), _mm_mul_pd(nz, pz)));
+    }
+#endif
+    for (; i < count; ++i) {
+        double px = x[i], py = y[i], pz = z[i];
+        x[i] = (extAxisX.x*px)+(extAxisY.x*py)+(extPoint.x*pz);
+        y[i] = (extAxisX.y*px)+(extAxisY.y*py)+(extPoint.y*pz);
+        z[i] = (extAxisX.z*px)+(extAxisY.z*py)+(extPoint.z*pz);
+    }
+}
+
 bool DRW_Entity::parseCode(int code, dxfReader *reader){
     switch (code) {
     case 5:
@@ -75,10 +141,10 @@ bool DRW_Entity::parseCode(int code, dxfReader *reader){
         parentHandle = reader->getHandleString();
         break;
     case 8:
-        layer = reader->getUtf8String();
+        layer = reader->getName();
         break;
     case 6:
-        lineType = reader->getUtf8String();
+        lineType = reader->getName();
         break;
     case 62:
         color = reader->getInt32();
@@ -814,10 +880,15 @@ void DRW_Ellipse::toPolyline(DRW_Polyline *pol, int parts){
 void DRW_Trace::applyExtrusion(){
     if (haveExtrusion) {
         calculateAxis(extPoint);
-        extrudePoint(extPoint, &basePoint);
-        extrudePoint(extPoint, &secPoint);
-        extrudePoint(extPoint, &thirdPoint);
-        extrudePoint(extPoint, &fourPoint);
+        DRW_Coord *pts[4] = {&basePoint, &secPoint, &thirdPoint, &fourPoint};
+        double x[4], y[4], z[4];
+        for (int i = 0; i < 4; ++i) {
+            x[i] = pts[i]->x; y[i] = pts[i]->y; z[i] = pts[i]->z;
+        }
+        extrudePoints(extPoint, x, y, z, 4);
+        for (int i = 0; i < 4; ++i) {
+            pts[i]->x = x[i]; pts[i]->y = y[i]; pts[i]->z = z[i];
+        }
     }
 }
 
@@ -1118,12 +1189,21 @@ bool DRW_Insert::parseDwg(DRW::Version version, dwgBuffer *buf, duint32 bs){
 void DRW_LWPolyline::applyExtrusion(){
     if (haveExtrusion) {
         calculateAxis(extPoint);
-        for (unsigned int i=0; i<vertlist.size(); i++) {
-            DRW_Vertex2D *vert = vertlist.at(i);
-            DRW_Coord v(vert->x, vert->y, elevation);
-            extrudePoint(extPoint, &v);
-            vert->x = v.x;
-            vert->y = v.y;
+        double x[EXTRUDE_BATCH], y[EXTRUDE_BATCH], z[EXTRUDE_BATCH];
+        for (size_t first = 0; first < vertlist.size(); first += EXTRUDE_BATCH) {
+            size_t count = std::min(EXTRUDE_BATCH, vertlist.size() - first);
+            for (size_t i = 0; i < count; ++i) {
+                const DRW_Vertex2D *vert = vertlist[first + i];
+                x[i] = vert->x;
+                y[i] = vert->y;
+                z[i] = elevation;
+            }
+            extrudePoints(extPoint, x, y, z, count);
+            for (size_t i = 0; i < count; ++i) {
+                DRW_Vertex2D *vert = vertlist[first + i];
+                vert->x = x[i];
+                vert->y = y[i];
+            }
         }
     }
 }
@@ -1313,7 +1393,7 @@ void DRW_Text::parseCode(int code, dxfReader *reader){
         text = reader->getUtf8String();
         break;
     case 7:
-        style = reader->getUtf8String();
+        style = reader->getName();
         break;
     default:
         DRW_Line::parseCode(code, reader);
@@ -1733,29 +1813,79 @@ void DRW_Hatch::parseCode(int code, dxfReader *reader){
         else if (pline) {
             plvert = pline->addVertex();
             plvert->x = reader->getDouble();
+        } else if (spline) {
+            spline->controllist.push_back(new DRW_Coord());
+            spline->controllist.back()->x = reader->getDouble();
         }
         break;
     case 20:
         if (pt) pt->basePoint.y = reader->getDouble();
         else if (plvert) plvert ->y = reader->getDouble();
+        else if (spline && !spline->controllist.empty())
+            spline->controllist.back()->y = reader->getDouble();
         break;
     case 11:
         if (line) line->secPoint.x = reader->getDouble();
         else if (ellipse) ellipse->secPoint.x = reader->getDouble();
+        else if (spline) {
+            spline->fitlist.push_back(new DRW_Coord());
+            spline->fitlist.back()->x = reader->getDouble();
+        }
         break;
     case 21:
         if (line) line->secPoint.y = reader->getDouble();
         else if (ellipse) ellipse->secPoint.y = reader->getDouble();
+        else if (spline && !spline->fitlist.empty())
+            spline->fitlist.back()->y = reader->getDouble();
         break;
     case 40:
         if (arc) arc->radious = reader->getDouble();
         else if (ellipse) ellipse->ratio = reader->getDouble();
+        else if (spline) spline->knotslist.push_back(reader->getDouble());
         break;
     case 41:
         scale = reader->getDouble();
         break;
     case 42:
         if (plvert) plvert ->bulge = reader->getDouble();
+        else if (spline) spline->weightlist.push_back(reader->getDouble());
+        break;
+    case 94:
+        if (spline) spline->degree = reader->getInt32();
+        break;
+    case 95:
+        if (spline) spline->nknots = reader->getInt32();
+        break;
+    case 96:
+        if (spline) spline->ncontrol = reader->getInt32();
+        break;
+    case 74:
+        if (spline && reader->getInt32()) spline->flags |= 2; //periodic
+        break;
+    case 53:
+        patternlines.push_back(DRW_HatchPatternLine());
+        patternlines.back().angle = reader->getDouble();
+        break;
+    case 43:
+        if (!patternlines.empty()) patternlines.back().base.x = reader->getDouble();
+        break;
+    case 44:
+        if (!patternlines.empty()) patternlines.back().base.y = reader->getDouble();
+        break;
+    case 45:
+        if (!patternlines.empty()) patternlines.back().offset.x = reader->getDouble();
+        break;
+    case 46:
+        if (!patternlines.empty()) patternlines.back().offset.y = reader->getDouble();
+        break;
+    case 79: {
+        //count of the file, only trusted if small
+        int count = reader->getInt32();
+        if (!patternlines.empty() && count > 0 && count <= 64)
+            patternlines.back().dashes.reserve(count);
+        break; }
+    case 49:
+        if (!patternlines.empty()) patternlines.back().dashes.push_back(reader->getDouble());
         break;
     case 50:
         if (arc) arc->staangle = reader->getDouble()/ARAD;
@@ -1770,7 +1900,9 @@ void DRW_Hatch::parseCode(int code, dxfReader *reader){
         break;
     case 73:
         if (arc) arc->isccw = reader->getInt32();
+        else if (ellipse) ellipse->isccw = reader->getInt32();
         else if (pline) pline->flags = reader->getInt32();
+        else if (spline && reader->getInt32()) spline->flags |= 4; //rational
         break;
     case 75:
         hstyle = reader->getInt32();
@@ -1915,8 +2047,7 @@ bool DRW_Hatch::parseDwg(DRW::Version version, dwgBuffer *buf, duint32 bs){
                         DRW_Coord* crd = new DRW_Coord(buf->get2RawDouble());
                         spline->controllist.push_back(crd);
                         if(isRational)
-                            crd->z =  buf->getBitDouble(); //RLZ: investigate how store weight
-                        spline->controllist.push_back(crd);
+                            spline->weightlist.push_back(buf->getBitDouble());
                     }
                     if (version > DRW::AC1021) { //2010+
                         spline->nfit = buf->getBitLong();
@@ -1961,19 +2092,23 @@ bool DRW_Hatch::parseDwg(DRW::Version version, dwgBuffer *buf, duint32 bs){
         doubleflag = buf->getBit();
         deflines = buf->getBitShort();
         for (dint32 i = 0 ; i < deflines; ++i){
-            DRW_Coord ptL, offL;
-            double angleL = buf->getBitDouble();
-            ptL.x = buf->getBitDouble();
-            ptL.y = buf->getBitDouble();
-            offL.x = buf->getBitDouble();
-            offL.y = buf->getBitDouble();
+            DRW_HatchPatternLine defL;
+            defL.angle = buf->getBitDouble() * ARAD;
+            defL.base.x = buf->getBitDouble();
+            defL.base.y = buf->getBitDouble();
+            defL.offset.x = buf->getBitDouble();
+            defL.offset.y = buf->getBitDouble();
             duint16 numDashL = buf->getBitShort();
-            DRW_DBG("\ndef line: "); DRW_DBG(angleL); DRW_DBG(","); DRW_DBG(ptL.x); DRW_DBG(","); DRW_DBG(ptL.y);
-            DRW_DBG(","); DRW_DBG(offL.x); DRW_DBG(","); DRW_DBG(offL.y); DRW_DBG(","); DRW_DBG(angleL);
+            DRW_DBG("\ndef line: "); DRW_DBG(defL.angle); DRW_DBG(","); DRW_DBG(defL.base.x); DRW_DBG(","); DRW_DBG(defL.base.y);
+            DRW_DBG(","); DRW_DBG(defL.offset.x); DRW_DBG(","); DRW_DBG(defL.offset.y);
             for (duint16 i = 0 ; i < numDashL; ++i){
                 double lenghtL = buf->getBitDouble();
+                defL.dashes.push_back(lenghtL);
                 DRW_DBG(","); DRW_DBG(lenghtL);
             }
+            if (!buf->isGood())
+                break;
+            patternlines.push_back(defL);
         }//end deflines
     } //end not solid
 
@@ -2088,8 +2223,9 @@ void DRW_Spline::parseCode(int code, dxfReader *reader){
     case 40:
         knotslist.push_back(reader->getDouble());
         break;
-//    case 41:
-//        break;
+    case 41:
+        weightlist.push_back(reader->getDouble());
+        break;
     default:
         DRW_Entity::parseCode(code, reader);
         break;
@@ -2154,7 +2290,8 @@ bool DRW_Spline::parseDwg(DRW::Version version, dwgBuffer *buf, duint32 bs){
         DRW_Coord* crd = new DRW_Coord(buf->get3BitDouble());
         controllist.push_back(crd);
         if (weight){
-            DRW_DBG("\n w: "); DRW_DBG(buf->getBitDouble()); //RLZ Warning: D (BD or RD)
+            weightlist.push_back(buf->getBitDouble()); //RLZ Warning: D (BD or RD)
+            DRW_DBG("\n w: "); DRW_DBG(weightlist.back());
         }
     }
     fitlist.reserve(nfit);
@@ -2289,7 +2426,7 @@ void DRW_Dimension::parseCode(int code, dxfReader *reader){
         name = reader->getString();
         break;
     case 3:
-        style = reader->getUtf8String();
+        style = reader->getName();
         break;
     case 70:
         type = reader->getInt32();
@@ -2695,7 +2832,7 @@ bool DRW_DimOrdinate::parseDwg(DRW::Version version, dwgBuffer *buf, duint32 bs)
 void DRW_Leader::parseCode(int code, dxfReader *reader){
     switch (code) {
     case 3:
-        style = reader->getUtf8String();
+        style = reader->getName();
         break;
     case 71:
         arrow = reader->getInt32();
@@ -17,7 +17,10 @@
 #include <string>
 #include <vector>
 #include <list>
+#include <utility>
 #include "drw_base.h"
+#include "drw_name.h"
+#include "drw_shared.h"
 
 class dxfReader;
 class dwgBuffer;
@@ -88,7 +91,8 @@ namespace DRW {
 //shape, dictionary, MLEADER, MLEADERSTYLE
 
 #define SETENTFRIENDS  friend class dxfRW; \
-                       friend class dwgReader;
+                       friend class dwgReader; \
+                       friend class DRW_Extents;
 
 //! Base class for entities
 /*!
@@ -101,12 +105,12 @@ public:
     //initializes default values
         //handles: default no handle (0), color: default BYLAYER (256), 24 bits color: default -1 (not set)
         //line weight: default BYLAYER  (dxf -1, dwg 29), space: default ModelSpace (0)
-    DRW_Entity(): eType(DRW::UNKNOWN), handle(DRW::NoHandle), parentHandle(DRW::NoHandle), appData(0),
+    DRW_Entity(): eType(DRW::UNKNOWN), handle(DRW::NoHandle), parentHandle(DRW::NoHandle), appData(),
                   space(DRW::ModelSpace), layer("0"), lineType("BYLAYER"), material(DRW::MaterialByLayer),
                   color(DRW::ColorByLayer), lWeight(DRW_LW_Conv::widthByLayer), ltypeScale(1.0), visible(true),
                   numProxyGraph(0), proxyGraphics(std::string()), color24(-1), colorName(std::string()),
                   transparency(DRW::Opaque), plotStyle(DRW::DefaultPlotStyle), shadow(DRW::CastAndReceieveShadows),
-                  haveExtrusion(false), extData(), haveNextLinks(0),plotFlags(0), ltFlags(0),materialFlag(0),
+                  haveExtrusion(false), extData(), fingerprint(0), haveNextLinks(0),plotFlags(0), ltFlags(0),materialFlag(0),
                   shadowFlag(0), lTypeH(dwgHandle()), layerH(dwgHandle()), nextEntLink(0), prevEntLink(0),
                   ownerHandle(false), xDictFlag(0), numReactors(0), objSize(0), oType(0), extAxisX(DRW_Coord()),
                   extAxisY(DRW_Coord()), curr(NULL) {}
@@ -135,21 +139,48 @@ public:
         xDictFlag = e.xDictFlag;
         curr = NULL;
         ownerHandle= false;
-        for (std::vector<DRW_Variant*>::const_iterator it=e.extData.begin(); it!=e.extData.end(); ++it){
-            extData.push_back(new DRW_Variant(*(*it)));
-        }
+        appData = e.appData; //shared until changed
+        extData = e.extData;
+        bbox = e.bbox;
+        fingerprint = e.fingerprint;
     }
 
-    virtual ~DRW_Entity() {
-        for (std::vector<DRW_Variant*>::iterator it=extData.begin(); it!=extData.end(); ++it)
-            delete *it;
-
-        extData.clear();
+    //takes the strings, application and extended data of 'e' without copy
+    DRW_Entity(DRW_Entity&& e): appData(std::move(e.appData)), layer(std::move(e.layer)),
+                  lineType(std::move(e.lineType)), proxyGraphics(std::move(e.proxyGraphics)),
+                  colorName(std::move(e.colorName)) {
+        eType = e.eType;
+        handle = e.handle;
+        parentHandle = e.parentHandle;
+        color = e.color;
+        ltypeScale = e.ltypeScale;
+        visible = e.visible;
+        lWeight = e.lWeight;
+        space = e.space;
+        haveExtrusion = e.haveExtrusion;
+        color24 = e.color24;
+        numProxyGraph = e.numProxyGraph;
+        shadow = e.shadow;
+        material = e.material;
+        plotStyle = e.plotStyle;
+        transparency = e.transparency;
+        nextEntLink = e.nextEntLink;
+        prevEntLink = e.prevEntLink;
+        numReactors = e.numReactors;
+        xDictFlag = e.xDictFlag;
+        curr = NULL;
+        ownerHandle= false;
+        extData.swap(e.extData);
+        bbox = e.bbox;
+        fingerprint = e.fingerprint;
+        e.curr = NULL;
     }
 
+    DRW_Entity &operator=(const DRW_Entity&) = default;
+
+    virtual ~DRW_Entity() {}
+
     void reset(){
-        for (std::vector<DRW_Variant*>::iterator it=extData.begin(); it!=extData.end(); ++it)
-            delete *it;
         extData.clear();
     }
 
@@ -162,6 +193,8 @@ protected:
     void calculateAxis(DRW_Coord extPoint);
     //apply extrusion to @extPoint and return data in @point
     void extrudePoint(DRW_Coord extPoint, DRW_Coord *point);
+    //apply extrusion to the @count points of the coordinate arrays
+    void extrudePoints(const DRW_Coord &extPoint, double *x, double *y, double *z, size_t count);
     virtual bool parseDwg(DRW::Version version, dwgBuffer *buf, duint32 bs=0)=0;
     //parses dwg common start part to read entity
     bool parseDwg(DRW::Version version, dwgBuffer *buf, dwgBuffer* strBuf, duint32 bs=0);
@@ -175,10 +208,10 @@ public:
     enum DRW::ETYPE eType;     /*!< enum: entity type, code 0 */
     duint32 handle;            /*!< entity identifier, code 5 */
     duint32 parentHandle;      /*!< Soft-pointer ID/handle to owner BLOCK_RECORD object, code 330 */
-    std::list<std::list<DRW_Variant> > appData; /*!< list of application data, code 102 */
+    DRW_AppData appData;       /*!< list of application data, code 102 */
     DRW::Space space;          /*!< space indicator, code 67*/
-    UTF8STRING layer;          /*!< layer name, code 8 */
-    UTF8STRING lineType;       /*!< line type, code 6 */
+    DRW_Name layer;            /*!< layer name, code 8 */
+    DRW_Name lineType;         /*!< line type, code 6 */
     duint32 material;          /*!< hard pointer id to material object, code 347 */
     int color;                 /*!< entity color, code 62 */
     enum DRW_LW_Conv::lineWidth lWeight; /*!< entity lineweight, code 370 */
@@ -192,7 +225,9 @@ public:
     int plotStyle;             /*!< hard pointer id to plot style object, code 390 */
     DRW::ShadowMode shadow;    /*!< shadow mode, code 284 */
     bool haveExtrusion;        /*!< set to true if the entity have extrusion*/
-    std::vector<DRW_Variant*> extData; /*!< FIFO list of extended data, codes 1000 to 1071*/
+    DRW_ExtData extData;       /*!< FIFO list of extended data, codes 1000 to 1071*/
+    DRW_BBox bbox;             /*!< bounds in WCS, set by the reader if the extents are enabled */
+    duint64 fingerprint;       /*!< content hash, set by the reader if the fingerprints are enabled, 0 if not */
 
 protected: //only for read dwg
     duint8 haveNextLinks; //aka nolinks //B
@@ -602,6 +637,20 @@ public:
         this->vertex = NULL;
     }
 
+    DRW_LWPolyline(DRW_LWPolyline&& p):DRW_Entity(std::move(p)){
+        this->eType = DRW::LWPOLYLINE;
+        this->elevation = p.elevation;
+        this->thickness = p.thickness;
+        this->width = p.width;
+        this->flags = p.flags;
+        this->extPoint = p.extPoint;
+        this->vertlist.swap(p.vertlist);
+        this->vertex = NULL;
+        p.vertex = NULL;
+    }
+
+    DRW_LWPolyline &operator=(const DRW_LWPolyline&) = default;
+
     ~DRW_LWPolyline() {
         while (!vertlist.empty()) {
             vertlist.pop_back();
@@ -690,7 +739,7 @@ public:
     double angle;              /*!< rotation angle in degrees (360), code 50 */
     double widthscale;         /*!< width factor, code 41 */
     double oblique;            /*!< oblique angle, code 51 */
-    UTF8STRING style;          /*!< style name, code 7 */
+    DRW_Name style;            /*!< style name, code 7 */
     int textgen;               /*!< text generation, code 71 */
     enum HAlign alignH;        /*!< horizontal align, code 72 */
     enum VAlign alignV;        /*!< vertical align, code 73 */
@@ -796,6 +845,9 @@ public:
         flags = vertexcount = facecount = 0;
         smoothM = smoothN = curvetype = 0;
     }
+    DRW_Polyline(const DRW_Polyline&) = default;
+    DRW_Polyline(DRW_Polyline&&) = default; //takes the lists
+    DRW_Polyline &operator=(const DRW_Polyline&) = default;
     ~DRW_Polyline() {
         while (!vertlist.empty()) {
            vertlist.pop_back();
@@ -853,6 +905,9 @@ public:
         tolknot = tolcontrol = tolfit = 0.0000001;
 
     }
+    DRW_Spline(const DRW_Spline&) = default;
+    DRW_Spline(DRW_Spline&&) = default; //takes the lists
+    DRW_Spline &operator=(const DRW_Spline&) = default;
     ~DRW_Spline() {
         while (!controllist.empty()) {
            controllist.pop_back();
@@ -892,6 +947,7 @@ public:
     std::vector<double> knotslist;           /*!< knots list, code 40 */
     std::vector<DRW_Coord *> controllist;  /*!< control points list, code 10, 20 & 30 */
     std::vector<DRW_Coord *> fitlist;      /*!< fit points list, code 11, 21 & 31 */
+    std::vector<double> weightlist;        /*!< weights of the control points, code 41, empty if all are 1 */
 
 private:
     DRW_Coord *controlpoint;   /*!< current control point to add data */
@@ -931,6 +987,22 @@ public:
     std::vector<DRW_Entity *> objlist;      /*!< entities list */
 };
 
+//! Line of a hatch pattern definition.
+/*!
+*  Already rotated & scaled by the hatch. The lines of the family pass by
+*  base + k*offset, dashes are positive, gaps negative & dots 0.
+*/
+class DRW_HatchPatternLine {
+public:
+    DRW_HatchPatternLine(): angle(0.0) {}
+
+public:
+    double angle;                /*!< line angle in degrees, code 53 */
+    DRW_Coord base;              /*!< base point, code 43 & 44 */
+    DRW_Coord offset;            /*!< offset to the next line, code 45 & 46 */
+    std::vector<double> dashes;  /*!< dash lengths, code 49, count in code 79 */
+};
+
 //! Class to handle hatch entity
 /*!
 *  Class to handle hatch entity
@@ -948,9 +1020,13 @@ public:
         solid = hpattern = 1;
         deflines = doubleflag = 0;
         loop = NULL;
+        ispol = false;
         clearEntities();
     }
 
+    DRW_Hatch(const DRW_Hatch&) = default;
+    DRW_Hatch(DRW_Hatch&&) = default; //takes the lists
+    DRW_Hatch &operator=(const DRW_Hatch&) = default;
     ~DRW_Hatch() {
         while (!looplist.empty()) {
            looplist.pop_back();
@@ -980,6 +1056,7 @@ public:
     int deflines;              /*!< number of pattern definition lines, code 78 */
 
     std::vector<DRW_HatchLoop *> looplist;  /*!< polyline list */
+    std::vector<DRW_HatchPatternLine> patternlines;  /*!< pattern definition lines */
 
 private:
     void clearEntities(){
@@ -1114,6 +1191,30 @@ public:
         length = d.length;
         //RLZ needed a def value for this: hdir = ???
     }
+
+    DRW_Dimension(DRW_Dimension&& d): DRW_Entity(std::move(d)), name(std::move(d.name)),
+                  text(std::move(d.text)), style(std::move(d.style)) {
+        eType = DRW::DIMENSION;
+        type =d.type;
+        defPoint = d.defPoint;
+        textPoint = d.textPoint;
+        align = d.align;
+        linesty = d.linesty;
+        linefactor = d.linefactor;
+        rot = d.rot;
+        extPoint = d.extPoint;
+        clonePoint = d.clonePoint;
+        def1 = d.def1;
+        def2 = d.def2;
+        angle = d.angle;
+        oblique = d.oblique;
+        arcPoint = d.arcPoint;
+        circlePoint = d.circlePoint;
+        length = d.length;
+    }
+
+    DRW_Dimension &operator=(const DRW_Dimension&) = default;
+
     virtual ~DRW_Dimension() {}
 
     virtual void applyExtrusion(){}
@@ -1172,7 +1273,7 @@ private:
     DRW_Coord defPoint;        /*!<  definition point, code 10, 20 & 30 (WCS) */
     DRW_Coord textPoint;       /*!< Middle point of text, code 11, 21 & 31 (OCS) */
     UTF8STRING text;           /*!< Dimension text explicitly entered by the user, code 1 */
-    UTF8STRING style;          /*!< Dimension style, code 3 */
+    DRW_Name style;            /*!< Dimension style, code 3 */
     int align;                 /*!< attachment point, code 71 */
     int linesty;               /*!< Dimension text line spacing style, code 72, default 1 */
     double linefactor;         /*!< Dimension text line spacing factor, code 41, default 1? (value range 0.25 to 4.00*/
@@ -1210,6 +1311,9 @@ public:
     DRW_DimAligned(const DRW_Dimension& d): DRW_Dimension(d) {
         eType = DRW::DIMALIGNED;
     }
+    DRW_DimAligned(DRW_Dimension&& d): DRW_Dimension(std::move(d)) {
+        eType = DRW::DIMALIGNED;
+    }
 
     DRW_Coord getClonepoint() const {return getPt2();}      /*!< Insertion for clones (Baseline & Continue), 12, 22 & 32 */
     void setClonePoint(DRW_Coord c){setPt2(c);}
@@ -1238,6 +1342,9 @@ public:
     DRW_DimLinear(const DRW_Dimension& d): DRW_DimAligned(d) {
         eType = DRW::DIMLINEAR;
     }
+    DRW_DimLinear(DRW_Dimension&& d): DRW_DimAligned(std::move(d)) {
+        eType = DRW::DIMLINEAR;
+    }
 
     double getAngle() const {return getAn50();}          /*!< Angle of rotated, horizontal, or vertical dimensions, code 50 */
     void setAngle(const double d) {setAn50(d);}
@@ -1259,6 +1366,9 @@ public:
     DRW_DimRadial(const DRW_Dimension& d): DRW_Dimension(d) {
         eType = DRW::DIMRADIAL;
     }
+    DRW_DimRadial(DRW_Dimension&& d): DRW_Dimension(std::move(d)) {
+        eType = DRW::DIMRADIAL;
+    }
 
     DRW_Coord getCenterPoint() const {return getDefPoint();}   /*!< center point, code 10, 20 & 30 */
     void setCenterPoint(const DRW_Coord p){setDefPoint(p);}
@@ -1285,6 +1395,9 @@ public:
     DRW_DimDiametric(const DRW_Dimension& d): DRW_Dimension(d) {
         eType = DRW::DIMDIAMETRIC;
     }
+    DRW_DimDiametric(DRW_Dimension&& d): DRW_Dimension(std::move(d)) {
+        eType = DRW::DIMDIAMETRIC;
+    }
 
     DRW_Coord getDiameter1Point() const {return getPt5();}      /*!< First definition point for diameter, code 15, 25 & 35 */
     void setDiameter1Point(const DRW_Coord p){setPt5(p);}
@@ -1311,6 +1424,9 @@ public:
     DRW_DimAngular(const DRW_Dimension& d): DRW_Dimension(d) {
         eType = DRW::DIMANGULAR;
     }
+    DRW_DimAngular(DRW_Dimension&& d): DRW_Dimension(std::move(d)) {
+        eType = DRW::DIMANGULAR;
+    }
 
     DRW_Coord getFirstLine1() const {return getPt3();}       /*!< Definition point line 1-1, code 13, 23 & 33 */
     void setFirstLine1(const DRW_Coord p) {setPt3(p);}
@@ -1342,6 +1458,9 @@ public:
     DRW_DimAngular3p(const DRW_Dimension& d): DRW_Dimension(d) {
         eType = DRW::DIMANGULAR3P;
     }
+    DRW_DimAngular3p(DRW_Dimension&& d): DRW_Dimension(std::move(d)) {
+        eType = DRW::DIMANGULAR3P;
+    }
 
     DRW_Coord getFirstLine() const {return getPt3();}       /*!< Definition point line 1, code 13, 23 & 33 */
     void setFirstLine(const DRW_Coord p) {setPt3(p);}
@@ -1370,6 +1489,9 @@ public:
     DRW_DimOrdinate(const DRW_Dimension& d): DRW_Dimension(d) {
         eType = DRW::DIMORDINATE;
     }
+    DRW_DimOrdinate(DRW_Dimension&& d): DRW_Dimension(std::move(d)) {
+        eType = DRW::DIMORDINATE;
+    }
 
     DRW_Coord getOriginPoint() const {return getDefPoint();}   /*!< Origin definition point, code 10, 20 & 30 */
     void setOriginPoint(const DRW_Coord p) {setDefPoint(p);}
@@ -1399,6 +1521,9 @@ public:
         arrow = 1;
         extrusionPoint.z = 1.0;
     }
+    DRW_Leader(const DRW_Leader&) = default;
+    DRW_Leader(DRW_Leader&&) = default; //takes the lists
+    DRW_Leader &operator=(const DRW_Leader&) = default;
     ~DRW_Leader() {
         while (!vertexlist.empty()) {
            vertexlist.pop_back();
@@ -1412,7 +1537,7 @@ protected:
     virtual bool parseDwg(DRW::Version version, dwgBuffer *buf, duint32 bs=0);
 
 public:
-    UTF8STRING style;          /*!< Dimension style name, code 3 */
+    DRW_Name style;            /*!< Dimension style name, code 3 */
     int arrow;                 /*!< Arrowhead flag, code 71, 0=Disabled; 1=Enabled */
     int leadertype;            /*!< Leader path type, code 72, 0=Straight line segments; 1=Spline */
     int flag;                  /*!< Leader creation flag, code 73, default 3 */
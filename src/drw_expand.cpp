@@ -0,0 +1,625 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_expand.h"
+#include "drw_interface.h"
+#include "intern/drw_threads.h"
+#include "intern/drw_entitycopy.h"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+
+namespace {
+
+const size_t BATCH = 256;  //top level inserts per thread expanded before handing the entities
+
+double dot(const DRW_Coord &a, const DRW_Coord &b){
+    return a.x*b.x + a.y*b.y + a.z*b.z;
+}
+
+DRW_Coord cross(const DRW_Coord &a, const DRW_Coord &b){
+    return DRW_Coord(a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x);
+}
+
+double length(const DRW_Coord &v){
+    return sqrt(dot(v, v));
+}
+
+DRW_Coord scaled(const DRW_Coord &v, double s){
+    return DRW_Coord(v.x*s, v.y*s, v.z*s);
+}
+
+DRW_Coord unit(DRW_Coord v){
+    v.unitize();
+    return v;
+}
+
+//angle in [0, 2*PI)
+double normalAngle(double a){
+    a = fmod(a, M_PIx2);
+    return a < 0 ? a + M_PIx2 : a;
+}
+
+//! Plane of an OCS entity placed in WCS.
+/*!
+*  'local' maps the OCS of the entity to the OCS of the placed plane. The
+*  normal of the placed plane keeps the in plane part counterclockwise,
+*  a mirrored block only changes the normal.
+*/
+class PlaneMap {
+public:
+    PlaneMap(const DRW_Transform &w, const DRW_Coord &extrusion) {
+        wcs = w * DRW_Transform::ocs(extrusion);
+        normal = cross(wcs.applyVector(DRW_Coord(1, 0, 0)), wcs.applyVector(DRW_Coord(0, 1, 0)));
+        if (length(normal) == 0.0) //flattened by a zero scale
+            normal = DRW_Coord(0, 0, 1);
+        normal.unitize();
+        local = DRW_Transform::ocs(normal).inverse() * wcs;
+        double a = local.m[0][0], b = local.m[0][1];
+        double c = local.m[1][0], d = local.m[1][1];
+        scale = sqrt(fabs(a*d - b*c));
+        conformal = fabs(a - d) <= 1e-9 * scale && fabs(b + c) <= 1e-9 * scale;
+        height = dot(wcs.applyVector(DRW_Coord(0, 0, 1)), normal);
+    }
+    DRW_Coord point(const DRW_Coord &p) const { return local.apply(p); }
+    DRW_Coord vector(double x, double y) const { return local.applyVector(DRW_Coord(x, y, 0)); }
+    double angle(double a) const {
+        DRW_Coord v = vector(cos(a), sin(a));
+        return normalAngle(atan2(v.y, v.x));
+    }
+
+public:
+    DRW_Transform wcs;    /*!< OCS of the entity to WCS */
+    DRW_Transform local;  /*!< OCS of the entity to OCS of 'normal' */
+    DRW_Coord normal;
+    double scale;         /*!< area scale of the plane, square root */
+    double height;        /*!< scale along the normal, thickness & elevation */
+    bool conformal;       /*!< circles stay circles */
+};
+
+/*sets the ellipse c + u*cos(t) + v*sin(t), t from t0 to t1, the axes u & v
+ *are conjugate, not orthogonal after a skew*/
+void setEllipse(DRW_Ellipse *el, const DRW_Coord &c, const DRW_Coord &u, const DRW_Coord &v,
+                double t0, double t1, bool full){
+    //rotating the parameter by s gives orthogonal axes
+    double s = 0.5 * atan2(2 * dot(u, v), dot(u, u) - dot(v, v));
+    DRW_Coord a(u.x*cos(s) + v.x*sin(s), u.y*cos(s) + v.y*sin(s), u.z*cos(s) + v.z*sin(s));
+    DRW_Coord b(v.x*cos(s) - u.x*sin(s), v.y*cos(s) - u.y*sin(s), v.z*cos(s) - u.z*sin(s));
+    if (length(b) > length(a)) {
+        DRW_Coord t = a;
+        a = b;
+        b = scaled(t, -1);
+        s += M_PI_2;
+    }
+    el->basePoint = c;
+    el->secPoint = a;
+    el->ratio = length(a) > 0 ? length(b) / length(a) : 1.0;
+    DRW_Coord n = cross(a, b);
+    el->extPoint = length(n) > 0 ? unit(n) : DRW_Coord(0, 0, 1);
+    if (full) {
+        el->staparam = 0;
+        el->endparam = M_PIx2;
+    } else {
+        el->staparam = normalAngle(t0 - s);
+        el->endparam = normalAngle(t1 - s);
+    }
+}
+
+//extrusion direction & thickness of points, lines & 3d entities
+void placeThickness(DRW_Point *p, const DRW_Transform &w){
+    DRW_Coord dir = w.applyVector(p->extPoint);
+    double len = length(dir);
+    if (len == 0.0)
+        return;
+    p->thickness *= len / length(p->extPoint);
+    p->extPoint = scaled(dir, 1 / len);
+}
+
+//copies the common data to an entity of another type
+void copyBase(DRW_Entity *to, const DRW_Entity &from){
+    DRW::ETYPE type = to->eType;
+    *to = from;
+    to->eType = type;
+}
+
+void placeText(DRW_Text *t, const PlaneMap &pm){
+    double a = t->angle / ARAD;
+    DRW_Coord dir = pm.vector(cos(a), sin(a));
+    DRW_Coord up = pm.vector(-sin(a), cos(a));
+    double dirLen = length(dir);
+    double h = dirLen > 0 ? length(cross(dir, up)) / dirLen : 0.0;  //up, square to the baseline
+    t->angle = normalAngle(atan2(dir.y, dir.x)) * ARAD;
+    t->height *= h;
+    t->extPoint = pm.normal;
+    t->thickness *= pm.height;
+    if (t->eType == DRW::MTEXT) {
+        t->widthscale *= dirLen;  //reference rectangle width
+    } else if (h > 0) {
+        t->widthscale *= dirLen / h;
+    }
+}
+
+/*new entity for 'e' placed with 'w', the lists are new too*/
+DRW_Entity *placeEntity(const DRW_Entity &e, const DRW_Transform &w){
+    switch (e.eType) {
+    case DRW::POINT: {
+        DRW_Point *p = new DRW_Point(static_cast<const DRW_Point &>(e));
+        p->basePoint = w.apply(p->basePoint);
+        placeThickness(p, w);
+        return p; }
+    case DRW::LINE: {
+        DRW_Line *l = new DRW_Line(static_cast<const DRW_Line &>(e));
+        l->basePoint = w.apply(l->basePoint);
+        l->secPoint = w.apply(l->secPoint);
+        placeThickness(l, w);
+        return l; }
+    case DRW::RAY:
+    case DRW::XLINE: {
+        DRW_Ray *r = e.eType == DRW::RAY ? new DRW_Ray(static_cast<const DRW_Ray &>(e))
+                                          : new DRW_Xline(static_cast<const DRW_Xline &>(e));
+        r->basePoint = w.apply(r->basePoint);
+        r->secPoint = unit(w.applyVector(r->secPoint));
+        return r; }
+    case DRW::CIRCLE:
+    case DRW::ARC: {
+        const DRW_Circle &c = static_cast<const DRW_Circle &>(e);
+        PlaneMap pm(w, c.extPoint);
+        bool arc = e.eType == DRW::ARC;
+        if (!pm.conformal) {
+            DRW_Ellipse *el = new DRW_Ellipse();
+            copyBase(el, e);
+            double r = c.radious;
+            const DRW_Arc *a = arc ? static_cast<const DRW_Arc *>(&c) : NULL;
+            setEllipse(el, pm.wcs.apply(c.basePoint), pm.wcs.applyVector(DRW_Coord(r, 0, 0)),
+                       pm.wcs.applyVector(DRW_Coord(0, r, 0)), arc ? a->staangle : 0,
+                       arc ? a->endangle : 0, !arc);
+            return el;
+        }
+        DRW_Circle *r = arc ? new DRW_Arc(static_cast<const DRW_Arc &>(e)) : new DRW_Circle(c);
+        r->basePoint = pm.point(c.basePoint);
+        r->radious *= pm.scale;
+        r->extPoint = pm.normal;
+        r->thickness *= pm.height;
+        if (arc) {
+            DRW_Arc *a = static_cast<DRW_Arc *>(r);
+            a->staangle = pm.angle(a->staangle);
+            a->endangle = pm.angle(a->endangle);
+        }
+        return r; }
+    case DRW::ELLIPSE: {
+        const DRW_Ellipse &src = static_cast<const DRW_Ellipse &>(e);
+        DRW_Ellipse *el = new DRW_Ellipse(src);
+        DRW_Coord minor = scaled(cross(unit(src.extPoint), src.secPoint), src.ratio);
+        double sweep = src.endparam - src.staparam;
+        bool full = src.endparam == src.staparam || fabs(fabs(sweep) - M_PIx2) < 1.0e-10;
+        setEllipse(el, w.apply(src.basePoint), w.applyVector(src.secPoint), w.applyVector(minor),
+                   src.staparam, src.endparam, full);
+        return el; }
+    case DRW::TRACE:
+    case DRW::SOLID: {
+        const DRW_Trace &src = static_cast<const DRW_Trace &>(e);
+        DRW_Trace *t = e.eType == DRW::TRACE ? new DRW_Trace(src)
+                                             : new DRW_Solid(static_cast<const DRW_Solid &>(e));
+        PlaneMap pm(w, src.extPoint);
+        t->basePoint = pm.point(t->basePoint);
+        t->secPoint = pm.point(t->secPoint);
+        t->thirdPoint = pm.point(t->thirdPoint);
+        t->fourPoint = pm.point(t->fourPoint);
+        t->extPoint = pm.normal;
+        t->thickness *= pm.height;
+        return t; }
+    case DRW::E3DFACE: {
+        DRW_3Dface *f = new DRW_3Dface(static_cast<const DRW_3Dface &>(e));
+        f->basePoint = w.apply(f->basePoint);
+        f->secPoint = w.apply(f->secPoint);
+        f->thirdPoint = w.apply(f->thirdPoint);
+        f->fourPoint = w.apply(f->fourPoint);
+        return f; }
+    case DRW::LWPOLYLINE: {
+        DRW_LWPolyline *pl = new DRW_LWPolyline(static_cast<const DRW_LWPolyline &>(e));
+        PlaneMap pm(w, pl->extPoint);
+        for (std::vector<DRW_Vertex2D *>::iterator it = pl->vertlist.begin(); it != pl->vertlist.end(); ++it) {
+            DRW_Coord p = pm.point(DRW_Coord((*it)->x, (*it)->y, pl->elevation));
+            (*it)->x = p.x;
+            (*it)->y = p.y;
+            (*it)->stawidth *= pm.scale;
+            (*it)->endwidth *= pm.scale;
+        }
+        pl->elevation = pm.point(DRW_Coord(0, 0, pl->elevation)).z;
+        pl->width *= pm.scale;
+        pl->extPoint = pm.normal;
+        pl->thickness *= pm.height;
+        return pl; }
+    case DRW::POLYLINE: {
+        DRW_Polyline *pl = new DRW_Polyline(static_cast<const DRW_Polyline &>(e));
+        bool planar = (pl->flags & (8 | 16 | 64)) == 0; //not 3d polyline, mesh or polyface
+        PlaneMap pm(w, pl->extPoint);
+        for (std::vector<DRW_Vertex *>::iterator it = pl->vertlist.begin(); it != pl->vertlist.end(); ++it) {
+            DRW_Vertex *v = new DRW_Vertex(**it);  //the copy shares the vertices
+            if (planar) {
+                v->basePoint = pm.point(DRW_Coord(v->basePoint.x, v->basePoint.y, pl->basePoint.z));
+                v->basePoint.z = 0;
+                v->stawidth *= pm.scale;
+                v->endwidth *= pm.scale;
+            } else {
+                v->basePoint = w.apply(v->basePoint);
+            }
+            *it = v;
+        }
+        if (planar) {
+            pl->basePoint = DRW_Coord(0, 0, pm.point(DRW_Coord(0, 0, pl->basePoint.z)).z);
+            pl->defstawidth *= pm.scale;
+            pl->defendwidth *= pm.scale;
+            pl->extPoint = pm.normal;
+            pl->thickness *= pm.height;
+        }
+        return pl; }
+    case DRW::SPLINE: {
+        DRW_Spline *sp = new DRW_Spline(static_cast<const DRW_Spline &>(e));
+        for (std::vector<DRW_Coord *>::iterator it = sp->controllist.begin(); it != sp->controllist.end(); ++it)
+            *it = new DRW_Coord(w.apply(**it));
+        for (std::vector<DRW_Coord *>::iterator it = sp->fitlist.begin(); it != sp->fitlist.end(); ++it)
+            *it = new DRW_Coord(w.apply(**it));
+        sp->tgStart = w.applyVector(sp->tgStart);
+        sp->tgEnd = w.applyVector(sp->tgEnd);
+        //normals go with the inverse transpose
+        DRW_Transform inv = w.inverse();
+        const DRW_Coord &n = sp->normalVec;
+        sp->normalVec = unit(DRW_Coord(inv.m[0][0]*n.x + inv.m[1][0]*n.y + inv.m[2][0]*n.z,
+                                       inv.m[0][1]*n.x + inv.m[1][1]*n.y + inv.m[2][1]*n.z,
+                                       inv.m[0][2]*n.x + inv.m[1][2]*n.y + inv.m[2][2]*n.z));
+        return sp; }
+    case DRW::TEXT: {
+        DRW_Text *t = new DRW_Text(static_cast<const DRW_Text &>(e));
+        PlaneMap pm(w, t->extPoint);
+        t->basePoint = pm.point(t->basePoint);
+        t->secPoint = pm.point(t->secPoint);
+        placeText(t, pm);
+        return t; }
+    case DRW::MTEXT: {
+        //insertion point & x axis in WCS, the angle in the plane
+        DRW_MText *t = new DRW_MText(static_cast<const DRW_MText &>(e));
+        PlaneMap pm(w, t->extPoint);
+        t->basePoint = w.apply(t->basePoint);
+        if (length(t->secPoint) > 0)
+            t->secPoint = w.applyVector(t->secPoint);
+        placeText(t, pm);
+        return t; }
+    default:
+        return NULL;
+    }
+}
+
+/*the types handed by takeEntity()*/
+bool expandable(DRW::ETYPE t){
+    switch (t) {
+    case DRW::POINT:
+    case DRW::LINE:
+    case DRW::RAY:
+    case DRW::XLINE:
+    case DRW::CIRCLE:
+    case DRW::ARC:
+    case DRW::ELLIPSE:
+    case DRW::TRACE:
+    case DRW::SOLID:
+    case DRW::E3DFACE:
+    case DRW::LWPOLYLINE:
+    case DRW::POLYLINE:
+    case DRW::SPLINE:
+    case DRW::TEXT:
+    case DRW::MTEXT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/*hands 'e' to the interface, the lists go with it*/
+void takeEntity(DRW_Interface *iface, DRW_Entity *e){
+    switch (e->eType) {
+    case DRW::POINT:
+        iface->takePoint(std::move(*static_cast<DRW_Point *>(e)));
+        break;
+    case DRW::LINE:
+        iface->takeLine(std::move(*static_cast<DRW_Line *>(e)));
+        break;
+    case DRW::RAY:
+        iface->takeRay(std::move(*static_cast<DRW_Ray *>(e)));
+        break;
+    case DRW::XLINE:
+        iface->takeXline(std::move(*static_cast<DRW_Xline *>(e)));
+        break;
+    case DRW::CIRCLE:
+        iface->takeCircle(std::move(*static_cast<DRW_Circle *>(e)));
+        break;
+    case DRW::ARC:
+        iface->takeArc(std::move(*static_cast<DRW_Arc *>(e)));
+        break;
+    case DRW::ELLIPSE:
+        iface->takeEllipse(std::move(*static_cast<DRW_Ellipse *>(e)));
+        break;
+    case DRW::TRACE:
+        iface->takeTrace(std::move(*static_cast<DRW_Trace *>(e)));
+        break;
+    case DRW::SOLID:
+        iface->takeSolid(std::move(*static_cast<DRW_Solid *>(e)));
+        break;
+    case DRW::E3DFACE:
+        iface->take3dFace(std::move(*static_cast<DRW_3Dface *>(e)));
+        break;
+    case DRW::LWPOLYLINE:
+        iface->takeLWPolyline(std::move(*static_cast<DRW_LWPolyline *>(e)));
+        break;
+    case DRW::POLYLINE:
+        iface->takePolyline(std::move(*static_cast<DRW_Polyline *>(e)));
+        break;
+    case DRW::SPLINE:
+        iface->takeSpline(std::move(*static_cast<DRW_Spline *>(e)));
+        break;
+    case DRW::TEXT:
+        iface->takeText(std::move(*static_cast<DRW_Text *>(e)));
+        break;
+    case DRW::MTEXT:
+        iface->takeMText(std::move(*static_cast<DRW_MText *>(e)));
+        break;
+    default:
+        break;
+    }
+}
+
+bool isByBlock(const std::string &s){
+    static const char BYBLOCK[] = "BYBLOCK";
+    if (s.size() != sizeof(BYBLOCK) - 1)
+        return false;
+    for (size_t i = 0; i < s.size(); ++i) {
+        if (toupper(static_cast<unsigned char>(s[i])) != BYBLOCK[i])
+            return false;
+    }
+    return true;
+}
+
+} //namespace
+
+DRW_BlockExpander::DRW_BlockExpander(): instanceCount(0), current(NULL), threads(0), prepared(false) {
+    clear();
+}
+
+DRW_BlockExpander::~DRW_BlockExpander(){
+    clear();
+}
+
+void DRW_BlockExpander::clear(){
+    for (std::map<std::string, Block>::iterator it = blocks.begin(); it != blocks.end(); ++it) {
+        for (std::vector<DRW_Entity *>::iterator e = it->second.entities.begin(); e != it->second.entities.end(); ++e)
+            DRW::destroyEntity(*e);
+    }
+    blocks.clear();
+    inserts.clear();
+    tops.clear();
+    instanceCount = 0;
+    current = NULL;
+    prepared = false;
+    skipped = 0;
+    missing = 0;
+}
+
+void DRW_BlockExpander::beginBlock(const DRW_Block &b){
+    current = &blocks[b.name];
+    current->name = b.name;
+    current->base = b.basePoint;
+    prepared = false;
+}
+
+void DRW_BlockExpander::endBlock(){
+    current = NULL;
+}
+
+void DRW_BlockExpander::addEntity(const DRW_Entity &e){
+    prepared = false;
+    if (e.eType == DRW::INSERT) {
+        const DRW_Insert &ins = static_cast<const DRW_Insert &>(e);
+        if (current != NULL)
+            current->inserts.push_back(ins);
+        else
+            inserts.push_back(ins);
+        return;
+    }
+    if (current == NULL)
+        return;
+    DRW_Entity *copy = expandable(e.eType) ? DRW::copyEntity(e) : NULL;
+    if (copy == NULL)
+        ++skipped;
+    else
+        current->entities.push_back(copy);
+}
+
+DRW_BlockExpander::Inherited DRW_BlockExpander::propsOf(const DRW_Entity &e){
+    Inherited p;
+    p.color = e.color;
+    p.lWeight = e.lWeight;
+    p.layer = e.layer;
+    p.lineType = e.lineType;
+    return p;
+}
+
+/*the properties of 'p' still by block take the ones of 'from'*/
+void DRW_BlockExpander::inherit(Inherited *p, const Inherited &from){
+    if (p->color == DRW::ColorByBlock)
+        p->color = from.color;
+    if (p->lWeight == DRW_LW_Conv::widthByBlock)
+        p->lWeight = from.lWeight;
+    if (p->layer == "0")
+        p->layer = from.layer;
+    if (isByBlock(p->lineType))
+        p->lineType = from.lineType;
+}
+
+/*block coordinates of 'ins' to the ones of its owner*/
+DRW_Transform DRW_BlockExpander::insertTransform(const DRW_Insert &ins, const DRW_Coord &base,
+                                                 int col, int row){
+    return DRW_Transform::ocs(ins.extPoint)
+         * DRW_Transform::translation(ins.basePoint.x, ins.basePoint.y, ins.basePoint.z)
+         * DRW_Transform::rotation(ins.angle)
+         * DRW_Transform::translation(col * ins.colspace, row * ins.rowspace, 0)
+         * DRW_Transform::scale(ins.xscale, ins.yscale, ins.zscale)
+         * DRW_Transform::translation(-base.x, -base.y, -base.z);
+}
+
+/*appends the placements of 'target' inserted by 'ins' in a block placed by 'outer'*/
+void DRW_BlockExpander::placeInsert(const DRW_Insert &ins, const Block *target, const DRW_Transform &outer,
+                                    const Inherited &props, std::vector<Placement> *out) const{
+    Inherited own = propsOf(ins);
+    inherit(&own, props);
+    int cols = std::max(ins.colcount, 1);
+    int rows = std::max(ins.rowcount, 1);
+    for (int c = 0; c < cols; ++c) {
+        for (int r = 0; r < rows; ++r) {
+            DRW_Transform t = outer * insertTransform(ins, target->base, c, r);
+            for (std::vector<Placement>::const_iterator p = target->placements.begin(); p != target->placements.end(); ++p) {
+                Placement q;
+                q.block = p->block;
+                q.transform = t * p->transform;
+                q.props = p->props;
+                inherit(&q.props, own);
+                out->push_back(q);
+            }
+        }
+    }
+}
+
+/*caches the placements of the blocks nested in 'b'*/
+void DRW_BlockExpander::solve(Block *b){
+    if (b->solved)
+        return;
+    b->solving = true;
+    b->placements.clear();
+    Placement self;
+    self.block = b;
+    b->placements.push_back(self);
+    for (std::vector<DRW_Insert>::const_iterator ins = b->inserts.begin(); ins != b->inserts.end(); ++ins) {
+        std::map<std::string, Block>::iterator it = blocks.find(ins->name);
+        if (it == blocks.end() || it->second.solving) {
+            ++missing;
+            continue;
+        }
+        solve(&it->second);
+        placeInsert(*ins, &it->second, DRW_Transform(), Inherited(), &b->placements);
+    }
+    b->solving = false;
+    b->solved = true;
+}
+
+/*solves the blocks once after the last change, counts the instances of each top level insert*/
+void DRW_BlockExpander::prepare(){
+    if (prepared)
+        return;
+    missing = 0;
+    for (std::map<std::string, Block>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+        it->second.solved = false;
+    tops.clear();
+    size_t count = 0;
+    for (std::vector<DRW_Insert>::const_iterator ins = inserts.begin(); ins != inserts.end(); ++ins) {
+        std::map<std::string, Block>::iterator it = blocks.find(ins->name);
+        if (it == blocks.end()) {
+            ++missing;
+            continue;
+        }
+        solve(&it->second);
+        Top t;
+        t.insert = &*ins;
+        t.block = &it->second;
+        t.first = count;
+        tops.push_back(t);
+        count += static_cast<size_t>(std::max(ins->colcount, 1)) * std::max(ins->rowcount, 1)
+               * it->second.placements.size();
+    }
+    instanceCount = count;
+    prepared = true;
+}
+
+void DRW_BlockExpander::instanceRange(size_t first, size_t last, std::vector<DRW_BlockInstance> *out,
+                                      size_t offset) const{
+    std::vector<Placement> placed;
+    for (size_t i = first; i < last; ++i) {
+        const Top &t = tops[i];
+        placed.clear();
+        placeInsert(*t.insert, t.block, DRW_Transform(), Inherited(), &placed);
+        size_t pos = offset + t.first;
+        for (std::vector<Placement>::const_iterator p = placed.begin(); p != placed.end(); ++p, ++pos) {
+            DRW_BlockInstance &bi = (*out)[pos];
+            bi.block = p->block->name;
+            bi.transform = p->transform;
+            bi.insert = t.insert->handle;
+            bi.space = t.insert->space;
+        }
+    }
+}
+
+void DRW_BlockExpander::instances(std::vector<DRW_BlockInstance> *out){
+    prepare();
+    size_t offset = out->size();
+    out->resize(offset + instanceCount);
+    unsigned int n = DRW::threadCount(threads, tops.size());
+    size_t per = (tops.size() + n - 1) / n;
+    DRW::runJobs(n, [&](unsigned int job) {
+        size_t first = std::min(tops.size(), job * per);
+        instanceRange(first, std::min(tops.size(), first + per), out, offset);
+    });
+}
+
+void DRW_BlockExpander::expandRange(size_t first, size_t last, std::vector<DRW_Entity *> *out) const{
+    std::vector<Placement> placed;
+    for (size_t i = first; i < last; ++i) {
+        const Top &t = tops[i];
+        placed.clear();
+        placeInsert(*t.insert, t.block, DRW_Transform(), Inherited(), &placed);
+        for (std::vector<Placement>::const_iterator p = placed.begin(); p != placed.end(); ++p) {
+            const std::vector<DRW_Entity *> &src = p->block->entities;
+            for (std::vector<DRW_Entity *>::const_iterator e = src.begin(); e != src.end(); ++e) {
+                DRW_Entity *placedEnt = placeEntity(**e, p->transform);
+                if (placedEnt == NULL)
+                    continue;
+                Inherited props = propsOf(**e);
+                inherit(&props, p->props);
+                placedEnt->color = props.color;
+                placedEnt->lWeight = props.lWeight;
+                placedEnt->layer = props.layer;
+                placedEnt->lineType = props.lineType;
+                placedEnt->space = t.insert->space;
+                out->push_back(placedEnt);
+            }
+        }
+    }
+}
+
+/*the inserts are expanded in batches, each thread a slice, the entities of a
+ *batch are handed in order while none is expanded*/
+void DRW_BlockExpander::expand(DRW_Interface *iface){
+    prepare();
+    unsigned int n = DRW::threadCount(threads, tops.size());
+    std::vector<std::vector<DRW_Entity *> > results(n);
+    for (size_t begin = 0; begin < tops.size(); begin += BATCH * n) {
+        size_t end = std::min(tops.size(), begin + BATCH * n);
+        size_t per = (end - begin + n - 1) / n;
+        DRW::runJobs(n, [&](unsigned int job) {
+            size_t first = std::min(end, begin + job * per);
+            expandRange(first, std::min(end, first + per), &results[job]);
+        });
+        for (unsigned int i = 0; i < n; ++i) {
+            for (std::vector<DRW_Entity *>::iterator e = results[i].begin(); e != results[i].end(); ++e) {
+                takeEntity(iface, *e);
+                delete *e; //the lists went with it or are shared with the copy
+            }
+            results[i].clear();
+        }
+    }
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_EXPAND_H
+#define DRW_EXPAND_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include "drw_base.h"
+#include "drw_entities.h"
+
+class DRW_Interface;
+
+//! A block placed in WCS by a top level insert, directly or nested.
+class DRW_BlockInstance {
+public:
+    std::string block;        /*!< name of the placed block */
+    DRW_Transform transform;  /*!< block coordinates, as read, to WCS */
+    duint32 insert;           /*!< handle of the top level insert */
+    DRW::Space space;         /*!< space of the top level insert */
+};
+
+//! Expands the inserts of the spaces in WCS.
+/*!
+*  Fed with the blocks and entities as read, before applyExtrusion() (read
+*  with ext = false), in the same order as DRW_Interface gets them. The
+*  entities of the blocks are copied once, the inserts outside blocks are
+*  the ones expanded.
+*  Each block caches the placements of the blocks nested in it, with the
+*  transformations of the insert chains already composed, so a block path
+*  is composed once whatever the number of inserts. The columns & rows
+*  of a minsert are placements of the same block.
+*  The top level inserts are expanded in parallel, the results are handed
+*  in insert order.
+*  Entities on layer 0 or by block color, line type or line weight take
+*  the ones of the insert. Circles & arcs scaled unevenly become ellipses,
+*  the bulges of polylines are kept. Hatches, dimensions, leaders, images
+*  and viewports are not expanded, they are counted in 'skipped'.
+*/
+class DRW_BlockExpander {
+public:
+    DRW_BlockExpander();
+    ~DRW_BlockExpander();
+    void clear();
+    /** threads used to expand, 0 is one per core */
+    void setThreads(unsigned int count) { threads = count; }
+
+    void beginBlock(const DRW_Block &b);
+    void endBlock();
+    /** copies the entity in the current block, keeps the inserts of the spaces */
+    void addEntity(const DRW_Entity &e);
+
+    /** all the blocks placed by the top level inserts, nested ones included */
+    void instances(std::vector<DRW_BlockInstance> *out);
+    /** hands the entities of all the placed blocks in WCS to the take methods of 'iface' */
+    void expand(DRW_Interface *iface);
+
+public:
+    duint32 skipped;   /*!< block entities that can not be expanded */
+    duint32 missing;   /*!< inserts of blocks not found or recursive */
+
+private:
+    struct Block;
+    //! Properties taken from the insert, not set if layer 0 or by block.
+    struct Inherited {
+        Inherited(): color(DRW::ColorByBlock), lWeight(DRW_LW_Conv::widthByBlock), layer("0"), lineType("BYBLOCK") {}
+        int color;
+        enum DRW_LW_Conv::lineWidth lWeight;
+        DRW_Name layer;
+        DRW_Name lineType;
+    };
+    //! A block in the coordinates of another.
+    struct Placement {
+        const Block *block;
+        DRW_Transform transform;
+        Inherited props;
+    };
+    struct Block {
+        Block(): solved(false), solving(false) {}
+        std::string name;
+        DRW_Coord base;
+        std::vector<DRW_Entity *> entities;
+        std::vector<DRW_Insert> inserts;
+        std::vector<Placement> placements;  /*!< itself first, then the nested blocks */
+        bool solved;
+        bool solving;
+    };
+    //! A top level insert with its block solved.
+    struct Top {
+        const DRW_Insert *insert;
+        const Block *block;
+        size_t first;    /*!< its first instance */
+    };
+
+    DRW_BlockExpander(const DRW_BlockExpander&) = delete;
+    DRW_BlockExpander &operator=(const DRW_BlockExpander&) = delete;
+
+    static Inherited propsOf(const DRW_Entity &e);
+    static void inherit(Inherited *p, const Inherited &from);
+    static DRW_Transform insertTransform(const DRW_Insert &ins, const DRW_Coord &base, int col, int row);
+    void placeInsert(const DRW_Insert &ins, const Block *target, const DRW_Transform &outer,
+                     const Inherited &props, std::vector<Placement> *out) const;
+    void solve(Block *b);
+    void prepare();
+    void instanceRange(size_t first, size_t last, std::vector<DRW_BlockInstance> *out, size_t offset) const;
+    void expandRange(size_t first, size_t last, std::vector<DRW_Entity *> *out) const;
+
+    std::map<std::string, Block> blocks;
+    std::vector<DRW_Insert> inserts;  /*!< inserts of the spaces */
+    std::vector<Top> tops;
+    size_t instanceCount;
+    Block *current;
+    unsigned int threads;
+    bool prepared;
+};
+
+#endif // DRW_EXPAND_H
@@ -0,0 +1,613 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_extents.h"
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+const double CHAR_WIDTH = 0.8;          //average advance of a character, in text heights
+const double LINE_SPACING = 5.0 / 3.0;  //distance between mtext lines, in text heights
+
+//p + u*s
+DRW_Coord along(const DRW_Coord &p, const DRW_Coord &u, double s){
+    return DRW_Coord(p.x + u.x*s, p.y + u.y*s, p.z + u.z*s);
+}
+
+//p + u*s + v*t
+DRW_Coord along(const DRW_Coord &p, const DRW_Coord &u, double s, const DRW_Coord &v, double t){
+    return DRW_Coord(p.x + u.x*s + v.x*t, p.y + u.y*s + v.y*t, p.z + u.z*s + v.z*t);
+}
+
+//! Maps OCS to WCS with the axes of DRW_Transform::ocs().
+class OcsFrame {
+public:
+    explicit OcsFrame(const DRW_Coord &ext): t(DRW_Transform::ocs(ext)), identity(t.isIdentity()) {
+        n = t.applyVector(DRW_Coord(0, 0, 1));
+    }
+    DRW_Coord point(double x, double y, double z) const {
+        if (identity)
+            return DRW_Coord(x, y, z);
+        return t.apply(DRW_Coord(x, y, z));
+    }
+    DRW_Coord point(const DRW_Coord &p) const { return point(p.x, p.y, p.z); }
+    DRW_Coord vector(double x, double y) const { return t.applyVector(DRW_Coord(x, y, 0)); }
+
+public:
+    DRW_Transform t;
+    bool identity;
+    DRW_Coord n;
+};
+
+/*adds the points c + u*cos(t) + v*sin(t) with t from t0 to t1 counterclockwise,
+ *the ends and the extremes of each axis. t0 == t1 is the full curve*/
+void addEllipse(DRW_BBox *box, const DRW_Coord &c, const DRW_Coord &u, const DRW_Coord &v,
+                double t0, double t1){
+    double sweep = fmod(t1 - t0, M_PIx2);
+    if (sweep < 0)
+        sweep += M_PIx2;
+    if (sweep < 1.0e-12)
+        sweep = M_PIx2;
+    box->add(along(c, u, cos(t0), v, sin(t0)));
+    box->add(along(c, u, cos(t0 + sweep), v, sin(t0 + sweep)));
+    const double uc[3] = {u.x, u.y, u.z};
+    const double vc[3] = {v.x, v.y, v.z};
+    for (int i = 0; i < 3; ++i) {
+        if (uc[i] == 0.0 && vc[i] == 0.0)
+            continue;
+        //d/dt (u*cos(t) + v*sin(t)) = 0
+        double t = atan2(vc[i], uc[i]);
+        for (int k = 0; k < 2; ++k, t += M_PI) {
+            double d = fmod(t - t0, M_PIx2);
+            if (d < 0)
+                d += M_PIx2;
+            if (d <= sweep)
+                box->add(along(c, u, cos(t), v, sin(t)));
+        }
+    }
+}
+
+//arc of circle in OCS, angles in radians
+void addArc(DRW_BBox *box, const OcsFrame &ocs, double cx, double cy, double z, double r,
+            double a0, double a1){
+    addEllipse(box, ocs.point(cx, cy, z), ocs.vector(r, 0), ocs.vector(0, r), a0, a1);
+}
+
+//polyline segment in OCS from (x1, y1) to (x2, y2)
+void addSegment(DRW_BBox *box, const OcsFrame &ocs, double x1, double y1, double x2, double y2,
+                double z, double bulge){
+    box->add(ocs.point(x1, y1, z));
+    box->add(ocs.point(x2, y2, z));
+    if (fabs(bulge) < 1.0e-12)
+        return;
+    double dx = x2 - x1;
+    double dy = y2 - y1;
+    double len = sqrt(dx*dx + dy*dy);
+    if (len < 1.0e-12)
+        return;
+    //the included angle is 4*atan(bulge), the center is at the left for positive bulges
+    double offset = (len / 2) / tan(2 * atan(bulge));
+    double cx = (x1 + x2) / 2 - dy / len * offset;
+    double cy = (y1 + y2) / 2 + dx / len * offset;
+    double r = sqrt((x1 - cx)*(x1 - cx) + (y1 - cy)*(y1 - cy));
+    double a1 = atan2(y1 - cy, x1 - cx);
+    double a2 = atan2(y2 - cy, x2 - cx);
+    if (bulge > 0)
+        addArc(box, ocs, cx, cy, z, r, a1, a2);
+    else
+        addArc(box, ocs, cx, cy, z, r, a2, a1);
+}
+
+void addVertices(DRW_BBox *box, const OcsFrame &ocs, const std::vector<DRW_Vertex2D *> &v,
+                 double z, bool closed){
+    size_t n = v.size();
+    if (n == 1)
+        box->add(ocs.point(v[0]->x, v[0]->y, z));
+    for (size_t i = 0; i + 1 < n; ++i)
+        addSegment(box, ocs, v[i]->x, v[i]->y, v[i+1]->x, v[i+1]->y, z, v[i]->bulge);
+    if (closed && n > 1)
+        addSegment(box, ocs, v[n-1]->x, v[n-1]->y, v[0]->x, v[0]->y, z, v[n-1]->bulge);
+}
+
+//rectangle x0..x1, y0..y1 in the frame of origin org and axes ux, uy
+void addRect(DRW_BBox *box, const DRW_Coord &org, const DRW_Coord &ux, const DRW_Coord &uy,
+             double x0, double y0, double x1, double y1){
+    box->add(along(org, ux, x0, uy, y0));
+    box->add(along(org, ux, x1, uy, y0));
+    box->add(along(org, ux, x0, uy, y1));
+    box->add(along(org, ux, x1, uy, y1));
+}
+
+/*characters of a text, the %%x control codes are one character or none*/
+int textLength(const std::string &s){
+    int n = 0;
+    for (size_t i = 0; i < s.size(); ++i) {
+        unsigned char ch = s[i];
+        if ((ch & 0xC0) == 0x80) //utf-8 continuation
+            continue;
+        if (ch == '%' && i + 2 < s.size() && s[i+1] == '%') {
+            char code = s[i+2];
+            i += 2;
+            if (code == 'u' || code == 'U' || code == 'o' || code == 'O' || code == 'k' || code == 'K')
+                continue; //toggles
+        }
+        ++n;
+    }
+    return n;
+}
+
+/*characters of each paragraph of a mtext, the format codes are skipped*/
+void mtextParagraphs(const std::string &s, std::vector<int> *para){
+    int n = 0;
+    for (size_t i = 0; i < s.size(); ++i) {
+        unsigned char ch = s[i];
+        if ((ch & 0xC0) == 0x80 || ch == '{' || ch == '}' || ch == '\r')
+            continue;
+        if (ch == '\n') {
+            para->push_back(n);
+            n = 0;
+            continue;
+        }
+        if (ch == '\\' && i + 1 < s.size()) {
+            char code = s[++i];
+            switch (code) {
+            case 'P':
+                para->push_back(n);
+                n = 0;
+                break;
+            case 'L': case 'l': case 'O': case 'o': case 'K': case 'k':
+                break;
+            case 'U': //\U+XXXX
+                if (i + 1 < s.size() && s[i+1] == '+')
+                    i += 5;
+                ++n;
+                break;
+            case '\\': case '{': case '}': case '~':
+                ++n;
+                break;
+            case 'S': //stacked text up to ';', counted as written
+                while (i + 1 < s.size() && s[i+1] != ';') {
+                    ++i;
+                    if (s[i] != '^' && s[i] != '/' && s[i] != '#' && (s[i] & 0xC0) != 0x80)
+                        ++n;
+                }
+                ++i;
+                break;
+            default: //font, height, color... up to ';'
+                while (i < s.size() && s[i] != ';')
+                    ++i;
+                break;
+            }
+            continue;
+        }
+        ++n;
+    }
+    para->push_back(n);
+}
+
+void textBounds(const DRW_Text &t, DRW_BBox *box){
+    OcsFrame ocs(t.extPoint);
+    double h = t.height;
+    double w = textLength(t.text) * h * CHAR_WIDTH * t.widthscale;
+    double angle = t.angle / ARAD;
+    DRW_Coord org = t.basePoint;
+    double x0 = 0;
+    double y0 = 0;
+    if (t.alignV == DRW_Text::VBaseLine && (t.alignH == DRW_Text::HAligned || t.alignH == DRW_Text::HFit)) {
+        //fitted between the two points
+        double dx = t.secPoint.x - t.basePoint.x;
+        double dy = t.secPoint.y - t.basePoint.y;
+        if (dx != 0.0 || dy != 0.0) {
+            w = sqrt(dx*dx + dy*dy);
+            angle = atan2(dy, dx);
+        }
+    } else if (t.alignH != DRW_Text::HLeft || t.alignV != DRW_Text::VBaseLine) {
+        org = t.secPoint;
+        org.z = t.basePoint.z;
+        if (t.alignH == DRW_Text::HCenter || t.alignH == DRW_Text::HMiddle)
+            x0 = -w / 2;
+        else if (t.alignH == DRW_Text::HRight)
+            x0 = -w;
+        if (t.alignV == DRW_Text::VMiddle || (t.alignH == DRW_Text::HMiddle && t.alignV == DRW_Text::VBaseLine))
+            y0 = -h / 2;
+        else if (t.alignV == DRW_Text::VTop)
+            y0 = -h;
+    }
+    DRW_Coord ux = ocs.vector(cos(angle), sin(angle));
+    DRW_Coord uy = ocs.vector(-sin(angle), cos(angle));
+    addRect(box, ocs.point(org), ux, uy, x0, y0, x0 + w, y0 + h);
+}
+
+void mtextBounds(const DRW_MText &t, DRW_BBox *box){
+    OcsFrame ocs(t.extPoint);
+    double h = t.height;
+    double refWidth = t.widthscale; //reference rectangle width, code 41
+    std::vector<int> para;
+    mtextParagraphs(t.text, &para);
+    double w = 0;
+    int lines = 0;
+    for (std::vector<int>::const_iterator it = para.begin(); it != para.end(); ++it) {
+        double pw = *it * h * CHAR_WIDTH;
+        int n = 1;
+        if (refWidth > 0 && pw > refWidth) { //wrapped
+            n = static_cast<int>(ceil(pw / refWidth));
+            pw = refWidth;
+        }
+        w = std::max(w, pw);
+        lines += n;
+    }
+    double ht = h + (lines - 1) * h * LINE_SPACING * t.interlin;
+    int attach = (t.textgen >= 1 && t.textgen <= 9) ? t.textgen - 1 : 0; //code 71
+    double x0 = 0;
+    if (attach % 3 == 1)
+        x0 = -w / 2;
+    else if (attach % 3 == 2)
+        x0 = -w;
+    double y0 = -ht;
+    if (attach / 3 == 1)
+        y0 = -ht / 2;
+    else if (attach / 3 == 2)
+        y0 = 0;
+    double angle = t.angle / ARAD;
+    DRW_Coord ux = ocs.vector(cos(angle), sin(angle));
+    DRW_Coord uy = ocs.vector(-sin(angle), cos(angle));
+    addRect(box, t.basePoint, ux, uy, x0, y0, x0 + w, y0 + ht);
+}
+
+void hatchBounds(const DRW_Hatch &hatch, DRW_BBox *box){
+    OcsFrame ocs(hatch.extPoint);
+    double z = hatch.basePoint.z;
+    for (std::vector<DRW_HatchLoop *>::const_iterator it = hatch.looplist.begin(); it != hatch.looplist.end(); ++it) {
+        const std::vector<DRW_Entity *> &edges = (*it)->objlist;
+        for (std::vector<DRW_Entity *>::const_iterator e = edges.begin(); e != edges.end(); ++e) {
+            switch ((*e)->eType) {
+            case DRW::LINE: {
+                const DRW_Line *l = static_cast<const DRW_Line *>(*e);
+                box->add(ocs.point(l->basePoint.x, l->basePoint.y, z));
+                box->add(ocs.point(l->secPoint.x, l->secPoint.y, z));
+                break; }
+            case DRW::ARC: {
+                const DRW_Arc *a = static_cast<const DRW_Arc *>(*e);
+                //clockwise edges have the angles mirrored
+                if (a->isccw)
+                    addArc(box, ocs, a->basePoint.x, a->basePoint.y, z, a->radious, a->staangle, a->endangle);
+                else
+                    addArc(box, ocs, a->basePoint.x, a->basePoint.y, z, a->radious, -a->endangle, -a->staangle);
+                break; }
+            case DRW::ELLIPSE: {
+                const DRW_Ellipse *el = static_cast<const DRW_Ellipse *>(*e);
+                DRW_Coord u = ocs.vector(el->secPoint.x, el->secPoint.y);
+                DRW_Coord v = ocs.vector(-el->secPoint.y * el->ratio, el->secPoint.x * el->ratio);
+                DRW_Coord c = ocs.point(el->basePoint.x, el->basePoint.y, z);
+                if (el->isccw)
+                    addEllipse(box, c, u, v, el->staparam, el->endparam);
+                else
+                    addEllipse(box, c, u, v, -el->endparam, -el->staparam);
+                break; }
+            case DRW::SPLINE: {
+                const DRW_Spline *sp = static_cast<const DRW_Spline *>(*e);
+                for (std::vector<DRW_Coord *>::const_iterator p = sp->controllist.begin(); p != sp->controllist.end(); ++p)
+                    box->add(ocs.point((*p)->x, (*p)->y, z));
+                break; }
+            case DRW::LWPOLYLINE: {
+                const DRW_LWPolyline *pl = static_cast<const DRW_LWPolyline *>(*e);
+                addVertices(box, ocs, pl->vertlist, z, true);
+                break; }
+            default:
+                break;
+            }
+        }
+    }
+}
+
+} //namespace
+
+void DRW_Extents::clear(){
+    model.clear();
+    paper.clear();
+    layers.clear();
+    blocks.clear();
+    bounded = 0;
+    modelIndex.clear();
+    paperIndex.clear();
+    basePoints.clear();
+    pending.clear();
+    pendingTop.clear();
+    current.clear();
+    currentBox = NULL;
+    lastLayer = DRW_Name();
+    lastLayerBox = NULL;
+}
+
+/*the coordinates are the read ones, before DRW_Entity::applyExtrusion()*/
+bool DRW_Extents::entityBounds(const DRW_Entity &e, DRW_BBox *box) const{
+    box->clear();
+    switch (e.eType) {
+    case DRW::POINT:
+        box->add(static_cast<const DRW_Point &>(e).basePoint);
+        break;
+    case DRW::LINE: {
+        const DRW_Line &l = static_cast<const DRW_Line &>(e);
+        box->add(l.basePoint);
+        box->add(l.secPoint);
+        break; }
+    case DRW::CIRCLE:
+    case DRW::ARC: {
+        const DRW_Circle &c = static_cast<const DRW_Circle &>(e);
+        double a0 = 0;
+        double a1 = M_PIx2;
+        if (e.eType == DRW::ARC) {
+            a0 = static_cast<const DRW_Arc &>(e).staangle;
+            a1 = static_cast<const DRW_Arc &>(e).endangle;
+        }
+        addArc(box, OcsFrame(c.extPoint), c.basePoint.x, c.basePoint.y, c.basePoint.z, c.radious, a0, a1);
+        break; }
+    case DRW::ELLIPSE: {
+        //center & major axis in WCS, the minor axis is normal to both
+        const DRW_Ellipse &el = static_cast<const DRW_Ellipse &>(e);
+        DRW_Coord n = el.extPoint;
+        n.unitize();
+        const DRW_Coord &u = el.secPoint;
+        DRW_Coord v((n.y*u.z - n.z*u.y) * el.ratio, (n.z*u.x - n.x*u.z) * el.ratio,
+                    (n.x*u.y - n.y*u.x) * el.ratio);
+        addEllipse(box, el.basePoint, u, v, el.staparam, el.endparam);
+        break; }
+    case DRW::TRACE:
+    case DRW::SOLID: {
+        const DRW_Trace &t = static_cast<const DRW_Trace &>(e);
+        OcsFrame ocs(t.extPoint);
+        box->add(ocs.point(t.basePoint));
+        box->add(ocs.point(t.secPoint));
+        box->add(ocs.point(t.thirdPoint));
+        box->add(ocs.point(t.fourPoint));
+        break; }
+    case DRW::E3DFACE: {
+        const DRW_3Dface &f = static_cast<const DRW_3Dface &>(e);
+        box->add(f.basePoint);
+        box->add(f.secPoint);
+        box->add(f.thirdPoint);
+        box->add(f.fourPoint);
+        break; }
+    case DRW::LWPOLYLINE: {
+        const DRW_LWPolyline &pl = static_cast<const DRW_LWPolyline &>(e);
+        addVertices(box, OcsFrame(pl.extPoint), pl.vertlist, pl.elevation, pl.flags & 1);
+        break; }
+    case DRW::POLYLINE: {
+        const DRW_Polyline &pl = static_cast<const DRW_Polyline &>(e);
+        const std::vector<DRW_Vertex *> &v = pl.vertlist;
+        if (pl.flags & (8 | 16 | 64)) { //3d polyline, mesh or polyface, in WCS
+            for (std::vector<DRW_Vertex *>::const_iterator it = v.begin(); it != v.end(); ++it) {
+                if (((*it)->flags & 128) && !((*it)->flags & 64))
+                    continue; //polyface face record, not a point
+                box->add((*it)->basePoint);
+            }
+            break;
+        }
+        OcsFrame ocs(pl.extPoint);
+        double z = pl.basePoint.z;
+        size_t n = v.size();
+        if (n == 1)
+            box->add(ocs.point(v[0]->basePoint.x, v[0]->basePoint.y, z));
+        for (size_t i = 0; i + 1 < n; ++i)
+            addSegment(box, ocs, v[i]->basePoint.x, v[i]->basePoint.y, v[i+1]->basePoint.x,
+                       v[i+1]->basePoint.y, z, v[i]->bulge);
+        if ((pl.flags & 1) && n > 1)
+            addSegment(box, ocs, v[n-1]->basePoint.x, v[n-1]->basePoint.y, v[0]->basePoint.x,
+                       v[0]->basePoint.y, z, v[n-1]->bulge);
+        break; }
+    case DRW::SPLINE: {
+        //the curve is inside the hull of the control points
+        const DRW_Spline &sp = static_cast<const DRW_Spline &>(e);
+        const std::vector<DRW_Coord *> &pts = sp.controllist.empty() ? sp.fitlist : sp.controllist;
+        for (std::vector<DRW_Coord *>::const_iterator it = pts.begin(); it != pts.end(); ++it)
+            box->add(*(*it));
+        break; }
+    case DRW::HATCH:
+        hatchBounds(static_cast<const DRW_Hatch &>(e), box);
+        break;
+    case DRW::TEXT:
+        textBounds(static_cast<const DRW_Text &>(e), box);
+        break;
+    case DRW::MTEXT:
+        mtextBounds(static_cast<const DRW_MText &>(e), box);
+        break;
+    case DRW::INSERT:
+        return insertBounds(static_cast<const DRW_Insert &>(e), box);
+    case DRW::DIMENSION:
+    case DRW::DIMALIGNED:
+    case DRW::DIMLINEAR:
+    case DRW::DIMRADIAL:
+    case DRW::DIMDIAMETRIC:
+    case DRW::DIMANGULAR:
+    case DRW::DIMANGULAR3P:
+    case DRW::DIMORDINATE: {
+        //the dimension block is drawn in WCS, without base point
+        const DRW_Dimension &d = static_cast<const DRW_Dimension &>(e);
+        std::map<std::string, DRW_BBox>::const_iterator bi = blocks.find(d.name);
+        if (!d.name.empty() && bi != blocks.end() && bi->second.isValid() && complete(d.name)) {
+            box->add(bi->second);
+            break;
+        }
+        //without block, the definition points of each type
+        if (e.eType == DRW::DIMRADIAL || e.eType == DRW::DIMDIAMETRIC) {
+            box->add(d.defPoint);
+            box->add(d.circlePoint);
+        } else if (e.eType == DRW::DIMANGULAR || e.eType == DRW::DIMANGULAR3P) {
+            box->add(d.defPoint);
+            box->add(d.def1);
+            box->add(d.def2);
+            box->add(d.circlePoint);
+            if (e.eType == DRW::DIMANGULAR)
+                box->add(d.arcPoint);
+        } else {
+            if (e.eType != DRW::DIMORDINATE) //the origin is not drawn
+                box->add(d.defPoint);
+            box->add(d.def1);
+            box->add(d.def2);
+        }
+        box->add(OcsFrame(d.extPoint).point(d.textPoint));
+        break; }
+    case DRW::LEADER: {
+        const DRW_Leader &l = static_cast<const DRW_Leader &>(e);
+        for (std::vector<DRW_Coord *>::const_iterator it = l.vertexlist.begin(); it != l.vertexlist.end(); ++it)
+            box->add(*(*it));
+        break; }
+    case DRW::VIEWPORT: {
+        const DRW_Viewport &vp = static_cast<const DRW_Viewport &>(e);
+        box->add(vp.basePoint.x - vp.pswidth / 2, vp.basePoint.y - vp.psheight / 2, vp.basePoint.z);
+        box->add(vp.basePoint.x + vp.pswidth / 2, vp.basePoint.y + vp.psheight / 2, vp.basePoint.z);
+        break; }
+    case DRW::IMAGE: {
+        const DRW_Image &img = static_cast<const DRW_Image &>(e);
+        addRect(box, img.basePoint, img.secPoint, img.vVector, 0, 0, img.sizeu, img.sizev);
+        break; }
+    default: //rays & xlines are unbounded
+        break;
+    }
+    return box->isValid();
+}
+
+/*block box through base point, scale, rotation & position of the insert, the
+ *columns & rows of a minsert extend it to the last ones*/
+bool DRW_Extents::insertBounds(const DRW_Insert &ins, DRW_BBox *box) const{
+    box->clear();
+    std::map<std::string, DRW_BBox>::const_iterator bi = blocks.find(ins.name);
+    std::map<std::string, DRW_Coord>::const_iterator base = basePoints.find(ins.name);
+    if (bi == blocks.end() || base == basePoints.end() || !bi->second.isValid())
+        return false;
+    const DRW_BBox &b = bi->second;
+    OcsFrame ocs(ins.extPoint);
+    DRW_Coord ux = ocs.vector(cos(ins.angle), sin(ins.angle));
+    DRW_Coord uy = ocs.vector(-sin(ins.angle), cos(ins.angle));
+    DRW_Coord org = ocs.point(ins.basePoint);
+    int cols = std::max(ins.colcount, 1);
+    int rows = std::max(ins.rowcount, 1);
+    for (int c = 0; c < cols; c += std::max(cols - 1, 1)) {
+        for (int r = 0; r < rows; r += std::max(rows - 1, 1)) {
+            for (int i = 0; i < 8; ++i) {
+                const DRW_Coord &cx = (i & 1) ? b.maxPoint : b.minPoint;
+                const DRW_Coord &cy = (i & 2) ? b.maxPoint : b.minPoint;
+                const DRW_Coord &cz = (i & 4) ? b.maxPoint : b.minPoint;
+                double x = (cx.x - base->second.x) * ins.xscale + c * ins.colspace;
+                double y = (cy.y - base->second.y) * ins.yscale + r * ins.rowspace;
+                double z = (cz.z - base->second.z) * ins.zscale;
+                box->add(along(along(org, ux, x, uy, y), ocs.n, z));
+            }
+        }
+    }
+    return true;
+}
+
+/*true if the block was read and has no unsolved inserts*/
+bool DRW_Extents::complete(const std::string &name) const{
+    return basePoints.find(name) != basePoints.end() && pending.find(name) == pending.end();
+}
+
+void DRW_Extents::beginBlock(const DRW_Block &b){
+    if (currentBox != NULL) //previous one not ended
+        endBlock();
+    current = b.name;
+    currentBase = b.basePoint;
+    currentBox = &blocks[current];
+    currentBox->clear();
+}
+
+void DRW_Extents::endBlock(){
+    if (currentBox != NULL)
+        basePoints[current] = currentBase;
+    current.clear();
+    currentBox = NULL;
+}
+
+void DRW_Extents::addToOwner(const DRW_Entity &e, const DRW_BBox &box){
+    ++bounded;
+    if (currentBox != NULL) {
+        currentBox->add(box);
+        return;
+    }
+    if (e.space == DRW::PaperSpace) {
+        paper.add(box);
+        if (indexed)
+            paperIndex.add(e.handle, box);
+    } else {
+        model.add(box);
+        if (indexed)
+            modelIndex.add(e.handle, box);
+    }
+    //entities come in runs on the same layer
+    if (lastLayerBox == NULL || !lastLayer.sameAs(e.layer)) {
+        lastLayer = e.layer;
+        lastLayerBox = &layers[e.layer.str()];
+    }
+    lastLayerBox->add(box);
+}
+
+void DRW_Extents::addEntity(DRW_Entity *e){
+    if (e->eType == DRW::INSERT) {
+        const DRW_Insert *ins = static_cast<const DRW_Insert *>(e);
+        if (!complete(ins->name)) {
+            e->bbox.clear();
+            if (currentBox != NULL)
+                pending[current].push_back(*ins);
+            else
+                pendingTop.push_back(*ins);
+            return;
+        }
+    }
+    DRW_BBox box;
+    if (!entityBounds(*e, &box)) {
+        e->bbox.clear();
+        return;
+    }
+    e->bbox = box;
+    addToOwner(*e, box);
+}
+
+/*solves the inserts of 'name' after the blocks they insert, 'stack' has
+ *the blocks being solved to skip recursive inserts*/
+void DRW_Extents::solveBlock(const std::string &name, std::vector<std::string> *stack){
+    std::map<std::string, std::vector<DRW_Insert> >::iterator it = pending.find(name);
+    if (it == pending.end() || std::find(stack->begin(), stack->end(), name) != stack->end())
+        return;
+    stack->push_back(name);
+    std::vector<DRW_Insert> inserts;
+    inserts.swap(it->second);
+    for (std::vector<DRW_Insert>::const_iterator ins = inserts.begin(); ins != inserts.end(); ++ins) {
+        solveBlock(ins->name, stack);
+        DRW_BBox box;
+        if (insertBounds(*ins, &box)) {
+            blocks[name].add(box);
+            ++bounded;
+        }
+    }
+    pending.erase(name);
+    stack->pop_back();
+}
+
+/*adds the inserts of blocks read after them*/
+void DRW_Extents::finish(){
+    currentBox = NULL;
+    std::vector<std::string> stack;
+    while (!pending.empty())
+        solveBlock(pending.begin()->first, &stack);
+    for (std::vector<DRW_Insert>::const_iterator ins = pendingTop.begin(); ins != pendingTop.end(); ++ins) {
+        DRW_BBox box;
+        if (insertBounds(*ins, &box))
+            addToOwner(*ins, box);
+    }
+    pendingTop.clear();
+    if (indexed) {
+        modelIndex.build();
+        paperIndex.build();
+    }
+}
@@ -0,0 +1,80 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_EXTENTS_H
+#define DRW_EXTENTS_H
+
+#include <string>
+#include <map>
+#include <vector>
+#include "drw_base.h"
+#include "drw_entities.h"
+#include "drw_spatial.h"
+
+//! Extents of a drawing, computed while it is read.
+/*!
+*  Enabled with setExtents(true) in dxfRW or dwgR, query it afterwards
+*  with getExtents(). Before an entity is handed to the interface its
+*  bounds in WCS are stored in DRW_Entity::bbox, and added to the box of
+*  its block, or to the box of its space and layer.
+*  Curves are bounded exactly. Text is estimated from the height and the
+*  number of characters, splines by their control points, the widths and
+*  thickness are ignored. Rays and xlines are unbounded, they are skipped.
+*  An insert of a block not complete yet (nested inserts in dwg) has no
+*  bbox, it is added to the summary at the end of the read.
+*  With setIndexed(true) the handles of the entities of each space are
+*  also packed in a spatial index at the end of the read.
+*/
+class DRW_Extents {
+public:
+    DRW_Extents(): indexed(false) { clear(); }
+    /** clears the results, keeps the settings */
+    void clear();
+    void setIndexed(bool enable) { indexed = enable; }
+    bool isIndexed() const { return indexed; }
+
+    /** bounds in WCS of 'e', inserts use the blocks read so far, false if it has none */
+    bool entityBounds(const DRW_Entity &e, DRW_BBox *box) const;
+
+    //used by the readers
+    void beginBlock(const DRW_Block &b);
+    void endBlock();
+    void addEntity(DRW_Entity *e);
+    void finish();
+
+public:
+    DRW_BBox model;                          /*!< model space */
+    DRW_BBox paper;                          /*!< paper space */
+    std::map<std::string, DRW_BBox> layers;  /*!< entities of the spaces per layer */
+    std::map<std::string, DRW_BBox> blocks;  /*!< block definitions, in block coordinates */
+    duint32 bounded;                         /*!< entities with bounds */
+    DRW_SpatialIndex modelIndex;             /*!< entities of model space, if indexed */
+    DRW_SpatialIndex paperIndex;             /*!< entities of paper space, if indexed */
+
+private:
+    bool insertBounds(const DRW_Insert &ins, DRW_BBox *box) const;
+    bool complete(const std::string &name) const;
+    void addToOwner(const DRW_Entity &e, const DRW_BBox &box);
+    void solveBlock(const std::string &name, std::vector<std::string> *stack);
+
+    std::map<std::string, DRW_Coord> basePoints;  /*!< base point of the ended blocks */
+    std::map<std::string, std::vector<DRW_Insert> > pending; /*!< unsolved inserts per block */
+    std::vector<DRW_Insert> pendingTop;  /*!< unsolved inserts of the spaces */
+    std::string current;                 /*!< block being read */
+    DRW_Coord currentBase;               /*!< its base point */
+    DRW_BBox *currentBox;                /*!< its box, NULL out of blocks */
+    DRW_Name lastLayer;
+    DRW_BBox *lastLayerBox;
+    bool indexed;
+};
+
+#endif // DRW_EXTENTS_H
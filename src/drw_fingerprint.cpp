@@ -0,0 +1,370 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_fingerprint.h"
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+const duint64 FNV_BASIS = 0xcbf29ce484222325ULL;
+const duint64 FNV_PRIME = 0x100000001b3ULL;
+
+//splitmix64 finalizer, spreads the bits of a value before it is combined
+duint64 mix(duint64 v){
+    v ^= v >> 30;
+    v *= 0xbf58476d1ce4e5b9ULL;
+    v ^= v >> 27;
+    v *= 0x94d049bb133111ebULL;
+    v ^= v >> 31;
+    return v;
+}
+
+duint64 stringHash(const std::string &s){
+    duint64 h = FNV_BASIS;
+    for (size_t i = 0; i < s.size(); ++i)
+        h = (h ^ static_cast<unsigned char>(s[i])) * FNV_PRIME;
+    return h;
+}
+
+duint64 doubleBits(double v){
+    if (v == 0.0)
+        v = 0.0;  //-0
+    duint64 bits;
+    memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+//! Combines the rounded & the exact values at once.
+/*!
+*  With 'values' the rounded values & the strings are kept too, to tell
+*  the entities with the same hash apart.
+*/
+class Hasher {
+public:
+    explicit Hasher(double q, std::vector<duint64> *v = NULL): quantum(q), rounded(FNV_BASIS), exact(FNV_BASIS), values(v) {}
+    void add(int v) { combine(static_cast<duint64>(static_cast<dint64>(v)), static_cast<duint64>(static_cast<dint64>(v))); }
+    void add(double v) { combine(round(v), doubleBits(v)); }
+    void add(const DRW_Coord &p) { add(p.x); add(p.y); add(p.z); }
+    void add(const std::string &s) {
+        if (values != NULL) {
+            values->push_back(s.size());
+            for (size_t i = 0; i < s.size(); i += 8) {
+                duint64 w = 0;
+                memcpy(&w, s.data() + i, std::min<size_t>(8, s.size() - i));
+                values->push_back(w);
+            }
+        }
+        duint64 h = stringHash(s);
+        combine(h, h);
+    }
+    duint64 round(double v) const {
+        if (quantum <= 0.0)
+            return doubleBits(v);
+        double s = v / quantum;
+        //too large to round or not a number
+        if (!(fabs(s) < 9.0e18))
+            return doubleBits(v);
+        return static_cast<duint64>(llround(s));
+    }
+    duint64 roundedHash() const { return mix(rounded); }
+    duint64 exactHash() const { return mix(exact); }
+
+private:
+    void combine(duint64 r, duint64 e) {
+        if (values != NULL)
+            values->push_back(r);
+        rounded = (rounded ^ mix(r)) * FNV_PRIME;
+        exact = (exact ^ mix(e)) * FNV_PRIME;
+    }
+    double quantum;
+    duint64 rounded;
+    duint64 exact;
+    std::vector<duint64> *values;
+};
+
+//true if 'a' goes before 'b' once rounded, orders the ends of lines
+bool pointBefore(const Hasher &h, const DRW_Coord &a, const DRW_Coord &b){
+    dint64 ax = static_cast<dint64>(h.round(a.x)), bx = static_cast<dint64>(h.round(b.x));
+    if (ax != bx)
+        return ax < bx;
+    dint64 ay = static_cast<dint64>(h.round(a.y)), by = static_cast<dint64>(h.round(b.y));
+    if (ay != by)
+        return ay < by;
+    return static_cast<dint64>(h.round(a.z)) < static_cast<dint64>(h.round(b.z));
+}
+
+void addPoint(Hasher *h, const DRW_Point &p){
+    h->add(p.basePoint);
+    h->add(p.thickness);
+    h->add(p.extPoint);
+}
+
+//geometry of 'e', false if its type is not hashed
+bool addGeometry(Hasher *h, const DRW_Entity &e){
+    h->add(static_cast<int>(e.eType));
+    switch (e.eType) {
+    case DRW::POINT:
+        addPoint(h, static_cast<const DRW_Point &>(e));
+        break;
+    case DRW::LINE: {
+        const DRW_Line &l = static_cast<const DRW_Line &>(e);
+        bool swap = pointBefore(*h, l.secPoint, l.basePoint);
+        h->add(swap ? l.secPoint : l.basePoint);
+        h->add(swap ? l.basePoint : l.secPoint);
+        h->add(l.thickness);
+        h->add(l.extPoint);
+        break; }
+    case DRW::RAY:
+    case DRW::XLINE: {
+        const DRW_Line &l = static_cast<const DRW_Line &>(e);
+        h->add(l.basePoint);
+        h->add(l.secPoint);
+        break; }
+    case DRW::CIRCLE: {
+        const DRW_Circle &c = static_cast<const DRW_Circle &>(e);
+        addPoint(h, c);
+        h->add(c.radious);
+        break; }
+    case DRW::ARC: {
+        const DRW_Arc &a = static_cast<const DRW_Arc &>(e);
+        addPoint(h, a);
+        h->add(a.radious);
+        h->add(a.staangle);
+        h->add(a.endangle);
+        h->add(a.isccw);
+        break; }
+    case DRW::ELLIPSE: {
+        const DRW_Ellipse &el = static_cast<const DRW_Ellipse &>(e);
+        addPoint(h, el);
+        h->add(el.secPoint);
+        h->add(el.ratio);
+        h->add(el.staparam);
+        h->add(el.endparam);
+        h->add(el.isccw);
+        break; }
+    case DRW::TRACE:
+    case DRW::SOLID:
+    case DRW::E3DFACE: {
+        const DRW_Trace &t = static_cast<const DRW_Trace &>(e);
+        addPoint(h, t);
+        h->add(t.secPoint);
+        h->add(t.thirdPoint);
+        h->add(t.fourPoint);
+        if (e.eType == DRW::E3DFACE)
+            h->add(static_cast<const DRW_3Dface &>(e).invisibleflag);
+        break; }
+    case DRW::LWPOLYLINE: {
+        const DRW_LWPolyline &pl = static_cast<const DRW_LWPolyline &>(e);
+        h->add(pl.flags);
+        h->add(pl.width);
+        h->add(pl.elevation);
+        h->add(pl.thickness);
+        h->add(pl.extPoint);
+        h->add(static_cast<int>(pl.vertlist.size()));
+        for (size_t i = 0; i < pl.vertlist.size(); ++i) {
+            const DRW_Vertex2D *v = pl.vertlist[i];
+            h->add(v->x);
+            h->add(v->y);
+            h->add(v->stawidth);
+            h->add(v->endwidth);
+            h->add(v->bulge);
+        }
+        break; }
+    case DRW::POLYLINE: {
+        const DRW_Polyline &pl = static_cast<const DRW_Polyline &>(e);
+        addPoint(h, pl);
+        h->add(pl.flags);
+        h->add(pl.defstawidth);
+        h->add(pl.defendwidth);
+        h->add(pl.vertexcount);
+        h->add(pl.facecount);
+        h->add(pl.curvetype);
+        h->add(static_cast<int>(pl.vertlist.size()));
+        for (size_t i = 0; i < pl.vertlist.size(); ++i) {
+            const DRW_Vertex *v = pl.vertlist[i];
+            h->add(v->basePoint);
+            h->add(v->stawidth);
+            h->add(v->endwidth);
+            h->add(v->bulge);
+            h->add(v->flags);
+            h->add(v->vindex1);
+            h->add(v->vindex2);
+            h->add(v->vindex3);
+            h->add(v->vindex4);
+        }
+        break; }
+    case DRW::SPLINE: {
+        const DRW_Spline &s = static_cast<const DRW_Spline &>(e);
+        h->add(s.normalVec);
+        h->add(s.tgStart);
+        h->add(s.tgEnd);
+        h->add(s.flags);
+        h->add(s.degree);
+        h->add(static_cast<int>(s.knotslist.size()));
+        for (size_t i = 0; i < s.knotslist.size(); ++i)
+            h->add(s.knotslist[i]);
+        h->add(static_cast<int>(s.controllist.size()));
+        for (size_t i = 0; i < s.controllist.size(); ++i)
+            h->add(*s.controllist[i]);
+        h->add(static_cast<int>(s.weightlist.size()));
+        for (size_t i = 0; i < s.weightlist.size(); ++i)
+            h->add(s.weightlist[i]);
+        h->add(static_cast<int>(s.fitlist.size()));
+        for (size_t i = 0; i < s.fitlist.size(); ++i)
+            h->add(*s.fitlist[i]);
+        break; }
+    case DRW::TEXT:
+    case DRW::MTEXT: {
+        const DRW_Text &t = static_cast<const DRW_Text &>(e);
+        addPoint(h, t);
+        h->add(t.secPoint);
+        h->add(t.text);
+        h->add(t.style.str());
+        h->add(t.height);
+        h->add(t.angle);
+        h->add(t.widthscale);
+        h->add(t.oblique);
+        h->add(t.textgen);
+        h->add(static_cast<int>(t.alignH));
+        h->add(static_cast<int>(t.alignV));
+        if (e.eType == DRW::MTEXT)
+            h->add(static_cast<const DRW_MText &>(e).interlin);
+        break; }
+    case DRW::INSERT: {
+        const DRW_Insert &ins = static_cast<const DRW_Insert &>(e);
+        addPoint(h, ins);
+        h->add(ins.name);
+        h->add(ins.xscale);
+        h->add(ins.yscale);
+        h->add(ins.zscale);
+        h->add(ins.angle);
+        h->add(ins.colcount);
+        h->add(ins.rowcount);
+        h->add(ins.colspace);
+        h->add(ins.rowspace);
+        break; }
+    case DRW::HATCH: {
+        const DRW_Hatch &ht = static_cast<const DRW_Hatch &>(e);
+        addPoint(h, ht);
+        h->add(ht.name);
+        h->add(ht.solid);
+        h->add(ht.hstyle);
+        h->add(ht.hpattern);
+        h->add(ht.doubleflag);
+        h->add(ht.angle);
+        h->add(ht.scale);
+        h->add(static_cast<int>(ht.looplist.size()));
+        for (size_t i = 0; i < ht.looplist.size(); ++i) {
+            const DRW_HatchLoop *loop = ht.looplist[i];
+            h->add(loop->type);
+            h->add(static_cast<int>(loop->objlist.size()));
+            for (size_t j = 0; j < loop->objlist.size(); ++j)
+                addGeometry(h, *loop->objlist[j]);
+        }
+        h->add(static_cast<int>(ht.patternlines.size()));
+        for (size_t i = 0; i < ht.patternlines.size(); ++i) {
+            const DRW_HatchPatternLine &pl = ht.patternlines[i];
+            h->add(pl.angle);
+            h->add(pl.base);
+            h->add(pl.offset);
+            h->add(static_cast<int>(pl.dashes.size()));
+            for (size_t j = 0; j < pl.dashes.size(); ++j)
+                h->add(pl.dashes[j]);
+        }
+        break; }
+    default:
+        return false;
+    }
+    return true;
+}
+
+} //namespace
+
+void DRW_Fingerprints::clear(){
+    duplicates.clear();
+    hashed = dropped = 0;
+    seen.clear();
+    block = 0;
+}
+
+duint64 DRW_Fingerprints::hash(const DRW_Entity &e, duint64 *exact) const {
+    return hash(e, exact, NULL);
+}
+
+duint64 DRW_Fingerprints::hash(const DRW_Entity &e, duint64 *exact, std::vector<duint64> *values) const {
+    Hasher h(quantum, values);
+    if (!addGeometry(&h, e)) {
+        if (exact != NULL)
+            *exact = 0;
+        return 0;
+    }
+    if (properties) {
+        h.add(e.layer.str());
+        h.add(e.lineType.str());
+        h.add(e.color);
+        h.add(e.color24);
+        h.add(static_cast<int>(e.lWeight));
+        h.add(e.ltypeScale);
+        h.add(e.transparency);
+        h.add(e.visible ? 1 : 0);
+    }
+    //0 is for the entities not hashed
+    duint64 r = h.roundedHash();
+    if (exact != NULL) {
+        *exact = h.exactHash();
+        if (*exact == 0)
+            *exact = 1;
+    }
+    return r == 0 ? 1 : r;
+}
+
+void DRW_Fingerprints::beginBlock(const DRW_Block &b){
+    block = mix(stringHash(b.name));
+}
+
+void DRW_Fingerprints::endBlock(){
+    block = 0;
+}
+
+bool DRW_Fingerprints::addEntity(DRW_Entity *e){
+    duint64 exact;
+    First first;
+    e->fingerprint = hash(*e, &exact, mode == HASH ? NULL : &first.values);
+    if (e->fingerprint == 0)
+        return true;
+    ++hashed;
+    if (mode == HASH)
+        return true;
+    //duplicates in the same block or space
+    duint64 scope = block != 0 ? block : mix(static_cast<duint64>(e->space) + 1);
+    first.handle = e->handle;
+    first.exact = exact;
+    std::pair<std::unordered_map<duint64, First>::iterator, bool> it =
+            seen.insert(std::make_pair(e->fingerprint ^ scope, First()));
+    if (it.second) {
+        it.first->second.handle = first.handle;
+        it.first->second.exact = first.exact;
+        it.first->second.values.swap(first.values);
+        return true;
+    }
+    //the same hash for other values is not a duplicate
+    if (it.first->second.values != first.values)
+        return true;
+    DRW_Duplicate d = {e->handle, it.first->second.handle, it.first->second.exact == exact};
+    duplicates.push_back(d);
+    if (mode != DROP)
+        return true;
+    ++dropped;
+    return false;
+}
@@ -0,0 +1,92 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_FINGERPRINT_H
+#define DRW_FINGERPRINT_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "drw_base.h"
+#include "drw_entities.h"
+
+//! Entity found again in the same block or space.
+struct DRW_Duplicate {
+    duint32 handle;    /*!< the duplicate */
+    duint32 original;  /*!< first entity with the same fingerprint */
+    bool exact;        /*!< equal values, not only once rounded */
+};
+
+//! Content hashes of the entities & their duplicates.
+/*!
+*  The fingerprint is a 64 bit hash of the type, the geometry &, if
+*  enabled, the properties (layer, line type, color, line weight, line
+*  type scale, transparency & visibility) of an entity. Handles & owners
+*  are not part of it, the hash is the same in every read & platform and
+*  can be used as a cache key.
+*  Coordinates, sizes & angles are rounded to multiples of the quantum,
+*  entities closer than it are near duplicates; two values on both sides
+*  of a multiple still differ. Lines are the same in both directions.
+*  Points, lines, rays, xlines, circles, arcs, ellipses, traces, solids,
+*  3d faces, polylines, splines, texts, inserts & hatches are hashed, the
+*  others have fingerprint 0 and are never duplicates.
+*  Duplicates are searched in the same block or space, the first entity
+*  is kept. Entities with the same fingerprint are compared value by
+*  value once rounded, a collision is not taken for a duplicate.
+*/
+class DRW_Fingerprints {
+public:
+    enum Mode {
+        HASH,    /*!< sets DRW_Entity::fingerprint */
+        REPORT,  /*!< also lists the duplicates */
+        DROP     /*!< also removes the duplicates from the read */
+    };
+
+    DRW_Fingerprints(): quantum(1.0e-6), properties(true), mode(HASH) { clear(); }
+    /** clears the results, keeps the settings */
+    void clear();
+    /** 0 to hash the exact values */
+    void setQuantum(double q) { quantum = q > 0.0 ? q : 0.0; }
+    double getQuantum() const { return quantum; }
+    void setProperties(bool enable) { properties = enable; }
+    void setMode(Mode m) { mode = m; }
+    Mode getMode() const { return mode; }
+
+    /** fingerprint of 'e', 0 if its type is not hashed; 'exact' gets the hash without rounding */
+    duint64 hash(const DRW_Entity &e, duint64 *exact = NULL) const;
+
+    //used by the readers
+    void beginBlock(const DRW_Block &b);
+    void endBlock();
+    /** sets the fingerprint of 'e', false if it is a duplicate to drop */
+    bool addEntity(DRW_Entity *e);
+
+public:
+    std::vector<DRW_Duplicate> duplicates;  /*!< in read order, REPORT & DROP modes */
+    duint32 hashed;                         /*!< entities with a fingerprint */
+    duint32 dropped;                        /*!< duplicates removed, DROP mode */
+
+private:
+    struct First {
+        duint32 handle;
+        duint64 exact;
+        std::vector<duint64> values;  /*!< rounded values & strings, compared on equal hashes */
+    };
+    duint64 hash(const DRW_Entity &e, duint64 *exact, std::vector<duint64> *values) const;
+    std::unordered_map<duint64, First> seen;  /*!< fingerprint & scope of the entities kept */
+    duint64 block;                            /*!< hash of the block being read, 0 out of blocks */
+    double quantum;
+    bool properties;
+    Mode mode;
+};
+
+#endif // DRW_FINGERPRINT_H
@@ -0,0 +1,272 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_hatchfill.h"
+#include "intern/drw_threads.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+
+namespace {
+
+const double JOIN_TOLERANCE = 1.0e-9;  //ends of edges closer than this are the same point
+
+double distance2(const DRW_Coord &a, const DRW_Coord &b){
+    double dx = a.x - b.x, dy = a.y - b.y;
+    return dx*dx + dy*dy;
+}
+
+//! Polygon edge in the frame of a pattern line, v along the scanlines offset.
+struct Edge {
+    double vlo;    //the edge crosses scanlines with vlo <= v < vhi
+    double vhi;
+    double ulo;    //u at vlo
+    double slope;  //du/dv
+};
+
+bool edgeBefore(const Edge &a, const Edge &b){
+    return a.vlo < b.vlo;
+}
+
+} //namespace
+
+void DRW_HatchFill::loopPoints(const DRW_HatchLoop &loop, double elevation, std::vector<DRW_Coord> *out) const {
+    std::vector<DRW_Coord> pts;
+    const DRW_Coord normal(0.0, 0.0, 1.0);
+    for (size_t i = 0; i < loop.objlist.size(); ++i) {
+        const DRW_Entity *e = loop.objlist[i];
+        pts.clear();
+        bool reversed = false;
+        switch (e->eType) {
+        case DRW::LINE: {
+            const DRW_Line *l = static_cast<const DRW_Line *>(e);
+            pts.push_back(l->basePoint);
+            pts.push_back(l->secPoint);
+            break; }
+        case DRW::ARC: {
+            const DRW_Arc *a = static_cast<const DRW_Arc *>(e);
+            if (a->isccw) {
+                tessellator.arc(a->basePoint, a->radious, a->staangle, a->endangle, &pts);
+            } else {
+                //clockwise from -start to -end
+                tessellator.arc(a->basePoint, a->radious, -a->endangle, -a->staangle, &pts);
+                reversed = true;
+            }
+            break; }
+        case DRW::ELLIPSE: {
+            const DRW_Ellipse *el = static_cast<const DRW_Ellipse *>(e);
+            if (el->isccw) {
+                tessellator.ellipse(el->basePoint, el->secPoint, el->ratio, normal, el->staparam, el->endparam, &pts);
+            } else {
+                tessellator.ellipse(el->basePoint, el->secPoint, el->ratio, normal, -el->endparam, -el->staparam, &pts);
+                reversed = true;
+            }
+            break; }
+        case DRW::SPLINE:
+            tessellator.spline(*static_cast<const DRW_Spline *>(e), &pts);
+            break;
+        case DRW::LWPOLYLINE: {
+            //a polyline boundary is closed whatever its flag
+            const std::vector<DRW_Vertex2D *> &v = static_cast<const DRW_LWPolyline *>(e)->vertlist;
+            for (size_t j = 0; j < v.size(); ++j) {
+                DRW_Coord p(v[j]->x, v[j]->y, 0.0);
+                const DRW_Vertex2D *w = v[(j + 1) % v.size()];
+                if (j == 0)
+                    pts.push_back(p);
+                tessellator.bulge(p, DRW_Coord(w->x, w->y, 0.0), v[j]->bulge, &pts);
+            }
+            break; }
+        default:
+            break;
+        }
+        if (pts.empty())
+            continue;
+        if (reversed)
+            std::reverse(pts.begin(), pts.end());
+        //edges written backwards are turned to join the previous one
+        if (!out->empty() && distance2(out->back(), pts.back()) < distance2(out->back(), pts.front()))
+            std::reverse(pts.begin(), pts.end());
+        for (size_t j = 0; j < pts.size(); ++j) {
+            DRW_Coord p(pts[j].x, pts[j].y, elevation);
+            if (out->empty() || distance2(out->back(), p) > JOIN_TOLERANCE * JOIN_TOLERANCE)
+                out->push_back(p);
+        }
+    }
+    if (out->size() > 1 && distance2(out->front(), out->back()) <= JOIN_TOLERANCE * JOIN_TOLERANCE)
+        out->pop_back();
+}
+
+bool DRW_HatchFill::boundaries(const DRW_Hatch &h, std::vector<std::vector<DRW_Coord> > *loops) const {
+    for (size_t i = 0; i < h.looplist.size(); ++i) {
+        std::vector<DRW_Coord> pts;
+        loopPoints(*h.looplist[i], h.basePoint.z, &pts);
+        if (pts.size() > 2)
+            loops->push_back(pts);
+    }
+    return !loops->empty();
+}
+
+bool DRW_HatchFill::clip(const DRW_HatchPatternLine &line, const std::vector<std::vector<DRW_Coord> > &loops,
+                         double elevation, std::vector<DRW_Coord> *out) const {
+    double a = line.angle / ARAD;
+    const DRW_Coord d(cos(a), sin(a), 0.0);
+    const DRW_Coord n(-d.y, d.x, 0.0);
+    double spacing = line.offset.x * n.x + line.offset.y * n.y;
+    double shift = line.offset.x * d.x + line.offset.y * d.y;
+    if (fabs(spacing) < 1.0e-12)
+        return true;
+    if (spacing < 0) {
+        spacing = -spacing;
+        shift = -shift;
+    }
+    double u0 = line.base.x * d.x + line.base.y * d.y;
+    double v0 = line.base.x * n.x + line.base.y * n.y;
+
+    std::vector<Edge> edges;
+    double vmin = 0, vmax = 0;
+    for (size_t i = 0; i < loops.size(); ++i) {
+        const std::vector<DRW_Coord> &pts = loops[i];
+        for (size_t j = 0; j < pts.size(); ++j) {
+            const DRW_Coord &p = pts[j];
+            const DRW_Coord &q = pts[(j + 1) % pts.size()];
+            double pu = p.x * d.x + p.y * d.y, pv = p.x * n.x + p.y * n.y;
+            double qu = q.x * d.x + q.y * d.y, qv = q.x * n.x + q.y * n.y;
+            if (pv == qv)
+                continue;
+            Edge e;
+            if (pv < qv) {
+                e.vlo = pv; e.vhi = qv; e.ulo = pu;
+            } else {
+                e.vlo = qv; e.vhi = pv; e.ulo = qu;
+            }
+            e.slope = (qu - pu) / (qv - pv);
+            if (edges.empty()) {
+                vmin = e.vlo; vmax = e.vhi;
+            } else {
+                vmin = std::min(vmin, e.vlo); vmax = std::max(vmax, e.vhi);
+            }
+            edges.push_back(e);
+        }
+    }
+    if (edges.empty())
+        return true;
+    std::sort(edges.begin(), edges.end(), edgeBefore);
+
+    double period = 0.0;
+    for (size_t i = 0; i < line.dashes.size(); ++i)
+        period += fabs(line.dashes[i]);
+    bool continuous = line.dashes.empty() || period < 1.0e-12;
+
+    double kFirst = ceil((vmin - v0) / spacing);
+    double kLast = floor((vmax - v0) / spacing);
+    if (kLast - kFirst > static_cast<double>(maxSegments))
+        return false;
+    std::vector<const Edge *> active;
+    std::vector<double> crossings;
+    size_t next = 0;
+    for (double k = kFirst; k <= kLast; k += 1.0) {
+        double v = v0 + k * spacing;
+        while (next < edges.size() && edges[next].vlo <= v)
+            active.push_back(&edges[next++]);
+        crossings.clear();
+        size_t kept = 0;
+        for (size_t i = 0; i < active.size(); ++i) {
+            const Edge *e = active[i];
+            if (e->vhi <= v)
+                continue;
+            active[kept++] = e;
+            crossings.push_back(e->ulo + (v - e->vlo) * e->slope);
+        }
+        active.resize(kept);
+        std::sort(crossings.begin(), crossings.end());
+        double phase = u0 + k * shift;
+        for (size_t i = 0; i + 1 < crossings.size(); i += 2) {
+            double from = crossings[i], to = crossings[i + 1];
+            if (to <= from)
+                continue;
+            if (continuous) {
+                if (out->size() / 2 >= maxSegments)
+                    return false;
+                out->push_back(DRW_Coord(from * d.x + v * n.x, from * d.y + v * n.y, elevation));
+                out->push_back(DRW_Coord(to * d.x + v * n.x, to * d.y + v * n.y, elevation));
+                continue;
+            }
+            if ((to - from) / period > static_cast<double>(maxSegments))
+                return false;
+            double pos = phase + floor((from - phase) / period) * period;
+            while (pos <= to) {
+                for (size_t j = 0; j < line.dashes.size() && pos <= to; ++j) {
+                    double dash = line.dashes[j];
+                    double end = pos + fabs(dash);
+                    if (dash >= 0.0) {
+                        double s = std::max(from, pos), t = std::min(to, end);
+                        //a dot is kept inside, a dash if something of it is
+                        if (dash == 0.0 ? (pos >= from) : (t > s)) {
+                            if (out->size() / 2 >= maxSegments)
+                                return false;
+                            out->push_back(DRW_Coord(s * d.x + v * n.x, s * d.y + v * n.y, elevation));
+                            out->push_back(DRW_Coord(t * d.x + v * n.x, t * d.y + v * n.y, elevation));
+                        }
+                    }
+                    pos = end;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool DRW_HatchFill::fill(const DRW_Hatch &h, DRW_HatchGeometry *out) const {
+    out->clear();
+    std::vector<std::vector<DRW_Coord> > all;
+    std::vector<int> types;
+    for (size_t i = 0; i < h.looplist.size(); ++i) {
+        std::vector<DRW_Coord> pts;
+        loopPoints(*h.looplist[i], h.basePoint.z, &pts);
+        if (pts.size() > 2) {
+            all.push_back(pts);
+            types.push_back(h.looplist[i]->type);
+        }
+    }
+    if (all.empty())
+        return false;
+    //loop types: 1 external, 16 outermost
+    int wanted = h.hstyle == 1 ? (1 | 16) : (h.hstyle == 2 ? 1 : 0);
+    bool flagged = false;
+    for (size_t i = 0; i < types.size() && wanted; ++i)
+        flagged |= (types[i] & wanted) != 0;
+    for (size_t i = 0; i < all.size(); ++i) {
+        if (!flagged || (types[i] & wanted))
+            out->loops.push_back(all[i]);
+    }
+    if (h.solid)
+        return true;
+    for (size_t i = 0; i < h.patternlines.size(); ++i) {
+        if (!clip(h.patternlines[i], out->loops, h.basePoint.z, &out->segments)) {
+            out->truncated = true;
+            break;
+        }
+    }
+    return true;
+}
+
+void DRW_HatchFill::fill(const std::vector<const DRW_Hatch *> &hatches, std::vector<DRW_HatchGeometry> *out) const {
+    out->clear();
+    out->resize(hatches.size());
+    unsigned int n = DRW::threadCount(threads, hatches.size());
+    //hatches differ much in cost, each thread takes the next one left
+    std::atomic<size_t> next(0);
+    DRW::runJobs(n, [&](unsigned int) {
+        for (size_t i = next++; i < hatches.size(); i = next++)
+            fill(*hatches[i], &(*out)[i]);
+    });
+}
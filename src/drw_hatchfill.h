@@ -0,0 +1,74 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_HATCHFILL_H
+#define DRW_HATCHFILL_H
+
+#include <vector>
+#include "drw_base.h"
+#include "drw_entities.h"
+#include "drw_tessellate.h"
+
+//! Boundary polygons & pattern dashes of a hatch, in its OCS.
+class DRW_HatchGeometry {
+public:
+    DRW_HatchGeometry(): truncated(false) {}
+    void clear() { loops.clear(); segments.clear(); truncated = false; }
+
+public:
+    std::vector<std::vector<DRW_Coord> > loops;  /*!< polygons bounding the fill, the first point not repeated */
+    std::vector<DRW_Coord> segments;             /*!< pattern dashes, start & end points in pairs, a dot twice */
+    bool truncated;                              /*!< the pattern stopped at the maximum of segments */
+};
+
+//! Turns the loops of hatches in polygons & clips their patterns.
+/*!
+*  Lines, arcs, ellipses, splines & polylines of the loops are joined in
+*  closed polygons by the tessellator; arcs & ellipses not counterclockwise
+*  have mirrored angles. Islands follow the hatch style: normal (0) is even
+*  odd on all the loops, outer (1) only uses the external & outermost ones,
+*  ignore (2) only the external ones.
+*  Each line of the pattern is a family of parallel lines, swept as
+*  scanlines over the polygon edges sorted by their start, with a list of
+*  the active edges; the crossings of a scanline are paired inside, then
+*  cut by the dashes.
+*  Solid hatches only get their loops. The hatches of a list are filled in
+*  parallel, the results are in the order of the list.
+*/
+class DRW_HatchFill {
+public:
+    DRW_HatchFill(): maxSegments(1000000), threads(0) {}
+    /** curves of the loops are approximated by 't' */
+    void setTessellator(const DRW_Tessellator &t) { tessellator = t; }
+    /** dashes of a hatch at most, dense patterns on large areas stop there */
+    void setMaxSegments(size_t count) { maxSegments = count; }
+    /** threads used to fill a list, 0 is one per core */
+    void setThreads(unsigned int count) { threads = count; }
+
+    /** all the loops as closed polygons, false if the hatch has none */
+    bool boundaries(const DRW_Hatch &h, std::vector<std::vector<DRW_Coord> > *loops) const;
+    /** the loops used by the style of the hatch and the dashes of its pattern inside them */
+    bool fill(const DRW_Hatch &h, DRW_HatchGeometry *out) const;
+    /** fills the hatches in parallel, 'out' gets one result for each one */
+    void fill(const std::vector<const DRW_Hatch *> &hatches, std::vector<DRW_HatchGeometry> *out) const;
+
+private:
+    void loopPoints(const DRW_HatchLoop &loop, double elevation, std::vector<DRW_Coord> *out) const;
+    bool clip(const DRW_HatchPatternLine &line, const std::vector<std::vector<DRW_Coord> > &loops,
+              double elevation, std::vector<DRW_Coord> *out) const;
+
+    DRW_Tessellator tessellator;
+    size_t maxSegments;
+    unsigned int threads;
+};
+
+#endif // DRW_HATCHFILL_H
@@ -1599,7 +1599,7 @@ void DRW_Header::write(dxfWriter *writer, DRW::Version ver){
         else
             writer->writeDouble(40, 1.0);
         writer->writeString(9, "$NORTHDIRECTION");
-        if (getDouble("$LONGITUDE", &varDouble))
+        if (getDouble("$NORTHDIRECTION", &varDouble))
             writer->writeDouble(40, varDouble);
         else
             writer->writeDouble(40, 0.0);
@@ -1662,13 +1662,6 @@ void DRW_Header::write(dxfWriter *writer, DRW::Version ver){
         else
             writer->writeDouble(40, 0.0);
     }
-
-#ifdef DRW_DBG
-    std::map<std::string,DRW_Variant *>::const_iterator it;
-    for ( it=vars.begin() ; it != vars.end(); ++it ){
-        DRW_DBG((*it).first); DRW_DBG("\n");
-    }
-#endif
 }
 
 void DRW_Header::addDouble(std::string key, double value, int code){
@@ -1691,9 +1684,9 @@ void DRW_Header::addCoord(std::string key, DRW_Coord value, int code){
     vars[key] =curr;
 }
 
-bool DRW_Header::getDouble(std::string key, double *varDouble){
+bool DRW_Header::getDouble(std::string key, double *varDouble) const{
     bool result = false;
-    std::map<std::string,DRW_Variant *>::iterator it;
+    std::map<std::string,DRW_Variant *>::const_iterator it;
     it=vars.find( key);
     if (it != vars.end()) {
         DRW_Variant *var = (*it).second;
@@ -1701,15 +1694,13 @@ bool DRW_Header::getDouble(std::string key, double *varDouble){
             *varDouble = var->content.d;
             result = true;
         }
-        delete var;
-        vars.erase (it);
     }
     return result;
 }
 
-bool DRW_Header::getInt(std::string key, int *varInt){
+bool DRW_Header::getInt(std::string key, int *varInt) const{
     bool result = false;
-    std::map<std::string,DRW_Variant *>::iterator it;
+    std::map<std::string,DRW_Variant *>::const_iterator it;
     it=vars.find( key);
     if (it != vars.end()) {
         DRW_Variant *var = (*it).second;
@@ -1717,15 +1708,13 @@ bool DRW_Header::getInt(std::string key, int *varInt){
             *varInt = var->content.i;
             result = true;
         }
-        delete var;
-        vars.erase (it);
     }
     return result;
 }
 
-bool DRW_Header::getStr(std::string key, std::string *varStr){
+bool DRW_Header::getStr(std::string key, std::string *varStr) const{
     bool result = false;
-    std::map<std::string,DRW_Variant *>::iterator it;
+    std::map<std::string,DRW_Variant *>::const_iterator it;
     it=vars.find( key);
     if (it != vars.end()) {
         DRW_Variant *var = (*it).second;
@@ -1733,15 +1722,13 @@ bool DRW_Header::getStr(std::string key, std::string *varStr){
             *varStr = *var->content.s;
             result = true;
         }
-        delete var;
-        vars.erase (it);
     }
     return result;
 }
 
-bool DRW_Header::getCoord(std::string key, DRW_Coord *varCoord){
+bool DRW_Header::getCoord(std::string key, DRW_Coord *varCoord) const{
     bool result = false;
-    std::map<std::string,DRW_Variant *>::iterator it;
+    std::map<std::string,DRW_Variant *>::const_iterator it;
     it=vars.find( key);
     if (it != vars.end()) {
         DRW_Variant *var = (*it).second;
@@ -1749,8 +1736,6 @@ bool DRW_Header::getCoord(std::string key, DRW_Coord *varCoord){
             *varCoord = *var->content.v;
             result = true;
         }
-        delete var;
-        vars.erase (it);
     }
     return result;
 }
@@ -2366,7 +2351,7 @@ bool DRW_Header::parseDwg(DRW::Version version, dwgBuffer *buf, dwgBuffer *hBbuf
     DRW_DBG("  string buf bit position: "); DRW_DBG(buf->getBitPos());
 
     if (DRW_DBGGL == DRW_dbg::DEBUG){
-        for (std::map<std::string,DRW_Variant*>::iterator it=vars.begin(); it!=vars.end(); ++it){
+        for (std::map<std::string,DRW_Variant*>::const_iterator it=vars.begin(); it!=vars.end(); ++it){
             DRW_DBG("\n"); DRW_DBG(it->first); DRW_DBG(": ");
             switch (it->second->type()){
             case DRW_Variant::INTEGER:
@@ -16,6 +16,7 @@
 
 #include <map>
 #include "drw_base.h"
+#include "drw_shared.h"
 
 class dxfReader;
 class dxfWriter;
@@ -26,9 +27,9 @@ class dwgBuffer;
 
 //! Class to handle header entries
 /*!
-*  Class to handle header vars, to read iterate over "std::map vars"
-*  to write add a DRW_Variant* into "std::map vars" (do not delete it, are cleared in dtor)
-*  or use add* helper functions.
+*  Class to handle header vars, to read iterate over "vars" as a std::map
+*  to write add a DRW_Variant* into "vars" (do not delete it, are cleared in dtor)
+*  or use add* helper functions. Copies share the vars until one changes.
 *  @author Rallaz
 */
 class DRW_Header {
@@ -42,19 +43,14 @@ public:
     DRW_Header(const DRW_Header& h){
         this->version = h.version;
         this->comments = h.comments;
-        for (std::map<std::string,DRW_Variant*>::const_iterator it=h.vars.begin(); it!=h.vars.end(); ++it){
-            this->vars[it->first] = new DRW_Variant( *(it->second) );
-        }
+        this->vars = h.vars; //shared until changed
         this->curr = NULL;
     }
     DRW_Header& operator=(const DRW_Header &h) {
        if(this != &h) {
-           clearVars();
            this->version = h.version;
            this->comments = h.comments;
-           for (std::map<std::string,DRW_Variant*>::const_iterator it=h.vars.begin(); it!=h.vars.end(); ++it){
-               this->vars[it->first] = new DRW_Variant( *(it->second) );
-           }
+           this->vars = h.vars;
        }
        return *this;
     }
@@ -71,19 +67,16 @@ protected:
     void parseCode(int code, dxfReader *reader);
     bool parseDwg(DRW::Version version, dwgBuffer *buf, dwgBuffer *hBbuf, duint8 mv=0);
 private:
-    bool getDouble(std::string key, double *varDouble);
-    bool getInt(std::string key, int *varInt);
-    bool getStr(std::string key, std::string *varStr);
-    bool getCoord(std::string key, DRW_Coord *varStr);
+    bool getDouble(std::string key, double *varDouble) const;
+    bool getInt(std::string key, int *varInt) const;
+    bool getStr(std::string key, std::string *varStr) const;
+    bool getCoord(std::string key, DRW_Coord *varStr) const;
     void clearVars(){
-        for (std::map<std::string,DRW_Variant*>::iterator it=vars.begin(); it!=vars.end(); ++it)
-            delete it->second;
-
         vars.clear();
     }
 
 public:
-    std::map<std::string,DRW_Variant*> vars;
+    DRW_HeaderVars vars;
 private:
     std::string comments;
     std::string name;
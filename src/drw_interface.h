@@ -14,11 +14,14 @@
 #define DRW_INTERFACE_H
 
 #include <cstring>
+#include <memory>
 
 #include "drw_entities.h"
 #include "drw_objects.h"
 #include "drw_header.h"
 
+class DRW_BlockDef;
+
 /**
  * Abstract class (interface) for comunicate dxfReader with the application.
  * Inherit your class which takes care of the entities in the 
@@ -185,6 +188,49 @@ public:
      */
     virtual void addComment(const char* comment) = 0;
 
+    /**
+     * Entity callbacks with ownership transfer. The reader calls these,
+     * by default they forward to the add functions above. Override them
+     * to keep the entity without copying it, e.g. new DRW_Line(std::move(data)),
+     * the vertex lists and extended data are taken, not copied.
+     */
+    virtual void takePoint(DRW_Point&& data) { addPoint(data); }
+    virtual void takeLine(DRW_Line&& data) { addLine(data); }
+    virtual void takeRay(DRW_Ray&& data) { addRay(data); }
+    virtual void takeXline(DRW_Xline&& data) { addXline(data); }
+    virtual void takeArc(DRW_Arc&& data) { addArc(data); }
+    virtual void takeCircle(DRW_Circle&& data) { addCircle(data); }
+    virtual void takeEllipse(DRW_Ellipse&& data) { addEllipse(data); }
+    virtual void takeLWPolyline(DRW_LWPolyline&& data) { addLWPolyline(data); }
+    virtual void takePolyline(DRW_Polyline&& data) { addPolyline(data); }
+    virtual void takeSpline(DRW_Spline&& data) { addSpline(&data); }
+    virtual void takeInsert(DRW_Insert&& data) { addInsert(data); }
+    virtual void takeTrace(DRW_Trace&& data) { addTrace(data); }
+    virtual void take3dFace(DRW_3Dface&& data) { add3dFace(data); }
+    virtual void takeSolid(DRW_Solid&& data) { addSolid(data); }
+    virtual void takeMText(DRW_MText&& data) { addMText(data); }
+    virtual void takeText(DRW_Text&& data) { addText(data); }
+    virtual void takeDimAlign(DRW_DimAligned&& data) { addDimAlign(&data); }
+    virtual void takeDimLinear(DRW_DimLinear&& data) { addDimLinear(&data); }
+    virtual void takeDimRadial(DRW_DimRadial&& data) { addDimRadial(&data); }
+    virtual void takeDimDiametric(DRW_DimDiametric&& data) { addDimDiametric(&data); }
+    virtual void takeDimAngular(DRW_DimAngular&& data) { addDimAngular(&data); }
+    virtual void takeDimAngular3P(DRW_DimAngular3p&& data) { addDimAngular3P(&data); }
+    virtual void takeDimOrdinate(DRW_DimOrdinate&& data) { addDimOrdinate(&data); }
+    virtual void takeLeader(DRW_Leader&& data) { addLeader(&data); }
+    virtual void takeHatch(DRW_Hatch&& data) { addHatch(&data); }
+    virtual void takeViewport(DRW_Viewport&& data) { addViewport(data); }
+    virtual void takeImage(DRW_Image&& data) { addImage(&data); }
+
+    /**
+     * Called instead of addBlock(), the entities & endBlock() when the
+     * reader has a DRW_BlockCache. 'def' can be shared with other drawings
+     * and must not be changed, keep it to avoid copying the entities.
+     * By default calls addBlock(), the add functions with the entities of
+     * 'def' & endBlock().
+     */
+    virtual void takeBlockDefinition(const DRW_Block& data, const std::shared_ptr<const DRW_BlockDef>& def);
+
     virtual void writeHeader(DRW_Header& data) = 0;
     virtual void writeBlocks() = 0;
     virtual void writeBlockRecords() = 0;
@@ -0,0 +1,168 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_linetype.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+const size_t DASH_POINTS = 256;  //points of a dash handed at once
+}
+
+DRW_Dasher::DRW_Dasher(): sink(NULL), index(0), remaining(0), epsilon(0), dashes(0),
+    maxDashes(1000000), solid(true) {
+    points.reserve(DASH_POINTS);
+}
+
+void DRW_Dasher::setPattern(const std::vector<double> &path, double scale){
+    pattern.clear();
+    double total = 0;
+    for (size_t i = 0; i < path.size(); ++i) {
+        pattern.push_back(path[i] * scale);
+        total += fabs(path[i] * scale);
+    }
+    //without length the pattern is solid
+    if (total <= 0.0)
+        pattern.clear();
+}
+
+void DRW_Dasher::begin(const DRW_Coord &p, double entityScale){
+    end();
+    elements.clear();
+    double total = 0;
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        elements.push_back(pattern[i] * entityScale);
+        total += fabs(elements.back());
+    }
+    solid = total <= 0.0;
+    epsilon = total * 1.0e-9;
+    current = p;
+    index = 0;
+    remaining = solid ? 0 : fabs(elements[0]);
+    dashes = 0;
+    if (solid)
+        points.push_back(p);
+}
+
+void DRW_Dasher::next(){
+    index = (index + 1) % elements.size();
+    remaining = fabs(elements[index]);
+}
+
+void DRW_Dasher::addPoint(const DRW_Coord &p){
+    if (points.size() >= DASH_POINTS) {
+        DRW_Coord last = points.back();
+        if (sink)
+            sink->dash(&points[0], points.size());
+        points.clear();
+        points.push_back(last);
+    }
+    points.push_back(p);
+}
+
+void DRW_Dasher::flush(){
+    if (!points.empty() && sink)
+        sink->dash(&points[0], points.size());
+    points.clear();
+}
+
+void DRW_Dasher::lineTo(const DRW_Coord &p){
+    double dx = p.x - current.x, dy = p.y - current.y, dz = p.z - current.z;
+    double len = sqrt(dx*dx + dy*dy + dz*dz);
+    if (len == 0.0)
+        return;
+    if (solid) {
+        addPoint(p);
+        current = p;
+        return;
+    }
+    double t = 0;
+    while (true) {
+        double e = elements[index];
+        DRW_Coord at(current.x + dx * t / len, current.y + dy * t / len, current.z + dz * t / len);
+        if (e == 0.0) {
+            //a dot, the one at the end of the segment is the start of the next one
+            if (t >= len)
+                break;
+            points.push_back(at);
+            flush();
+            if (++dashes >= maxDashes) {
+                solid = true;
+                points.push_back(at);
+                addPoint(p);
+                break;
+            }
+            next();
+            continue;
+        }
+        if (e > 0 && points.empty())
+            points.push_back(at);
+        double step = std::min(remaining, len - t);
+        t += step;
+        remaining -= step;
+        if (remaining > epsilon) {
+            if (e > 0)
+                addPoint(p);
+            break;
+        }
+        if (e > 0) {
+            addPoint(DRW_Coord(current.x + dx * t / len, current.y + dy * t / len, current.z + dz * t / len));
+            flush();
+            if (++dashes >= maxDashes) {
+                //too fine for the path, the rest is solid
+                solid = true;
+                if (t < len) {
+                    points.push_back(DRW_Coord(current.x + dx * t / len, current.y + dy * t / len,
+                                               current.z + dz * t / len));
+                    addPoint(p);
+                } else {
+                    points.push_back(p);
+                }
+                break;
+            }
+        }
+        next();
+        if (t >= len && elements[index] != 0.0)
+            break;
+    }
+    current = p;
+}
+
+void DRW_Dasher::end(){
+    //a solid path that did not move has nothing to draw
+    if (points.size() > 1)
+        flush();
+    points.clear();
+}
+
+bool DRW_Dasher::entity(const DRW_Entity &e){
+    work.clear();
+    bool closed;
+    if (!tessellator.points(e, &work, &closed) || work.empty())
+        return false;
+    begin(work[0], e.ltypeScale);
+    for (size_t i = 1; i < work.size(); ++i)
+        lineTo(work[i]);
+    if (closed)
+        lineTo(work[0]);
+    end();
+    return true;
+}
+
+size_t DRW_Dasher::entities(const std::vector<const DRW_Entity *> &list){
+    size_t done = 0;
+    for (size_t i = 0; i < list.size(); ++i) {
+        if (entity(*list[i]))
+            ++done;
+    }
+    return done;
+}
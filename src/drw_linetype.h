@@ -0,0 +1,91 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_LINETYPE_H
+#define DRW_LINETYPE_H
+
+#include <vector>
+#include "drw_base.h"
+#include "drw_entities.h"
+#include "drw_objects.h"
+#include "drw_tessellate.h"
+
+//! Receiver of the dashes made by DRW_Dasher.
+/*!
+*  A dash is a polyline, it turns at the vertices it covers; a dot has one
+*  point. The points are only valid during the call.
+*/
+class DRW_DashSink {
+public:
+    virtual ~DRW_DashSink() {}
+    virtual void dash(const DRW_Coord *points, size_t count) = 0;
+};
+
+//! Applies a line type pattern along paths.
+/*!
+*  The pattern is the path of DRW_LType: dashes positive, spaces negative
+*  & dots 0, times the scale. It starts with each entity and goes on across
+*  the vertices, as the linetype generation of polylines. Curves are
+*  approximated by the tessellator first.
+*  Points are streamed: begin(), lineTo() for each vertex & end(), the
+*  dashes reach the sink as they are done. A dash longer than 256 vertices
+*  is handed in pieces, each one starting at the end of the previous one,
+*  so the memory does not depend on the paths.
+*  When an entity needs more than maxDashes the rest of it is solid.
+*  Empty patterns are solid.
+*  entity() hands the points in the coordinates of the entity, as the
+*  tessellator gives them: OCS of their extrusion for circles, arcs,
+*  lightweight & 2d polylines, WCS for lines, ellipses, splines & 3d
+*  polylines. begin() & lineTo() keep the points as they are given.
+*/
+class DRW_Dasher {
+public:
+    DRW_Dasher();
+    void setSink(DRW_DashSink *s) { sink = s; }
+    /** 'path' of a line type, 'scale' is the global one (LTSCALE) */
+    void setPattern(const std::vector<double> &path, double scale = 1.0);
+    void setPattern(const DRW_LType &lt, double scale = 1.0) { setPattern(lt.path, scale); }
+    void setTessellator(const DRW_Tessellator &t) { tessellator = t; }
+    void setMaxDashes(size_t count) { maxDashes = count; }
+
+    /** starts a path at 'p', the pattern scaled by 'entityScale' too */
+    void begin(const DRW_Coord &p, double entityScale = 1.0);
+    void lineTo(const DRW_Coord &p);
+    /** hands the last dash */
+    void end();
+
+    /** lines, arcs, circles, ellipses, polylines & splines with their ltypeScale, false for others */
+    bool entity(const DRW_Entity &e);
+    /** entities sharing the pattern, each one starts it; returns the ones done */
+    size_t entities(const std::vector<const DRW_Entity *> &list);
+
+private:
+    void next();
+    void addPoint(const DRW_Coord &p);
+    void flush();
+
+    std::vector<double> pattern;   /*!< path times the global scale */
+    std::vector<double> elements;  /*!< pattern of the current path */
+    std::vector<DRW_Coord> points; /*!< the dash being made */
+    std::vector<DRW_Coord> work;   /*!< points of the entity being done */
+    DRW_Tessellator tessellator;
+    DRW_DashSink *sink;
+    DRW_Coord current;
+    size_t index;        /*!< current element */
+    double remaining;    /*!< length left of the current element */
+    double epsilon;
+    size_t dashes;       /*!< dashes of the current path */
+    size_t maxDashes;
+    bool solid;
+};
+
+#endif // DRW_LINETYPE_H
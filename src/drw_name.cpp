@@ -0,0 +1,68 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_name.h"
+#include <ostream>
+
+DRW_Name::Node *DRW_Name::emptyNode(){
+    static Node empty("", -1);
+    return &empty;
+}
+
+/*the default names of the entities are static, not counted*/
+DRW_Name::Node *DRW_Name::makeNode(const std::string &s){
+    static Node layer0("0", -1);
+    static Node byLayer("BYLAYER", -1);
+    static Node byBlock("BYBLOCK", -1);
+    static Node standard("STANDARD", -1);
+    switch (s.size()) {
+    case 0:
+        return emptyNode();
+    case 1:
+        if (s == layer0.text)
+            return &layer0;
+        break;
+    case 7:
+        if (s == byLayer.text)
+            return &byLayer;
+        if (s == byBlock.text)
+            return &byBlock;
+        break;
+    case 8:
+        if (s == standard.text)
+            return &standard;
+        break;
+    default:
+        break;
+    }
+    return new Node(s, 1);
+}
+
+DRW_Name::DRW_Name(): node(emptyNode()) {}
+
+DRW_Name::DRW_Name(const std::string &s): node(makeNode(s)) {}
+
+DRW_Name::DRW_Name(const char *s): node(makeNode(s ? std::string(s) : std::string())) {}
+
+std::ostream &operator<<(std::ostream &os, const DRW_Name &n){
+    return os << n.str();
+}
+
+DRW_Name DRW_NamePool::intern(const std::string &s){
+    if (last == s)
+        return last;
+    std::unordered_map<std::string, DRW_Name>::iterator it = names.find(s);
+    if (it == names.end())
+        it = names.insert(std::make_pair(s, DRW_Name(s))).first;
+    last = it->second;
+    return last;
+}
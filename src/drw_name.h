@@ -0,0 +1,123 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_NAME_H
+#define DRW_NAME_H
+
+#include <string>
+#include <iosfwd>
+#include <atomic>
+#include <unordered_map>
+
+//! Shared, immutable name of a table entry.
+/*!
+*  Used by the entities for the layer, line type and style names. The text
+*  is stored once and shared by all the copies, copying is a reference
+*  count increment. Names interned in the same DRW_NamePool compare by
+*  pointer, others fall back to a string compare.
+*  Reads as a const std::string, assign a new string to change it;
+*  append() & += make a new name with the text added. Unlike the
+*  std::string members they replace, the text can not be bound to a
+*  std::string& or changed in place: copy it with str(), change the copy
+*  and assign it back.
+*/
+class DRW_Name {
+public:
+    DRW_Name();
+    DRW_Name(const std::string &s);
+    DRW_Name(const char *s);
+    DRW_Name(const DRW_Name &n): node(n.node) { acquire(); }
+    DRW_Name(DRW_Name &&n): node(n.node) { n.node = emptyNode(); }
+    ~DRW_Name() { release(); }
+
+    DRW_Name &operator=(const DRW_Name &n) {
+        n.acquire();
+        release();
+        node = n.node;
+        return *this;
+    }
+    DRW_Name &operator=(DRW_Name &&n) {
+        if (this != &n) {
+            release();
+            node = n.node;
+            n.node = emptyNode();
+        }
+        return *this;
+    }
+    DRW_Name &operator=(const std::string &s) { return *this = DRW_Name(s); }
+    DRW_Name &operator=(const char *s) { return *this = DRW_Name(s); }
+    DRW_Name &append(const std::string &s) { return *this = node->text + s; }
+    DRW_Name &operator+=(const std::string &s) { return append(s); }
+    DRW_Name &operator+=(const char *s) { return append(s); }
+
+    const std::string &str() const { return node->text; }
+    operator const std::string&() const { return node->text; }
+    const char *c_str() const { return node->text.c_str(); }
+    bool empty() const { return node->text.empty(); }
+    size_t size() const { return node->text.size(); }
+    size_t length() const { return node->text.size(); }
+    /** true if both share the same text, as names from the same pool */
+    bool sameAs(const DRW_Name &n) const { return node == n.node; }
+
+    bool operator==(const DRW_Name &n) const { return node == n.node || node->text == n.node->text; }
+    bool operator!=(const DRW_Name &n) const { return !(*this == n); }
+    bool operator<(const DRW_Name &n) const { return node != n.node && node->text < n.node->text; }
+    bool operator==(const std::string &s) const { return node->text == s; }
+    bool operator!=(const std::string &s) const { return node->text != s; }
+    bool operator==(const char *s) const { return node->text == s; }
+    bool operator!=(const char *s) const { return node->text != s; }
+
+private:
+    struct Node {
+        Node(const std::string &s, int r): refs(r), text(s) {}
+        std::atomic<int> refs;  /*!< negative in the static names, never freed */
+        const std::string text;
+    };
+    static Node *emptyNode();
+    static Node *makeNode(const std::string &s);
+    void acquire() const {
+        if (node->refs.load(std::memory_order_relaxed) >= 0)
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    void release() {
+        if (node->refs.load(std::memory_order_relaxed) >= 0
+                && node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete node;
+    }
+
+    Node *node;
+};
+
+inline bool operator==(const std::string &s, const DRW_Name &n) { return n == s; }
+inline bool operator!=(const std::string &s, const DRW_Name &n) { return n != s; }
+inline bool operator==(const char *s, const DRW_Name &n) { return n == s; }
+inline bool operator!=(const char *s, const DRW_Name &n) { return n != s; }
+std::ostream &operator<<(std::ostream &os, const DRW_Name &n);
+
+//! Interns the names of a document.
+/*!
+*  Each distinct name is stored once, every intern() of the same text
+*  returns a DRW_Name sharing it. The names stay valid after the pool is
+*  destroyed. Not thread safe, a pool belongs to one reader.
+*/
+class DRW_NamePool {
+public:
+    DRW_Name intern(const std::string &s);
+    size_t size() const { return names.size(); }
+    void clear() { names.clear(); last = DRW_Name(); }
+
+private:
+    std::unordered_map<std::string, DRW_Name> names;
+    DRW_Name last;  /*!< entities mostly come in runs on the same layer */
+};
+
+#endif // DRW_NAME_H
@@ -18,6 +18,7 @@
 #include <vector>
 #include <map>
 #include "drw_base.h"
+#include "drw_shared.h"
 
 class dxfReader;
 class dxfWriter;
@@ -64,12 +65,7 @@ public:
         curr = NULL;
     }
 
-    virtual~DRW_TableEntry() {
-        for (std::vector<DRW_Variant*>::iterator it=extData.begin(); it!=extData.end(); ++it)
-            delete *it;
-
-        extData.clear();
-    }
+    virtual~DRW_TableEntry() {}
 
     DRW_TableEntry(const DRW_TableEntry& e) {
         tType = e.tType;
@@ -80,9 +76,7 @@ public:
         numReactors = e.numReactors;
         xDictFlag = e.xDictFlag;
         curr = e.curr;
-        for (std::vector<DRW_Variant*>::const_iterator it=e.extData.begin(); it!=e.extData.end(); ++it){
-            extData.push_back(new DRW_Variant(*(*it)));
-        }
+        extData = e.extData; //shared until changed
     }
 
 protected:
@@ -91,8 +85,6 @@ protected:
     bool parseDwg(DRW::Version version, dwgBuffer *buf, dwgBuffer* strBuf, duint32 bs=0);
     void reset(){
         flags =0;
-        for (std::vector<DRW_Variant*>::iterator it=extData.begin(); it!=extData.end(); ++it)
-            delete *it;
         extData.clear();
     }
 
@@ -102,7 +94,7 @@ public:
     int parentHandle;          /*!< Soft-pointer ID/handle to owner object, code 330 */
     UTF8STRING name;           /*!< entry name, code 2 */
     int flags;                 /*!< Flags relevant to entry, code 70 */
-    std::vector<DRW_Variant*> extData; /*!< FIFO list of extended data, codes 1000 to 1071*/
+    DRW_ExtData extData;       /*!< FIFO list of extended data, codes 1000 to 1071*/
 
 private:
     DRW_Variant* curr;
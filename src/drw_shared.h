@@ -0,0 +1,166 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_SHARED_H
+#define DRW_SHARED_H
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <atomic>
+#include "drw_base.h"
+
+//the containers of DRW_Variant* own the variants
+inline void DRW_copyItems(std::vector<DRW_Variant*> &to, const std::vector<DRW_Variant*> &from){
+    to.reserve(from.size());
+    for (std::vector<DRW_Variant*>::const_iterator it=from.begin(); it!=from.end(); ++it)
+        to.push_back(new DRW_Variant(*(*it)));
+}
+inline void DRW_freeItems(std::vector<DRW_Variant*> &c){
+    for (std::vector<DRW_Variant*>::iterator it=c.begin(); it!=c.end(); ++it)
+        delete *it;
+}
+inline void DRW_copyItems(std::map<std::string, DRW_Variant*> &to, const std::map<std::string, DRW_Variant*> &from){
+    for (std::map<std::string, DRW_Variant*>::const_iterator it=from.begin(); it!=from.end(); ++it)
+        to[it->first] = new DRW_Variant(*(it->second));
+}
+inline void DRW_freeItems(std::map<std::string, DRW_Variant*> &c){
+    for (std::map<std::string, DRW_Variant*>::iterator it=c.begin(); it!=c.end(); ++it)
+        delete it->second;
+}
+template <class C> inline void DRW_copyItems(C &to, const C &from){ to = from; }
+template <class C> inline void DRW_freeItems(C &){}
+
+//! Copy-on-write container.
+/*!
+*  The copies share one block of data, copying is a reference count
+*  increment. The first change through a non-const function makes a
+*  private copy of the block, so changes are never seen by the others.
+*  An empty container has no block.
+*  get() gives the shared data as is, the derived classes give const
+*  items from their const accessors and change them through edit().
+*  Iterating is const, edit().begin() iterates to change the items.
+*/
+template <class C>
+class DRW_Shared {
+public:
+    typedef typename C::iterator iterator;
+    typedef typename C::const_iterator const_iterator;
+    typedef typename C::size_type size_type;
+
+    DRW_Shared(): block(NULL) {}
+    DRW_Shared(const DRW_Shared &s): block(s.block) {
+        if (block)
+            block->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+    DRW_Shared(DRW_Shared &&s): block(s.block) { s.block = NULL; }
+    ~DRW_Shared() { release(); }
+
+    DRW_Shared &operator=(const DRW_Shared &s) {
+        if (s.block)
+            s.block->refs.fetch_add(1, std::memory_order_relaxed);
+        release();
+        block = s.block;
+        return *this;
+    }
+    DRW_Shared &operator=(DRW_Shared &&s) {
+        if (this != &s) {
+            release();
+            block = s.block;
+            s.block = NULL;
+        }
+        return *this;
+    }
+
+    const C &get() const { return block ? block->data : emptyData(); }
+    operator const C&() const { return get(); }
+    /** the data to change, copied first if it is shared */
+    C &edit() {
+        if (block == NULL) {
+            block = new Block();
+        } else if (block->refs.load(std::memory_order_acquire) > 1) {
+            Block *b = new Block();
+            DRW_copyItems(b->data, block->data);
+            release();
+            block = b;
+        }
+        return block->data;
+    }
+    bool shared() const { return block && block->refs.load(std::memory_order_acquire) > 1; }
+
+    const_iterator begin() const { return get().begin(); }
+    const_iterator end() const { return get().end(); }
+    size_type size() const { return get().size(); }
+    bool empty() const { return get().empty(); }
+    void clear() { release(); block = NULL; }
+    void swap(DRW_Shared &s) { Block *b = block; block = s.block; s.block = b; }
+
+private:
+    struct Block {
+        Block(): refs(1) {}
+        ~Block() { DRW_freeItems(data); }
+        std::atomic<int> refs;
+        C data;
+    };
+    static const C &emptyData() {
+        static const C empty;
+        return empty;
+    }
+    void release() {
+        if (block && block->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            delete block;
+    }
+
+    Block *block;
+};
+
+//! Extended data (XDATA) of entities and table entries, codes 1000 to 1071.
+/*!
+*  Used as a std::vector<DRW_Variant*>, push_back() takes the ownership
+*  of the variant.
+*/
+class DRW_ExtData : public DRW_Shared<std::vector<DRW_Variant*> > {
+public:
+    void push_back(DRW_Variant *v) { edit().push_back(v); }
+    const DRW_Variant *operator[](size_type i) const { return get()[i]; }
+    DRW_Variant *&operator[](size_type i) { return edit()[i]; }
+    const DRW_Variant *at(size_type i) const { return get().at(i); }
+    DRW_Variant *at(size_type i) { return edit().at(i); }
+    const DRW_Variant *front() const { return get().front(); }
+    DRW_Variant *front() { return edit().front(); }
+    const DRW_Variant *back() const { return get().back(); }
+    DRW_Variant *back() { return edit().back(); }
+};
+
+//! Application data of entities, code 102 groups.
+class DRW_AppData : public DRW_Shared<std::list<std::list<DRW_Variant> > > {
+public:
+    void push_back(const std::list<DRW_Variant> &l) { edit().push_back(l); }
+    const std::list<DRW_Variant> &front() const { return get().front(); }
+    const std::list<DRW_Variant> &back() const { return get().back(); }
+};
+
+//! Header variables, used as a std::map<std::string, DRW_Variant*>.
+/*!
+*  The variants are owned by the map, as in std::map erase() does not
+*  delete them.
+*/
+class DRW_HeaderVars : public DRW_Shared<std::map<std::string, DRW_Variant*> > {
+public:
+    DRW_Variant *&operator[](const std::string &key) { return edit()[key]; }
+    const_iterator find(const std::string &key) const { return get().find(key); }
+    size_type count(const std::string &key) const { return get().count(key); }
+    size_type erase(const std::string &key) { return empty() ? 0 : edit().erase(key); }
+};
+
+#endif // DRW_SHARED_H
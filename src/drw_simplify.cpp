@@ -0,0 +1,320 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_simplify.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <queue>
+
+namespace {
+
+const double KEEP = std::numeric_limits<double>::max();
+
+double distance2(const DRW_Coord &a, const DRW_Coord &b){
+    double dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+    return dx*dx + dy*dy + dz*dz;
+}
+
+//distance from 'p' to the segment a-b
+double segmentDistance(const DRW_Coord &p, const DRW_Coord &a, const DRW_Coord &b){
+    double dx = b.x - a.x, dy = b.y - a.y, dz = b.z - a.z;
+    double len2 = dx*dx + dy*dy + dz*dz;
+    double t = 0.0;
+    if (len2 > 0.0) {
+        t = ((p.x - a.x) * dx + (p.y - a.y) * dy + (p.z - a.z) * dz) / len2;
+        t = std::max(0.0, std::min(1.0, t));
+    }
+    DRW_Coord q(a.x + dx * t, a.y + dy * t, a.z + dz * t);
+    return sqrt(distance2(p, q));
+}
+
+double triangleArea(const DRW_Coord &a, const DRW_Coord &b, const DRW_Coord &c){
+    double ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+    double vx = c.x - a.x, vy = c.y - a.y, vz = c.z - a.z;
+    double cx = uy * vz - uz * vy, cy = uz * vx - ux * vz, cz = ux * vy - uy * vx;
+    return 0.5 * sqrt(cx*cx + cy*cy + cz*cz);
+}
+
+//a segment the vertices can be removed from: straight & of constant width
+bool plainSegment(double bulge, double stawidth, double endwidth){
+    return bulge == 0.0 && stawidth == endwidth;
+}
+
+struct Range {
+    size_t first;
+    size_t last;
+    double limit;  //significance of the vertex splitting the parent range
+};
+
+struct Candidate {
+    double area;
+    size_t index;
+    size_t stamp;
+    bool operator<(const Candidate &c) const { return area > c.area; } //smallest on top
+};
+
+} //namespace
+
+bool DRW_Simplifier::gather(const DRW_LWPolyline &pl, std::vector<DRW_Coord> *pts,
+                            std::vector<char> *locked) const {
+    const std::vector<DRW_Vertex2D *> &v = pl.vertlist;
+    if (v.size() < 3)
+        return false;
+    pts->reserve(v.size());
+    locked->assign(v.size(), 0);
+    for (size_t i = 0; i < v.size(); ++i) {
+        pts->push_back(DRW_Coord(v[i]->x, v[i]->y, 0.0));
+        if (i == 0)
+            continue;
+        const DRW_Vertex2D *p = v[i - 1];
+        if (!plainSegment(p->bulge, p->stawidth, p->endwidth) || !plainSegment(v[i]->bulge, v[i]->stawidth, v[i]->endwidth)
+                || p->endwidth != v[i]->stawidth)
+            (*locked)[i] = 1;
+    }
+    //a closed polyline ends where it starts
+    if (pl.flags & 1) {
+        pts->push_back(pts->front());
+        locked->push_back(1);
+    }
+    return true;
+}
+
+bool DRW_Simplifier::gather(const DRW_Polyline &pl, std::vector<DRW_Coord> *pts,
+                            std::vector<char> *locked) const {
+    const std::vector<DRW_Vertex *> &v = pl.vertlist;
+    //curve & spline fit, mesh & polyface
+    if (v.size() < 3 || (pl.flags & (2 | 4 | 16 | 64)))
+        return false;
+    pts->reserve(v.size());
+    locked->assign(v.size(), 0);
+    for (size_t i = 0; i < v.size(); ++i) {
+        if (v[i]->flags & (1 | 8 | 16 | 64 | 128))
+            return false;
+        pts->push_back(v[i]->basePoint);
+        if (i == 0)
+            continue;
+        const DRW_Vertex *p = v[i - 1];
+        if (!plainSegment(p->bulge, p->stawidth, p->endwidth) || !plainSegment(v[i]->bulge, v[i]->stawidth, v[i]->endwidth)
+                || p->endwidth != v[i]->stawidth)
+            (*locked)[i] = 1;
+    }
+    //a closed polyline ends where it starts
+    if (pl.flags & 1) {
+        pts->push_back(pts->front());
+        locked->push_back(1);
+    }
+    return true;
+}
+
+void DRW_Simplifier::douglasPeucker(const std::vector<DRW_Coord> &pts, size_t first, size_t last,
+                                    double minTol, std::vector<double> *sig) const {
+    //a stack instead of recursion, polylines can have millions of vertices
+    std::vector<Range> stack;
+    Range all = {first, last, KEEP};
+    stack.push_back(all);
+    while (!stack.empty()) {
+        Range r = stack.back();
+        stack.pop_back();
+        if (r.last - r.first < 2)
+            continue;
+        double far = -1.0;
+        size_t k = r.first;
+        for (size_t i = r.first + 1; i < r.last; ++i) {
+            double d = segmentDistance(pts[i], pts[r.first], pts[r.last]);
+            if (d > far) {
+                far = d;
+                k = i;
+            }
+        }
+        //below the finest tolerance the vertices between are removed in every level
+        if (far <= minTol)
+            continue;
+        (*sig)[k] = std::min(far, r.limit);
+        Range left = {r.first, k, (*sig)[k]};
+        Range right = {k, r.last, (*sig)[k]};
+        stack.push_back(left);
+        stack.push_back(right);
+    }
+}
+
+void DRW_Simplifier::visvalingam(const std::vector<DRW_Coord> &pts, size_t first, size_t last,
+                                 double maxTol, std::vector<double> *sig) const {
+    size_t n = last - first + 1;
+    std::vector<size_t> prev(n), next(n), stamp(n, 0);
+    std::vector<char> removed(n, 0);
+    std::priority_queue<Candidate> heap;
+    for (size_t i = 0; i < n; ++i) {
+        prev[i] = i - 1;
+        next[i] = i + 1;
+        if (i > 0 && i + 1 < n) {
+            Candidate c = {triangleArea(pts[first + i - 1], pts[first + i], pts[first + i + 1]), i, 0};
+            heap.push(c);
+        }
+    }
+    double maxArea = maxTol * maxTol;
+    double area = 0.0;
+    while (!heap.empty()) {
+        Candidate c = heap.top();
+        heap.pop();
+        if (c.stamp != stamp[c.index])
+            continue;
+        //the area removing a vertex never decreases, the levels stay nested
+        area = std::max(area, c.area);
+        if (area > maxArea)
+            break;
+        (*sig)[first + c.index] = sqrt(area);
+        removed[c.index] = 1;
+        size_t p = prev[c.index], q = next[c.index];
+        next[p] = q;
+        prev[q] = p;
+        if (p > 0) {
+            Candidate d = {triangleArea(pts[first + prev[p]], pts[first + p], pts[first + q]), p, ++stamp[p]};
+            heap.push(d);
+        }
+        if (q + 1 < n) {
+            Candidate d = {triangleArea(pts[first + p], pts[first + q], pts[first + next[q]]), q, ++stamp[q]};
+            heap.push(d);
+        }
+    }
+    //the vertices left are kept in every level
+    for (size_t i = 1; i + 1 < n; ++i) {
+        if (!removed[i])
+            (*sig)[first + i] = KEEP;
+    }
+}
+
+void DRW_Simplifier::significance(const std::vector<DRW_Coord> &pts, std::vector<char> *locked, bool closed,
+                                  double minTol, double maxTol, std::vector<double> *sig) const {
+    size_t n = pts.size();
+    sig->assign(n, 0.0);
+    (*locked)[0] = (*locked)[n - 1] = 1;
+    if (closed) {
+        //the vertex farthest from the first one, a closed polyline keeps its area
+        size_t far = 1;
+        for (size_t i = 2; i + 1 < n; ++i) {
+            if (distance2(pts[i], pts[0]) > distance2(pts[far], pts[0]))
+                far = i;
+        }
+        (*locked)[far] = 1;
+    }
+    size_t first = 0;
+    for (size_t i = 1; i < n; ++i) {
+        if (!(*locked)[i])
+            continue;
+        if (i - first > 1) {
+            if (method == VISVALINGAM)
+                visvalingam(pts, first, i, maxTol, sig);
+            else
+                douglasPeucker(pts, first, i, minTol, sig);
+        }
+        first = i;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        if ((*locked)[i])
+            (*sig)[i] = KEEP;
+    }
+}
+
+size_t DRW_Simplifier::simplify(DRW_LWPolyline *pl) const {
+    std::vector<DRW_Coord> pts;
+    std::vector<char> locked;
+    if (!enabled() || !gather(*pl, &pts, &locked))
+        return 0;
+    std::vector<double> sig;
+    significance(pts, &locked, pl->flags & 1, tol, tol, &sig);
+    size_t kept = 0;
+    for (size_t i = 0; i < pl->vertlist.size(); ++i) {
+        if (sig[i] > tol)
+            pl->vertlist[kept++] = pl->vertlist[i];
+        else
+            delete pl->vertlist[i];
+    }
+    size_t removed = pl->vertlist.size() - kept;
+    pl->vertlist.resize(kept);
+    pl->vertexnum = static_cast<int>(kept);
+    pl->vertex = pl->vertlist.back();
+    return removed;
+}
+
+size_t DRW_Simplifier::simplify(DRW_Polyline *pl) const {
+    std::vector<DRW_Coord> pts;
+    std::vector<char> locked;
+    if (!enabled() || !gather(*pl, &pts, &locked))
+        return 0;
+    std::vector<double> sig;
+    significance(pts, &locked, pl->flags & 1, tol, tol, &sig);
+    size_t kept = 0;
+    for (size_t i = 0; i < pl->vertlist.size(); ++i) {
+        if (sig[i] > tol)
+            pl->vertlist[kept++] = pl->vertlist[i];
+        else
+            delete pl->vertlist[i];
+    }
+    size_t removed = pl->vertlist.size() - kept;
+    pl->vertlist.resize(kept);
+    return removed;
+}
+
+void DRW_Simplifier::levels(const DRW_LWPolyline &pl, const std::vector<double> &tolerances,
+                            std::vector<DRW_LWPolyline> *out) const {
+    out->clear();
+    if (tolerances.empty())
+        return;
+    std::vector<DRW_Coord> pts;
+    std::vector<char> locked;
+    std::vector<double> sig;
+    bool simple = gather(pl, &pts, &locked);
+    if (simple) {
+        double minTol = *std::min_element(tolerances.begin(), tolerances.end());
+        double maxTol = *std::max_element(tolerances.begin(), tolerances.end());
+        significance(pts, &locked, pl.flags & 1, std::max(minTol, 0.0), maxTol, &sig);
+    }
+    out->resize(tolerances.size());
+    for (size_t l = 0; l < tolerances.size(); ++l) {
+        DRW_LWPolyline &lod = (*out)[l];
+        lod = pl;  //shares the vertices, replaced below
+        lod.vertlist.clear();
+        for (size_t i = 0; i < pl.vertlist.size(); ++i) {
+            if (!simple || tolerances[l] <= 0.0 || sig[i] > tolerances[l])
+                lod.vertlist.push_back(new DRW_Vertex2D(*pl.vertlist[i]));
+        }
+        lod.vertexnum = static_cast<int>(lod.vertlist.size());
+        lod.vertex = NULL;
+    }
+}
+
+void DRW_Simplifier::levels(const DRW_Polyline &pl, const std::vector<double> &tolerances,
+                            std::vector<DRW_Polyline> *out) const {
+    out->clear();
+    if (tolerances.empty())
+        return;
+    std::vector<DRW_Coord> pts;
+    std::vector<char> locked;
+    std::vector<double> sig;
+    bool simple = gather(pl, &pts, &locked);
+    if (simple) {
+        double minTol = *std::min_element(tolerances.begin(), tolerances.end());
+        double maxTol = *std::max_element(tolerances.begin(), tolerances.end());
+        significance(pts, &locked, pl.flags & 1, std::max(minTol, 0.0), maxTol, &sig);
+    }
+    out->resize(tolerances.size());
+    for (size_t l = 0; l < tolerances.size(); ++l) {
+        DRW_Polyline &lod = (*out)[l];
+        lod = pl;  //shares the vertices, replaced below
+        lod.vertlist.clear();
+        for (size_t i = 0; i < pl.vertlist.size(); ++i) {
+            if (!simple || tolerances[l] <= 0.0 || sig[i] > tolerances[l])
+                lod.vertlist.push_back(new DRW_Vertex(*pl.vertlist[i]));
+        }
+    }
+}
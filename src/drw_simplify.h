@@ -0,0 +1,72 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_SIMPLIFY_H
+#define DRW_SIMPLIFY_H
+
+#include <vector>
+#include "drw_base.h"
+#include "drw_entities.h"
+
+//! Removes the vertices of polylines that change little their shape.
+/*!
+*  Douglas-Peucker keeps the vertices farther than the tolerance from the
+*  simplified path, Visvalingam removes the vertices making the smallest
+*  triangles while their area is below tolerance squared.
+*  The ends, the vertices of arcs (bulges) & of segments with width are
+*  always kept, a closed polyline keeps at least 3 vertices.
+*  Curve & spline fit polylines, meshes & polyfaces are not changed.
+*  Levels of detail are nested, a level keeps the vertices of the levels
+*  with larger tolerances.
+*  A tolerance of 0, the default, disables the simplification.
+*/
+class DRW_Simplifier {
+public:
+    enum Method {
+        DOUGLASPEUCKER,
+        VISVALINGAM
+    };
+
+    DRW_Simplifier(): tol(0.0), method(DOUGLASPEUCKER) {}
+    void setTolerance(double tolerance) { tol = tolerance > 0.0 ? tolerance : 0.0; }
+    double tolerance() const { return tol; }
+    void setMethod(Method m) { method = m; }
+    Method getMethod() const { return method; }
+    bool enabled() const { return tol > 0.0; }
+
+    /** simplifies the polyline in place, returns the vertices removed */
+    size_t simplify(DRW_LWPolyline *pl) const;
+    size_t simplify(DRW_Polyline *pl) const;
+
+    /** a copy of 'pl' for each tolerance; the caller frees the vertices of the polylines */
+    void levels(const DRW_LWPolyline &pl, const std::vector<double> &tolerances,
+                std::vector<DRW_LWPolyline> *out) const;
+    void levels(const DRW_Polyline &pl, const std::vector<double> &tolerances,
+                std::vector<DRW_Polyline> *out) const;
+
+private:
+    /** the largest tolerance keeping each vertex, computed down to 'minTol' & up to 'maxTol';
+        the points of closed polylines end with the first one again */
+    void significance(const std::vector<DRW_Coord> &pts, std::vector<char> *locked, bool closed,
+                      double minTol, double maxTol, std::vector<double> *sig) const;
+    void douglasPeucker(const std::vector<DRW_Coord> &pts, size_t first, size_t last,
+                        double minTol, std::vector<double> *sig) const;
+    void visvalingam(const std::vector<DRW_Coord> &pts, size_t first, size_t last,
+                     double maxTol, std::vector<double> *sig) const;
+    bool gather(const DRW_LWPolyline &pl, std::vector<DRW_Coord> *pts, std::vector<char> *locked) const;
+    bool gather(const DRW_Polyline &pl, std::vector<DRW_Coord> *pts, std::vector<char> *locked) const;
+
+    double tol;
+    Method method;
+};
+
+#endif // DRW_SIMPLIFY_H
@@ -0,0 +1,33 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_SOURCE_H
+#define DRW_SOURCE_H
+
+#include <cstddef>
+
+//! User supplied data source.
+/*!
+*  Used by dxfRW::read() and dwgR::read() to pull the file content from
+*  any origin (network, archive, ...). Data is read sequentially, dxf is
+*  parsed while it is read and dwg, that needs random access, is read
+*  whole in memory before parsing.
+*/
+class DRW_InputSource {
+public:
+    virtual ~DRW_InputSource() {}
+    /** copies up to 'n' bytes in 'buf', returns the number of bytes copied,
+    * 0 at end of data or on error */
+    virtual size_t read(char *buf, size_t n) = 0;
+};
+
+#endif // DRW_SOURCE_H
@@ -0,0 +1,289 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_spatial.h"
+#include <algorithm>
+#include <queue>
+#include <cmath>
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+namespace {
+
+const size_t NODE_SIZE = 16;    //children per node
+const char MAGIC[8] = {'D', 'R', 'W', 'S', 'I', 'D', 'X', '1'};
+
+template <class T>
+bool lessX(const T &a, const T &b){
+    return a.box.minPoint.x + a.box.maxPoint.x < b.box.minPoint.x + b.box.maxPoint.x;
+}
+
+template <class T>
+bool lessY(const T &a, const T &b){
+    return a.box.minPoint.y + a.box.maxPoint.y < b.box.minPoint.y + b.box.maxPoint.y;
+}
+
+/*sort-tile-recursive order: vertical slices by x, each one by y, every
+ *NODE_SIZE entries make a node*/
+template <class T>
+void tileSort(typename std::vector<T>::iterator first, typename std::vector<T>::iterator last){
+    size_t n = last - first;
+    size_t pages = (n + NODE_SIZE - 1) / NODE_SIZE;
+    size_t slice = static_cast<size_t>(ceil(sqrt(static_cast<double>(pages)))) * NODE_SIZE;
+    std::sort(first, last, lessX<T>);
+    for (size_t i = 0; i < n; i += slice)
+        std::sort(first + i, first + std::min(n, i + slice), lessY<T>);
+}
+
+//squared distance from p to the box, 0 inside
+double distance2(const DRW_BBox &b, const DRW_Coord &p){
+    double dx = std::max(std::max(b.minPoint.x - p.x, p.x - b.maxPoint.x), 0.0);
+    double dy = std::max(std::max(b.minPoint.y - p.y, p.y - b.maxPoint.y), 0.0);
+    double dz = std::max(std::max(b.minPoint.z - p.z, p.z - b.maxPoint.z), 0.0);
+    return dx*dx + dy*dy + dz*dz;
+}
+
+struct Candidate {
+    Candidate(double dist, duint32 i, bool it): d(dist), index(i), item(it) {}
+    bool operator>(const Candidate &c) const { return d > c.d; }
+    double d;
+    duint32 index;
+    bool item;
+};
+
+//little endian, independent of the platform
+void putU32(std::ostream &out, duint32 v){
+    char b[4];
+    for (int i = 0; i < 4; ++i)
+        b[i] = static_cast<char>((v >> (8 * i)) & 0xFF);
+    out.write(b, 4);
+}
+
+void putF64(std::ostream &out, double d){
+    duint64 v;
+    memcpy(&v, &d, 8);
+    char b[8];
+    for (int i = 0; i < 8; ++i)
+        b[i] = static_cast<char>((v >> (8 * i)) & 0xFF);
+    out.write(b, 8);
+}
+
+void putBox(std::ostream &out, const DRW_BBox &b){
+    putF64(out, b.minPoint.x);
+    putF64(out, b.minPoint.y);
+    putF64(out, b.minPoint.z);
+    putF64(out, b.maxPoint.x);
+    putF64(out, b.maxPoint.y);
+    putF64(out, b.maxPoint.z);
+}
+
+bool getU32(std::istream &in, duint32 *v){
+    unsigned char b[4];
+    if (!in.read(reinterpret_cast<char *>(b), 4))
+        return false;
+    *v = b[0] | (b[1] << 8) | (b[2] << 16) | (static_cast<duint32>(b[3]) << 24);
+    return true;
+}
+
+bool getF64(std::istream &in, double *d){
+    unsigned char b[8];
+    if (!in.read(reinterpret_cast<char *>(b), 8))
+        return false;
+    duint64 v = 0;
+    for (int i = 7; i >= 0; --i)
+        v = (v << 8) | b[i];
+    memcpy(d, &v, 8);
+    return true;
+}
+
+bool getBox(std::istream &in, DRW_BBox *b){
+    DRW_Coord p1, p2;
+    if (!getF64(in, &p1.x) || !getF64(in, &p1.y) || !getF64(in, &p1.z)
+            || !getF64(in, &p2.x) || !getF64(in, &p2.y) || !getF64(in, &p2.z))
+        return false;
+    *b = DRW_BBox(p1, p2);
+    return true;
+}
+
+} //namespace
+
+void DRW_SpatialIndex::clear(){
+    items.clear();
+    nodes.clear();
+    leafCount = 0;
+    built = true;
+}
+
+void DRW_SpatialIndex::add(duint32 handle, const DRW_BBox &box){
+    if (!box.isValid())
+        return;
+    Item it;
+    it.box = box;
+    it.handle = handle;
+    items.push_back(it);
+    built = false;
+}
+
+void DRW_SpatialIndex::build(){
+    nodes.clear();
+    leafCount = 0;
+    built = true;
+    if (items.empty())
+        return;
+    nodes.reserve(items.size() / (NODE_SIZE - 1) + 2);
+    tileSort<Item>(items.begin(), items.end());
+    for (size_t i = 0; i < items.size(); i += NODE_SIZE) {
+        Node nd;
+        nd.first = i;
+        nd.count = std::min(NODE_SIZE, items.size() - i);
+        for (size_t j = i; j < i + nd.count; ++j)
+            nd.box.add(items[j].box);
+        nodes.push_back(nd);
+    }
+    leafCount = nodes.size();
+    //each level packs the previous one until the root
+    size_t begin = 0;
+    size_t end = nodes.size();
+    while (end - begin > 1) {
+        tileSort<Node>(nodes.begin() + begin, nodes.begin() + end);
+        for (size_t i = begin; i < end; i += NODE_SIZE) {
+            Node nd;
+            nd.first = i;
+            nd.count = std::min(NODE_SIZE, end - i);
+            for (size_t j = i; j < i + nd.count; ++j)
+                nd.box.add(nodes[j].box);
+            nodes.push_back(nd);
+        }
+        begin = end;
+        end = nodes.size();
+    }
+}
+
+DRW_BBox DRW_SpatialIndex::bounds() const{
+    if (built)
+        return root() ? root()->box : DRW_BBox();
+    DRW_BBox box;
+    for (std::vector<Item>::const_iterator it = items.begin(); it != items.end(); ++it)
+        box.add(it->box);
+    return box;
+}
+
+/*the boxes are 3d, a 2d window needs the z range of the drawing*/
+void DRW_SpatialIndex::query(const DRW_BBox &window, std::vector<duint32> *handles) const{
+    if (!built) {
+        for (std::vector<Item>::const_iterator it = items.begin(); it != items.end(); ++it) {
+            if (it->box.intersects(window))
+                handles->push_back(it->handle);
+        }
+        return;
+    }
+    if (root() == NULL || !root()->box.intersects(window))
+        return;
+    std::vector<duint32> stack(1, nodes.size() - 1);
+    while (!stack.empty()) {
+        duint32 idx = stack.back();
+        stack.pop_back();
+        const Node &nd = nodes[idx];
+        if (idx < leafCount) {
+            for (duint32 i = nd.first; i < nd.first + nd.count; ++i) {
+                if (items[i].box.intersects(window))
+                    handles->push_back(items[i].handle);
+            }
+        } else {
+            for (duint32 i = nd.first; i < nd.first + nd.count; ++i) {
+                if (nodes[i].box.intersects(window))
+                    stack.push_back(i);
+            }
+        }
+    }
+}
+
+/*best first, the items come out of the queue in order of distance*/
+void DRW_SpatialIndex::nearest(const DRW_Coord &p, size_t k, std::vector<duint32> *handles) const{
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate> > queue;
+    if (!built) {
+        for (size_t i = 0; i < items.size(); ++i)
+            queue.push(Candidate(distance2(items[i].box, p), i, true));
+    } else if (root() != NULL) {
+        queue.push(Candidate(distance2(root()->box, p), nodes.size() - 1, false));
+    }
+    size_t found = 0;
+    while (!queue.empty() && found < k) {
+        Candidate c = queue.top();
+        queue.pop();
+        if (c.item) {
+            handles->push_back(items[c.index].handle);
+            ++found;
+            continue;
+        }
+        const Node &nd = nodes[c.index];
+        for (duint32 i = nd.first; i < nd.first + nd.count; ++i) {
+            if (c.index < leafCount)
+                queue.push(Candidate(distance2(items[i].box, p), i, true));
+            else
+                queue.push(Candidate(distance2(nodes[i].box, p), i, false));
+        }
+    }
+}
+
+/* "DRWSIDX1", item count, node count, leaf count, items (handle & box)
+ * and nodes (first, count & box), integers & doubles in little endian */
+bool DRW_SpatialIndex::write(std::ostream &out) const{
+    if (!built)
+        return false;
+    out.write(MAGIC, sizeof(MAGIC));
+    putU32(out, items.size());
+    putU32(out, nodes.size());
+    putU32(out, leafCount);
+    for (std::vector<Item>::const_iterator it = items.begin(); it != items.end(); ++it) {
+        putU32(out, it->handle);
+        putBox(out, it->box);
+    }
+    for (std::vector<Node>::const_iterator it = nodes.begin(); it != nodes.end(); ++it) {
+        putU32(out, it->first);
+        putU32(out, it->count);
+        putBox(out, it->box);
+    }
+    return out.good();
+}
+
+bool DRW_SpatialIndex::read(std::istream &in){
+    clear();
+    char magic[sizeof(MAGIC)];
+    duint32 itemCount, nodeCount, leaves;
+    if (!in.read(magic, sizeof(MAGIC)) || memcmp(magic, MAGIC, sizeof(MAGIC)) != 0
+            || !getU32(in, &itemCount) || !getU32(in, &nodeCount) || !getU32(in, &leaves)
+            || leaves > nodeCount || (itemCount == 0) != (nodeCount == 0))
+        return false;
+    for (duint32 i = 0; i < itemCount; ++i) { //no reserve, the counts are not trusted
+        Item it;
+        if (!getU32(in, &it.handle) || !getBox(in, &it.box)) {
+            clear();
+            return false;
+        }
+        items.push_back(it);
+    }
+    for (duint32 i = 0; i < nodeCount; ++i) {
+        Node nd;
+        //leaves point to items, the others to nodes before them
+        duint32 limit = i < leaves ? itemCount : i;
+        if (!getU32(in, &nd.first) || !getU32(in, &nd.count) || !getBox(in, &nd.box)
+                || nd.count == 0 || nd.first > limit || nd.count > limit - nd.first) {
+            clear();
+            return false;
+        }
+        nodes.push_back(nd);
+    }
+    leafCount = leaves;
+    return true;
+}
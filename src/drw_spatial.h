@@ -0,0 +1,69 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_SPATIAL_H
+#define DRW_SPATIAL_H
+
+#include <vector>
+#include <iosfwd>
+#include "drw_base.h"
+
+//! Static R-tree of entity handles.
+/*!
+*  The boxes are collected with add() and packed in one pass by build(),
+*  sort-tile-recursive on the x & y centers. The nodes are stored level
+*  by level in one array, the leaves first and the root last.
+*  Adding after build() needs a new build(). The queries return the
+*  entity handles, entities without handle (dxf R12) are all 0.
+*/
+class DRW_SpatialIndex {
+public:
+    DRW_SpatialIndex(): leafCount(0), built(true) {}
+    void clear();
+
+    void add(duint32 handle, const DRW_BBox &box);
+    /** packs the tree, the queries use it */
+    void build();
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+    /** bounds of all the items, invalid if empty */
+    DRW_BBox bounds() const;
+
+    /** appends the handles of the items with a box intersecting 'window' */
+    void query(const DRW_BBox &window, std::vector<duint32> *handles) const;
+    /** appends the handles of the 'k' items with a box nearest to 'p', the nearest first */
+    void nearest(const DRW_Coord &p, size_t k, std::vector<duint32> *handles) const;
+
+    /** binary, independent of the platform */
+    bool write(std::ostream &out) const;
+    /** replaces the content with a tree saved by write(), false if it is not valid */
+    bool read(std::istream &in);
+
+private:
+    struct Item {
+        DRW_BBox box;
+        duint32 handle;
+    };
+    struct Node {
+        DRW_BBox box;
+        duint32 first;   /*!< first item for the leaves, first child for the others */
+        duint32 count;
+    };
+    const Node *root() const { return nodes.empty() ? NULL : &nodes.back(); }
+
+    std::vector<Item> items;  /*!< in leaf order after build() */
+    std::vector<Node> nodes;
+    duint32 leafCount;        /*!< nodes[0, leafCount) are leaves */
+    bool built;
+};
+
+#endif // DRW_SPATIAL_H
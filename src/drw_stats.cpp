@@ -0,0 +1,64 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include <chrono>
+#include "drw_stats.h"
+
+void DRW_ReadStats::clear(){
+    for (int i = 0; i < PHASES; ++i)
+        phaseTime[i] = 0.0;
+    totalTime = decompressTime = rsDecodeTime = 0.0;
+    bytesIn = bytesOut = 0;
+    objects.clear();
+    skipped = failed = 0;
+    removedVertices = 0;
+}
+
+const char *DRW_ReadStats::phaseName(Phase p){
+    switch (p){
+    case FILEHEADER:
+        return "FILEHEADER";
+    case HEADER:
+        return "HEADER";
+    case CLASSES:
+        return "CLASSES";
+    case HANDLES:
+        return "HANDLES";
+    case TABLES:
+        return "TABLES";
+    case BLOCKS:
+        return "BLOCKS";
+    case ENTITIES:
+        return "ENTITIES";
+    case OBJECTS:
+        return "OBJECTS";
+    default:
+        break;
+    }
+    return "UNKNOWN";
+}
+
+double DRW_ReadStats::now(){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+duint32 DRW_ReadStats::objectCount(const std::string &name) const{
+    std::map<std::string, duint32>::const_iterator it = objects.find(name);
+    return (it == objects.end()) ? 0 : it->second;
+}
+
+duint32 DRW_ReadStats::totalObjects() const{
+    duint32 total = 0;
+    for (std::map<std::string, duint32>::const_iterator it = objects.begin(); it != objects.end(); ++it)
+        total += it->second;
+    return total;
+}
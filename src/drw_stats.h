@@ -0,0 +1,65 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_STATS_H
+#define DRW_STATS_H
+
+#include <string>
+#include <map>
+#include "drw_base.h"
+
+//! Statistics of a read session.
+/*!
+*  Filled by dwgR::read() and dxfRW::read(), query it afterwards with
+*  getStats(). Times are wall clock seconds.
+*  In dxf the phases are the file sections, FILEHEADER is the format
+*  detection and HANDLES is not used. The dxf records are not decoded
+*  one object at a time, 'failed' is only counted in dwg.
+*/
+class DRW_ReadStats {
+public:
+    enum Phase {
+        FILEHEADER,  /*!< readFileHeader (dwg) or format detection (dxf) */
+        HEADER,      /*!< readDwgHeader or HEADER section */
+        CLASSES,     /*!< readDwgClasses or CLASSES section */
+        HANDLES,     /*!< readDwgHandles, dwg only */
+        TABLES,      /*!< readDwgTables or TABLES section */
+        BLOCKS,      /*!< readDwgBlocks or BLOCKS section */
+        ENTITIES,    /*!< readDwgEntities or ENTITIES section */
+        OBJECTS,     /*!< readDwgObjects or OBJECTS section */
+        PHASES       /*!< number of phases */
+    };
+
+    DRW_ReadStats() { clear(); }
+    void clear();
+    static const char *phaseName(Phase p);
+    /** monotonic clock in seconds, used to measure the phases */
+    static double now();
+
+    void addObject(const std::string &name) { ++objects[name]; }
+    duint32 objectCount(const std::string &name) const;
+    duint32 totalObjects() const;
+
+public:
+    double phaseTime[PHASES];  /*!< wall time per phase */
+    double totalTime;          /*!< wall time of the whole read */
+    double decompressTime;     /*!< dwg 2004+ page decompression, included in the phases */
+    double rsDecodeTime;       /*!< dwg 2007 Reed-Solomon decoding, included in the phases */
+    duint64 bytesIn;           /*!< bytes consumed from the source */
+    duint64 bytesOut;          /*!< bytes produced by decompression (dwg 2004+, compressed dxf) */
+    std::map<std::string, duint32> objects; /*!< decoded entities & objects per dxf type name */
+    duint32 skipped;           /*!< unsupported entities & objects skipped */
+    duint32 failed;            /*!< entities & objects that failed to decode, dwg only */
+    duint64 removedVertices;   /*!< polyline vertices removed by the simplifier */
+};
+
+#endif // DRW_STATS_H
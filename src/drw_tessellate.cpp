@@ -0,0 +1,379 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_tessellate.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+DRW_Coord cross(const DRW_Coord &a, const DRW_Coord &b){
+    return DRW_Coord(a.y*b.z - a.z*b.y, a.z*b.x - a.x*b.z, a.x*b.y - a.y*b.x);
+}
+
+double length(const DRW_Coord &v){
+    return sqrt(v.x*v.x + v.y*v.y + v.z*v.z);
+}
+
+//sweep of a counterclockwise arc in (0, 2*PI], equal angles are a full turn
+double sweepOf(double a0, double a1){
+    double s = fmod(a1 - a0, M_PIx2);
+    if (s <= 1.0e-12)
+        s += M_PIx2;
+    return s;
+}
+
+int segmentsFor(double n, int maxSegments){
+    //the tolerance is met exactly by an integer count, do not round it up
+    n = ceil(n - 1.0e-9);
+    if (n < 1.0)
+        return 1;
+    if (n > maxSegments)
+        return maxSegments;
+    return static_cast<int>(n);
+}
+
+bool sameZ(const std::vector<DRW_Coord> &pts){
+    for (size_t i = 1; i < pts.size(); ++i) {
+        if (fabs(pts[i].z - pts[0].z) > 1.0e-12)
+            return false;
+    }
+    return true;
+}
+
+void vertexPoints(const DRW_Polyline &p, bool bulges, const DRW_Tessellator &t, std::vector<DRW_Coord> *out){
+    size_t n = p.vertlist.size();
+    bool closed = p.flags & 1;
+    for (size_t i = 0; i < n; ++i) {
+        const DRW_Vertex *v = p.vertlist[i];
+        if (i == 0)
+            out->push_back(v->basePoint);
+        if (i + 1 == n && !closed)
+            break;
+        const DRW_Coord &next = p.vertlist[(i + 1) % n]->basePoint;
+        if (bulges)
+            t.bulge(v->basePoint, next, v->bulge, out);
+        else
+            out->push_back(next);
+    }
+}
+
+} //namespace
+
+int DRW_Tessellator::arcSegments(double r, double sweep) const {
+    double t = tolFor(r);
+    double step = M_PI_2;
+    if (r > 0 && t > 0 && t < r)
+        step = std::min(step, 2.0 * acos(1.0 - t / r));
+    return segmentsFor(fabs(sweep) / step, maxSegments);
+}
+
+void DRW_Tessellator::arc(const DRW_Coord &c, double r, double a0, double a1, std::vector<DRW_Coord> *out) const {
+    double sweep = sweepOf(a0, a1);
+    int n = arcSegments(r, sweep);
+    out->reserve(out->size() + n + 1);
+    for (int i = 0; i <= n; ++i) {
+        double a = a0 + sweep * i / n;
+        out->push_back(DRW_Coord(c.x + r * cos(a), c.y + r * sin(a), c.z));
+    }
+}
+
+void DRW_Tessellator::ellipse(const DRW_Coord &c, const DRW_Coord &major, double ratio, const DRW_Coord &normal,
+                              double t0, double t1, std::vector<DRW_Coord> *out) const {
+    DRW_Coord n = normal;
+    n.unitize();
+    DRW_Coord u = major;
+    DRW_Coord v = cross(n, u);
+    v.x *= ratio; v.y *= ratio; v.z *= ratio;
+    //an affine image of the circle of the larger radius, its chord error is not exceeded
+    double sweep = sweepOf(t0, t1);
+    int count = arcSegments(std::max(length(u), length(v)), sweep);
+    out->reserve(out->size() + count + 1);
+    for (int i = 0; i <= count; ++i) {
+        double t = t0 + sweep * i / count;
+        double ct = cos(t), st = sin(t);
+        out->push_back(DRW_Coord(c.x + u.x*ct + v.x*st, c.y + u.y*ct + v.y*st, c.z + u.z*ct + v.z*st));
+    }
+}
+
+void DRW_Tessellator::bulge(const DRW_Coord &p1, const DRW_Coord &p2, double bulge, std::vector<DRW_Coord> *out) const {
+    double dx = p2.x - p1.x, dy = p2.y - p1.y;
+    double d = sqrt(dx*dx + dy*dy);
+    if (fabs(bulge) < 1.0e-12 || d == 0.0) {
+        out->push_back(p2);
+        return;
+    }
+    //included angle, positive counterclockwise, center to the left of the chord if less than PI
+    double theta = 4.0 * atan(bulge);
+    double h = d / (2.0 * tan(theta / 2.0));
+    double cx = (p1.x + p2.x) / 2.0 - dy / d * h;
+    double cy = (p1.y + p2.y) / 2.0 + dx / d * h;
+    double r = d * (1.0 + bulge*bulge) / (4.0 * fabs(bulge));
+    double a0 = atan2(p1.y - cy, p1.x - cx);
+    int n = arcSegments(r, theta);
+    out->reserve(out->size() + n);
+    for (int i = 1; i < n; ++i) {
+        double a = a0 + theta * i / n;
+        double f = static_cast<double>(i) / n;
+        out->push_back(DRW_Coord(cx + r * cos(a), cy + r * sin(a), p1.z + (p2.z - p1.z) * f));
+    }
+    out->push_back(p2);
+}
+
+void DRW_Tessellator::spline(const DRW_Spline &s, std::vector<DRW_Coord> *out) const {
+    int p = s.degree;
+    int n = static_cast<int>(s.controllist.size());
+    const std::vector<double> &k = s.knotslist;
+    if (p < 1 || n <= p || k.size() != static_cast<size_t>(n + p + 1)) {
+        const std::vector<DRW_Coord *> &pts = s.controllist.empty() ? s.fitlist : s.controllist;
+        for (size_t i = 0; i < pts.size(); ++i)
+            out->push_back(*pts[i]);
+        return;
+    }
+    bool rational = s.weightlist.size() == static_cast<size_t>(n);
+    double wMin = 1.0, wMax = 1.0;
+    DRW_BBox box;
+    for (int i = 0; i < n; ++i) {
+        box.add(*s.controllist[i]);
+        if (rational) {
+            double w = s.weightlist[i];
+            wMin = (i == 0) ? w : std::min(wMin, w);
+            wMax = (i == 0) ? w : std::max(wMax, w);
+        }
+    }
+    if (rational && wMin <= 0.0) {
+        //not a valid nurbs, keep the control polygon
+        for (int i = 0; i < n; ++i)
+            out->push_back(*s.controllist[i]);
+        return;
+    }
+    DRW_Coord diag(box.maxPoint.x - box.minPoint.x, box.maxPoint.y - box.minPoint.y,
+                   box.maxPoint.z - box.minPoint.z);
+    double t = tolFor(length(diag) / 2.0);
+    if (t <= 0.0)
+        t = 1.0e-9;
+
+    //segments of each span from the bound of the second derivative, its control points
+    //are the second differences; the change of the weights is a factor on it
+    std::vector<int> counts(n, 0);
+    long total = 0;
+    for (int span = p; span < n; ++span) {
+        double du = k[span + 1] - k[span];
+        if (du <= 0.0)
+            continue;
+        double m2 = 0.0;
+        if (p > 1) {
+            for (int i = span - p; i <= span - 2; ++i) {
+                double d0 = k[i + p + 1] - k[i + 1];
+                double d1 = k[i + p + 2] - k[i + 2];
+                double d2 = k[i + p + 1] - k[i + 2];
+                if (d0 <= 0.0 || d1 <= 0.0 || d2 <= 0.0)
+                    continue;
+                const DRW_Coord &a = *s.controllist[i];
+                const DRW_Coord &b = *s.controllist[i + 1];
+                const DRW_Coord &c = *s.controllist[i + 2];
+                DRW_Coord q0((b.x - a.x) / d0, (b.y - a.y) / d0, (b.z - a.z) / d0);
+                DRW_Coord q1((c.x - b.x) / d1, (c.y - b.y) / d1, (c.z - b.z) / d1);
+                DRW_Coord q2(q1.x - q0.x, q1.y - q0.y, q1.z - q0.z);
+                m2 = std::max(m2, p * (p - 1) * length(q2) / d2);
+            }
+        }
+        m2 *= wMax / wMin;
+        counts[span] = segmentsFor(du * sqrt(m2 / (8.0 * t)), maxSegments);
+        total += counts[span];
+    }
+    if (total == 0) {
+        out->push_back(*s.controllist[0]);
+        return;
+    }
+    if (total > maxSegments) {
+        for (int span = p; span < n; ++span) {
+            if (counts[span] > 0)
+                counts[span] = std::max(1, static_cast<int>(static_cast<long>(counts[span]) * maxSegments / total));
+        }
+    }
+    int last = n - 1;
+    while (counts[last] == 0)
+        --last;
+
+    std::vector<double> u, work;
+    out->reserve(out->size() + total + 1);
+    for (int span = p; span <= last; ++span) {
+        int c = counts[span];
+        if (c == 0)
+            continue;
+        int m = (span == last) ? c + 1 : c;
+        u.resize(m);
+        double du = k[span + 1] - k[span];
+        for (int i = 0; i < m; ++i)
+            u[i] = k[span] + du * i / c;
+        u[m - 1] = std::min(u[m - 1], k[span + 1]);
+        evaluateSpan(s, span, &u[0], m, &work, out);
+    }
+}
+
+/*!
+*  de Boor on all the parameters of the span at once, the points in
+*  separate homogeneous coordinate arrays so the inner loops run on
+*  contiguous data.
+*/
+void DRW_Tessellator::evaluateSpan(const DRW_Spline &s, int span, const double *u, size_t count,
+                                   std::vector<double> *work, std::vector<DRW_Coord> *out) const {
+    int p = s.degree;
+    const std::vector<double> &k = s.knotslist;
+    bool rational = s.weightlist.size() == s.controllist.size();
+    work->resize(4 * (p + 1) * count);
+    double *d = &(*work)[0];
+    //d[(j*4 + c)*count + i] coordinate c of the point j for the parameter i
+    for (int j = 0; j <= p; ++j) {
+        const DRW_Coord &cp = *s.controllist[span - p + j];
+        double w = rational ? s.weightlist[span - p + j] : 1.0;
+        double *x = d + (j*4) * count, *y = x + count, *z = y + count, *h = z + count;
+        for (size_t i = 0; i < count; ++i) {
+            x[i] = cp.x * w; y[i] = cp.y * w; z[i] = cp.z * w; h[i] = w;
+        }
+    }
+    for (int r = 1; r <= p; ++r) {
+        for (int j = p; j >= r; --j) {
+            double k0 = k[j + span - p];
+            double dk = k[j + 1 + span - r] - k0;
+            double *dst = d + (j*4) * count;
+            const double *src = d + ((j - 1)*4) * count;
+            for (int c = 0; c < 4; ++c) {
+                double *a = dst + c * count;
+                const double *b = src + c * count;
+                for (size_t i = 0; i < count; ++i) {
+                    double alpha = dk > 0.0 ? (u[i] - k0) / dk : 0.0;
+                    a[i] = (1.0 - alpha) * b[i] + alpha * a[i];
+                }
+            }
+        }
+    }
+    const double *x = d + (p*4) * count, *y = x + count, *z = y + count, *h = z + count;
+    for (size_t i = 0; i < count; ++i)
+        out->push_back(DRW_Coord(x[i] / h[i], y[i] / h[i], z[i] / h[i]));
+}
+
+bool DRW_Tessellator::points(const DRW_Entity &e, std::vector<DRW_Coord> *out, bool *closed) const {
+    *closed = false;
+    switch (e.eType) {
+    case DRW::CIRCLE: {
+        const DRW_Circle &c = static_cast<const DRW_Circle &>(e);
+        arc(c.basePoint, c.radious, 0.0, 0.0, out);
+        out->pop_back();
+        *closed = true;
+        break; }
+    case DRW::ARC: {
+        const DRW_Arc &a = static_cast<const DRW_Arc &>(e);
+        arc(a.basePoint, a.radious, a.staangle, a.endangle, out);
+        break; }
+    case DRW::ELLIPSE: {
+        const DRW_Ellipse &el = static_cast<const DRW_Ellipse &>(e);
+        ellipse(el.basePoint, el.secPoint, el.ratio, el.extPoint, el.staparam, el.endparam, out);
+        double sweep = fabs(el.endparam - el.staparam);
+        if (sweep < 1.0e-10 || fabs(sweep - M_PIx2) < 1.0e-10) {
+            out->pop_back();
+            *closed = true;
+        }
+        break; }
+    case DRW::LINE: {
+        const DRW_Line &l = static_cast<const DRW_Line &>(e);
+        out->push_back(l.basePoint);
+        out->push_back(l.secPoint);
+        break; }
+    case DRW::LWPOLYLINE: {
+        const DRW_LWPolyline &l = static_cast<const DRW_LWPolyline &>(e);
+        size_t n = l.vertlist.size();
+        if (n == 0)
+            return false;
+        *closed = l.flags & 1;
+        for (size_t i = 0; i < n; ++i) {
+            const DRW_Vertex2D *v = l.vertlist[i];
+            DRW_Coord p1(v->x, v->y, l.elevation);
+            if (i == 0)
+                out->push_back(p1);
+            if (i + 1 == n && !*closed)
+                break;
+            const DRW_Vertex2D *w = l.vertlist[(i + 1) % n];
+            bulge(p1, DRW_Coord(w->x, w->y, l.elevation), v->bulge, out);
+        }
+        if (*closed)
+            out->pop_back();
+        break; }
+    case DRW::POLYLINE: {
+        const DRW_Polyline &pl = static_cast<const DRW_Polyline &>(e);
+        //meshes & polyfaces are not curves
+        if (pl.flags & (16 | 64) || pl.vertlist.empty())
+            return false;
+        *closed = pl.flags & 1;
+        vertexPoints(pl, !(pl.flags & 8), *this, out);
+        if (*closed)
+            out->pop_back();
+        break; }
+    case DRW::SPLINE:
+        spline(static_cast<const DRW_Spline &>(e), out);
+        break;
+    default:
+        return false;
+    }
+    return true;
+}
+
+bool DRW_Tessellator::toPolyline(const DRW_Entity &e, DRW_Polyline *pol) const {
+    std::vector<DRW_Coord> pts;
+    bool closed;
+    if (!points(e, &pts, &closed) || pts.empty())
+        return false;
+    //circles, arcs & 2d polylines keep their OCS, the others are in WCS
+    DRW_Coord normal(0.0, 0.0, 1.0);
+    bool ocs = false;
+    switch (e.eType) {
+    case DRW::CIRCLE:
+    case DRW::ARC:
+    case DRW::LWPOLYLINE:
+        ocs = true;
+        break;
+    case DRW::POLYLINE:
+        ocs = !(static_cast<const DRW_Polyline &>(e).flags & 8);
+        break;
+    default:
+        break;
+    }
+    if (ocs && e.eType == DRW::LWPOLYLINE) {
+        normal = static_cast<const DRW_LWPolyline &>(e).extPoint;
+        pol->thickness = static_cast<const DRW_LWPolyline &>(e).thickness;
+    } else if (ocs) {
+        normal = static_cast<const DRW_Point &>(e).extPoint;
+        pol->thickness = static_cast<const DRW_Point &>(e).thickness;
+    }
+    //in WCS a constant z is a 2d polyline with the default extrusion
+    bool flat = ocs || sameZ(pts);
+    pol->flags = closed ? 1 : 0;
+    if (flat) {
+        pol->basePoint.z = pts[0].z;
+    } else {
+        pol->flags |= 8;
+        pol->basePoint.z = 0.0;
+    }
+    pol->extPoint = normal;
+    for (size_t i = 0; i < pts.size(); ++i) {
+        DRW_Vertex *v = new DRW_Vertex(pts[i].x, pts[i].y, pts[i].z, 0.0);
+        if (!flat)
+            v->flags = 32;
+        pol->appendVertex(v);
+    }
+    pol->layer = e.layer;
+    pol->lineType = e.lineType;
+    pol->color = e.color;
+    pol->lWeight = e.lWeight;
+    return true;
+}
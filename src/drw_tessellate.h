@@ -0,0 +1,72 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_TESSELLATE_H
+#define DRW_TESSELLATE_H
+
+#include <vector>
+#include "drw_base.h"
+#include "drw_entities.h"
+
+//! Approximates curves with polylines within a chord error.
+/*!
+*  The tolerance is the largest distance between the curve and the
+*  segments, in drawing units or, if relative, as a fraction of the
+*  radius, for splines of half the diagonal of the control points box.
+*  A full turn has at least 4 segments and no curve more than maxSegments.
+*  Splines are NURBS evaluated with de Boor, the parameters of a knot
+*  span in one batch. Each span gets the segments needed by the bound
+*  of its second derivative.
+*  The points are appended to 'out' in the coordinates of the entity,
+*  OCS for circles, arcs, lightweight & 2d polylines, WCS for lines,
+*  ellipses, splines & 3d polylines.
+*/
+class DRW_Tessellator {
+public:
+    DRW_Tessellator(): tol(0.01), relative(false), maxSegments(4096) {}
+    void setTolerance(double tolerance, bool relativeToSize = false) {
+        tol = tolerance;
+        relative = relativeToSize;
+    }
+    double tolerance() const { return tol; }
+    bool isRelative() const { return relative; }
+    void setMaxSegments(int count) { maxSegments = count > 0 ? count : 1; }
+
+    /** segments of an arc of radius 'r' covering 'sweep' radians */
+    int arcSegments(double r, double sweep) const;
+
+    /** counterclockwise from 'a0' to 'a1' in the plane z = c.z, the full circle if equal */
+    void arc(const DRW_Coord &c, double r, double a0, double a1, std::vector<DRW_Coord> *out) const;
+    /** c + u*cos(t) + v*sin(t), u the major axis & v = ratio * normal x u, the full ellipse if t0 == t1 */
+    void ellipse(const DRW_Coord &c, const DRW_Coord &major, double ratio, const DRW_Coord &normal,
+                 double t0, double t1, std::vector<DRW_Coord> *out) const;
+    /** segment of a polyline, the points after 'p1' up to 'p2' */
+    void bulge(const DRW_Coord &p1, const DRW_Coord &p2, double bulge, std::vector<DRW_Coord> *out) const;
+    /** the control points if the knots do not match, the fit points if there are no control points */
+    void spline(const DRW_Spline &s, std::vector<DRW_Coord> *out) const;
+
+    /** circles, arcs, ellipses, lines, polylines & splines, false for other entities */
+    bool points(const DRW_Entity &e, std::vector<DRW_Coord> *out, bool *closed) const;
+    /** the entity as a polyline, 3d if it is not planar in its OCS; the caller frees the vertices */
+    bool toPolyline(const DRW_Entity &e, DRW_Polyline *pol) const;
+
+private:
+    double tolFor(double size) const { return relative ? tol * size : tol; }
+    void evaluateSpan(const DRW_Spline &s, int span, const double *u, size_t count,
+                      std::vector<double> *work, std::vector<DRW_Coord> *out) const;
+
+    double tol;
+    bool relative;
+    int maxSegments;
+};
+
+#endif // DRW_TESSELLATE_H
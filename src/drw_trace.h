@@ -0,0 +1,68 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_TRACE_H
+#define DRW_TRACE_H
+
+#include <string>
+#include "drw_base.h"
+
+namespace DRW {
+
+//! Kind of structured trace event.
+enum TraceEvent {
+    SECTION_START,   /*!< a section (dxf) or read phase (dwg) begins */
+    SECTION_END,     /*!< a section or read phase ends, bytes holds its size if known */
+    OBJECT_DECODED,  /*!< an entity or object was decoded and delivered */
+    OBJECT_FAILED,   /*!< an entity or object failed to decode */
+    BYTES_CONSUMED   /*!< end of read, bytes holds the total consumed from the source */
+};
+
+}
+
+//! Structured trace event record.
+/*!
+*  Passed to DRW_TraceSink::traceEvent(), the record is only valid during
+*  the call.
+*  name is the section/phase name or, for objects, the dxf entity name,
+*  type is the dwg object type (0 in dxf).
+*/
+class DRW_TraceRecord {
+public:
+    DRW_TraceRecord(DRW::TraceEvent ev, const std::string &n){
+        event = ev;
+        name = n;
+        handle = 0;
+        type = 0;
+        offset = bytes = 0;
+    }
+
+    DRW::TraceEvent event;
+    std::string name;
+    duint32 handle;     /*!< object handle, 0 if unknown */
+    int type;           /*!< dwg object type */
+    duint64 offset;     /*!< position in the source, 0 if unknown */
+    duint64 bytes;      /*!< bytes consumed, 0 if unknown */
+};
+
+//! Receiver for structured trace events.
+/*!
+*  Install one with dxfRW::setTraceSink() or dwgR::setTraceSink(), when no
+*  sink is installed the readers only pay a NULL pointer test per event.
+*/
+class DRW_TraceSink {
+public:
+    virtual ~DRW_TraceSink() {}
+    virtual void traceEvent(const DRW_TraceRecord &rec) = 0;
+};
+
+#endif // DRW_TRACE_H
@@ -0,0 +1,394 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_compress.h"
+#include <climits>
+#include <cstring>
+#ifdef DRW_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef DRW_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+//! Decompression backend.
+class DRW_Inflater {
+public:
+    virtual ~DRW_Inflater(){}
+    /** decompresses from 'in' to 'out', sets the bytes used and made, and
+    *  'end' when a gzip member or zstd frame is complete */
+    virtual bool run(const char *in, size_t inLen, size_t *used,
+                     char *out, size_t outLen, size_t *made, bool *end) = 0;
+    /** prepares for the next gzip member or zstd frame */
+    virtual bool reset() = 0;
+};
+
+//! Compression backend, writes the compressed data to 'out'.
+class DRW_Deflater {
+public:
+    virtual ~DRW_Deflater(){}
+    virtual bool run(const char *data, size_t len, bool finish, std::ostream *out) = 0;
+};
+
+#ifdef DRW_HAVE_ZLIB
+class DRW_ZlibInflater : public DRW_Inflater {
+public:
+    DRW_ZlibInflater(){
+        memset(&zs, 0, sizeof(zs));
+        //32: accepts gzip and zlib headers
+        valid = (inflateInit2(&zs, 15 + 32) == Z_OK);
+    }
+    ~DRW_ZlibInflater(){
+        if (valid)
+            inflateEnd(&zs);
+    }
+    virtual bool run(const char *in, size_t inLen, size_t *used,
+                     char *out, size_t outLen, size_t *made, bool *end){
+        if (inLen > UINT_MAX)
+            inLen = UINT_MAX;
+        if (outLen > UINT_MAX)
+            outLen = UINT_MAX;
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in));
+        zs.avail_in = static_cast<uInt>(inLen);
+        zs.next_out = reinterpret_cast<Bytef*>(out);
+        zs.avail_out = static_cast<uInt>(outLen);
+        int r = inflate(&zs, Z_NO_FLUSH);
+        *used = inLen - zs.avail_in;
+        *made = outLen - zs.avail_out;
+        *end = (r == Z_STREAM_END);
+        return (r == Z_OK || r == Z_STREAM_END || r == Z_BUF_ERROR);
+    }
+    virtual bool reset(){
+        return inflateReset(&zs) == Z_OK;
+    }
+    bool valid;
+
+private:
+    z_stream zs;
+};
+
+class DRW_ZlibDeflater : public DRW_Deflater {
+public:
+    DRW_ZlibDeflater(int level){
+        memset(&zs, 0, sizeof(zs));
+        if (level < 0 || level > 9)
+            level = Z_DEFAULT_COMPRESSION;
+        //16: gzip header
+        valid = (deflateInit2(&zs, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK);
+    }
+    ~DRW_ZlibDeflater(){
+        if (valid)
+            deflateEnd(&zs);
+    }
+    /*'len' fits in uInt, the blocks are small*/
+    virtual bool run(const char *data, size_t len, bool finish, std::ostream *out){
+        char buf[65536];
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        zs.avail_in = static_cast<uInt>(len);
+        int r;
+        do {
+            zs.next_out = reinterpret_cast<Bytef*>(buf);
+            zs.avail_out = sizeof(buf);
+            r = deflate(&zs, finish ? Z_FINISH : Z_NO_FLUSH);
+            if (r == Z_STREAM_ERROR)
+                return false;
+            out->write(buf, sizeof(buf) - zs.avail_out);
+        } while (zs.avail_out == 0 || (finish && r != Z_STREAM_END));
+        return out->good();
+    }
+    bool valid;
+
+private:
+    z_stream zs;
+};
+#endif
+
+#ifdef DRW_HAVE_ZSTD
+class DRW_ZstdInflater : public DRW_Inflater {
+public:
+    DRW_ZstdInflater(){
+        ds = ZSTD_createDStream();
+        valid = (ds != NULL && !ZSTD_isError(ZSTD_initDStream(ds)));
+    }
+    ~DRW_ZstdInflater(){
+        ZSTD_freeDStream(ds);
+    }
+    virtual bool run(const char *in, size_t inLen, size_t *used,
+                     char *out, size_t outLen, size_t *made, bool *end){
+        ZSTD_inBuffer ib = {in, inLen, 0};
+        ZSTD_outBuffer ob = {out, outLen, 0};
+        size_t r = ZSTD_decompressStream(ds, &ob, &ib);
+        *used = ib.pos;
+        *made = ob.pos;
+        *end = (r == 0);
+        return !ZSTD_isError(r);
+    }
+    virtual bool reset(){
+        return !ZSTD_isError(ZSTD_initDStream(ds));
+    }
+    bool valid;
+
+private:
+    ZSTD_DStream *ds;
+};
+
+class DRW_ZstdDeflater : public DRW_Deflater {
+public:
+    DRW_ZstdDeflater(int level){
+        if (level < 1 || level > ZSTD_maxCLevel())
+            level = 3;
+        cs = ZSTD_createCStream();
+        valid = (cs != NULL && !ZSTD_isError(ZSTD_initCStream(cs, level)));
+    }
+    ~DRW_ZstdDeflater(){
+        ZSTD_freeCStream(cs);
+    }
+    virtual bool run(const char *data, size_t len, bool finish, std::ostream *out){
+        char buf[65536];
+        ZSTD_inBuffer ib = {data, len, 0};
+        while (ib.pos < ib.size) {
+            ZSTD_outBuffer ob = {buf, sizeof(buf), 0};
+            if (ZSTD_isError(ZSTD_compressStream(cs, &ob, &ib)))
+                return false;
+            out->write(buf, ob.pos);
+        }
+        if (finish) {
+            size_t left;
+            do {
+                ZSTD_outBuffer ob = {buf, sizeof(buf), 0};
+                left = ZSTD_endStream(cs, &ob);
+                if (ZSTD_isError(left))
+                    return false;
+                out->write(buf, ob.pos);
+            } while (left > 0);
+        }
+        return out->good();
+    }
+    bool valid;
+
+private:
+    ZSTD_CStream *cs;
+};
+#endif
+
+static DRW_Inflater *createInflater(DRW::Compression c){
+#ifdef DRW_HAVE_ZLIB
+    if (c == DRW::GZIP_COMPRESSION) {
+        DRW_ZlibInflater *z = new DRW_ZlibInflater();
+        if (z->valid)
+            return z;
+        delete z;
+    }
+#endif
+#ifdef DRW_HAVE_ZSTD
+    if (c == DRW::ZSTD_COMPRESSION) {
+        DRW_ZstdInflater *z = new DRW_ZstdInflater();
+        if (z->valid)
+            return z;
+        delete z;
+    }
+#endif
+    DRW_UNUSED(c);
+    return NULL;
+}
+
+static DRW_Deflater *createDeflater(DRW::Compression c, int level){
+#ifdef DRW_HAVE_ZLIB
+    if (c == DRW::GZIP_COMPRESSION) {
+        DRW_ZlibDeflater *z = new DRW_ZlibDeflater(level);
+        if (z->valid)
+            return z;
+        delete z;
+    }
+#endif
+#ifdef DRW_HAVE_ZSTD
+    if (c == DRW::ZSTD_COMPRESSION) {
+        DRW_ZstdDeflater *z = new DRW_ZstdDeflater(level);
+        if (z->valid)
+            return z;
+        delete z;
+    }
+#endif
+    DRW_UNUSED(c);
+    DRW_UNUSED(level);
+    return NULL;
+}
+
+DRW_DecompressSource::DRW_DecompressSource(std::istream *in, DRW::Compression c){
+    input = in;
+    codec = createInflater(c);
+    inPos = inLen = 0;
+    inTotal = outTotal = 0;
+    frameEnd = false;
+    error = false;
+}
+
+DRW_DecompressSource::~DRW_DecompressSource(){
+    delete codec;
+}
+
+duint64 DRW_DecompressSource::consumed() const{
+    return inTotal - (inLen - inPos);
+}
+
+size_t DRW_DecompressSource::read(char *buf, size_t n){
+    if (codec == NULL || error || n == 0)
+        return 0;
+    size_t made = 0;
+    while (made == 0) {
+        if (inPos == inLen) {
+            inBuf.resize(INSIZE);
+            input->read(&inBuf[0], INSIZE);
+            inLen = static_cast<size_t>(input->gcount());
+            inPos = 0;
+            inTotal += inLen;
+            if (inLen == 0) {
+                //truncated if it ends inside a member or frame
+                error = !frameEnd;
+                return 0;
+            }
+        }
+        if (frameEnd) { //concatenated members or frames
+            frameEnd = false;
+            if (!codec->reset()) {
+                error = true;
+                return 0;
+            }
+        }
+        size_t used = 0;
+        if (!codec->run(&inBuf[inPos], inLen - inPos, &used, buf, n, &made, &frameEnd)) {
+            error = true;
+            return 0;
+        }
+        inPos += used;
+    }
+    outTotal += made;
+    return made;
+}
+
+DRW_CompressStreamBuf::DRW_CompressStreamBuf(std::ostream *out, DRW::Compression c, int level){
+    output = out;
+    codec = createDeflater(c, level);
+    error = false;
+    threaded = false;
+    finished = false;
+    current = new std::vector<char>(BLOCKSIZE);
+    setp(&(*current)[0], &(*current)[0] + BLOCKSIZE);
+    if (codec == NULL)
+        return;
+    for (int i = 1; i < BLOCKS; ++i)
+        empty.push(new std::vector<char>(BLOCKSIZE));
+    try {
+        worker = std::thread(&DRW_CompressStreamBuf::compressBlocks, this);
+        threaded = true;
+    } catch (...) {
+        threaded = false;
+    }
+}
+
+DRW_CompressStreamBuf::~DRW_CompressStreamBuf(){
+    finish();
+    delete codec;
+    delete current;
+}
+
+DRW_CompressStreamBuf::int_type DRW_CompressStreamBuf::overflow(int_type c){
+    if (finished || codec == NULL || !nextBlock())
+        return traits_type::eof();
+    if (!traits_type::eq_int_type(c, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+
+/*hands the full block to the compressor and takes an empty one*/
+bool DRW_CompressStreamBuf::nextBlock(){
+    current->resize(pptr() - pbase());
+    if (threaded) {
+        full.push(current);
+        current = empty.pop();
+        if (current == NULL) {
+            setp(NULL, NULL);
+            return false;
+        }
+    } else if (!compress(current)) {
+        error = true;
+    }
+    current->resize(BLOCKSIZE);
+    setp(&(*current)[0], &(*current)[0] + BLOCKSIZE);
+    return !error;
+}
+
+/*runs in the worker thread*/
+void DRW_CompressStreamBuf::compressBlocks(){
+    std::vector<char> *block;
+    while ((block = full.pop()) != NULL) {
+        if (!error && !compress(block))
+            error = true;
+        empty.push(block);
+    }
+}
+
+bool DRW_CompressStreamBuf::compress(std::vector<char> *block){
+    if (block->empty())
+        return true;
+    return codec->run(&(*block)[0], block->size(), false, output);
+}
+
+bool DRW_CompressStreamBuf::finish(){
+    if (finished)
+        return !error;
+    finished = true;
+    if (codec == NULL)
+        return false;
+    if (current != NULL)
+        current->resize(pptr() - pbase());
+    setp(NULL, NULL);
+    if (threaded) {
+        if (current != NULL)
+            full.push(current);
+        current = NULL;
+        full.close();
+        worker.join();
+    } else if (current != NULL && !compress(current)) {
+        error = true;
+    }
+    if (!error && !codec->run(NULL, 0, true, output))
+        error = true;
+    output->flush();
+    if (!output->good())
+        error = true;
+    return !error;
+}
+
+namespace DRW {
+
+bool compressionSupported(Compression c){
+    switch (c) {
+    case NO_COMPRESSION:
+        return true;
+#ifdef DRW_HAVE_ZLIB
+    case GZIP_COMPRESSION:
+        return true;
+#endif
+#ifdef DRW_HAVE_ZSTD
+    case ZSTD_COMPRESSION:
+        return true;
+#endif
+    default:
+        break;
+    }
+    return false;
+}
+
+}
@@ -0,0 +1,99 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_COMPRESS_H
+#define DRW_COMPRESS_H
+
+#include <ostream>
+#include "drw_input.h"
+
+class DRW_Inflater;
+class DRW_Deflater;
+
+//! Decompresses a gzip or zstd stream.
+/*!
+*  Concatenated gzip members and zstd frames are read as one stream.
+*  ok() is false if the compression is not supported in this build,
+*  failed() is true after corrupt or truncated data.
+*/
+class DRW_DecompressSource : public DRW_InputSource {
+public:
+    DRW_DecompressSource(std::istream *in, DRW::Compression c);
+    ~DRW_DecompressSource();
+    virtual size_t read(char *buf, size_t n);
+    bool ok() const {return codec != NULL;}
+    bool failed() const {return error;}
+    duint64 consumed() const; /*!< compressed bytes used */
+    duint64 produced() const {return outTotal;} /*!< decompressed bytes returned */
+
+private:
+    DRW_DecompressSource(const DRW_DecompressSource&);
+    DRW_DecompressSource &operator=(const DRW_DecompressSource&);
+
+private:
+    enum { INSIZE = 65536 };
+    std::istream *input;
+    DRW_Inflater *codec;
+    std::vector<char> inBuf;
+    size_t inPos;
+    size_t inLen;
+    duint64 inTotal;
+    duint64 outTotal;
+    bool frameEnd;  /*!< at the end of a gzip member or zstd frame */
+    bool error;
+};
+
+//! Output stream buffer that compresses to another stream.
+/*!
+*  The formatted data is collected in blocks compressed by a background
+*  thread while the next block is written. finish() must be called at the
+*  end, it writes the end of the compressed stream.
+*/
+class DRW_CompressStreamBuf : public std::streambuf {
+public:
+    DRW_CompressStreamBuf(std::ostream *out, DRW::Compression c, int level);
+    ~DRW_CompressStreamBuf();
+    bool ok() const {return codec != NULL;}
+    /** flushes the data and ends the compressed stream, false on error */
+    bool finish();
+
+protected:
+    virtual int_type overflow(int_type c);
+
+private:
+    DRW_CompressStreamBuf(const DRW_CompressStreamBuf&);
+    DRW_CompressStreamBuf &operator=(const DRW_CompressStreamBuf&);
+    bool nextBlock();
+    void compressBlocks();
+    bool compress(std::vector<char> *block);
+
+private:
+    enum { BLOCKSIZE = 262144, BLOCKS = 3 };
+    std::ostream *output;
+    DRW_Deflater *codec;
+    DRW_BlockQueue empty;   /*!< blocks ready to be written */
+    DRW_BlockQueue full;    /*!< blocks ready to be compressed */
+    std::vector<char> *current;
+    std::thread worker;
+    std::atomic<bool> error;
+    bool threaded;
+    bool finished;
+};
+
+namespace DRW {
+
+/** true if 'c' can be read and written in this build */
+bool compressionSupported(Compression c);
+
+}
+
+#endif // DRW_COMPRESS_H
@@ -14,7 +14,7 @@
 #include <iomanip>
 #include "drw_dbg.h"
 
-DRW_dbg *DRW_dbg::instance= NULL;
+thread_local DRW_dbg DRW_dbg::instance;
 
 /*********private clases*************/
 class print_none {
@@ -48,19 +48,16 @@ private:
 };
 
 /********* debug class *************/
-DRW_dbg *DRW_dbg::getInstance(){
-    if (instance == NULL){
-        instance = new DRW_dbg;
-    }
-    return instance;
-}
-
 DRW_dbg::DRW_dbg(){
     level = NONE;
     prClass = new print_none;
     flags = std::cerr.flags();
 }
 
+DRW_dbg::~DRW_dbg(){
+    delete prClass;
+}
+
 void DRW_dbg::setLevel(LEVEL lvl){
     level = lvl;
     delete prClass;
@@ -73,10 +70,6 @@ void DRW_dbg::setLevel(LEVEL lvl){
     }
 }
 
-DRW_dbg::LEVEL DRW_dbg::getLevel(){
-    return level;
-}
-
 void DRW_dbg::print(std::string s){
     prClass->printS(s);
 }
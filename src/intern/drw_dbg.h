@@ -17,13 +17,28 @@
 #include <iostream>
 //#include <iomanip>
 
+/* Build with DRW_NO_DEBUG defined to remove all debug output at compile time.
+ * The arguments are always evaluated exactly once, many dwg parse routines
+ * read (and discard) stream fields inside a debug call, but nothing is
+ * converted nor printed unless the level is DEBUG. */
+#ifdef DRW_NO_DEBUG
+#define DRW_DBGSL(a) ((void)(a))
+#define DRW_DBGGL DRW_dbg::NONE
+#define DRW_DBG(a) ((void)(a))
+#define DRW_DBGH(a) ((void)(a))
+#define DRW_DBGB(a) ((void)(a))
+#define DRW_DBGHL(a, b, c) ((void)(a), (void)(b), (void)(c))
+#define DRW_DBGPT(a, b, c) ((void)(a), (void)(b), (void)(c))
+#else
+#define DRW_DBGON (DRW_dbg::getInstance()->getLevel() == DRW_dbg::DEBUG)
 #define DRW_DBGSL(a) DRW_dbg::getInstance()->setLevel(a)
 #define DRW_DBGGL DRW_dbg::getInstance()->getLevel()
-#define DRW_DBG(a) DRW_dbg::getInstance()->print(a)
-#define DRW_DBGH(a) DRW_dbg::getInstance()->printH(a)
-#define DRW_DBGB(a) DRW_dbg::getInstance()->printB(a)
-#define DRW_DBGHL(a, b, c) DRW_dbg::getInstance()->printHL(a, b ,c)
-#define DRW_DBGPT(a, b, c) DRW_dbg::getInstance()->printPT(a, b, c)
+#define DRW_DBG(a) (DRW_DBGON ? DRW_dbg::getInstance()->print(a) : (void)(a))
+#define DRW_DBGH(a) (DRW_DBGON ? DRW_dbg::getInstance()->printH(a) : (void)(a))
+#define DRW_DBGB(a) (DRW_DBGON ? DRW_dbg::getInstance()->printB(a) : (void)(a))
+#define DRW_DBGHL(a, b, c) (DRW_DBGON ? DRW_dbg::getInstance()->printHL(a, b ,c) : ((void)(a), (void)(b), (void)(c)))
+#define DRW_DBGPT(a, b, c) (DRW_DBGON ? DRW_dbg::getInstance()->printPT(a, b, c) : ((void)(a), (void)(b), (void)(c)))
+#endif
 
 
 class print_none;
@@ -35,8 +50,9 @@ public:
         DEBUG
     };
     void setLevel(LEVEL lvl);
-    LEVEL getLevel();
-    static DRW_dbg *getInstance();
+    LEVEL getLevel(){return level;}
+    /** one instance per thread, the level set in a thread does not affect others */
+    static DRW_dbg *getInstance(){return &instance;}
     void print(std::string s);
     void print(int i);
     void print(unsigned int i);
@@ -51,7 +67,8 @@ public:
 
 private:
     DRW_dbg();
-    static DRW_dbg *instance;
+    ~DRW_dbg();
+    static thread_local DRW_dbg instance;
     LEVEL level;
     std::ios_base::fmtflags flags;
     print_none* prClass;
@@ -0,0 +1,139 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_entitycopy.h"
+#include "../drw_entities.h"
+
+DRW_Entity *DRW::copyEntity(const DRW_Entity &e){
+    switch (e.eType) {
+    case DRW::POINT:
+        return new DRW_Point(static_cast<const DRW_Point &>(e));
+    case DRW::LINE:
+        return new DRW_Line(static_cast<const DRW_Line &>(e));
+    case DRW::RAY:
+        return new DRW_Ray(static_cast<const DRW_Ray &>(e));
+    case DRW::XLINE:
+        return new DRW_Xline(static_cast<const DRW_Xline &>(e));
+    case DRW::CIRCLE:
+        return new DRW_Circle(static_cast<const DRW_Circle &>(e));
+    case DRW::ARC:
+        return new DRW_Arc(static_cast<const DRW_Arc &>(e));
+    case DRW::ELLIPSE:
+        return new DRW_Ellipse(static_cast<const DRW_Ellipse &>(e));
+    case DRW::TRACE:
+        return new DRW_Trace(static_cast<const DRW_Trace &>(e));
+    case DRW::SOLID:
+        return new DRW_Solid(static_cast<const DRW_Solid &>(e));
+    case DRW::E3DFACE:
+        return new DRW_3Dface(static_cast<const DRW_3Dface &>(e));
+    case DRW::LWPOLYLINE:
+        return new DRW_LWPolyline(static_cast<const DRW_LWPolyline &>(e));
+    case DRW::POLYLINE: {
+        DRW_Polyline *pl = new DRW_Polyline(static_cast<const DRW_Polyline &>(e));
+        for (std::vector<DRW_Vertex *>::iterator it = pl->vertlist.begin(); it != pl->vertlist.end(); ++it)
+            *it = new DRW_Vertex(**it);
+        return pl; }
+    case DRW::SPLINE: {
+        DRW_Spline *sp = new DRW_Spline(static_cast<const DRW_Spline &>(e));
+        for (std::vector<DRW_Coord *>::iterator it = sp->controllist.begin(); it != sp->controllist.end(); ++it)
+            *it = new DRW_Coord(**it);
+        for (std::vector<DRW_Coord *>::iterator it = sp->fitlist.begin(); it != sp->fitlist.end(); ++it)
+            *it = new DRW_Coord(**it);
+        return sp; }
+    case DRW::INSERT:
+        return new DRW_Insert(static_cast<const DRW_Insert &>(e));
+    case DRW::TEXT:
+        return new DRW_Text(static_cast<const DRW_Text &>(e));
+    case DRW::MTEXT:
+        return new DRW_MText(static_cast<const DRW_MText &>(e));
+    case DRW::HATCH: {
+        DRW_Hatch *ht = new DRW_Hatch(static_cast<const DRW_Hatch &>(e));
+        for (std::vector<DRW_HatchLoop *>::iterator it = ht->looplist.begin(); it != ht->looplist.end(); ++it) {
+            DRW_HatchLoop *loop = new DRW_HatchLoop(**it);
+            std::vector<DRW_Entity *> edges;
+            for (std::vector<DRW_Entity *>::iterator ed = loop->objlist.begin(); ed != loop->objlist.end(); ++ed) {
+                DRW_Entity *c = copyEntity(**ed);
+                if (c != NULL)
+                    edges.push_back(c);
+            }
+            loop->objlist.swap(edges);
+            *it = loop;
+        }
+        return ht; }
+    case DRW::LEADER: {
+        DRW_Leader *ld = new DRW_Leader(static_cast<const DRW_Leader &>(e));
+        for (std::vector<DRW_Coord *>::iterator it = ld->vertexlist.begin(); it != ld->vertexlist.end(); ++it)
+            *it = new DRW_Coord(**it);
+        return ld; }
+    case DRW::DIMALIGNED:
+        return new DRW_DimAligned(static_cast<const DRW_DimAligned &>(e));
+    case DRW::DIMLINEAR:
+        return new DRW_DimLinear(static_cast<const DRW_DimLinear &>(e));
+    case DRW::DIMRADIAL:
+        return new DRW_DimRadial(static_cast<const DRW_DimRadial &>(e));
+    case DRW::DIMDIAMETRIC:
+        return new DRW_DimDiametric(static_cast<const DRW_DimDiametric &>(e));
+    case DRW::DIMANGULAR:
+        return new DRW_DimAngular(static_cast<const DRW_DimAngular &>(e));
+    case DRW::DIMANGULAR3P:
+        return new DRW_DimAngular3p(static_cast<const DRW_DimAngular3p &>(e));
+    case DRW::DIMORDINATE:
+        return new DRW_DimOrdinate(static_cast<const DRW_DimOrdinate &>(e));
+    case DRW::VIEWPORT:
+        return new DRW_Viewport(static_cast<const DRW_Viewport &>(e));
+    case DRW::IMAGE:
+        return new DRW_Image(static_cast<const DRW_Image &>(e));
+    default:
+        return NULL;
+    }
+}
+
+void DRW::freeLists(DRW_Entity *e){
+    if (e->eType == DRW::LWPOLYLINE) {
+        DRW_LWPolyline *pl = static_cast<DRW_LWPolyline *>(e);
+        for (std::vector<DRW_Vertex2D *>::iterator it = pl->vertlist.begin(); it != pl->vertlist.end(); ++it)
+            delete *it;
+        pl->vertlist.clear();
+    } else if (e->eType == DRW::POLYLINE) {
+        DRW_Polyline *pl = static_cast<DRW_Polyline *>(e);
+        for (std::vector<DRW_Vertex *>::iterator it = pl->vertlist.begin(); it != pl->vertlist.end(); ++it)
+            delete *it;
+        pl->vertlist.clear();
+    } else if (e->eType == DRW::SPLINE) {
+        DRW_Spline *sp = static_cast<DRW_Spline *>(e);
+        for (std::vector<DRW_Coord *>::iterator it = sp->controllist.begin(); it != sp->controllist.end(); ++it)
+            delete *it;
+        for (std::vector<DRW_Coord *>::iterator it = sp->fitlist.begin(); it != sp->fitlist.end(); ++it)
+            delete *it;
+        sp->controllist.clear();
+        sp->fitlist.clear();
+    } else if (e->eType == DRW::HATCH) {
+        DRW_Hatch *ht = static_cast<DRW_Hatch *>(e);
+        for (std::vector<DRW_HatchLoop *>::iterator it = ht->looplist.begin(); it != ht->looplist.end(); ++it) {
+            for (std::vector<DRW_Entity *>::iterator ed = (*it)->objlist.begin(); ed != (*it)->objlist.end(); ++ed)
+                destroyEntity(*ed);
+            (*it)->objlist.clear();
+            delete *it;
+        }
+        ht->looplist.clear();
+    } else if (e->eType == DRW::LEADER) {
+        DRW_Leader *ld = static_cast<DRW_Leader *>(e);
+        for (std::vector<DRW_Coord *>::iterator it = ld->vertexlist.begin(); it != ld->vertexlist.end(); ++it)
+            delete *it;
+        ld->vertexlist.clear();
+    }
+}
+
+void DRW::destroyEntity(DRW_Entity *e){
+    freeLists(e);
+    delete e;
+}
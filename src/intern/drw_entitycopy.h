@@ -0,0 +1,32 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_ENTITYCOPY_H
+#define DRW_ENTITYCOPY_H
+
+class DRW_Entity;
+
+namespace DRW {
+
+/** copy of 'e' with its own lists, NULL for the types not copied */
+DRW_Entity *copyEntity(const DRW_Entity &e);
+
+/** deletes the vertices, control & fit points, loops & leader points of 'e',
+    the destructors of the entities do not free them */
+void freeLists(DRW_Entity *e);
+
+/** frees the lists of 'e' & deletes it */
+void destroyEntity(DRW_Entity *e);
+
+}
+
+#endif // DRW_ENTITYCOPY_H
@@ -0,0 +1,374 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_input.h"
+#include <cstring>
+#include <cerrno>
+#include <sys/types.h>
+#include <sys/stat.h>
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#define DRW_READ(f, b, n) _read(f, b, (unsigned int)(n))
+#define DRW_OPEN(name) _open(name, _O_RDONLY | _O_BINARY)
+#define DRW_CLOSE(f) _close(f)
+#define DRW_LSEEK(f, o, w) _lseeki64(f, o, w)
+#define DRW_FSTAT(f, s) _fstati64(f, s)
+typedef struct _stati64 drw_stat_t;
+#ifndef S_ISREG
+#define S_ISREG(m) (((m) & _S_IFMT) == _S_IFREG)
+#endif
+#else
+#include <unistd.h>
+#include <fcntl.h>
+#define DRW_READ(f, b, n) ::read(f, b, n)
+#define DRW_OPEN(name) ::open(name, O_RDONLY)
+#define DRW_CLOSE(f) ::close(f)
+#define DRW_LSEEK(f, o, w) ::lseek(f, o, w)
+#define DRW_FSTAT(f, s) ::fstat(f, s)
+typedef struct stat drw_stat_t;
+#endif
+
+DRW_FdStreamBuf::DRW_FdStreamBuf(int f){
+    fd = f;
+    base = DRW_LSEEK(fd, 0, SEEK_CUR);
+    if (base < 0) //not seekable, pipe or socket
+        base = 0;
+    endPos = base;
+    setg(buf, buf, buf);
+}
+
+/*the descriptor is always at the end of the buffered data*/
+DRW_FdStreamBuf::int_type DRW_FdStreamBuf::underflow(){
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    //keep the last bytes, seeks back do not need the descriptor
+    size_t keep = gptr() - eback();
+    if (keep > PUTBACK)
+        keep = PUTBACK;
+    memmove(buf + PUTBACK - keep, gptr() - keep, keep);
+    long n;
+    do {
+        n = DRW_READ(fd, buf + PUTBACK, BUFSIZE - PUTBACK);
+    } while (n < 0 && errno == EINTR);
+    if (n < 0)
+        n = 0;
+    setg(buf + PUTBACK - keep, buf + PUTBACK, buf + PUTBACK + n);
+    endPos += n;
+    if (n == 0)
+        return traits_type::eof();
+    return traits_type::to_int_type(*gptr());
+}
+
+DRW_FdStreamBuf::pos_type DRW_FdStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir,
+                                                  std::ios_base::openmode which){
+    dint64 target;
+    if (dir == std::ios_base::beg) {
+        target = off;
+    } else if (dir == std::ios_base::cur) {
+        target = endPos - base - (egptr() - gptr()) + off;
+    } else {
+        drw_stat_t st;
+        if (DRW_FSTAT(fd, &st) != 0 || !S_ISREG(st.st_mode))
+            return pos_type(off_type(-1));
+        target = (dint64)st.st_size - base + off;
+    }
+    return seekpos(pos_type(target), which);
+}
+
+DRW_FdStreamBuf::pos_type DRW_FdStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which){
+    dint64 target = off_type(pos);
+    if (!(which & std::ios_base::in) || target < 0)
+        return pos_type(off_type(-1));
+    //inside the buffer, no system call
+    dint64 start = endPos - base - (egptr() - eback());
+    if (target >= start && target <= endPos - base) {
+        setg(eback(), eback() + (target - start), egptr());
+        return pos;
+    }
+    if (DRW_LSEEK(fd, base + target, SEEK_SET) < 0)
+        return pos_type(off_type(-1));
+    endPos = base + target;
+    setg(buf, buf, buf);
+    return pos;
+}
+
+DRW_MemStreamBuf::DRW_MemStreamBuf(const char *data, size_t size){
+    char *p = const_cast<char*>(data); //never written
+    setg(p, p, p + size);
+}
+
+DRW_MemStreamBuf::pos_type DRW_MemStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir,
+                                                    std::ios_base::openmode which){
+    off_type target = off;
+    if (dir == std::ios_base::cur)
+        target += gptr() - eback();
+    else if (dir == std::ios_base::end)
+        target += egptr() - eback();
+    return seekpos(pos_type(target), which);
+}
+
+DRW_MemStreamBuf::pos_type DRW_MemStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which){
+    off_type target = off_type(pos);
+    if (!(which & std::ios_base::in) || target < 0 || target > egptr() - eback())
+        return pos_type(off_type(-1));
+    setg(eback(), eback() + target, egptr());
+    return pos;
+}
+
+DRW_SourceStreamBuf::DRW_SourceStreamBuf(DRW_InputSource *src){
+    source = src;
+    endPos = 0;
+    setg(buf, buf, buf);
+}
+
+DRW_SourceStreamBuf::int_type DRW_SourceStreamBuf::underflow(){
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+    //keep the last bytes for seeks back
+    size_t keep = gptr() - eback();
+    if (keep > PUTBACK)
+        keep = PUTBACK;
+    memmove(buf + PUTBACK - keep, gptr() - keep, keep);
+    size_t n = source->read(buf + PUTBACK, BUFSIZE - PUTBACK);
+    if (n > BUFSIZE - PUTBACK) //misbehaving source
+        n = 0;
+    setg(buf + PUTBACK - keep, buf + PUTBACK, buf + PUTBACK + n);
+    endPos += n;
+    if (n == 0)
+        return traits_type::eof();
+    return traits_type::to_int_type(*gptr());
+}
+
+DRW_SourceStreamBuf::pos_type DRW_SourceStreamBuf::seekoff(off_type off, std::ios_base::seekdir dir,
+                                                          std::ios_base::openmode which){
+    if (dir == std::ios_base::end)
+        return pos_type(off_type(-1));
+    off_type target = off;
+    if (dir == std::ios_base::cur)
+        target += endPos - (egptr() - gptr());
+    return seekpos(pos_type(target), which);
+}
+
+DRW_SourceStreamBuf::pos_type DRW_SourceStreamBuf::seekpos(pos_type pos, std::ios_base::openmode which){
+    dint64 target = off_type(pos);
+    dint64 start = endPos - (egptr() - eback());
+    if (!(which & std::ios_base::in) || target < start || target > endPos)
+        return pos_type(off_type(-1));
+    setg(eback(), eback() + (target - start), egptr());
+    return pos;
+}
+
+/*returns what is available, waits only when nothing is buffered*/
+size_t DRW_StreamSource::read(char *buf, size_t n){
+    std::streambuf *sb = stream->rdbuf();
+    if (n == 0 || sb == NULL || sb->sgetc() == std::char_traits<char>::eof())
+        return 0;
+    std::streamsize avail = sb->in_avail();
+    if (avail < 1)
+        avail = 1;
+    if ((size_t)avail > n)
+        avail = n;
+    std::streamsize got = sb->sgetn(buf, avail);
+    return (got < 0) ? 0 : got;
+}
+
+DRW_FdSource::DRW_FdSource(const char *name){
+    fd = DRW_OPEN(name);
+    owned = true;
+}
+
+DRW_FdSource::~DRW_FdSource(){
+    if (owned && fd >= 0)
+        DRW_CLOSE(fd);
+}
+
+size_t DRW_FdSource::read(char *buf, size_t n){
+    if (fd < 0)
+        return 0;
+    if (n > 0x40000000) //fits in the read size of all systems
+        n = 0x40000000;
+    long r;
+    do {
+        r = DRW_READ(fd, buf, n);
+    } while (r < 0 && errno == EINTR);
+    return (r < 0) ? 0 : r;
+}
+
+DRW_BlockQueue::~DRW_BlockQueue(){
+    for (std::deque<std::vector<char>*>::iterator it = blocks.begin(); it != blocks.end(); ++it)
+        delete *it;
+}
+
+void DRW_BlockQueue::push(std::vector<char> *block){
+    std::lock_guard<std::mutex> lock(mtx);
+    blocks.push_back(block);
+    cond.notify_one();
+}
+
+std::vector<char> *DRW_BlockQueue::pop(){
+    std::unique_lock<std::mutex> lock(mtx);
+    while (blocks.empty() && !closed)
+        cond.wait(lock);
+    if (blocks.empty())
+        return NULL;
+    std::vector<char> *block = blocks.front();
+    blocks.pop_front();
+    return block;
+}
+
+void DRW_BlockQueue::close(){
+    std::lock_guard<std::mutex> lock(mtx);
+    closed = true;
+    cond.notify_all();
+}
+
+DRW_ReadAheadSource::DRW_ReadAheadSource(DRW_InputSource *src){
+    source = src;
+    current = NULL;
+    currentPos = 0;
+    stopping = false;
+    for (int i = 0; i < BLOCKS; ++i)
+        empty.push(new std::vector<char>());
+    try {
+        worker = std::thread(&DRW_ReadAheadSource::fillBlocks, this);
+        threaded = true;
+    } catch (...) {
+        threaded = false;
+    }
+}
+
+DRW_ReadAheadSource::~DRW_ReadAheadSource(){
+    //stops the thread before the end of the data if the parser gave up
+    stopping = true;
+    empty.close();
+    if (threaded)
+        worker.join();
+    delete current;
+}
+
+/*runs in the worker thread, an empty block marks the end of the data*/
+void DRW_ReadAheadSource::fillBlocks(){
+    bool end = false;
+    while (!end && !stopping) {
+        std::vector<char> *block = empty.pop();
+        if (block == NULL)
+            break;
+        block->resize(BLOCKSIZE);
+        size_t used = 0;
+        while (used < BLOCKSIZE) {
+            size_t n = source->read(&(*block)[used], BLOCKSIZE - used);
+            if (n == 0 || n > BLOCKSIZE - used) {
+                end = true;
+                break;
+            }
+            used += n;
+        }
+        block->resize(used);
+        full.push(block);
+        if (used == 0)
+            end = true;
+    }
+    full.close();
+}
+
+size_t DRW_ReadAheadSource::read(char *buf, size_t n){
+    if (!threaded)
+        return source->read(buf, n);
+    while (current == NULL || currentPos >= current->size()) {
+        if (current != NULL) {
+            if (current->empty()) //end of data
+                return 0;
+            empty.push(current);
+        }
+        current = full.pop();
+        currentPos = 0;
+        if (current == NULL)
+            return 0;
+    }
+    size_t len = current->size() - currentPos;
+    if (len > n)
+        len = n;
+    memcpy(buf, &(*current)[currentPos], len);
+    currentPos += len;
+    return len;
+}
+
+/*reads up to n bytes and puts them back, avoids a seek*/
+static std::streamsize peekBytes(std::istream *stream, char *head, std::streamsize n){
+    std::streampos start = stream->tellg();
+    stream->read(head, n);
+    std::streamsize got = stream->gcount();
+    stream->clear();
+    std::streamsize back = 0;
+    while (back < got && stream->rdbuf()->sungetc() != std::char_traits<char>::eof())
+        ++back;
+    if (back < got)
+        stream->seekg(start);
+    return got;
+}
+
+namespace DRW {
+
+FileFormat sniffFormat(std::istream *stream, Version *ver){
+    const char sentinel[22] = "AutoCAD Binary DXF\r\n\x1a";
+    char head[22];
+    if (ver != NULL)
+        *ver = UNKNOWNV;
+    std::streamsize n = peekBytes(stream, head, 22);
+    if (n == 0)
+        return UNKNOWN_FORMAT;
+    if (n == 22 && memcmp(head, sentinel, 22) == 0) {
+        stream->ignore(22);
+        return DXF_BINARY;
+    }
+
+    if (n < 6 || memcmp(head, "AC10", 4) != 0)
+        return DXF_ASCII;
+    std::string v(head, 6);
+    Version dwgVer = UNKNOWNV;
+    if (v == "AC1006")
+        dwgVer = AC1006;
+    else if (v == "AC1009")
+        dwgVer = AC1009;
+    else if (v == "AC1012")
+        dwgVer = AC1012;
+    else if (v == "AC1014")
+        dwgVer = AC1014;
+    else if (v == "AC1015")
+        dwgVer = AC1015;
+    else if (v == "AC1018")
+        dwgVer = AC1018;
+    else if (v == "AC1021")
+        dwgVer = AC1021;
+    else if (v == "AC1024")
+        dwgVer = AC1024;
+    else if (v == "AC1027")
+        dwgVer = AC1027;
+    else if (v == "AC1032")
+        dwgVer = AC1032;
+    if (ver != NULL)
+        *ver = dwgVer;
+    return DWG_FORMAT;
+}
+
+Compression sniffCompression(std::istream *stream){
+    unsigned char head[4];
+    std::streamsize n = peekBytes(stream, reinterpret_cast<char*>(head), 4);
+    if (n >= 2 && head[0] == 0x1f && head[1] == 0x8b)
+        return GZIP_COMPRESSION;
+    if (n == 4 && head[0] == 0x28 && head[1] == 0xb5 && head[2] == 0x2f && head[3] == 0xfd)
+        return ZSTD_COMPRESSION;
+    return NO_COMPRESSION;
+}
+
+}
@@ -0,0 +1,208 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_INPUT_H
+#define DRW_INPUT_H
+
+#include <istream>
+#include <streambuf>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include "../drw_base.h"
+#include "../drw_source.h"
+
+//! Buffered and seekable input from a file descriptor.
+/*!
+*  Positions are relative to the descriptor offset when the buffer is
+*  created, seeks inside the buffered data do not call the system.
+*  Pipes and sockets can be read, the last PUTBACK bytes are kept on
+*  refill for the format detection and small seeks back.
+*  The descriptor is not closed.
+*/
+class DRW_FdStreamBuf : public std::streambuf {
+public:
+    DRW_FdStreamBuf(int fd);
+
+protected:
+    virtual int_type underflow();
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                             std::ios_base::openmode which = std::ios_base::in);
+    virtual pos_type seekpos(pos_type pos,
+                             std::ios_base::openmode which = std::ios_base::in);
+
+private:
+    DRW_FdStreamBuf(const DRW_FdStreamBuf&);
+    DRW_FdStreamBuf &operator=(const DRW_FdStreamBuf&);
+
+private:
+    enum { BUFSIZE = 65536, PUTBACK = 32 };
+    int fd;
+    dint64 base;     /*!< descriptor offset of position 0 */
+    dint64 endPos;   /*!< descriptor offset of egptr() */
+    char buf[BUFSIZE];
+};
+
+//! Seekable input from a memory buffer, without copy.
+/*!
+*  The buffer must remain valid while it is read.
+*/
+class DRW_MemStreamBuf : public std::streambuf {
+public:
+    DRW_MemStreamBuf(const char *data, size_t size);
+
+protected:
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                             std::ios_base::openmode which = std::ios_base::in);
+    virtual pos_type seekpos(pos_type pos,
+                             std::ios_base::openmode which = std::ios_base::in);
+};
+
+//! Buffered input from a DRW_InputSource.
+/*!
+*  Sequential, seeks are only possible inside the buffered data, the
+*  last PUTBACK bytes are kept in the buffer on refill to allow small
+*  seeks back, enough to put back the bytes read by sniffFormat().
+*/
+class DRW_SourceStreamBuf : public std::streambuf {
+public:
+    DRW_SourceStreamBuf(DRW_InputSource *src);
+
+protected:
+    virtual int_type underflow();
+    virtual pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+                             std::ios_base::openmode which = std::ios_base::in);
+    virtual pos_type seekpos(pos_type pos,
+                             std::ios_base::openmode which = std::ios_base::in);
+
+private:
+    DRW_SourceStreamBuf(const DRW_SourceStreamBuf&);
+    DRW_SourceStreamBuf &operator=(const DRW_SourceStreamBuf&);
+
+private:
+    enum { BUFSIZE = 65536, PUTBACK = 32 };
+    DRW_InputSource *source;
+    dint64 endPos;   /*!< stream position of egptr() */
+    char buf[BUFSIZE];
+};
+
+//! DRW_InputSource over a non seekable std::istream (pipe, socket).
+/*!
+*  Each read returns the data already buffered by the stream, the
+*  parser does not wait for a full buffer before it starts.
+*/
+class DRW_StreamSource : public DRW_InputSource {
+public:
+    DRW_StreamSource(std::istream *s) : stream(s) {}
+    virtual size_t read(char *buf, size_t n);
+
+private:
+    std::istream *stream;
+};
+
+//! DRW_InputSource reading a file descriptor with large reads.
+/*!
+*  Opened from a name the descriptor is owned and closed, otherwise it
+*  is read from its current offset and left open.
+*/
+class DRW_FdSource : public DRW_InputSource {
+public:
+    DRW_FdSource(int f) : fd(f), owned(false) {}
+    DRW_FdSource(const char *name);
+    ~DRW_FdSource();
+    bool isOpen() const {return fd >= 0;}
+    virtual size_t read(char *buf, size_t n);
+
+private:
+    DRW_FdSource(const DRW_FdSource&);
+    DRW_FdSource &operator=(const DRW_FdSource&);
+
+private:
+    int fd;
+    bool owned;
+};
+
+//! Queue of data blocks passed between two threads.
+/*!
+*  pop() waits for a block, it returns NULL once the queue is closed and
+*  empty. The blocks left in the queue are deleted with it.
+*/
+class DRW_BlockQueue {
+public:
+    DRW_BlockQueue() : closed(false) {}
+    ~DRW_BlockQueue();
+    void push(std::vector<char> *block);
+    std::vector<char> *pop();
+    void close();
+
+private:
+    DRW_BlockQueue(const DRW_BlockQueue&);
+    DRW_BlockQueue &operator=(const DRW_BlockQueue&);
+
+private:
+    std::mutex mtx;
+    std::condition_variable cond;
+    std::deque<std::vector<char>*> blocks;
+    bool closed;
+};
+
+//! Reads another source ahead on a background thread.
+/*!
+*  BLOCKS buffers of BLOCKSIZE bytes circulate between the reader thread,
+*  which fills them from 'src', and read(), so the work of 'src' (i/o,
+*  decompression) overlaps with the parser. If the thread can not be
+*  started 'src' is read directly.
+*/
+class DRW_ReadAheadSource : public DRW_InputSource {
+public:
+    DRW_ReadAheadSource(DRW_InputSource *src);
+    ~DRW_ReadAheadSource();
+    virtual size_t read(char *buf, size_t n);
+
+private:
+    DRW_ReadAheadSource(const DRW_ReadAheadSource&);
+    DRW_ReadAheadSource &operator=(const DRW_ReadAheadSource&);
+    void fillBlocks();
+
+private:
+    enum { BLOCKSIZE = 262144, BLOCKS = 3 };
+    DRW_InputSource *source;
+    DRW_BlockQueue empty;   /*!< blocks ready to be filled */
+    DRW_BlockQueue full;    /*!< blocks ready to be read */
+    std::vector<char> *current;
+    size_t currentPos;
+    std::thread worker;
+    std::atomic<bool> stopping;
+    bool threaded;
+};
+
+namespace DRW {
+
+/** Detects the format reading the first bytes of 'stream', and the dwg
+*  version in 'ver' if it is not NULL. On return the stream is at the
+*  data to parse: after the sentinel in binary dxf, at the start
+*  otherwise. The bytes read are put back in the stream buffer when
+*  possible, to not seek the file.
+*/
+FileFormat sniffFormat(std::istream *stream, Version *ver);
+
+/** Detects gzip or zstd magic bytes at the current position of 'stream',
+*  the bytes read are put back like in sniffFormat().
+*/
+Compression sniffCompression(std::istream *stream);
+
+}
+
+#endif // DRW_INPUT_H
@@ -3,7 +3,14 @@
 #include <iomanip>
 #include <algorithm>
 #include <cstring>
+#include <cerrno>
+#include <map>
+#include <mutex>
 #include <iconv.h>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define DRW_TEXTCODEC_SSE2
+#endif
 #include "../drw_base.h"
 #include "drw_cptables.h"
 #include "drw_cptable932.h"
@@ -13,6 +20,7 @@
 
 DRW_TextCodec::DRW_TextCodec() {
     version = DRW::AC1021;
+    minVersion = DRW::AC1032 + 1;
     conv = new DRW_Converter(NULL, 0);
 }
 
@@ -55,8 +63,7 @@ void DRW_TextCodec::setVersion(std::string *v, bool dxfFormat){
 }
 
 void DRW_TextCodec::setCodePage(std::string *c, bool dxfFormat){
-    static int min_ver = 10;
-    min_ver = std::min(min_ver, version);
+    minVersion = std::min(minVersion, version);
 
     cp = correctCodePage(*c);
     delete conv;
@@ -98,7 +105,7 @@ void DRW_TextCodec::setCodePage(std::string *c, bool dxfFormat){
             conv = new DRW_ExtConverter("SJIS");
         }
     } else {
-        if (min_ver <= DRW::AC1018) {
+        if (minVersion <= DRW::AC1018) {
             conv = new DRW_ExtConverter("SJIS");
         } else {
             if (dxfFormat)
@@ -109,23 +116,119 @@ void DRW_TextCodec::setCodePage(std::string *c, bool dxfFormat){
     }
 }
 
+/** true if 's' is 7 bit ascii, with 'escapes' also checks for \\U+ sequences.
+**  Tests 16 bytes at a time with SSE2, 8 bytes at a time otherwise.
+**/
+bool DRW_TextCodec::isPlainAscii(const char *s, size_t len, bool escapes) {
+    size_t i = 0;
+    bool backslash = false;
+#ifdef DRW_TEXTCODEC_SSE2
+    const __m128i bs = _mm_set1_epi8('\\');
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+        if (_mm_movemask_epi8(v) != 0)
+            return false;
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, bs)) != 0)
+            backslash = true;
+    }
+#else
+    const duint64 high = 0x8080808080808080ULL;
+    const duint64 ones = 0x0101010101010101ULL;
+    for (; i + 8 <= len; i += 8) {
+        duint64 w;
+        memcpy(&w, s + i, 8);
+        if (w & high)
+            return false;
+        duint64 x = w ^ (ones * '\\'); //zero byte where a backslash is
+        if ((x - ones) & ~x & high)
+            backslash = true;
+    }
+#endif
+    for (; i < len; ++i) {
+        if (s[i] & 0x80)
+            return false;
+        if (s[i] == '\\')
+            backslash = true;
+    }
+    if (!escapes || !backslash)
+        return true;
+    for (i = 0; i + 6 < len; ++i) {
+        if (s[i] == '\\' && s[i+1] == 'U' && s[i+2] == '+')
+            return false;
+    }
+    return true;
+}
+
 std::string DRW_TextCodec::toUtf8(std::string s) {
-    return conv->toUtf8(&s);
+    if (conv->keepsAscii() && isPlainAscii(s.data(), s.size(), true))
+        return s;
+    std::string res;
+    conv->toUtf8(&s, &res);
+    return res;
 }
 
 std::string DRW_TextCodec::fromUtf8(std::string s) {
-    return conv->fromUtf8(&s);
+    if (conv->keepsAscii() && isPlainAscii(s.data(), s.size(), false))
+        return s;
+    std::string res;
+    conv->fromUtf8(&s, &res);
+    return res;
+}
+
+void DRW_TextCodec::toUtf8(const std::string &s, std::string *out) {
+    if (conv->keepsAscii() && isPlainAscii(s.data(), s.size(), true))
+        out->append(s);
+    else
+        conv->toUtf8(&s, out);
+}
+
+void DRW_TextCodec::fromUtf8(const std::string &s, std::string *out) {
+    if (conv->keepsAscii() && isPlainAscii(s.data(), s.size(), false))
+        out->append(s);
+    else
+        conv->fromUtf8(&s, out);
+}
+
+void DRW_TextCodec::toUtf8(std::vector<std::string> &strs) {
+    std::string res;
+    for (std::vector<std::string>::iterator it = strs.begin(); it != strs.end(); ++it) {
+        if (conv->keepsAscii() && isPlainAscii(it->data(), it->size(), true))
+            continue;
+        res.clear();
+        conv->toUtf8(&(*it), &res);
+        it->swap(res);
+    }
+}
+
+void DRW_TextCodec::fromUtf8(std::vector<std::string> &strs) {
+    std::string res;
+    for (std::vector<std::string>::iterator it = strs.begin(); it != strs.end(); ++it) {
+        if (conv->keepsAscii() && isPlainAscii(it->data(), it->size(), false))
+            continue;
+        res.clear();
+        conv->fromUtf8(&(*it), &res);
+        it->swap(res);
+    }
 }
 
-std::string DRW_Converter::toUtf8(std::string *s) {
-    std::string result;
+void DRW_TextCodec::toUtf8(const unsigned char *data, size_t len, std::string *out) {
+    conv->toUtf8(data, len, out);
+}
+
+void DRW_Converter::toUtf8(const unsigned char *data, size_t len, std::string *out) {
+    std::string s(reinterpret_cast<const char*>(data), len);
+    toUtf8(&s, out);
+}
+
+void DRW_Converter::toUtf8(const std::string *s, std::string *out) {
+    std::string &result = *out;
     int j = 0;
     unsigned int i= 0;
     for (i=0; i < s->length(); i++) {
         unsigned char c = s->at(i);
         if (c < 0x80) { //ascii check for /U+????
             if (c == '\\' && i+6 < s->length() && s->at(i+1) == 'U' && s->at(i+2) == '+') {
-                result += s->substr(j,i-j);
+                result.append(*s, j, i-j);
                 result += encodeText(s->substr(i,7));
                 i +=6;
                 j = i+1;
@@ -138,13 +241,11 @@ std::string DRW_Converter::toUtf8(std::string *s) {
             i +=3;
         }
     }
-    result += s->substr(j);
-
-    return result;
+    result.append(*s, j, std::string::npos);
 }
 
-std::string DRW_ConvTable::fromUtf8(std::string *s) {
-    std::string result;
+void DRW_ConvTable::fromUtf8(const std::string *s, std::string *out) {
+    std::string &result = *out;
     bool notFound;
     int code;
 
@@ -152,10 +253,9 @@ std::string DRW_ConvTable::fromUtf8(std::string *s) {
     for (unsigned int i=0; i < s->length(); i++) {
         unsigned char c = s->at(i);
         if (c > 0x7F) { //need to decode
-            result += s->substr(j,i-j);
-            std::string part1 = s->substr(i,4);
+            result.append(*s, j, i-j);
             int l;
-            code = decodeNum(part1, &l);
+            code = decodeNum(*s, i, &l);
             j = i+l;
             i = j - 1;
             notFound = true;
@@ -170,14 +270,12 @@ std::string DRW_ConvTable::fromUtf8(std::string *s) {
                 result += decodeText(code);
         }
     }
-    result += s->substr(j);
-
-    return result;
+    result.append(*s, j, std::string::npos);
 }
 
-std::string DRW_ConvTable::toUtf8(std::string *s) {
-    std::string res;
-    std::string::iterator it;
+void DRW_ConvTable::toUtf8(const std::string *s, std::string *out) {
+    std::string &res = *out;
+    std::string::const_iterator it;
     for ( it=s->begin() ; it < s->end(); ++it ) {
         unsigned char c = *it;
         if (c < 0x80) {
@@ -195,8 +293,6 @@ std::string DRW_ConvTable::toUtf8(std::string *s) {
             res += encodeNum(table[c-0x80]); //translate from table
         }
     } //end for
-
-    return res;
 }
 
 std::string DRW_Converter::encodeText(std::string stmp){
@@ -252,26 +348,26 @@ std::string DRW_Converter::encodeNum(int c){
     return std::string((char*)ret);
 }
 
-/** 's' is a string with at least 4 bytes lenght
+/** decodes the utf8 char of 's' starting at 'pos', without copying it
 ** returned 'b' is byte lenght of encoded char: 2,3 or 4
 **/
-int DRW_Converter::decodeNum(std::string s, int *b){
+int DRW_Converter::decodeNum(const std::string &s, size_t pos, int *b){
     int code= 0;
-    unsigned char c = s.at(0);
+    unsigned char c = s.at(pos);
     if ( (c& 0xE0)  == 0xC0) { //2 bytes
         code = ( c&0x1F)<<6;
-        code = (s.at(1) &0x3F) | code;
+        code = (s.at(pos+1) &0x3F) | code;
         *b = 2;
     } else if ( (c& 0xF0)  == 0xE0) { //3 bytes
         code = ( c&0x0F)<<12;
-        code = ((s.at(1) &0x3F)<<6) | code;
-        code = (s.at(2) &0x3F) | code;
+        code = ((s.at(pos+1) &0x3F)<<6) | code;
+        code = (s.at(pos+2) &0x3F) | code;
         *b = 3;
     } else if ( (c& 0xF8)  == 0xF0) { //4 bytes
         code = ( c&0x07)<<18;
-        code = ((s.at(1) &0x3F)<<12) | code;
-        code = ((s.at(2) &0x3F)<<6) | code;
-        code = (s.at(3) &0x3F) | code;
+        code = ((s.at(pos+1) &0x3F)<<12) | code;
+        code = ((s.at(pos+2) &0x3F)<<6) | code;
+        code = (s.at(pos+3) &0x3F) | code;
         *b = 4;
     }
 
@@ -279,8 +375,35 @@ int DRW_Converter::decodeNum(std::string s, int *b){
 }
 
 
-std::string DRW_ConvDBCSTable::fromUtf8(std::string *s) {
-    std::string result;
+static bool lessCodePoint(const std::pair<int, int> &a, const std::pair<int, int> &b) {
+    return a.first < b.first;
+}
+
+const DRW_DBCSIndex &DRW_DBCSIndex::of(const int dt[][2], int l) {
+    static std::mutex lock;
+    static std::map<const void *, DRW_DBCSIndex> indexes;
+    std::lock_guard<std::mutex> guard(lock);
+    DRW_DBCSIndex &ix = indexes[dt];
+    if (ix.index.empty()) {
+        ix.index.reserve(l);
+        for (int k=0; k<l; k++)
+            ix.index.push_back(std::make_pair(dt[k][1], dt[k][0]));
+        //stable, duplicated code points keep the table order
+        std::stable_sort(ix.index.begin(), ix.index.end(), lessCodePoint);
+    }
+    return ix;
+}
+
+int DRW_DBCSIndex::find(int code) const {
+    std::vector<std::pair<int, int> >::const_iterator it =
+            std::lower_bound(index.begin(), index.end(), std::make_pair(code, 0), lessCodePoint);
+    if (it == index.end() || it->first != code)
+        return -1;
+    return it->second;
+}
+
+void DRW_ConvDBCSTable::fromUtf8(const std::string *s, std::string *out) {
+    std::string &result = *out;
     bool notFound;
     int code;
 
@@ -288,37 +411,30 @@ std::string DRW_ConvDBCSTable::fromUtf8(std::string *s) {
     for (unsigned int i=0; i < s->length(); i++) {
         unsigned char c = s->at(i);
         if (c > 0x7F) { //need to decode
-            result += s->substr(j,i-j);
-            std::string part1 = s->substr(i,4);
+            result.append(*s, j, i-j);
             int l;
-            code = decodeNum(part1, &l);
+            code = decodeNum(*s, i, &l);
             j = i+l;
             i = j - 1;
             notFound = true;
-                for (int k=0; k<cpLenght; k++){
-                    if(doubleTable[k][1] == code) {
-                        int data = doubleTable[k][0];
-                        char d[3];
-                        d[0] = data >> 8;
-                        d[1] = data & 0xFF;
-                        d[2]= '\0';
-                        result += d; //translate from table
-                        notFound = false;
-                        break;
-                    }
-                }
+            if (reverse == NULL)
+                reverse = &DRW_DBCSIndex::of(doubleTable, cpLenght);
+            int data = reverse->find(code);
+            if (data >= 0) {
+                result += (char)(data >> 8);
+                result += (char)(data & 0xFF); //translate from table
+                notFound = false;
+            }
             if (notFound)
                 result += decodeText(code);
         } //direct conversion
     }
-    result += s->substr(j);
-
-    return result;
+    result.append(*s, j, std::string::npos);
 }
 
-std::string DRW_ConvDBCSTable::toUtf8(std::string *s) {
-    std::string res;
-    std::string::iterator it;
+void DRW_ConvDBCSTable::toUtf8(const std::string *s, std::string *out) {
+    std::string &res = *out;
+    std::string::const_iterator it;
     for ( it=s->begin() ; it < s->end(); ++it ) {
         bool notFound = true;
         unsigned char c = *it;
@@ -353,12 +469,10 @@ std::string DRW_ConvDBCSTable::toUtf8(std::string *s) {
         //not found
         if (notFound) res += encodeNum(NOTFOUND936);
     } //end for
-
-    return res;
 }
 
-std::string DRW_Conv932Table::fromUtf8(std::string *s) {
-    std::string result;
+void DRW_Conv932Table::fromUtf8(const std::string *s, std::string *out) {
+    std::string &result = *out;
     bool notFound;
     int code;
 
@@ -366,10 +480,9 @@ std::string DRW_Conv932Table::fromUtf8(std::string *s) {
     for (unsigned int i=0; i < s->length(); i++) {
         unsigned char c = s->at(i);
         if (c > 0x7F) { //need to decode
-            result += s->substr(j,i-j);
-            std::string part1 = s->substr(i,4);
+            result.append(*s, j, i-j);
             int l;
-            code = decodeNum(part1, &l);
+            code = decodeNum(*s, i, &l);
             j = i+l;
             i = j - 1;
             notFound = true;
@@ -380,31 +493,25 @@ std::string DRW_Conv932Table::fromUtf8(std::string *s) {
             }
             if (notFound && ( code<0xF8 || (code>0x390 && code<0x542) ||
                     (code>0x200F && code<0x9FA1) || code>0xF928 )) {
-                for (int k=0; k<cpLenght; k++){
-                    if(doubleTable[k][1] == code) {
-                        int data = doubleTable[k][0];
-                        char d[3];
-                        d[0] = data >> 8;
-                        d[1] = data & 0xFF;
-                        d[2]= '\0';
-                        result += d; //translate from table
-                        notFound = false;
-                        break;
-                    }
+                if (reverse == NULL)
+                    reverse = &DRW_DBCSIndex::of(doubleTable, cpLenght);
+                int data = reverse->find(code);
+                if (data >= 0) {
+                    result += (char)(data >> 8);
+                    result += (char)(data & 0xFF); //translate from table
+                    notFound = false;
                 }
             }
             if (notFound)
                 result += decodeText(code);
         } //direct conversion
     }
-    result += s->substr(j);
-
-    return result;
+    result.append(*s, j, std::string::npos);
 }
 
-std::string DRW_Conv932Table::toUtf8(std::string *s) {
-    std::string res;
-    std::string::iterator it;
+void DRW_Conv932Table::toUtf8(const std::string *s, std::string *out) {
+    std::string &res = *out;
+    std::string::const_iterator it;
     for ( it=s->begin() ; it < s->end(); ++it ) {
         bool notFound = true;
         unsigned char c = *it;
@@ -448,54 +555,151 @@ std::string DRW_Conv932Table::toUtf8(std::string *s) {
         //not found
         if (notFound) res += encodeNum(NOTFOUND932);
     } //end for
-
-    return res;
 }
 
-std::string DRW_ConvUTF16::fromUtf8(std::string *s){
+void DRW_ConvUTF16::fromUtf8(const std::string *s, std::string *out){
     DRW_UNUSED(s);
+    DRW_UNUSED(out);
     //RLZ: to be writen (only needed for write dwg 2007+)
-    return std::string();
 }
 
-std::string DRW_ConvUTF16::toUtf8(std::string *s){//RLZ: pending to write
-    std::string res;
-    std::string::iterator it;
-    for ( it=s->begin() ; it < s->end(); ++it ) {
-        unsigned char c1 = *it;
-        unsigned char c2 = *(++it);
-        duint16 ch = (c2 <<8) | c1;
-        res +=encodeNum(ch);
-    } //end for
+void DRW_ConvUTF16::toUtf8(const std::string *s, std::string *out){
+    utf16ToUtf8(reinterpret_cast<const unsigned char*>(s->data()), s->size(), out);
+}
 
-    return res;
+void DRW_ConvUTF16::toUtf8(const unsigned char *data, size_t len, std::string *out){
+    utf16ToUtf8(data, len, out);
+}
+
+void DRW_ConvUTF16::utf16ToUtf8(const unsigned char *data, size_t len, std::string *out){
+    size_t units = len / 2;
+    size_t start = out->size();
+    //worst case 3 bytes per unit, a surrogate pair gives 4 bytes from 2 units
+    out->resize(start + units * 3);
+    char *dst = &(*out)[0] + start;
+    char *d = dst;
+    size_t i = 0;
+    while (i < units) {
+#ifdef DRW_TEXTCODEC_SSE2
+        //all ascii block of 8 chars, none of them NULL
+        if (i + 8 <= units) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 2*i));
+            __m128i zero = _mm_setzero_si128();
+            __m128i high = _mm_and_si128(v, _mm_set1_epi16((short)0xFF80));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(high, zero)) == 0xFFFF
+                    && _mm_movemask_epi8(_mm_cmpeq_epi16(v, zero)) == 0) {
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(d), _mm_packus_epi16(v, v));
+                d += 8;
+                i += 8;
+                continue;
+            }
+        }
+#endif
+        duint16 c = data[2*i] | (data[2*i+1] << 8);
+        i++;
+        if (c < 0x80) {
+            if (c != 0)
+                *d++ = c;
+        } else if (c < 0x800) {
+            *d++ = 0xC0 | (c >> 6);
+            *d++ = 0x80 | (c & 0x3F);
+        } else if (c >= 0xD800 && c <= 0xDFFF) {
+            duint16 c2 = (i < units) ? (data[2*i] | (data[2*i+1] << 8)) : 0;
+            if (c <= 0xDBFF && c2 >= 0xDC00 && c2 <= 0xDFFF) {
+                duint32 cp = 0x10000 + ((c - 0xD800) << 10) + (c2 - 0xDC00);
+                i++;
+                *d++ = 0xF0 | (cp >> 18);
+                *d++ = 0x80 | ((cp >> 12) & 0x3F);
+                *d++ = 0x80 | ((cp >> 6) & 0x3F);
+                *d++ = 0x80 | (cp & 0x3F);
+            } else { //unpaired surrogate, replacement char
+                *d++ = (char)0xEF;
+                *d++ = (char)0xBF;
+                *d++ = (char)0xBD;
+            }
+        } else {
+            *d++ = 0xE0 | (c >> 12);
+            *d++ = 0x80 | ((c >> 6) & 0x3F);
+            *d++ = 0x80 | (c & 0x3F);
+        }
+    }
+    out->resize(start + (d - dst));
 }
 
-std::string DRW_ExtConverter::convertByiconv(const char *in_encode,
-                                             const char *out_encode,
-                                             const std::string *s) {
-    const int BUF_SIZE = 1000;
-    static char in_buf[BUF_SIZE], out_buf[BUF_SIZE];
+DRW_ExtConverter::DRW_ExtConverter(const char *enc):DRW_Converter(NULL, 0) {
+    encoding = enc;
+    fromCd = toCd = NULL;
+}
 
-	char *in_ptr = in_buf;
-	char *out_ptr = out_buf;
-    strncpy(in_buf, s->c_str(), BUF_SIZE);
+DRW_ExtConverter::~DRW_ExtConverter() {
+    if (fromCd != NULL && fromCd != (void*)-1)
+        iconv_close((iconv_t)fromCd);
+    if (toCd != NULL && toCd != (void*)-1)
+        iconv_close((iconv_t)toCd);
+}
 
-    iconv_t ic;
-    ic = iconv_open(out_encode, in_encode);
-    size_t il = BUF_SIZE-1, ol = BUF_SIZE-1;
-    iconv(ic , (char**)&in_ptr, &il, &out_ptr, &ol);
-    iconv_close(ic);
+/** opens the descriptor the first time it is needed,
+** returns NULL if iconv does not support the conversion
+**/
+void *DRW_ExtConverter::openDescriptor(void **cd, const char *in_encode,
+                                       const char *out_encode) {
+    if (*cd == NULL)
+        *cd = (void*)iconv_open(out_encode, in_encode);
+    return (*cd == (void*)-1) ? NULL : *cd;
+}
 
-    return std::string(out_buf);
+/** converts the whole string 's' appending it to 'res', growing the output
+** buffer as needed. Conversion stops at the first invalid or incomplete
+** sequence, returns false in this case with the text converted until there.
+**/
+bool DRW_ExtConverter::convertByiconv(void *cd, const std::string *s, std::string *res) {
+    iconv_t ic = (iconv_t)cd;
+    //reset the shift state left by a previous call
+    iconv(ic, NULL, NULL, NULL, NULL);
+    if (outBuf.size() < s->size() * 2 + 16)
+        outBuf.resize(s->size() * 2 + 16);
+
+    char *in_ptr = const_cast<char*>(s->data());
+    size_t il = s->size();
+    size_t done = 0;
+    bool ok = true;
+    for (;;) {
+        char *out_ptr = &outBuf[done];
+        size_t ol = outBuf.size() - done;
+        size_t r = iconv(ic, &in_ptr, &il, &out_ptr, &ol);
+        done = out_ptr - &outBuf[0];
+        if (r != (size_t)-1)
+            break;
+        if (errno != E2BIG) {
+            ok = false;
+            break;
+        }
+        outBuf.resize(outBuf.size() * 2);
+    }
+    //flush the final shift sequence if any
+    for (;;) {
+        char *out_ptr = &outBuf[done];
+        size_t ol = outBuf.size() - done;
+        size_t r = iconv(ic, NULL, NULL, &out_ptr, &ol);
+        done = out_ptr - &outBuf[0];
+        if (r != (size_t)-1 || errno != E2BIG)
+            break;
+        outBuf.resize(outBuf.size() * 2);
+    }
+    res->append(&outBuf[0], done);
+    return ok;
 }
 
-std::string DRW_ExtConverter::fromUtf8(std::string *s){
-    return convertByiconv("UTF8", this->encoding, s);
+void DRW_ExtConverter::fromUtf8(const std::string *s, std::string *out){
+    void *cd = openDescriptor(&fromCd, "UTF8", encoding);
+    if (cd != NULL)
+        convertByiconv(cd, s, out);
 }
 
-std::string DRW_ExtConverter::toUtf8(std::string *s){
-    return convertByiconv(this->encoding, "UTF8", s);
+void DRW_ExtConverter::toUtf8(const std::string *s, std::string *out){
+    void *cd = openDescriptor(&toCd, encoding, "UTF8");
+    if (cd != NULL)
+        convertByiconv(cd, s, out);
 }
 
 std::string DRW_TextCodec::correctCodePage(const std::string& s) {
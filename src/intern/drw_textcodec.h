@@ -2,9 +2,15 @@
 #define DRW_TEXTCODEC_H
 
 #include <string>
+#include <vector>
 
 class DRW_Converter;
 
+//! Text conversion between utf8 and the file encoding.
+/*!
+*  Plain 7 bit ascii text, the most of names and handles, is returned
+*  unchanged without calling the converter when it allows it.
+*/
 class DRW_TextCodec
 {
 public:
@@ -12,34 +18,51 @@ public:
     ~DRW_TextCodec();
     std::string fromUtf8(std::string s);
     std::string toUtf8(std::string s);
+    /** converts 's' and appends the result to 'out' */
+    void fromUtf8(const std::string &s, std::string *out);
+    void toUtf8(const std::string &s, std::string *out);
+    /** converts all strings of the list in place */
+    void fromUtf8(std::vector<std::string> &strs);
+    void toUtf8(std::vector<std::string> &strs);
+    /** converts 'len' bytes of encoded text and appends the result to 'out' */
+    void toUtf8(const unsigned char *data, size_t len, std::string *out);
     int getVersion(){return version;}
     void setVersion(std::string *v, bool dxfFormat);
     void setVersion(int v, bool dxfFormat);
     void setCodePage(std::string *c, bool dxfFormat);
     void setCodePage(std::string c, bool dxfFormat){setCodePage(&c, dxfFormat);}
     std::string getCodePage(){return cp;}
+    static bool isPlainAscii(const char *s, size_t len, bool escapes);
 
 private:
     std::string correctCodePage(const std::string& s);
 
 private:
     int version;
+    int minVersion; /*!< lowest version set, DWG previous to 2007 keep codepage text */
     std::string cp;
     DRW_Converter *conv;
 };
 
+//! Base converter, utf8 text with \U+ escapes (dxf 2007+).
+/*!
+*  Converters append the result to 'out'.
+*/
 class DRW_Converter
 {
 public:
     DRW_Converter(const int *t, int l){table = t;
                                cpLenght = l;}
     virtual ~DRW_Converter(){}
-    virtual std::string fromUtf8(std::string *s) {return *s;}
-    virtual std::string toUtf8(std::string *s);
+    virtual void fromUtf8(const std::string *s, std::string *out) {out->append(*s);}
+    virtual void toUtf8(const std::string *s, std::string *out);
+    virtual void toUtf8(const unsigned char *data, size_t len, std::string *out);
+    /** true if ascii text without \U+ escapes converts to itself */
+    virtual bool keepsAscii() const {return true;}
     std::string encodeText(std::string stmp);
     std::string decodeText(int c);
     std::string encodeNum(int c);
-    int decodeNum(std::string s, int *b);
+    int decodeNum(const std::string &s, size_t pos, int *b);
     const int *table;
     int cpLenght;
 };
@@ -47,59 +70,96 @@ public:
 class DRW_ConvUTF16 : public DRW_Converter {
 public:
     DRW_ConvUTF16():DRW_Converter(NULL, 0) {}
-    virtual std::string fromUtf8(std::string *s);
-    virtual std::string toUtf8(std::string *s);
+    virtual void fromUtf8(const std::string *s, std::string *out);
+    virtual void toUtf8(const std::string *s, std::string *out);
+    virtual void toUtf8(const unsigned char *data, size_t len, std::string *out);
+    virtual bool keepsAscii() const {return false;}
+    /** appends UTF-16LE 'data' to 'out' as utf8, 'len' in bytes. NULL chars
+    * are dropped, unpaired surrogates become U+FFFD and an odd byte is ignored */
+    static void utf16ToUtf8(const unsigned char *data, size_t len, std::string *out);
 };
 
 class DRW_ConvTable : public DRW_Converter {
 public:
     DRW_ConvTable(const int *t, int l):DRW_Converter(t, l) {}
-    virtual std::string fromUtf8(std::string *s);
-    virtual std::string toUtf8(std::string *s);
+    virtual void fromUtf8(const std::string *s, std::string *out);
+    virtual void toUtf8(const std::string *s, std::string *out);
+};
+
+//! Reverse lookup of a double byte table.
+/*!
+*  Unicode to double byte code, an array sorted by code point, when a
+*  code point appears more than once the first entry of the table is used.
+*  There is one index per table, built on first use & shared by all the
+*  converters of the process.
+*/
+class DRW_DBCSIndex {
+public:
+    /** the index of table 'dt', built once */
+    static const DRW_DBCSIndex &of(const int dt[][2], int l);
+    /** returns the double byte code of unicode 'code' or -1 if not found */
+    int find(int code) const;
+private:
+    std::vector<std::pair<int, int> > index;
 };
 
 class DRW_ConvDBCSTable : public DRW_Converter {
 public:
-    DRW_ConvDBCSTable(const int *t,  const int *lt, const int dt[][2], int l):DRW_Converter(t, l) {
+    DRW_ConvDBCSTable(const int *t,  const int *lt, const int dt[][2], int l):
+        DRW_Converter(t, l), reverse(NULL) {
         leadTable = lt;
         doubleTable = dt;
     }
 
-    virtual std::string fromUtf8(std::string *s);
-    virtual std::string toUtf8(std::string *s);
+    virtual void fromUtf8(const std::string *s, std::string *out);
+    virtual void toUtf8(const std::string *s, std::string *out);
 private:
     const int *leadTable;
     const int (*doubleTable)[2];
+    const DRW_DBCSIndex *reverse;  /*!< set on first fromUtf8() */
 
 };
 
 class DRW_Conv932Table : public DRW_Converter {
 public:
-    DRW_Conv932Table(const int *t,  const int *lt, const int dt[][2], int l):DRW_Converter(t, l) {
+    DRW_Conv932Table(const int *t,  const int *lt, const int dt[][2], int l):
+        DRW_Converter(t, l), reverse(NULL) {
         leadTable = lt;
         doubleTable = dt;
     }
 
-    virtual std::string fromUtf8(std::string *s);
-    virtual std::string toUtf8(std::string *s);
+    virtual void fromUtf8(const std::string *s, std::string *out);
+    virtual void toUtf8(const std::string *s, std::string *out);
 private:
     const int *leadTable;
     const int (*doubleTable)[2];
+    const DRW_DBCSIndex *reverse;  /*!< set on first fromUtf8() */
 
 };
 
+//! Conversion by iconv.
+/*!
+*  The iconv descriptors are opened on first use and kept until the
+*  converter is destroyed, the output buffer grows as needed and is
+*  reused between calls, then an instance must not be shared by threads.
+*/
 class DRW_ExtConverter : public DRW_Converter {
 public:
-    DRW_ExtConverter(const char *enc):DRW_Converter(NULL, 0) {
-        encoding = enc;
-    }
-    virtual std::string fromUtf8(std::string *s);
-    virtual std::string toUtf8(std::string *s);
+    DRW_ExtConverter(const char *enc);
+    virtual ~DRW_ExtConverter();
+    virtual void fromUtf8(const std::string *s, std::string *out);
+    virtual void toUtf8(const std::string *s, std::string *out);
+    virtual bool keepsAscii() const {return false;}
+ private:
+    DRW_ExtConverter(const DRW_ExtConverter&);
+    DRW_ExtConverter &operator=(const DRW_ExtConverter&);
+    void *openDescriptor(void **cd, const char *in_encode, const char *out_encode);
+    bool convertByiconv(void *cd, const std::string *s, std::string *res);
  private:
     const char *encoding;
-    std::string convertByiconv(const char *in_encode,
-                               const char *out_encode,
-                               const std::string *s);
+    void *fromCd;  /*!< utf8 to encoding, iconv_t */
+    void *toCd;    /*!< encoding to utf8, iconv_t */
+    std::vector<char> outBuf;
 };
 
 #endif // DRW_TEXTCODEC_H
@@ -0,0 +1,42 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_threads.h"
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+unsigned int DRW::threadCount(unsigned int requested, size_t jobs){
+    unsigned int n = requested;
+    if (n == 0)
+        n = std::thread::hardware_concurrency();
+    if (n == 0)
+        n = 1;
+    return static_cast<unsigned int>(std::min<size_t>(n, std::max<size_t>(jobs, 1)));
+}
+
+void DRW::runJobs(unsigned int count, const std::function<void(unsigned int)> &job){
+    std::vector<std::thread> workers;
+    unsigned int started = 1;
+    for (; started < count; ++started) {
+        try {
+            workers.push_back(std::thread(job, started));
+        } catch (...) {
+            break;
+        }
+    }
+    job(0);
+    for (unsigned int i = started; i < count; ++i) //could not start a thread
+        job(i);
+    for (size_t i = 0; i < workers.size(); ++i)
+        workers[i].join();
+}
@@ -0,0 +1,30 @@
+/******************************************************************************
+**  libDXFrw - Library to read/write DXF files (ascii & binary)              **
+**                                                                           **
+**  Copyright (C) 2011-2015 José F. Soriano, rallazz@gmail.com               **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#ifndef DRW_THREADS_H
+#define DRW_THREADS_H
+
+#include <cstddef>
+#include <functional>
+
+namespace DRW {
+
+/** threads to run 'jobs', 'requested' or the hardware threads if 0, at least 1 & at most 'jobs' */
+unsigned int threadCount(unsigned int requested, size_t jobs);
+
+/** runs job(0) .. job(count-1), job(0) in the calling thread; the jobs whose
+    thread can not be started run in the calling thread too */
+void runJobs(unsigned int count, const std::function<void(unsigned int)> &job);
+
+}
+
+#endif // DRW_THREADS_H
@@ -144,6 +144,14 @@ bool dwgCharStream::read(duint8* s, duint64 n){
     return true;
 }
 
+const duint8 *dwgCharStream::readDirect(duint64 n){
+    if ( n > (sz - pos) )
+        return NULL;
+    const duint8 *p = stream + pos;
+    pos += n;
+    return p;
+}
+
 dwgBuffer::dwgBuffer(duint8 *buf, int size, DRW_TextCodec *dc){
     filestr = new dwgCharStream(buf, size);
     decoder = dc;
@@ -151,7 +159,7 @@ dwgBuffer::dwgBuffer(duint8 *buf, int size, DRW_TextCodec *dc){
     bitPos = 0;
 }
 
-dwgBuffer::dwgBuffer(std::ifstream *stream, DRW_TextCodec *dc){
+dwgBuffer::dwgBuffer(std::istream *stream, DRW_TextCodec *dc){
     filestr = new dwgFileStream(stream);
     decoder = dc;
     maxSize = filestr->size();
@@ -599,8 +607,10 @@ std::string dwgBuffer::get16bitStr(duint16 textSize, bool nullTerm){
         ts += 2;
     duint8 *tmpBuffer = new duint8[textSize + 2];
     bool good = getBytes(tmpBuffer, ts);
-    if (!good)
+    if (!good) {
+        delete[]tmpBuffer;
         return std::string();
+    }
     if (!nullTerm) {
         tmpBuffer[textSize] = '\0';
         tmpBuffer[textSize + 1] = '\0';
@@ -626,29 +636,51 @@ std::string dwgBuffer::getCP8Text(){
    ts= total input size in bytes.
 **/
 std::string dwgBuffer::getUCSStr(duint16 ts){
-    std::string strData;
     if (ts<4) //at least 1 char
         return std::string();
-    strData = get16bitStr(ts/2, false);
     if (decoder == NULL)
-        return strData;
+        return get16bitStr(ts/2, false);
 
-    return decoder->toUtf8(strData);
+    return getUtf16Text(ts/2, false);
 }
 
 //TU unicode 16 bit (UCS) text converted to utf8
 //nullTerm = true if string are 2 bytes null terminated from the stream
 std::string dwgBuffer::getUCSText(bool nullTerm){
-    std::string strData;
     duint16 ts = getBitShort();
     if (ts == 0)
         return std::string();
 
-    strData = get16bitStr(ts, nullTerm);
     if (decoder == NULL)
-        return strData;
+        return get16bitStr(ts, nullTerm);
 
-    return decoder->toUtf8(strData);
+    return getUtf16Text(ts, nullTerm);
+}
+
+/** Reads textSize 2-bytes chars and converts them to utf8 with the decoder,
+**  from the stream memory when it is possible, avoiding a copy.
+**/
+std::string dwgBuffer::getUtf16Text(duint32 textSize, bool nullTerm){
+    duint32 len = textSize * 2;
+    duint32 ts = nullTerm ? len + 2 : len;
+    const duint8 *data = NULL;
+    duint8 stackBuf[512];
+    std::vector<duint8> heapBuf;
+    if (bitPos == 0)
+        data = filestr->readDirect(ts);
+    if (data == NULL) {
+        duint8 *tmpBuffer = stackBuf;
+        if (ts > sizeof(stackBuf)) {
+            heapBuf.resize(ts);
+            tmpBuffer = &heapBuf[0];
+        }
+        if (!getBytes(tmpBuffer, ts))
+            return std::string();
+        data = tmpBuffer;
+    }
+    std::string str;
+    decoder->toUtf8(data, len, &str);
+    return str;
 }
 
 //RLZ: read a T or TU if version is 2007+
@@ -26,6 +26,9 @@ protected:
 public:
     virtual ~dwgBasicStream(){}
     virtual bool read(duint8* s, duint64 n) = 0;
+    /** pointer to the next n bytes, advancing the position, for streams in memory.
+    * returns NULL if the stream can't do it, the position is not changed then */
+    virtual const duint8 *readDirect(duint64 n){DRW_UNUSED(n); return NULL;}
     virtual duint64 size() = 0;
     virtual duint64 getPos() = 0;
     virtual bool setPos(duint64 p) = 0;
@@ -35,7 +38,7 @@ public:
 
 class dwgFileStream: public dwgBasicStream{
 public:
-    dwgFileStream(std::ifstream *s){
+    dwgFileStream(std::istream *s){
         stream =s;
         stream->seekg (0, std::ios::end);
         sz = stream->tellg();
@@ -49,7 +52,7 @@ public:
     virtual bool good(){return stream->good();}
     virtual dwgBasicStream* clone(){return new dwgFileStream(stream);}
 private:
-    std::ifstream *stream;
+    std::istream *stream;
     duint64 sz;
 };
 
@@ -63,6 +66,7 @@ public:
     }
     virtual ~dwgCharStream(){}
     virtual bool read(duint8* s, duint64 n);
+    virtual const duint8 *readDirect(duint64 n);
     virtual duint64 size(){return sz;}
     virtual duint64 getPos(){return pos;}
     virtual bool setPos(duint64 p);
@@ -77,7 +81,7 @@ private:
 
 class dwgBuffer {
 public:
-    dwgBuffer(std::ifstream *stream, DRW_TextCodec *decoder = NULL);
+    dwgBuffer(std::istream *stream, DRW_TextCodec *decoder = NULL);
     dwgBuffer(duint8 *buf, int size, DRW_TextCodec *decoder= NULL);
     dwgBuffer( const dwgBuffer& org );
     dwgBuffer& operator=( const dwgBuffer& org );
@@ -150,6 +154,7 @@ private:
 
     UTF8STRING get8bitStr();
     UTF8STRING get16bitStr(duint16 textSize, bool nullTerm = true);
+    UTF8STRING getUtf16Text(duint32 textSize, bool nullTerm);
 };
 
 #endif // DWGBUFFER_H
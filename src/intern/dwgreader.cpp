@@ -16,7 +16,9 @@
 #include <string>
 #include <sstream>
 #include "dwgreader.h"
+#include "../drw_blockcache.h"
 #include "drw_textcodec.h"
+#include "drw_entitycopy.h"
 #include "drw_dbg.h"
 
 dwgReader::~dwgReader(){
@@ -48,15 +50,74 @@ void dwgReader::parseAttribs(DRW_Entity* e){
         duint32 lyref =e->layerH.ref;
         std::map<duint32, DRW_LType*>::iterator lt_it = ltypemap.find(ltref);
         if (lt_it != ltypemap.end()){
-            e->lineType = (lt_it->second)->name;
+            e->lineType = names.intern((lt_it->second)->name);
         }
         std::map<duint32, DRW_Layer*>::iterator ly_it = layermap.find(lyref);
         if (ly_it != layermap.end()){
-            e->layer = (ly_it->second)->name;
+            e->layer = names.intern((ly_it->second)->name);
         }
     }
 }
 
+/*dxf name of the dwg object types handled by readDwgEntity & readDwgObject*/
+static const char *dwgTypeName(duint32 oType){
+    switch (oType){
+    case 1: return "TEXT";
+    case 7:
+    case 8: return "INSERT";
+    case 15:
+    case 16:
+    case 29: return "POLYLINE";
+    case 17: return "ARC";
+    case 18: return "CIRCLE";
+    case 19: return "LINE";
+    case 20:
+    case 21:
+    case 22:
+    case 23:
+    case 24:
+    case 25:
+    case 26: return "DIMENSION";
+    case 27: return "POINT";
+    case 28: return "3DFACE";
+    case 31: return "SOLID";
+    case 32: return "TRACE";
+    case 34: return "VIEWPORT";
+    case 35: return "ELLIPSE";
+    case 36: return "SPLINE";
+    case 40: return "RAY";
+    case 41: return "XLINE";
+    case 44: return "MTEXT";
+    case 45: return "LEADER";
+    case 77: return "LWPOLYLINE";
+    case 78: return "HATCH";
+    case 101: return "IMAGE";
+    case 102: return "IMAGEDEF";
+    default: break;
+    }
+    return "UNKNOWN";
+}
+
+/*updates the read statistics and sends a OBJECT_DECODED or OBJECT_FAILED
+ * trace event if the parent has a sink*/
+void dwgReader::reportObject(const objHandle& obj, bool ok, duint64 size){
+    if (stats != NULL) {
+        if (ok)
+            stats->addObject(dwgTypeName(obj.type));
+        else
+            stats->failed++;
+    }
+    DRW_TraceSink *sink = parent->getTraceSink();
+    if (sink == NULL)
+        return;
+    DRW_TraceRecord rec(ok ? DRW::OBJECT_DECODED : DRW::OBJECT_FAILED, dwgTypeName(obj.type));
+    rec.handle = obj.handle;
+    rec.type = obj.type;
+    rec.offset = obj.loc;
+    rec.bytes = size;
+    sink->traceEvent(rec);
+}
+
 std::string dwgReader::findTableName(DRW::TTYPE table, dint32 handle){
     std::string name;
     switch (table){
@@ -766,7 +827,14 @@ bool dwgReader::readDwgBlocks(DRW_Interface& intfa, dwgBuffer *dbuf){
         //complete block entity with block record data
         bk.basePoint = bkr->basePoint;
         bk.flags = bkr->flags;
-        intfa.addBlock(bk);
+        //with a cache the block is collected & handed at once
+        DRW_BlockBuilder builder;
+        DRW_Interface &target = blockCache != NULL ? builder : intfa;
+        target.addBlock(bk);
+        if (extents != NULL)
+            extents->beginBlock(bk);
+        if (fingerprints != NULL)
+            fingerprints->beginBlock(bk);
         //and update block record name
         bkr->name = bk.name;
 
@@ -789,7 +857,7 @@ bool dwgReader::readDwgBlocks(DRW_Interface& intfa, dwgBuffer *dbuf){
                     } else {//foud entity reads it
                         oc = mit->second;
                         ObjectMap.erase(mit);
-                        ret2 = readDwgEntity(dbuf, oc, intfa);
+                        ret2 = readDwgEntity(dbuf, oc, target);
                         ret = ret && ret2;
                     }
                     if (nextH == bkr->lastEH)
@@ -809,7 +877,7 @@ bool dwgReader::readDwgBlocks(DRW_Interface& intfa, dwgBuffer *dbuf){
                         oc = mit->second;
                         ObjectMap.erase(mit);
                         DRW_DBG("\nBlocks, parsing entity: "); DRW_DBGH(oc.handle); DRW_DBG(", pos: "); DRW_DBG(oc.loc); DRW_DBG("\n");
-                        ret2 = readDwgEntity(dbuf, oc, intfa);
+                        ret2 = readDwgEntity(dbuf, oc, target);
                         ret = ret && ret2;
                     }
                 }
@@ -821,6 +889,17 @@ bool dwgReader::readDwgBlocks(DRW_Interface& intfa, dwgBuffer *dbuf){
         if (mit==ObjectMap.end()) {
             DRW_DBG("\nWARNING: end block entity not found\n");
             ret = false;
+            if (extents != NULL)
+                extents->endBlock();
+            if (fingerprints != NULL)
+                fingerprints->endBlock();
+            //the entities read are still sent
+            if (blockCache != NULL) {
+                builder.endBlock();
+                const DRW_BlockBuilder::Built &b = builder.blocks.back();
+                intfa.addBlock(b.block);
+                b.def->replay(&intfa);
+            }
             continue;
         }
         oc = mit->second;
@@ -842,12 +921,32 @@ bool dwgReader::readDwgBlocks(DRW_Interface& intfa, dwgBuffer *dbuf){
         ret = ret && ret2;
         if (bk.parentHandle == DRW::NoHandle) bk.parentHandle= bkr->handle;
         parseAttribs(&end);
-        intfa.endBlock();
+        if (extents != NULL)
+            extents->endBlock();
+        if (fingerprints != NULL)
+            fingerprints->endBlock();
+        target.endBlock();
+        if (blockCache != NULL) {
+            const DRW_BlockBuilder::Built &b = builder.blocks.back();
+            intfa.takeBlockDefinition(b.block, blockCache->share(b.block, b.def));
+        }
     }
 
     return ret;
 }
 
+/*fingerprints & bounds of an entity read, false if it is a duplicate to drop,
+  its lists are freed as it does not reach the interface*/
+bool dwgReader::admitEntity(DRW_Entity *e){
+    if (fingerprints != NULL && !fingerprints->addEntity(e)) {
+        DRW::freeLists(e);
+        return false;
+    }
+    if (extents != NULL)
+        extents->addEntity(e);
+    return true;
+}
+
 bool dwgReader::readPlineVertex(DRW_Polyline& pline, dwgBuffer *dbuf){
     bool ret = true;
     bool ret2 = true;
@@ -989,6 +1088,7 @@ bool dwgReader::readDwgEntity(dwgBuffer *dbuf, objHandle& obj, DRW_Interface& in
             std::map<duint32, DRW_Class*>::iterator it = classesmap.find(oType);
             if (it == classesmap.end()){//fail, not found in classes set error
                 DRW_DBG("Class "); DRW_DBG(oType);DRW_DBG("not found, handle: "); DRW_DBG(obj.handle); DRW_DBG("\n");
+                reportObject(obj, false, size);
                 delete[]tmpByteStr;
                 return false;
             } else {
@@ -1003,134 +1103,159 @@ bool dwgReader::readDwgEntity(dwgBuffer *dbuf, objHandle& obj, DRW_Interface& in
         case 17: {
             DRW_Arc e;
             ENTRY_PARSE(e)
-            intfa.addArc(e);
+            if (admitEntity(&e))
+                intfa.takeArc(std::move(e));
             break; }
         case 18: {
             DRW_Circle e;
             ENTRY_PARSE(e)
-            intfa.addCircle(e);
+            if (admitEntity(&e))
+                intfa.takeCircle(std::move(e));
             break; }
         case 19:{
             DRW_Line e;
             ENTRY_PARSE(e)
-            intfa.addLine(e);
+            if (admitEntity(&e))
+                intfa.takeLine(std::move(e));
             break;}
         case 27: {
             DRW_Point e;
             ENTRY_PARSE(e)
-            intfa.addPoint(e);
+            if (admitEntity(&e))
+                intfa.takePoint(std::move(e));
             break; }
         case 35: {
             DRW_Ellipse e;
             ENTRY_PARSE(e)
-            intfa.addEllipse(e);
+            if (admitEntity(&e))
+                intfa.takeEllipse(std::move(e));
             break; }
         case 7:
         case 8: {//minsert = 8
             DRW_Insert e;
             ENTRY_PARSE(e)
             e.name = findTableName(DRW::BLOCK_RECORD, e.blockRecH.ref);//RLZ: find as block or blockrecord (ps & ps0)
-            intfa.addInsert(e);
+            if (admitEntity(&e))
+                intfa.takeInsert(std::move(e));
             break; }
         case 77: {
             DRW_LWPolyline e;
             ENTRY_PARSE(e)
-            intfa.addLWPolyline(e);
+            simplify(&e);
+            if (admitEntity(&e))
+                intfa.takeLWPolyline(std::move(e));
             break; }
         case 1: {
             DRW_Text e;
             ENTRY_PARSE(e)
-            e.style = findTableName(DRW::STYLE, e.styleH.ref);
-            intfa.addText(e);
+            e.style = names.intern(findTableName(DRW::STYLE, e.styleH.ref));
+            if (admitEntity(&e))
+                intfa.takeText(std::move(e));
             break; }
         case 44: {
             DRW_MText e;
             ENTRY_PARSE(e)
-            e.style = findTableName(DRW::STYLE, e.styleH.ref);
-            intfa.addMText(e);
+            e.style = names.intern(findTableName(DRW::STYLE, e.styleH.ref));
+            if (admitEntity(&e))
+                intfa.takeMText(std::move(e));
             break; }
         case 28: {
             DRW_3Dface e;
             ENTRY_PARSE(e)
-            intfa.add3dFace(e);
+            if (admitEntity(&e))
+                intfa.take3dFace(std::move(e));
             break; }
         case 20: {
             DRW_DimOrdinate e;
             ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimOrdinate(&e);
+            e.style = names.intern(findTableName(DRW::DIMSTYLE, e.dimStyleH.ref));
+            if (admitEntity(&e))
+                intfa.takeDimOrdinate(std::move(e));
             break; }
         case 21: {
             DRW_DimLinear e;
             ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimLinear(&e);
+            e.style = names.intern(findTableName(DRW::DIMSTYLE, e.dimStyleH.ref));
+            if (admitEntity(&e))
+                intfa.takeDimLinear(std::move(e));
             break; }
         case 22: {
             DRW_DimAligned e;
             ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimAlign(&e);
+            e.style = names.intern(findTableName(DRW::DIMSTYLE, e.dimStyleH.ref));
+            if (admitEntity(&e))
+                intfa.takeDimAlign(std::move(e));
             break; }
         case 23: {
             DRW_DimAngular3p e;
             ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimAngular3P(&e);
+            e.style = names.intern(findTableName(DRW::DIMSTYLE, e.dimStyleH.ref));
+            if (admitEntity(&e))
+                intfa.takeDimAngular3P(std::move(e));
             break; }
         case 24: {
             DRW_DimAngular e;
             ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimAngular(&e);
+            e.style = names.intern(findTableName(DRW::DIMSTYLE, e.dimStyleH.ref));
+            if (admitEntity(&e))
+                intfa.takeDimAngular(std::move(e));
             break; }
         case 25: {
             DRW_DimRadial e;
             ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimRadial(&e);
+            e.style = names.intern(findTableName(DRW::DIMSTYLE, e.dimStyleH.ref));
+            if (admitEntity(&e))
+                intfa.takeDimRadial(std::move(e));
             break; }
         case 26: {
             DRW_DimDiametric e;
             ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addDimDiametric(&e);
+            e.style = names.intern(findTableName(DRW::DIMSTYLE, e.dimStyleH.ref));
+            if (admitEntity(&e))
+                intfa.takeDimDiametric(std::move(e));
             break; }
         case 45: {
             DRW_Leader e;
             ENTRY_PARSE(e)
-            e.style = findTableName(DRW::DIMSTYLE, e.dimStyleH.ref);
-            intfa.addLeader(&e);
+            e.style = names.intern(findTableName(DRW::DIMSTYLE, e.dimStyleH.ref));
+            if (admitEntity(&e))
+                intfa.takeLeader(std::move(e));
             break; }
         case 31: {
             DRW_Solid e;
             ENTRY_PARSE(e)
-            intfa.addSolid(e);
+            if (admitEntity(&e))
+                intfa.takeSolid(std::move(e));
             break; }
         case 78: {
             DRW_Hatch e;
             ENTRY_PARSE(e)
-            intfa.addHatch(&e);
+            if (admitEntity(&e))
+                intfa.takeHatch(std::move(e));
             break; }
         case 32: {
             DRW_Trace e;
             ENTRY_PARSE(e)
-            intfa.addTrace(e);
+            if (admitEntity(&e))
+                intfa.takeTrace(std::move(e));
             break; }
         case 34: {
             DRW_Viewport e;
             ENTRY_PARSE(e)
-            intfa.addViewport(e);
+            if (admitEntity(&e))
+                intfa.takeViewport(std::move(e));
             break; }
         case 36: {
             DRW_Spline e;
             ENTRY_PARSE(e)
-            intfa.addSpline(&e);
+            if (admitEntity(&e))
+                intfa.takeSpline(std::move(e));
             break; }
         case 40: {
             DRW_Ray e;
             ENTRY_PARSE(e)
-            intfa.addRay(e);
+            if (admitEntity(&e))
+                intfa.takeRay(std::move(e));
             break; }
         case 15:    // pline 2D
         case 16:    // pline 3D
@@ -1138,32 +1263,39 @@ bool dwgReader::readDwgEntity(dwgBuffer *dbuf, objHandle& obj, DRW_Interface& in
             DRW_Polyline e;
             ENTRY_PARSE(e)
             readPlineVertex(e, dbuf);
-            intfa.addPolyline(e);
+            simplify(&e);
+            if (admitEntity(&e))
+                intfa.takePolyline(std::move(e));
             break; }
 //        case 30: {
 //            DRW_Polyline e;// MESH (not pline)
 //            ENTRY_PARSE(e)
-//            intfa.addRay(e);
+//            intfa.takeRay(std::move(e));
 //            break; }
         case 41: {
             DRW_Xline e;
             ENTRY_PARSE(e)
-            intfa.addXline(e);
+            if (admitEntity(&e))
+                intfa.takeXline(std::move(e));
             break; }
         case 101: {
             DRW_Image e;
             ENTRY_PARSE(e)
-            intfa.addImage(&e);
+            if (admitEntity(&e))
+                intfa.takeImage(std::move(e));
             break; }
 
         default:
             //not supported or are object add to remaining map
             objObjectMap[obj.handle]= obj;
+            size = 0;
             break;
         }
         if (!ret){
             DRW_DBG("Warning: Entity type "); DRW_DBG(oType);DRW_DBG("has failed, handle: "); DRW_DBG(obj.handle); DRW_DBG("\n");
         }
+        if (size != 0)
+            reportObject(obj, ret, size);
         delete[]tmpByteStr;
     return ret;
 }
@@ -1232,11 +1364,16 @@ bool dwgReader::readDwgObject(dwgBuffer *dbuf, objHandle& obj, DRW_Interface& in
         default:
             //not supported object or entity add to remaining map for debug
             remainingMap[obj.handle]= obj;
+            if (stats != NULL)
+                stats->skipped++;
+            size = 0;
             break;
         }
         if (!ret){
             DRW_DBG("Warning: Object type "); DRW_DBG(oType);DRW_DBG("has failed, handle: "); DRW_DBG(obj.handle); DRW_DBG("\n");
         }
+        if (size != 0)
+            reportObject(obj, ret, size);
         delete[]tmpByteStr;
     return ret;
 }
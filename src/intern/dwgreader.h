@@ -120,8 +120,9 @@ public:
 class dwgReader {
     friend class dwgR;
 public:
-    dwgReader(std::ifstream *stream, dwgR *p){
-        fileBuf = new dwgBuffer(stream);
+    /** takes the ownership of 'buf', the file data */
+    dwgReader(dwgBuffer *buf, dwgR *p){
+        fileBuf = buf;
         parent = p;
         decoder.setVersion(DRW::AC1021, false);//default 2007 in utf8(no convert)
         decoder.setCodePage("UTF-16", false);
@@ -130,6 +131,11 @@ public:
 //        ucsCtrl=vportCtrl=appidCtrl=dimstyleCtrl=vpEntHeaderCtrl=0;
         nextEntLink = prevEntLink = 0;
         maintenanceVersion=0;
+        stats = NULL;
+        extents = NULL;
+        simplifier = NULL;
+        fingerprints = NULL;
+        blockCache = NULL;
     }
     virtual ~dwgReader();
 
@@ -148,6 +154,7 @@ protected:
     virtual bool readDwgEntity(dwgBuffer *dbuf, objHandle& obj, DRW_Interface& intfa);
     bool readDwgObject(dwgBuffer *dbuf, objHandle& obj, DRW_Interface& intfa);
     void parseAttribs(DRW_Entity* e);
+    void reportObject(const objHandle& obj, bool ok, duint64 size);
     std::string findTableName(DRW::TTYPE table, dint32 handle);
 
     void setCodePage(std::string *c){decoder.setCodePage(c, false);}
@@ -161,6 +168,15 @@ protected:
     bool readDwgEntities(DRW_Interface& intfa, dwgBuffer *dbuf);
     bool readDwgObjects(DRW_Interface& intfa, dwgBuffer *dbuf);
     bool readPlineVertex(DRW_Polyline& pline, dwgBuffer *dbuf);
+    bool admitEntity(DRW_Entity *e);
+    /** removes vertices of a polyline if the simplifier is enabled */
+    template <class T> void simplify(T *pl) {
+        if (simplifier == NULL)
+            return;
+        size_t removed = simplifier->simplify(pl);
+        if (stats != NULL)
+            stats->removedVertices += removed;
+    }
 
 public:
     std::map<duint32, objHandle>ObjectMap;
@@ -191,6 +207,12 @@ protected:
 
 protected:
     DRW_TextCodec decoder;
+    DRW_NamePool names;   /*!< layer, line type & style names of the entities */
+    DRW_ReadStats *stats; /*!< owned by dwgR, set on open */
+    DRW_Extents *extents; /*!< owned by dwgR, NULL if not enabled */
+    const DRW_Simplifier *simplifier; /*!< owned by dwgR, NULL if not enabled */
+    DRW_Fingerprints *fingerprints; /*!< owned by dwgR, NULL if not enabled */
+    DRW_BlockCache *blockCache; /*!< shared, NULL if not enabled */
 
 protected:
 //    duint32 blockCtrl;
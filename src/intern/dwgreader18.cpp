@@ -92,8 +92,13 @@ void dwgReader18::parseSysPage(duint8 *decompSec, duint32 decompSize){
     } DRW_DBG("\n");
 #endif
     DRW_DBG("decompresing "); DRW_DBG(compSize); DRW_DBG(" bytes in "); DRW_DBG(decompSize); DRW_DBG(" bytes\n");
+    double start = DRW_ReadStats::now();
     dwgCompressor comp;
     comp.decompress18(tmpCompSec, decompSec, compSize, decompSize);
+    if (stats != NULL) {
+        stats->decompressTime += DRW_ReadStats::now() - start;
+        stats->bytesOut += decompSize;
+    }
 #ifdef DRW_DBG_DUMP
     for (unsigned int i=0, j=0; i< decompSize;i++) {
         DRW_DBGH( decompSec[i]);
@@ -163,8 +168,13 @@ bool dwgReader18::parseDataPage(dwgSectionInfo si/*, duint8 *dData*/){
         duint8* oData = objData + pi.startOffset;
         pi.uSize = si.maxSize;
         DRW_DBG("decompresing "); DRW_DBG(pi.cSize); DRW_DBG(" bytes in "); DRW_DBG(pi.uSize); DRW_DBG(" bytes\n");
+        double start = DRW_ReadStats::now();
         dwgCompressor comp;
         comp.decompress18(cData, oData, pi.cSize, pi.uSize);
+        if (stats != NULL) {
+            stats->decompressTime += DRW_ReadStats::now() - start;
+            stats->bytesOut += pi.uSize;
+        }
         delete[]cData;
     }
     return true;
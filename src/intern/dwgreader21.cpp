@@ -67,8 +67,15 @@ bool dwgReader21::parseSysPage(duint64 sizeCompressed, duint64 sizeUncompressed,
     duint8 *tmpDataRaw = new duint8[fpsize];
     fileBuf->getBytes(tmpDataRaw, fpsize);
     duint8 *tmpDataRS = new duint8[fpsize];
+    double start = DRW_ReadStats::now();
     dwgRSCodec::decode239I(tmpDataRaw, tmpDataRS, fpsize/255);
+    double rsEnd = DRW_ReadStats::now();
     dwgCompressor::decompress21(tmpDataRS, decompData, sizeCompressed, sizeUncompressed);
+    if (stats != NULL) {
+        stats->rsDecodeTime += rsEnd - start;
+        stats->decompressTime += DRW_ReadStats::now() - rsEnd;
+        stats->bytesOut += sizeUncompressed;
+    }
     delete[]tmpDataRaw;
     delete[]tmpDataRS;
     return true;
@@ -94,7 +101,10 @@ bool dwgReader21::parseDataPage(dwgSectionInfo si, duint8 *dData){
 
         duint8 *tmpPageRS = new duint8[pi.size];
         duint8 chunks =pi.size / 255;
+        double start = DRW_ReadStats::now();
         dwgRSCodec::decode251I(tmpPageRaw, tmpPageRS, chunks);
+        if (stats != NULL)
+            stats->rsDecodeTime += DRW_ReadStats::now() - start;
     #ifdef DRW_DBG_DUMP
         DRW_DBG("\nSection OBJECTS RS data=\n");
         for (unsigned int i=0, j=0; i< pi.size;i++) {
@@ -107,7 +117,12 @@ bool dwgReader21::parseDataPage(dwgSectionInfo si, duint8 *dData){
         DRW_DBG("\npage uncomp size: "); DRW_DBG(pi.uSize); DRW_DBG(" comp size: "); DRW_DBG(pi.cSize);
         DRW_DBG("\noffset: "); DRW_DBG(pi.startOffset);
         duint8 *pageData = dData + pi.startOffset;
+        start = DRW_ReadStats::now();
         dwgCompressor::decompress21(tmpPageRS, pageData, pi.cSize, pi.uSize);
+        if (stats != NULL) {
+            stats->decompressTime += DRW_ReadStats::now() - start;
+            stats->bytesOut += pi.uSize;
+        }
 
     #ifdef DRW_DBG_DUMP
         DRW_DBG("\n\nSection OBJECTS decompresed data=\n");
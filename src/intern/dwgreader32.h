@@ -21,7 +21,7 @@
 
 class dwgReader32 : public dwgReader18 {
 public:
-    dwgReader32(std::ifstream *stream, dwgR *p):dwgReader18(stream, p){ }
+    dwgReader32(dwgBuffer *buf, dwgR *p):dwgReader18(buf, p){ }
     virtual ~dwgReader32(){}
     bool readFileHeader();
     bool readDwgHeader(DRW_Header& hdr);
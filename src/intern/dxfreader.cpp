@@ -11,6 +11,7 @@
 ******************************************************************************/
 
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <string>
 #include <sstream>
@@ -87,6 +88,13 @@ bool dxfReader::readRec(int *codeData) {
 
     return (filestr->good());
 }
+
+/*current offset in the stream, 0 if unknown*/
+duint64 dxfReader::getPosition(){
+    std::streamoff pos = filestr->tellg();
+    return (pos < 0) ? 0 : pos;
+}
+
 int dxfReader::getHandleString(){
     int res;
 #if defined(__APPLE__)
@@ -101,34 +109,64 @@ int dxfReader::getHandleString(){
     return res;
 }
 
+/*reads n bytes, first the ones returned by readCode*/
+bool dxfReaderBinary::readBytes(char *buffer, int n) {
+    int i = 0;
+    for (; i < n && pendingPos < pendingCount; ++i)
+        buffer[i] = pending[pendingPos++];
+    if (i < n)
+        filestr->read(buffer + i, n - i);
+    return (filestr->good());
+}
+
 bool dxfReaderBinary::readCode(int *code) {
     unsigned short *int16p;
     char buffer[2];
-    filestr->read(buffer,2);
+    readBytes(buffer, 2);
     int16p = (unsigned short *) buffer;
 //exist a 32bits int (code 90) with 2 bytes???
-    if ((*code == 90) && (*int16p>2000)){
+    if ((lastCode == 90) && (*int16p>2000)){
         DRW_DBG(*code); DRW_DBG(" de 16bits\n");
-        filestr->seekg(-4, std::ios_base::cur);
-        filestr->read(buffer,2);
+        //the code is in the last 2 bytes read as int32, the 2 bytes
+        //just read are the start of the value, no seek back
+        pending[0] = buffer[0];
+        pending[1] = buffer[1];
+        pendingPos = 0;
+        pendingCount = 2;
+        buffer[0] = last32[2];
+        buffer[1] = last32[3];
         int16p = (unsigned short *) buffer;
     }
-    *code = *int16p;
+    *code = lastCode = *int16p;
     DRW_DBG(*code); DRW_DBG("\n");
 
     return (filestr->good());
 }
 
 bool dxfReaderBinary::readString() {
-    type = STRING;
-    std::getline(*filestr, strData, '\0');
-    DRW_DBG(strData); DRW_DBG("\n");
-    return (filestr->good());
+    return readString(&strData);
 }
 
 bool dxfReaderBinary::readString(std::string *text) {
     type = STRING;
-    std::getline(*filestr, *text, '\0');
+    text->clear();
+    bool ended = false;
+    while (pendingPos < pendingCount && !ended) {
+        char c = pending[pendingPos++];
+        if (c == '\0')
+            ended = true;
+        else
+            text->push_back(c);
+    }
+    if (!ended) {
+        if (text->empty())
+            std::getline(*filestr, *text, '\0');
+        else {
+            std::string rest;
+            std::getline(*filestr, rest, '\0');
+            text->append(rest);
+        }
+    }
     DRW_DBG(*text); DRW_DBG("\n");
     return (filestr->good());
 }
@@ -136,7 +174,7 @@ bool dxfReaderBinary::readString(std::string *text) {
 bool dxfReaderBinary::readInt16() {
     type = INT32;
     char buffer[2];
-    filestr->read(buffer,2);
+    readBytes(buffer, 2);
     intData = (int)((buffer[1] << 8) | buffer[0]);
     DRW_DBG(intData); DRW_DBG("\n");
     return (filestr->good());
@@ -146,7 +184,8 @@ bool dxfReaderBinary::readInt32() {
     type = INT32;
     unsigned int *int32p;
     char buffer[4];
-    filestr->read(buffer,4);
+    readBytes(buffer, 4);
+    memcpy(last32, buffer, 4);
     int32p = (unsigned int *) buffer;
     intData = *int32p;
     DRW_DBG(intData); DRW_DBG("\n");
@@ -157,7 +196,7 @@ bool dxfReaderBinary::readInt64() {
     type = INT64;
     unsigned long long int *int64p; //64 bits integer pointer
     char buffer[8];
-    filestr->read(buffer,8);
+    readBytes(buffer, 8);
     int64p = (unsigned long long int *) buffer;
     int64 = *int64p;
     DRW_DBG(int64); DRW_DBG(" int64\n");
@@ -168,7 +207,7 @@ bool dxfReaderBinary::readDouble() {
     type = DOUBLE;
     double *result;
     char buffer[8];
-    filestr->read(buffer,8);
+    readBytes(buffer, 8);
     result = (double *) buffer;
     doubleData = *result;
     DRW_DBG(doubleData); DRW_DBG("\n");
@@ -178,7 +217,7 @@ bool dxfReaderBinary::readDouble() {
 //saved as int or add a bool member??
 bool dxfReaderBinary::readBool() {
     char buffer[1];
-    filestr->read(buffer,1);
+    readBytes(buffer, 1);
     intData = (int)(buffer[0]);
     DRW_DBG(intData); DRW_DBG("\n");
     return (filestr->good());
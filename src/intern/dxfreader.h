@@ -13,7 +13,10 @@
 #ifndef DXFREADER_H
 #define DXFREADER_H
 
+#include <cstring>
 #include "drw_textcodec.h"
+#include "../drw_base.h"
+#include "../drw_name.h"
 
 class dxfReader {
 public:
@@ -27,7 +30,7 @@ public:
     };
     enum TYPE type;
 public:
-    dxfReader(std::ifstream *stream){
+    dxfReader(std::istream *stream){
         filestr = stream;
         type = INVALID;
     }
@@ -36,8 +39,10 @@ public:
 
     std::string getString() {return strData;}
     int getHandleString();//Convert hex string to int
-    std::string toUtf8String(std::string t) {return decoder.toUtf8(t);}
-    std::string getUtf8String() {return decoder.toUtf8(strData);}
+    //the utf8 strings are valid until the next conversion
+    const std::string &toUtf8String(const std::string &t) {utf8Data.clear(); decoder.toUtf8(t, &utf8Data); return utf8Data;}
+    const std::string &getUtf8String() {return toUtf8String(strData);}
+    DRW_Name getName() {return names.intern(toUtf8String(strData));} //table entry name, shared
     double getDouble() {return doubleData;}
     int getInt32() {return intData;}
     unsigned long long int getInt64() {return int64;}
@@ -46,6 +51,7 @@ public:
     void setVersion(std::string *v, bool dxfFormat){decoder.setVersion(v, dxfFormat);}
     void setCodePage(std::string *c){decoder.setCodePage(c, true);}
     std::string getCodePage(){ return decoder.getCodePage();}
+    duint64 getPosition();
 
 protected:
     virtual bool readCode(int *code) = 0; //return true if sucesful (not EOF)
@@ -58,7 +64,7 @@ protected:
     virtual bool readBool() = 0;
 
 protected:
-    std::ifstream *filestr;
+    std::istream *filestr;
     std::string strData;
     double doubleData;
     signed int intData; //32 bits integer
@@ -66,11 +72,17 @@ protected:
     bool skip; //set to true for ascii dxf, false for binary
 private:
     DRW_TextCodec decoder;
+    DRW_NamePool names;
+    std::string utf8Data;  /*!< converted string, reused */
 };
 
 class dxfReaderBinary : public dxfReader {
 public:
-    dxfReaderBinary(std::ifstream *stream):dxfReader(stream){skip = false; }
+    dxfReaderBinary(std::istream *stream):dxfReader(stream){
+        skip = false;
+        lastCode = pendingPos = pendingCount = 0;
+        memset(last32, 0, 4);
+    }
     virtual ~dxfReaderBinary() {}
     virtual bool readCode(int *code);
     virtual bool readString(std::string *text);
@@ -80,11 +92,22 @@ public:
     virtual bool readInt64();
     virtual bool readDouble();
     virtual bool readBool();
+
+private:
+    bool readBytes(char *buffer, int n);
+
+private:
+    //bounded lookahead for 16 bit code 90 values, the stream is never seeked
+    int lastCode;     /*!< previous group code */
+    char last32[4];   /*!< bytes of the last readInt32 */
+    char pending[2];  /*!< bytes read by readCode that belong to the next value */
+    int pendingPos;
+    int pendingCount;
 };
 
 class dxfReaderAscii : public dxfReader {
 public:
-    dxfReaderAscii(std::ifstream *stream):dxfReader(stream){skip = true; }
+    dxfReaderAscii(std::istream *stream):dxfReader(stream){skip = true; }
     virtual ~dxfReaderAscii(){}
     virtual bool readCode(int *code);
     virtual bool readString(std::string *text);
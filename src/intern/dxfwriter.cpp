@@ -143,6 +143,9 @@ bool dxfWriterBinary::writeString(int code, std::string text) {
 }*/
 
 bool dxfWriterBinary::writeInt16(int code, int data) {
+    //290-299 are read as one byte booleans
+    if (code > 289 && code < 300)
+        return writeBool(code, data != 0);
     char bufcode[2];
     char buffer[2];
     bufcode[0] =code & 0xFF;
@@ -214,7 +217,7 @@ bool dxfWriterBinary::writeBool(int code, bool data) {
     return (filestr->good());
 }
 
-dxfWriterAscii::dxfWriterAscii(std::ofstream *stream):dxfWriter(stream){
+dxfWriterAscii::dxfWriterAscii(std::ostream *stream):dxfWriter(stream){
     filestr->precision(16);
 }
 
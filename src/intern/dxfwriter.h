@@ -13,11 +13,12 @@
 #ifndef DXFWRITER_H
 #define DXFWRITER_H
 
+#include <ostream>
 #include "drw_textcodec.h"
 
 class dxfWriter {
 public:
-    dxfWriter(std::ofstream *stream){filestr = stream; /*count =0;*/}
+    dxfWriter(std::ostream *stream){filestr = stream; /*count =0;*/}
     virtual ~dxfWriter(){}
     virtual bool writeString(int code, std::string text) = 0;
     bool writeUtf8String(int code, std::string text);
@@ -32,14 +33,14 @@ public:
     void setCodePage(std::string *c){encoder.setCodePage(c, true);}
     std::string getCodePage(){return encoder.getCodePage();}
 protected:
-    std::ofstream *filestr;
+    std::ostream *filestr;
 private:
     DRW_TextCodec encoder;
 };
 
 class dxfWriterBinary : public dxfWriter {
 public:
-    dxfWriterBinary(std::ofstream *stream):dxfWriter(stream){}
+    dxfWriterBinary(std::ostream *stream):dxfWriter(stream){}
     virtual ~dxfWriterBinary() {}
     virtual bool writeString(int code, std::string text);
     virtual bool writeInt16(int code, int data);
@@ -51,7 +52,7 @@ public:
 
 class dxfWriterAscii : public dxfWriter {
 public:
-    dxfWriterAscii(std::ofstream *stream);
+    dxfWriterAscii(std::ostream *stream);
     virtual ~dxfWriterAscii(){}
     virtual bool writeString(int code, std::string text);
     virtual bool writeInt16(int code, int data);
@@ -17,6 +17,8 @@
 #include <sstream>
 #include "intern/drw_dbg.h"
 #include "intern/drw_textcodec.h"
+#include "intern/drw_input.h"
+#include "intern/dwgbuffer.h"
 #include "intern/dwgreader.h"
 #include "intern/dwgreader15.h"
 #include "intern/dwgreader18.h"
@@ -44,6 +46,12 @@ dwgR::dwgR(const char* name){
     applyExt = false;
     version = DRW::UNKNOWNV;
     error = DRW::BAD_NONE;
+    traceSink = NULL;
+    readAhead = false;
+    extentsEnabled = false;
+    computeExtents = false;
+    computeFingerprints = false;
+    blockCache = NULL;
 }
 
 dwgR::~dwgR(){
@@ -141,32 +149,145 @@ bool dwgR::testReader(){
 
 /*start reading dwg file header and, if can read it, continue reading all*/
 bool dwgR::read(DRW_Interface *interface_, bool ext){
-    bool isOk = false;
     applyExt = ext;
     iface = interface_;
+    stats.clear();
+    extents.clear();
+    fingerprints.clear();
+    double start = DRW_ReadStats::now();
 
 //testReader();return false;
 
+    if (readAhead) {
+        DRW_FdSource file(fileName.c_str());
+        if (!file.isOpen()) {
+            error = DRW::BAD_OPEN;
+            return false;
+        }
+        return read(&file, interface_, ext);
+    }
     std::ifstream filestr;
-    isOk = openFile(&filestr);
-    if (!isOk)
+    if (!openFile(&filestr))
         return false;
 
-    isOk = reader->readMetaData();
+    bool isOk = readDwg(start);
+    filestr.close();
+    return isOk;
+}
+
+bool dwgR::read(int fd, DRW_Interface *interface_, bool ext){
+    applyExt = ext;
+    iface = interface_;
+    stats.clear();
+    extents.clear();
+    fingerprints.clear();
+    double start = DRW_ReadStats::now();
+
+    if (fd < 0) {
+        error = DRW::BAD_OPEN;
+        return false;
+    }
+    if (readAhead) {
+        DRW_FdSource file(fd);
+        return read(&file, interface_, ext);
+    }
+    DRW_FdStreamBuf buf(fd);
+    std::istream stream(&buf);
+    if (!openStream(&stream))
+        return false;
+    return readDwg(start);
+}
+
+bool dwgR::read(std::istream *stream, DRW_Interface *interface_, bool ext){
+    applyExt = ext;
+    iface = interface_;
+    stats.clear();
+    extents.clear();
+    fingerprints.clear();
+    double start = DRW_ReadStats::now();
+
+    if (stream == NULL || !stream->good()) {
+        error = DRW::BAD_OPEN;
+        return false;
+    }
+    if (!openStream(stream))
+        return false;
+    return readDwg(start);
+}
+
+bool dwgR::read(const char *data, size_t size, DRW_Interface *interface_, bool ext){
+    applyExt = ext;
+    iface = interface_;
+    stats.clear();
+    extents.clear();
+    fingerprints.clear();
+    double start = DRW_ReadStats::now();
+
+    if (data == NULL || size > 0x7FFFFFFF) { //dwgBuffer size is int
+        error = DRW::BAD_OPEN;
+        return false;
+    }
+    //sniffed from the memory, read by dwgCharStream, no copies
+    DRW_MemStreamBuf buf(data, size);
+    std::istream stream(&buf);
+    dwgBuffer *fileBuf = new dwgBuffer(reinterpret_cast<duint8*>(const_cast<char*>(data)), size);
+    if (!openReader(&stream, fileBuf))
+        return false;
+    return readDwg(start);
+}
+
+bool dwgR::read(DRW_InputSource *source, DRW_Interface *interface_, bool ext){
+    if (source == NULL) {
+        error = DRW::BAD_OPEN;
+        return false;
+    }
+    //dwg needs random access, load it all, with read-ahead the
+    //source is read in another thread while the data is collected
+    DRW_ReadAheadSource *ahead = NULL;
+    if (readAhead)
+        source = ahead = new DRW_ReadAheadSource(source);
+    std::vector<char> data;
+    size_t n = 0;
+    size_t r;
+    do {
+        data.resize(n + 65536);
+        r = source->read(&data[n], 65536);
+        if (r > 65536) //misbehaving source
+            r = 0;
+        n += r;
+    } while (r > 0);
+    delete ahead;
+    data.resize(n);
+    if (n == 0) {
+        stats.clear();
+        error = DRW::BAD_VERSION;
+        return false;
+    }
+    return read(&data[0], n, interface_, ext);
+}
+
+/*reads the dwg with the reader installed by openStream and deletes it*/
+bool dwgR::readDwg(double start){
+    bool isOk = reader->readMetaData();
     if (isOk) {
+        double t = beginPhase(DRW_ReadStats::FILEHEADER);
         isOk = reader->readFileHeader();
+        endPhase(DRW_ReadStats::FILEHEADER, t);
         if (isOk) {
             isOk = processDwg();
+            stats.bytesIn = reader->fileBuf->size();
+            if (traceSink != NULL)
+                traceEvent(DRW::BYTES_CONSUMED, fileName.c_str(), stats.bytesIn);
         } else
             error = DRW::BAD_READ_FILE_HEADER;
     } else
         error = DRW::BAD_READ_METADATA;
 
-    filestr.close();
     if (reader != NULL) {
         delete reader;
         reader = NULL;
     }
+    stats.totalTime = DRW_ReadStats::now() - start;
 
     return isOk;
 }
@@ -178,88 +299,130 @@ bool dwgR::read(DRW_Interface *interface_, bool ext){
  * Return true on succeed or false on fail
 */
 bool dwgR::openFile(std::ifstream *filestr){
-    bool isOk = false;
     DRW_DBG("dwgR::read 1\n");
     filestr->open (fileName.c_str(), std::ios_base::in | std::ios::binary);
     if (!filestr->is_open() || !filestr->good() ){
         error = DRW::BAD_OPEN;
-        return isOk;
+        return false;
+    }
+    if (!openStream(filestr)) {
+        filestr->close();
+        return false;
     }
+    return true;
+}
+
+/* Detects the version from the first bytes of stream and install the
+ * correct reader version, the same buffered stream is used to read.
+ * If not are DWG or are unsupported version, error are set as DRW::BAD_VERSION
+*/
+bool dwgR::openStream(std::istream *stream){
+    return openReader(stream, new dwgBuffer(stream));
+}
 
-    char line[7];
-    filestr->read (line, 6);
-    line[6]='\0';
+/* Detects the version reading stream and installs the reader for it,
+ * the reader takes the ownership of buf, it is deleted on fail.
+*/
+bool dwgR::openReader(std::istream *stream, dwgBuffer *buf){
+    //not dwg gives UNKNOWNV
+    DRW::sniffFormat(stream, &version);
     DRW_DBG("dwgR::read 2\n");
-    DRW_DBG("dwgR::read line version: ");
-    DRW_DBG(line);
+    DRW_DBG("dwgR::read version: ");
+    DRW_DBG(version);
     DRW_DBG("\n");
 
-    if (strcmp(line, "AC1006") == 0)
-        version = DRW::AC1006;
-    else if (strcmp(line, "AC1009") == 0) {
-        version = DRW::AC1009;
-//        reader = new dwgReader09(&filestr, this);
-    }else if (strcmp(line, "AC1012") == 0){
-        version = DRW::AC1012;
-        reader = new dwgReader15(filestr, this);
-    } else if (strcmp(line, "AC1014") == 0) {
-        version = DRW::AC1014;
-        reader = new dwgReader15(filestr, this);
-    } else if (strcmp(line, "AC1015") == 0) {
-        version = DRW::AC1015;
-        reader = new dwgReader15(filestr, this);
-    } else if (strcmp(line, "AC1018") == 0){
-        version = DRW::AC1018;
-        reader = new dwgReader18(filestr, this);
-    } else if (strcmp(line, "AC1021") == 0) {
-        version = DRW::AC1021;
-        reader = new dwgReader21(filestr, this);
-    } else if (strcmp(line, "AC1024") == 0) {
-        version = DRW::AC1024;
-        reader = new dwgReader24(filestr, this);
-    } else if (strcmp(line, "AC1027") == 0) {
-        version = DRW::AC1027;
-        reader = new dwgReader27(filestr, this);
-    } else if (strcmp(line, "AC1032") == 0) {
-        version = DRW::AC1032;
-        reader = new dwgReader32(filestr, this);
-    } else
-        version = DRW::UNKNOWNV;
+    switch (version) {
+    case DRW::AC1012:
+    case DRW::AC1014:
+    case DRW::AC1015:
+        reader = new dwgReader15(buf, this);
+        break;
+    case DRW::AC1018:
+        reader = new dwgReader18(buf, this);
+        break;
+    case DRW::AC1021:
+        reader = new dwgReader21(buf, this);
+        break;
+    case DRW::AC1024:
+        reader = new dwgReader24(buf, this);
+        break;
+    case DRW::AC1027:
+        reader = new dwgReader27(buf, this);
+        break;
+    case DRW::AC1032:
+        reader = new dwgReader32(buf, this);
+        break;
+    default: //AC1006 & AC1009 unsupported
+        break;
+    }
 
     if (reader == NULL) {
+        delete buf;
         error = DRW::BAD_VERSION;
-        filestr->close();
-    } else
-        isOk = true;
-
-    return isOk;
+        return false;
+    }
+    reader->stats = &stats;
+    reader->extents = computeExtents ? &extents : NULL;
+    reader->simplifier = simplifier.enabled() ? &simplifier : NULL;
+    reader->fingerprints = computeFingerprints ? &fingerprints : NULL;
+    reader->blockCache = blockCache;
+    return true;
 }
 
 /********* Reader Process *********/
 
+/*starts timing a read phase and traces it, returns the start time*/
+double dwgR::beginPhase(DRW_ReadStats::Phase phase){
+    traceEvent(DRW::SECTION_START, DRW_ReadStats::phaseName(phase));
+    return DRW_ReadStats::now();
+}
+
+void dwgR::endPhase(DRW_ReadStats::Phase phase, double start){
+    stats.phaseTime[phase] += DRW_ReadStats::now() - start;
+    traceEvent(DRW::SECTION_END, DRW_ReadStats::phaseName(phase));
+}
+
+/*sends a structured trace event to the installed sink, if any*/
+void dwgR::traceEvent(DRW::TraceEvent ev, const char *name, duint64 bytes){
+    if (traceSink == NULL)
+        return;
+    DRW_TraceRecord rec(ev, name);
+    rec.bytes = bytes;
+    traceSink->traceEvent(rec);
+}
+
 bool dwgR::processDwg() {
     DRW_DBG("dwgR::processDwg() start processing dwg\n");
     bool ret;
     bool ret2;
+    double t;
     DRW_Header hdr;
+    t = beginPhase(DRW_ReadStats::HEADER);
     ret = reader->readDwgHeader(hdr);
+    endPhase(DRW_ReadStats::HEADER, t);
     if (!ret) {
         error = DRW::BAD_READ_HEADER;
     }
 
+    t = beginPhase(DRW_ReadStats::CLASSES);
     ret2 = reader->readDwgClasses();
+    endPhase(DRW_ReadStats::CLASSES, t);
     if (ret && !ret2) {
         error = DRW::BAD_READ_CLASSES;
         ret = ret2;
     }
 
+    t = beginPhase(DRW_ReadStats::HANDLES);
     ret2 = reader->readDwgHandles();
+    endPhase(DRW_ReadStats::HANDLES, t);
     if (ret && !ret2) {
         error = DRW::BAD_READ_HANDLES;
         ret = ret2;
     }
 
+    t = beginPhase(DRW_ReadStats::TABLES);
     ret2 = reader->readDwgTables(hdr);
+    endPhase(DRW_ReadStats::TABLES, t);
     if (ret && !ret2) {
         error = DRW::BAD_READ_TABLES;
         ret = ret2;
@@ -296,19 +459,27 @@ bool dwgR::processDwg() {
         iface->addAppId(const_cast<DRW_AppId&>(*ly));
     }
 
+    t = beginPhase(DRW_ReadStats::BLOCKS);
     ret2 = reader->readDwgBlocks(*iface);
+    endPhase(DRW_ReadStats::BLOCKS, t);
     if (ret && !ret2) {
         error = DRW::BAD_READ_BLOCKS;
         ret = ret2;
     }
 
+    t = beginPhase(DRW_ReadStats::ENTITIES);
     ret2 = reader->readDwgEntities(*iface);
+    endPhase(DRW_ReadStats::ENTITIES, t);
     if (ret && !ret2) {
         error = DRW::BAD_READ_ENTITIES;
         ret = ret2;
     }
+    if (computeExtents)
+        extents.finish();
 
+    t = beginPhase(DRW_ReadStats::OBJECTS);
     ret2 = reader->readDwgObjects(*iface);
+    endPhase(DRW_ReadStats::OBJECTS, t);
     if (ret && !ret2) {
         error = DRW::BAD_READ_OBJECTS;
         ret = ret2;
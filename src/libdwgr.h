@@ -14,13 +14,22 @@
 #define LIBDWGR_H
 
 #include <string>
+#include <iosfwd>
 //#include <deque>
 #include "drw_entities.h"
 #include "drw_objects.h"
 #include "drw_classes.h"
 #include "drw_interface.h"
+#include "drw_trace.h"
+#include "drw_stats.h"
+#include "drw_extents.h"
+#include "drw_simplify.h"
+#include "drw_fingerprint.h"
+#include "drw_source.h"
 
 class dwgReader;
+class dwgBuffer;
+class DRW_BlockCache;
 
 class dwgR {
 public:
@@ -28,15 +37,46 @@ public:
     ~dwgR();
     //read: return true if all ok
     bool read(DRW_Interface *interface_, bool ext);
+    //read from an open file descriptor, from its current offset, it is not closed
+    bool read(int fd, DRW_Interface *interface_, bool ext);
+    //read from a seekable stream
+    bool read(std::istream *stream, DRW_Interface *interface_, bool ext);
+    //read from a memory buffer, it is not copied
+    bool read(const char *data, size_t size, DRW_Interface *interface_, bool ext);
+    //read from a user supplied source, loaded in memory before parsing
+    bool read(DRW_InputSource *source, DRW_Interface *interface_, bool ext);
     bool getPreview();
     DRW::Version getVersion(){return version;}
     DRW::error getError(){return error;}
 bool testReader();
     void setDebug(DRW::DBG_LEVEL lvl);
+    void setTraceSink(DRW_TraceSink *sink){traceSink = sink;} /*!< receives structured trace events, NULL to disable */
+    DRW_TraceSink *getTraceSink(){return traceSink;}
+    const DRW_ReadStats& getStats() const {return stats;} /*!< statistics of the last read() */
+    //files, descriptors and sources are loaded in memory with large reads in a background thread
+    void setReadAhead(bool enable){readAhead = enable;}
+    //computes the bounds of the entities while they are read, disabled by default
+    void setExtents(bool enable){extentsEnabled = enable; computeExtents = enable || extents.isIndexed();}
+    //also packs the entities of each space in DRW_Extents::modelIndex & paperIndex, computes the extents while enabled
+    void setSpatialIndex(bool enable){extents.setIndexed(enable); computeExtents = enable || extentsEnabled;}
+    const DRW_Extents& getExtents() const {return extents;} /*!< extents of the last read() */
+    //simplifies the polylines while they are read, disabled by default, see DRW_Simplifier
+    void setSimplifier(const DRW_Simplifier &s){simplifier = s;}
+    //hashes the entities while they are read & finds their duplicates, disabled by default, see DRW_Fingerprints
+    void setFingerprints(const DRW_Fingerprints &f){fingerprints = f; computeFingerprints = true;}
+    const DRW_Fingerprints& getFingerprints() const {return fingerprints;} /*!< results of the last read() */
+    //shares the block definitions with the other drawings read with 'cache', not owned, NULL to disable, see DRW_BlockCache
+    void setBlockCache(DRW_BlockCache *cache){blockCache = cache;}
 
 private:
     bool openFile(std::ifstream *filestr);
+    bool openStream(std::istream *stream);
+    bool openReader(std::istream *stream, dwgBuffer *buf);
+    bool readDwg(double start);
     bool processDwg();
+    void traceEvent(DRW::TraceEvent ev, const char *name, duint64 bytes=0);
+    double beginPhase(DRW_ReadStats::Phase phase);
+    void endPhase(DRW_ReadStats::Phase phase, double start);
 private:
     DRW::Version version;
     DRW::error error;
@@ -45,6 +85,16 @@ private:
     std::string codePage;
     DRW_Interface *iface;
     dwgReader *reader;
+    DRW_TraceSink *traceSink;
+    DRW_ReadStats stats;
+    bool readAhead;
+    bool extentsEnabled;  /*!< set by setExtents() */
+    bool computeExtents;  /*!< extents enabled or indexed */
+    DRW_Extents extents;
+    DRW_Simplifier simplifier;
+    bool computeFingerprints;
+    DRW_Fingerprints fingerprints;
+    DRW_BlockCache *blockCache;
 
 };
 
@@ -16,9 +16,13 @@
 #include <algorithm>
 #include <sstream>
 #include <cassert>
+#include "drw_blockcache.h"
 #include "intern/drw_textcodec.h"
 #include "intern/dxfreader.h"
 #include "intern/dxfwriter.h"
+#include "intern/drw_input.h"
+#include "intern/drw_compress.h"
+#include "intern/drw_entitycopy.h"
 #include "intern/drw_dbg.h"
 
 #define FIRSTHANDLE 48
@@ -38,7 +42,15 @@ dxfRW::dxfRW(const char* name){
     reader = NULL;
     writer = NULL;
     applyExt = false;
-    elParts = 128; //parts munber when convert ellipse to polyline
+    setEllipseParts(128); //parts munber when convert ellipse to polyline
+    traceSink = NULL;
+    compression = DRW::NO_COMPRESSION;
+    compressLevel = -1;
+    readAhead = false;
+    extentsEnabled = false;
+    computeExtents = false;
+    computeFingerprints = false;
+    blockCache = NULL;
 }
 dxfRW::~dxfRW(){
     if (reader != NULL)
@@ -51,6 +63,13 @@ dxfRW::~dxfRW(){
     imageDef.clear();
 }
 
+void dxfRW::setEllipseParts(int parts){
+    if (parts < 1)
+        parts = 1;
+    //the chord error of a circle split in 'parts', relative to its radius
+    tessellator.setTolerance(1.0 - cos(M_PI / parts), true);
+}
+
 void dxfRW::setDebug(DRW::DBG_LEVEL lvl){
     switch (lvl){
     case DRW::DEBUG:
@@ -63,61 +82,206 @@ void dxfRW::setDebug(DRW::DBG_LEVEL lvl){
 
 bool dxfRW::read(DRW_Interface *interface_, bool ext){
     drw_assert(fileName.empty() == false);
-    bool isOk = false;
     applyExt = ext;
-    std::ifstream filestr;
     if ( interface_ == NULL )
-                return isOk;
+                return false;
+    stats.clear();
+    extents.clear();
+    fingerprints.clear();
+    double start = DRW_ReadStats::now();
     DRW_DBG("dxfRW::read 1def\n");
+    if (readAhead) {
+        DRW_FdSource file(fileName.c_str());
+        if (!file.isOpen())
+            return false;
+        iface = interface_;
+        return readSource(&file, start);
+    }
+    //opened once in binary mode, ascii reader strips the '\r'
+    std::ifstream filestr;
     filestr.open (fileName.c_str(), std::ios_base::in | std::ios::binary);
     if (!filestr.is_open())
-        return isOk;
+        return false;
     if (!filestr.good())
-        return isOk;
+        return false;
 
-    char line[22];
-    char line2[22] = "AutoCAD Binary DXF\r\n";
-    line2[20] = (char)26;
-    line2[21] = '\0';
-    filestr.read (line, 22);
+    iface = interface_;
+    bool isOk = readStream(&filestr, start);
     filestr.close();
+    return isOk;
+}
+
+bool dxfRW::read(int fd, DRW_Interface *interface_, bool ext){
+    applyExt = ext;
+    if ( interface_ == NULL || fd < 0 )
+                return false;
+    stats.clear();
+    extents.clear();
+    fingerprints.clear();
+    double start = DRW_ReadStats::now();
+    iface = interface_;
+    if (readAhead) {
+        DRW_FdSource file(fd);
+        return readSource(&file, start);
+    }
+    DRW_FdStreamBuf buf(fd);
+    std::istream stream(&buf);
+    return readStream(&stream, start);
+}
+
+bool dxfRW::read(std::istream *stream, DRW_Interface *interface_, bool ext){
+    applyExt = ext;
+    if ( interface_ == NULL || stream == NULL || !stream->good() )
+                return false;
+    stats.clear();
+    extents.clear();
+    fingerprints.clear();
+    double start = DRW_ReadStats::now();
     iface = interface_;
+    if (stream->tellg() < 0) {
+        //not seekable, read forward only with a small put back area
+        stream->clear();
+        DRW_StreamSource source(stream);
+        DRW_SourceStreamBuf buf(&source);
+        std::istream forward(&buf);
+        return readStream(&forward, start);
+    }
+    return readStream(stream, start);
+}
+
+bool dxfRW::read(const char *data, size_t size, DRW_Interface *interface_, bool ext){
+    applyExt = ext;
+    if ( interface_ == NULL || data == NULL )
+                return false;
+    stats.clear();
+    extents.clear();
+    fingerprints.clear();
+    double start = DRW_ReadStats::now();
+    DRW_MemStreamBuf buf(data, size);
+    std::istream stream(&buf);
+    iface = interface_;
+    return readStream(&stream, start);
+}
+
+bool dxfRW::read(DRW_InputSource *source, DRW_Interface *interface_, bool ext){
+    applyExt = ext;
+    if ( interface_ == NULL || source == NULL )
+                return false;
+    stats.clear();
+    extents.clear();
+    fingerprints.clear();
+    double start = DRW_ReadStats::now();
+    iface = interface_;
+    return readSource(source, start);
+}
+
+/*reads a source forward only, in another thread if read-ahead is enabled*/
+bool dxfRW::readSource(DRW_InputSource *source, double start){
+    if (readAhead) {
+        DRW_ReadAheadSource ahead(source);
+        DRW_SourceStreamBuf buf(&ahead);
+        std::istream stream(&buf);
+        return readStream(&stream, start);
+    }
+    DRW_SourceStreamBuf buf(source);
+    std::istream stream(&buf);
+    return readStream(&stream, start);
+}
+
+/*decompresses the stream if needed and parses it*/
+bool dxfRW::readStream(std::istream *stream, double start){
+    DRW::Compression comp = DRW::sniffCompression(stream);
+    bool isOk;
+    if (comp == DRW::NO_COMPRESSION) {
+        isOk = parseStream(stream, start);
+    } else {
+        DRW_DecompressSource unpack(stream, comp);
+        if (!unpack.ok())
+            return false;
+        //decompression in another thread overlaps with parsing
+        {
+            DRW_ReadAheadSource ahead(&unpack);
+            DRW_SourceStreamBuf buf(&ahead);
+            std::istream plain(&buf);
+            isOk = parseStream(&plain, start);
+        }
+        //the worker is joined, 'unpack' is no longer read
+        isOk = isOk && !unpack.failed();
+        stats.bytesOut = stats.bytesIn;
+        stats.bytesIn = unpack.consumed();
+    }
+    stats.totalTime = DRW_ReadStats::now() - start;
+    if (traceSink != NULL)
+        traceEvent(DRW::BYTES_CONSUMED, fileName, 0, stats.bytesIn);
+    return isOk;
+}
+
+/*detects the format from the stream and parses it*/
+bool dxfRW::parseStream(std::istream *stream, double start){
     DRW_DBG("dxfRW::read 2\n");
-    if (strcmp(line, line2) == 0) {
-        filestr.open (fileName.c_str(), std::ios_base::in | std::ios::binary);
+    DRW::FileFormat format = DRW::sniffFormat(stream, NULL);
+    if (format == DRW::DXF_BINARY) {
         binFile = true;
-        //skip sentinel
-        filestr.seekg (22, std::ios::beg);
-        reader = new dxfReaderBinary(&filestr);
+        reader = new dxfReaderBinary(stream);
         DRW_DBG("dxfRW::read binary file\n");
-    } else {
+    } else if (format == DRW::DXF_ASCII) {
         binFile = false;
-        filestr.open (fileName.c_str(), std::ios_base::in);
-        reader = new dxfReaderAscii(&filestr);
-    }
+        reader = new dxfReaderAscii(stream);
+    } else
+        return false;
+    stats.phaseTime[DRW_ReadStats::FILEHEADER] = DRW_ReadStats::now() - start;
 
-    isOk = processDxf();
-    filestr.close();
+    std::fill(entityCounts, entityCounts + DRW::UNKNOWN + 1, 0);
+    bool isOk = processDxf();
+    for (int i = 0; i < DRW::UNKNOWN; ++i) {
+        if (entityCounts[i] > 0)
+            stats.objects[entityName(static_cast<DRW::ETYPE>(i))] += entityCounts[i];
+    }
+    if (computeExtents)
+        extents.finish();
+    stats.bytesIn = reader->getPosition();
     delete reader;
     reader = NULL;
     return isOk;
 }
 
+bool dxfRW::setCompression(DRW::Compression c, int level){
+    if (!DRW::compressionSupported(c))
+        return false;
+    compression = c;
+    compressLevel = level;
+    return true;
+}
+
 bool dxfRW::write(DRW_Interface *interface_, DRW::Version ver, bool bin){
     bool isOk = false;
     std::ofstream filestr;
+    std::ostream *out = &filestr;
+    DRW_CompressStreamBuf *packer = NULL;
     version = ver;
     binFile = bin;
     iface = interface_;
-    if (binFile) {
+    if (compression != DRW::NO_COMPRESSION) {
+        //compressed by another thread while the next block is formatted
         filestr.open (fileName.c_str(), std::ios_base::out | std::ios::binary | std::ios::trunc);
+        packer = new DRW_CompressStreamBuf(&filestr, compression, compressLevel);
+        if (!filestr.is_open() || !packer->ok()) {
+            delete packer;
+            return false;
+        }
+        out = new std::ostream(packer);
+    }
+    if (binFile) {
+        if (packer == NULL)
+            filestr.open (fileName.c_str(), std::ios_base::out | std::ios::binary | std::ios::trunc);
         //write sentinel
-        filestr << "AutoCAD Binary DXF\r\n" << (char)26 << '\0';
-        writer = new dxfWriterBinary(&filestr);
+        *out << "AutoCAD Binary DXF\r\n" << (char)26 << '\0';
+        writer = new dxfWriterBinary(out);
         DRW_DBG("dxfRW::read binary file\n");
     } else {
-        filestr.open (fileName.c_str(), std::ios_base::out | std::ios::trunc);
-        writer = new dxfWriterAscii(&filestr);
+        if (packer == NULL)
+            filestr.open (fileName.c_str(), std::ios_base::out | std::ios::trunc);
+        writer = new dxfWriterAscii(out);
         std::string comm = std::string("dxfrw ") + std::string(DRW_VERSION);
         writer->writeString(999, comm);
     }
@@ -153,9 +317,14 @@ bool dxfRW::write(DRW_Interface *interface_, DRW::Version ver, bool bin){
         writer->writeString(0, "ENDSEC");
     }
     writer->writeString(0, "EOF");
+    isOk = true;
+    if (packer != NULL) {
+        isOk = packer->finish();
+        delete out;
+        delete packer;
+    }
     filestr.flush();
     filestr.close();
-    isOk = true;
     delete writer;
     writer = NULL;
     return isOk;
@@ -656,10 +825,7 @@ bool dxfRW::writeEllipse(DRW_Ellipse *ent){
         writer->writeDouble(41, ent->staparam);
         writer->writeDouble(42, ent->endparam);
     } else {
-        DRW_Polyline pol;
-        //RLZ: copy properties
-        ent->toPolyline(&pol, elParts);
-        writePolyline(&pol);
+        writeAsPolyline(ent);
     }
     return true;
 }
@@ -826,7 +992,7 @@ bool dxfRW::writePolyline(DRW_Polyline *ent) {
         if (v->bulge != 0)
             writer->writeDouble(42, v->bulge);
         if (v->flags != 0) {
-            writer->writeInt16(70, ent->flags);
+            writer->writeInt16(70, v->flags);
         }
         if (v->flags & 2) {
             writer->writeDouble(50, v->tgdir);
@@ -875,18 +1041,33 @@ bool dxfRW::writeSpline(DRW_Spline *ent){
         for (int i = 0;  i< ent->nknots; i++){
             writer->writeDouble(40, ent->knotslist.at(i));
         }
+        bool weighted = ent->weightlist.size() == static_cast<size_t>(ent->ncontrol);
         for (int i = 0;  i< ent->ncontrol; i++){
             DRW_Coord *crd = ent->controllist.at(i);
             writer->writeDouble(10, crd->x);
             writer->writeDouble(20, crd->y);
             writer->writeDouble(30, crd->z);
+            if (weighted)
+                writer->writeDouble(41, ent->weightlist.at(i));
         }
     } else {
-        //RLZ: TODO convert spline in polyline (not exist in acad 12)
+        writeAsPolyline(ent);
     }
     return true;
 }
 
+//curves not in R12 are written as polylines within the tessellation tolerance
+bool dxfRW::writeAsPolyline(DRW_Entity *ent){
+    DRW_Polyline pol;
+    if (!tessellator.toPolyline(*ent, &pol))
+        return false;
+    bool ret = writePolyline(&pol);
+    for (unsigned int i = 0; i < pol.vertlist.size(); ++i)
+        delete pol.vertlist.at(i);
+    pol.vertlist.clear();
+    return ret;
+}
+
 bool dxfRW::writeHatch(DRW_Hatch *ent){
     if (version > DRW::AC1009) {
         writer->writeString(0, "HATCH");
@@ -963,11 +1144,20 @@ bool dxfRW::writeHatch(DRW_Hatch *ent){
             writer->writeDouble(52, ent->angle);
             writer->writeDouble(41, ent->scale);
             writer->writeInt16(77, ent->doubleflag);
-            writer->writeInt16(78, ent->deflines);
+            int deflines = ent->patternlines.size();
+            writer->writeInt16(78, deflines);
+            for (int i = 0; i < deflines; ++i) {
+                const DRW_HatchPatternLine &l = ent->patternlines.at(i);
+                writer->writeDouble(53, l.angle);
+                writer->writeDouble(43, l.base.x);
+                writer->writeDouble(44, l.base.y);
+                writer->writeDouble(45, l.offset.x);
+                writer->writeDouble(46, l.offset.y);
+                writer->writeInt16(79, l.dashes.size());
+                for (unsigned int j = 0; j < l.dashes.size(); ++j)
+                    writer->writeDouble(49, l.dashes.at(j));
+            }
         }
-/*        if (ent->deflines > 0){
-            writer->writeInt16(78, ent->deflines);
-        }*/
         writer->writeInt32(98, 0);
     } else {
         //RLZ: TODO verify in acad12
@@ -1834,20 +2024,39 @@ bool dxfRW::processDxf() {
                 if (code == 2) {
                     sectionstr = reader->getString();
                     DRW_DBG(sectionstr); DRW_DBG("  processDxf\n");
+                    duint64 secStart = 0;
+                    double secTime = DRW_ReadStats::now();
+                    if (traceSink != NULL) {
+                        secStart = reader->getPosition();
+                        traceEvent(DRW::SECTION_START, sectionstr, secStart);
+                    }
                 //found section, process it
+                    DRW_ReadStats::Phase phase = DRW_ReadStats::PHASES;
                     if (sectionstr == "HEADER") {
+                        phase = DRW_ReadStats::HEADER;
                         processHeader();
                     } else if (sectionstr == "CLASSES") {
+                        phase = DRW_ReadStats::CLASSES;
 //                        processClasses();
                     } else if (sectionstr == "TABLES") {
+                        phase = DRW_ReadStats::TABLES;
                         processTables();
                     } else if (sectionstr == "BLOCKS") {
+                        phase = DRW_ReadStats::BLOCKS;
                         processBlocks();
                     } else if (sectionstr == "ENTITIES") {
+                        phase = DRW_ReadStats::ENTITIES;
                         processEntities(false);
                     } else if (sectionstr == "OBJECTS") {
+                        phase = DRW_ReadStats::OBJECTS;
                         processObjects();
                     }
+                    if (phase != DRW_ReadStats::PHASES)
+                        stats.phaseTime[phase] += DRW_ReadStats::now() - secTime;
+                    if (traceSink != NULL) {
+                        duint64 secEnd = reader->getPosition();
+                        traceEvent(DRW::SECTION_END, sectionstr, secStart, secEnd - secStart);
+                    }
                 }
             }
         }
@@ -1857,6 +2066,17 @@ bool dxfRW::processDxf() {
     return true;
 }
 
+/*sends a structured trace event to the installed sink, callers test traceSink
+ * first to avoid building the arguments when tracing is disabled*/
+void dxfRW::traceEvent(DRW::TraceEvent ev, const std::string &name, duint64 offset, duint64 bytes){
+    if (traceSink == NULL)
+        return;
+    DRW_TraceRecord rec(ev, name);
+    rec.offset = offset;
+    rec.bytes = bytes;
+    traceSink->traceEvent(rec);
+}
+
 /********* Header Section *********/
 
 bool dxfRW::processHeader() {
@@ -2109,15 +2329,29 @@ bool dxfRW::processBlock() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
+            //with a cache the block is collected & handed at once
+            DRW_Interface *target = iface;
+            DRW_BlockBuilder builder;
+            if (blockCache != NULL)
+                iface = &builder;
             iface->addBlock(block);
-            if (nextentity == "ENDBLK") {
-                iface->endBlock();
-                return true;  //found ENDBLK, terminate
-            } else {
+            if (computeExtents)
+                extents.beginBlock(block);
+            if (computeFingerprints)
+                fingerprints.beginBlock(block);
+            if (nextentity != "ENDBLK")
                 processEntities(true);
-                iface->endBlock();
-                return true;  //found ENDBLK, terminate
+            if (computeExtents)
+                extents.endBlock();
+            if (computeFingerprints)
+                fingerprints.endBlock();
+            iface->endBlock();
+            if (blockCache != NULL) {
+                iface = target;
+                const DRW_BlockBuilder::Built &b = builder.blocks.back();
+                iface->takeBlockDefinition(b.block, blockCache->share(b.block, b.def));
             }
+            return true;  //found ENDBLK, terminate
         }
         default:
             block.parseCode(code, reader);
@@ -2133,6 +2367,8 @@ bool dxfRW::processBlock() {
 bool dxfRW::processEntities(bool isblock) {
     DRW_DBG("dxfRW::processEntities\n");
     int code;
+    std::string entName; //only with a trace sink
+    bool skipping = false;
     if (!reader->readRec(&code)){
         return false;
     }
@@ -2143,6 +2379,8 @@ bool dxfRW::processEntities(bool isblock) {
             return false;  //first record in entities is 0
    }
     do {
+        if (traceSink != NULL)
+            entName = nextentity;
         if (nextentity == "ENDSEC" || nextentity == "ENDBLK") {
             return true;  //found ENDSEC or ENDBLK terminate
         } else if (nextentity == "POINT") {
@@ -2188,12 +2426,21 @@ bool dxfRW::processEntities(bool isblock) {
         } else if (nextentity == "XLINE") {
             processXline();
         } else {
+            entName.clear(); //unsupported, skipped
+            if (!skipping) {
+                stats.skipped++;
+                skipping = true;
+            }
             if (reader->readRec(&code)){
-                if (code == 0)
+                if (code == 0) {
                     nextentity = reader->getString();
+                    skipping = false;
+                }
             } else
                 return false; //end of file without ENDSEC
         }
+        if (!entName.empty())
+            traceEvent(DRW::OBJECT_DECODED, entName, reader->getPosition());
 
     } while (next);
     return true;
@@ -2209,9 +2456,11 @@ bool dxfRW::processEllipse() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            if (applyExt)
-                ellipse.applyExtrusion();
-            iface->addEllipse(ellipse);
+            if (admitEntity(&ellipse)) {
+                if (applyExt)
+                    ellipse.applyExtrusion();
+                iface->takeEllipse(std::move(ellipse));
+            }
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2232,9 +2481,11 @@ bool dxfRW::processTrace() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            if (applyExt)
-                trace.applyExtrusion();
-            iface->addTrace(trace);
+            if (admitEntity(&trace)) {
+                if (applyExt)
+                    trace.applyExtrusion();
+                iface->takeTrace(std::move(trace));
+            }
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2255,9 +2506,11 @@ bool dxfRW::processSolid() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            if (applyExt)
-                solid.applyExtrusion();
-            iface->addSolid(solid);
+            if (admitEntity(&solid)) {
+                if (applyExt)
+                    solid.applyExtrusion();
+                iface->takeSolid(std::move(solid));
+            }
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2278,7 +2531,8 @@ bool dxfRW::process3dface() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            iface->add3dFace(face);
+            if (admitEntity(&face))
+                iface->take3dFace(std::move(face));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2299,7 +2553,8 @@ bool dxfRW::processViewport() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            iface->addViewport(vp);
+            if (admitEntity(&vp))
+                iface->takeViewport(std::move(vp));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2310,6 +2565,77 @@ bool dxfRW::processViewport() {
     return true;
 }
 
+/*dxf name of the entities of type 't'*/
+const char *dxfRW::entityName(DRW::ETYPE t){
+    switch (t) {
+    case DRW::E3DFACE:
+        return "3DFACE";
+    case DRW::ARC:
+        return "ARC";
+    case DRW::CIRCLE:
+        return "CIRCLE";
+    case DRW::DIMENSION:
+    case DRW::DIMALIGNED:
+    case DRW::DIMLINEAR:
+    case DRW::DIMRADIAL:
+    case DRW::DIMDIAMETRIC:
+    case DRW::DIMANGULAR:
+    case DRW::DIMANGULAR3P:
+    case DRW::DIMORDINATE:
+        return "DIMENSION";
+    case DRW::ELLIPSE:
+        return "ELLIPSE";
+    case DRW::HATCH:
+        return "HATCH";
+    case DRW::IMAGE:
+        return "IMAGE";
+    case DRW::INSERT:
+        return "INSERT";
+    case DRW::LEADER:
+        return "LEADER";
+    case DRW::LINE:
+        return "LINE";
+    case DRW::LWPOLYLINE:
+        return "LWPOLYLINE";
+    case DRW::MTEXT:
+        return "MTEXT";
+    case DRW::POINT:
+        return "POINT";
+    case DRW::POLYLINE:
+        return "POLYLINE";
+    case DRW::RAY:
+        return "RAY";
+    case DRW::SOLID:
+        return "SOLID";
+    case DRW::SPLINE:
+        return "SPLINE";
+    case DRW::TEXT:
+        return "TEXT";
+    case DRW::TRACE:
+        return "TRACE";
+    case DRW::VIEWPORT:
+        return "VIEWPORT";
+    case DRW::XLINE:
+        return "XLINE";
+    default:
+        break;
+    }
+    return "UNKNOWN";
+}
+
+/*fingerprints & bounds of an entity read, false if it is a duplicate to drop,
+  its lists are freed as it does not reach the interface*/
+bool dxfRW::admitEntity(DRW_Entity *e){
+    ++entityCounts[e->eType];
+    if (computeFingerprints && !fingerprints.addEntity(e)) {
+        DRW::freeLists(e);
+        return false;
+    }
+    if (computeExtents)
+        extents.addEntity(e);
+    return true;
+}
+
 bool dxfRW::processPoint() {
     DRW_DBG("dxfRW::processPoint\n");
     int code;
@@ -2320,7 +2646,8 @@ bool dxfRW::processPoint() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            iface->addPoint(point);
+            if (admitEntity(&point))
+                iface->takePoint(std::move(point));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2341,7 +2668,8 @@ bool dxfRW::processLine() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            iface->addLine(line);
+            if (admitEntity(&line))
+                iface->takeLine(std::move(line));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2362,7 +2690,8 @@ bool dxfRW::processRay() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            iface->addRay(line);
+            if (admitEntity(&line))
+                iface->takeRay(std::move(line));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2383,7 +2712,8 @@ bool dxfRW::processXline() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            iface->addXline(line);
+            if (admitEntity(&line))
+                iface->takeXline(std::move(line));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2404,9 +2734,11 @@ bool dxfRW::processCircle() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            if (applyExt)
-                circle.applyExtrusion();
-            iface->addCircle(circle);
+            if (admitEntity(&circle)) {
+                if (applyExt)
+                    circle.applyExtrusion();
+                iface->takeCircle(std::move(circle));
+            }
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2427,9 +2759,11 @@ bool dxfRW::processArc() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            if (applyExt)
-                arc.applyExtrusion();
-            iface->addArc(arc);
+            if (admitEntity(&arc)) {
+                if (applyExt)
+                    arc.applyExtrusion();
+                iface->takeArc(std::move(arc));
+            }
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2450,7 +2784,8 @@ bool dxfRW::processInsert() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            iface->addInsert(insert);
+            if (admitEntity(&insert))
+                iface->takeInsert(std::move(insert));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2471,9 +2806,13 @@ bool dxfRW::processLWPolyline() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            if (applyExt)
-                pl.applyExtrusion();
-            iface->addLWPolyline(pl);
+            if (simplifier.enabled())
+                stats.removedVertices += simplifier.simplify(&pl);
+            if (admitEntity(&pl)) {
+                if (applyExt)
+                    pl.applyExtrusion();
+                iface->takeLWPolyline(std::move(pl));
+            }
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2495,7 +2834,10 @@ bool dxfRW::processPolyline() {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
             if (nextentity != "VERTEX") {
-            iface->addPolyline(pl);
+            if (simplifier.enabled())
+                stats.removedVertices += simplifier.simplify(&pl);
+            if (admitEntity(&pl))
+                iface->takePolyline(std::move(pl));
             return true;  //found new entity or ENDSEC, terminate
             } else {
                 processVertex(&pl);
@@ -2544,7 +2886,8 @@ bool dxfRW::processText() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            iface->addText(txt);
+            if (admitEntity(&txt))
+                iface->takeText(std::move(txt));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2566,7 +2909,8 @@ bool dxfRW::processMText() {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
             txt.updateAngle();
-            iface->addMText(txt);
+            if (admitEntity(&txt))
+                iface->takeMText(std::move(txt));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2587,7 +2931,8 @@ bool dxfRW::processHatch() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            iface->addHatch(&hatch);
+            if (admitEntity(&hatch))
+                iface->takeHatch(std::move(hatch));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2609,7 +2954,8 @@ bool dxfRW::processSpline() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            iface->addSpline(&sp);
+            if (admitEntity(&sp))
+                iface->takeSpline(std::move(sp));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2631,7 +2977,8 @@ bool dxfRW::processImage() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            iface->addImage(&img);
+            if (admitEntity(&img))
+                iface->takeImage(std::move(img));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2656,32 +3003,39 @@ bool dxfRW::processDimension() {
             int type = dim.type & 0x0F;
             switch (type) {
             case 0: {
-                DRW_DimLinear d(dim);
-                iface->addDimLinear(&d);
+                DRW_DimLinear d(std::move(dim));
+                if (admitEntity(&d))
+                    iface->takeDimLinear(std::move(d));
                 break; }
             case 1: {
-                DRW_DimAligned d(dim);
-                iface->addDimAlign(&d);
+                DRW_DimAligned d(std::move(dim));
+                if (admitEntity(&d))
+                    iface->takeDimAlign(std::move(d));
                 break; }
             case 2:  {
-                DRW_DimAngular d(dim);
-                iface->addDimAngular(&d);
+                DRW_DimAngular d(std::move(dim));
+                if (admitEntity(&d))
+                    iface->takeDimAngular(std::move(d));
                 break;}
             case 3: {
-                DRW_DimDiametric d(dim);
-                iface->addDimDiametric(&d);
+                DRW_DimDiametric d(std::move(dim));
+                if (admitEntity(&d))
+                    iface->takeDimDiametric(std::move(d));
                 break; }
             case 4: {
-                DRW_DimRadial d(dim);
-                iface->addDimRadial(&d);
+                DRW_DimRadial d(std::move(dim));
+                if (admitEntity(&d))
+                    iface->takeDimRadial(std::move(d));
                 break; }
             case 5: {
-                DRW_DimAngular3p d(dim);
-                iface->addDimAngular3P(&d);
+                DRW_DimAngular3p d(std::move(dim));
+                if (admitEntity(&d))
+                    iface->takeDimAngular3P(std::move(d));
                 break; }
             case 6: {
-                DRW_DimOrdinate d(dim);
-                iface->addDimOrdinate(&d);
+                DRW_DimOrdinate d(std::move(dim));
+                if (admitEntity(&d))
+                    iface->takeDimOrdinate(std::move(d));
                 break; }
             }
             return true;  //found new entity or ENDSEC, terminate
@@ -2704,7 +3058,8 @@ bool dxfRW::processLeader() {
         case 0: {
             nextentity = reader->getString();
             DRW_DBG(nextentity); DRW_DBG("\n");
-            iface->addLeader(&leader);
+            if (admitEntity(&leader))
+                iface->takeLeader(std::move(leader));
             return true;  //found new entity or ENDSEC, terminate
         }
         default:
@@ -2721,6 +3076,7 @@ bool dxfRW::processLeader() {
 bool dxfRW::processObjects() {
     DRW_DBG("dxfRW::processObjects\n");
     int code;
+    bool skipping = false;
     if (!reader->readRec(&code)){
         return false;
     }
@@ -2734,11 +3090,18 @@ bool dxfRW::processObjects() {
         if (nextentity == "ENDSEC") {
             return true;  //found ENDSEC terminate
         } else if (nextentity == "IMAGEDEF") {
+            stats.addObject(nextentity);
             processImageDef();
         } else {
+            if (!skipping) {
+                stats.skipped++;
+                skipping = true;
+            }
             if (reader->readRec(&code)){
-                if (code == 0)
+                if (code == 0) {
                     nextentity = reader->getString();
+                    skipping = false;
+                }
             } else
                 return false; //end of file without ENDSEC
         }
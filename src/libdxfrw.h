@@ -14,10 +14,20 @@
 #define LIBDXFRW_H
 
 #include <string>
+#include <iosfwd>
 #include "drw_entities.h"
 #include "drw_objects.h"
 #include "drw_header.h"
 #include "drw_interface.h"
+#include "drw_trace.h"
+#include "drw_stats.h"
+#include "drw_extents.h"
+#include "drw_tessellate.h"
+#include "drw_simplify.h"
+#include "drw_fingerprint.h"
+#include "drw_source.h"
+
+class DRW_BlockCache;
 
 
 class dxfReader;
@@ -32,14 +42,43 @@ public:
     /*!
      * An interface must be provided. It is used by the class to signal various
      * components being added.
+     * gzip and zstd compressed files are decompressed while they are parsed,
+     * this applies to all the read() variants.
      * @param interface_ the interface to use
      * @param ext should the extrusion be applied to convert in 2D?
      * @return true for success
      */
     bool read(DRW_Interface *interface_, bool ext);
+    /// reads from an open file descriptor
+    /*!
+     * Parsing starts at the current offset of the descriptor, it is not
+     * closed. Avoids opening the file again when the caller has it open.
+     * Pipes and sockets are accepted, dxf is parsed without seeking while
+     * the data arrives.
+     * @param fd the file descriptor
+     * @param interface_ the interface to use
+     * @param ext should the extrusion be applied to convert in 2D?
+     * @return true for success
+     */
+    bool read(int fd, DRW_Interface *interface_, bool ext);
+    /// reads from a stream, from its current position, non seekable streams are read forward only
+    bool read(std::istream *stream, DRW_Interface *interface_, bool ext);
+    /// reads from a memory buffer, it is not copied
+    bool read(const char *data, size_t size, DRW_Interface *interface_, bool ext);
+    /// reads from a user supplied source, the content is parsed while it is read
+    bool read(DRW_InputSource *source, DRW_Interface *interface_, bool ext);
     void setBinary(bool b) {binFile = b;}
 
     bool write(DRW_Interface *interface_, DRW::Version ver, bool bin);
+    /// compression of the files written by write()
+    /*!
+     * read() detects gzip and zstd input by its magic bytes, this selects the
+     * compression of the output. The default is no compression.
+     * @param c the compression, NO_COMPRESSION to disable
+     * @param level compression level, -1 for the default of the format
+     * @return false if the compression is not supported in this build
+     */
+    bool setCompression(DRW::Compression c, int level = -1);
     bool writeLineType(DRW_LType *ent);
     bool writeLayer(DRW_Layer *ent);
     bool writeDimstyle(DRW_Dimstyle *ent);
@@ -69,9 +108,55 @@ public:
     DRW_ImageDef *writeImage(DRW_Image *ent, std::string name);
     bool writeLeader(DRW_Leader *ent);
     bool writeDimension(DRW_Dimension *ent);
-    void setEllipseParts(int parts){elParts = parts;} /*!< set parts munber when convert ellipse to polyline */
+    /// segments of a full turn when ellipses & splines are converted to polylines for R12, 128 by default
+    /*!
+     * Taken as a chord error relative to the radius, so the count does not
+     * change with the size of the curve: a full ellipse gets 'parts'
+     * segments, an arc the share of its sweep (a quarter turn 'parts'/4).
+     * Splines use the same relative error with half the diagonal of their
+     * control points as radius.
+     */
+    void setEllipseParts(int parts);
+    /** largest distance in drawing units of the R12 polylines to the curves, replaces the parts */
+    void setTessellationTolerance(double tolerance){tessellator.setTolerance(tolerance);}
+    void setTraceSink(DRW_TraceSink *sink){traceSink = sink;} /*!< receives structured trace events, NULL to disable */
+    /// reads files, descriptors and sources in large blocks on a background thread
+    /*!
+     * The parser consumes a block while the next ones are read, it hides the
+     * latency of slow storage. Disabled by default, memory and stream input
+     * are not affected.
+     */
+    void setReadAhead(bool enable){readAhead = enable;}
+    const DRW_ReadStats& getStats() const {return stats;} /*!< statistics of the last read() */
+    /// computes the bounds of the entities while they are read, disabled by default
+    void setExtents(bool enable){extentsEnabled = enable; computeExtents = enable || extents.isIndexed();}
+    /// also packs the entities of each space in DRW_Extents::modelIndex & paperIndex, computes the extents while enabled
+    void setSpatialIndex(bool enable){extents.setIndexed(enable); computeExtents = enable || extentsEnabled;}
+    const DRW_Extents& getExtents() const {return extents;} /*!< extents of the last read() */
+    /// simplifies the polylines while they are read, before the interface gets them
+    /*!
+     * Disabled by default, see DRW_Simplifier. The removed vertices are
+     * counted in DRW_ReadStats::removedVertices.
+     */
+    void setSimplifier(const DRW_Simplifier &s){simplifier = s;}
+    /// hashes the entities while they are read & finds their duplicates, disabled by default
+    /*!
+     * 'f' gives the settings, see DRW_Fingerprints. The duplicates dropped
+     * do not reach the interface nor the extents.
+     */
+    void setFingerprints(const DRW_Fingerprints &f){fingerprints = f; computeFingerprints = true;}
+    const DRW_Fingerprints& getFingerprints() const {return fingerprints;} /*!< results of the last read() */
+    /// shares the block definitions with the other drawings read with 'cache'
+    /*!
+     * The interface gets the blocks with takeBlockDefinition(), see
+     * DRW_BlockCache. Not owned, NULL (the default) to disable.
+     */
+    void setBlockCache(DRW_BlockCache *cache){blockCache = cache;}
 
 private:
+    bool readSource(DRW_InputSource *source, double start);
+    bool readStream(std::istream *stream, double start);
+    bool parseStream(std::istream *stream, double start);
     /// used by read() to parse the content of the file
     bool processDxf();
     bool processHeader();
@@ -111,6 +196,9 @@ private:
     bool processImageDef();
     bool processDimension();
     bool processLeader();
+    bool admitEntity(DRW_Entity *e);
+    static const char *entityName(DRW::ETYPE t);
+    void traceEvent(DRW::TraceEvent ev, const std::string &name, duint64 offset, duint64 bytes=0);
 
 //    bool writeHeader();
     bool writeEntity(DRW_Entity *ent);
@@ -118,6 +206,7 @@ private:
     bool writeBlocks();
     bool writeObjects();
     bool writeExtData(const std::vector<DRW_Variant*> &ed);
+    bool writeAsPolyline(DRW_Entity *ent);
     /*use version from dwgutil.h*/
     std::string toHexStr(int n);//RLZ removeme
 
@@ -137,11 +226,24 @@ private:
     bool dimstyleStd;
     bool applyExt;
     bool writingBlock;
-    int elParts;  /*!< parts munber when convert ellipse to polyline */
+    DRW_Tessellator tessellator;  /*!< converts ellipses & splines to polylines for R12 */
     std::map<std::string,int> blockMap;
     std::vector<DRW_ImageDef*> imageDef;  /*!< imageDef list */
 
     int currHandle;
+    DRW_TraceSink *traceSink;
+    DRW_ReadStats stats;
+    duint32 entityCounts[DRW::UNKNOWN + 1];  /*!< entities read per type, added to stats at the end */
+    DRW::Compression compression; /*!< compression of write() */
+    int compressLevel;
+    bool readAhead;  /*!< read the input in a background thread */
+    bool extentsEnabled;  /*!< set by setExtents() */
+    bool computeExtents;  /*!< extents enabled or indexed */
+    DRW_Extents extents;
+    DRW_Simplifier simplifier;
+    bool computeFingerprints;
+    DRW_Fingerprints fingerprints;
+    DRW_BlockCache *blockCache;  /*!< not owned, NULL if not enabled */
 
 };
 
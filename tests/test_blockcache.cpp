@@ -0,0 +1,217 @@
+/******************************************************************************
+**  libDXFrw - Block Cache Tests                                            **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "libdxfrw.h"
+#include "drw_blockcache.h"
+#include "test_interface.h"
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+
+class SharingReader : public TestInterface {
+public:
+    virtual void takeBlockDefinition(const DRW_Block& data, const std::shared_ptr<const DRW_BlockDef>& def) {
+        names.push_back(data.name);
+        defs.push_back(def);
+    }
+    std::vector<std::string> names;
+    std::vector<std::shared_ptr<const DRW_BlockDef> > defs;
+};
+
+//a valve symbol: two lines, a circle & a closed polyline
+static std::string valveDxf(const char *name, int firstHandle, double radius = 2.5) {
+    std::ostringstream s;
+    s << std::hex << std::uppercase;
+    s << "0\nBLOCK\n5\n" << firstHandle << "\n8\n0\n2\n" << name << "\n70\n0\n10\n1\n20\n0\n30\n0\n";
+    s << "0\nLINE\n5\n" << firstHandle + 1 << "\n8\nsymbols\n10\n-5\n20\n0\n30\n0\n11\n5\n21\n0\n31\n0\n";
+    s << "0\nLINE\n5\n" << firstHandle + 2 << "\n8\nsymbols\n10\n0\n20\n-5\n30\n0\n11\n0\n21\n5\n31\n0\n";
+    s << "0\nCIRCLE\n5\n" << firstHandle + 3 << "\n8\nsymbols\n10\n0\n20\n0\n30\n0\n40\n" << std::dec << radius << std::hex << "\n";
+    s << "0\nLWPOLYLINE\n5\n" << firstHandle + 4 << "\n8\nsymbols\n90\n3\n70\n1\n"
+      << "10\n0\n20\n0\n10\n4\n20\n0\n10\n4\n20\n3\n";
+    s << "0\nENDBLK\n8\n0\n";
+    return s.str();
+}
+
+static std::string drawing(const std::string &blocks) {
+    return "0\nSECTION\n2\nBLOCKS\n" + blocks + "0\nENDSEC\n0\nSECTION\n2\nENTITIES\n"
+            "0\nLINE\n5\n90\n8\n0\n10\n0\n20\n0\n30\n0\n11\n1\n21\n1\n31\n0\n0\nENDSEC\n0\nEOF\n";
+}
+
+static const char *dimBlock =
+        "0\nBLOCK\n8\n0\n2\n*D1\n70\n1\n10\n0\n20\n0\n30\n0\n"
+        "0\nDIMENSION\n5\n60\n8\n0\n2\n*D1\n10\n0\n20\n0\n30\n0\n70\n1\n13\n0\n23\n0\n33\n0\n14\n5\n24\n0\n34\n0\n"
+        "0\nENDBLK\n8\n0\n";
+
+bool testShareAcrossReads() {
+    std::cout << "\n=== Test: Share Across Reads ===" << std::endl;
+
+    DRW_BlockCache cache;
+    std::string first = drawing(valveDxf("VALVE", 0x20) + valveDxf("BIG", 0x30, 4) + dimBlock);
+    std::string second = drawing(valveDxf("VALVE-2", 0x120));
+
+    SharingReader a, b;
+    dxfRW in("first");
+    in.setBlockCache(&cache);
+    dxfRW in2("second");
+    in2.setBlockCache(&cache);
+    if (!in.read(first.data(), first.size(), &a, false) || !in2.read(second.data(), second.size(), &b, false)
+            || a.defs.size() != 3 || b.defs.size() != 1 || a.lineCount != 1 || b.lineCount != 1) {
+        std::cout << "✗ Blocks not handed as definitions" << std::endl;
+        return false;
+    }
+    // the second drawing gets the block of the first one, under its own name
+    if (b.defs[0] != a.defs[0] || b.names[0] != "VALVE-2" || a.defs[1] == a.defs[0]
+            || a.defs[0]->entities.size() != 4 || a.defs[0]->entities[3]->eType != DRW::LWPOLYLINE
+            || a.defs[0]->basePoint.x != 1.0 || a.defs[0]->key == 0) {
+        std::cout << "✗ Same content not shared or other content shared" << std::endl;
+        return false;
+    }
+    // dimensions are not hashed, the block is handed but not kept
+    if (a.defs[2]->key != 0 || a.defs[2]->entities.size() != 1 || cache.size() != 2
+            || cache.hits() != 1 || cache.misses() != 2 || cache.unshared() != 1) {
+        std::cout << "✗ Wrong counts: " << cache.hits() << " hits, " << cache.misses() << " misses, "
+                  << cache.unshared() << " unshared" << std::endl;
+        return false;
+    }
+    if (cache.find(a.defs[0]->key) != a.defs[0]) {
+        std::cout << "✗ Block not found by its key" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Share across reads test passed" << std::endl;
+    return true;
+}
+
+bool testExtendedDataNotShared() {
+    std::cout << "\n=== Test: Extended Data Not Shared ===" << std::endl;
+
+    DRW_BlockCache cache;
+    std::string plain = valveDxf("VALVE", 0x20);
+    std::string tagged = valveDxf("VALVE-X", 0x120);
+    //XDATA on the first line, the prints are the same
+    size_t end = tagged.find("0\nLINE\n", 1);
+    tagged.insert(tagged.find("0\nLINE\n", end + 1), "1001\nAPP\n1000\ntag\n");
+    std::string dxf = drawing(plain + tagged);
+
+    SharingReader a;
+    dxfRW in("xdata");
+    in.setBlockCache(&cache);
+    if (!in.read(dxf.data(), dxf.size(), &a, false) || a.defs.size() != 2) {
+        std::cout << "✗ Blocks not handed as definitions" << std::endl;
+        return false;
+    }
+    if (a.defs[1] == a.defs[0] || a.defs[1]->key != 0 || a.defs[1]->entities[0]->extData.empty()
+            || cache.size() != 1 || cache.hits() != 0 || cache.unshared() != 1) {
+        std::cout << "✗ Block with XDATA shared, " << cache.hits() << " hits" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Extended data not shared test passed" << std::endl;
+    return true;
+}
+
+bool testDefaultReplay() {
+    std::cout << "\n=== Test: Default Replay ===" << std::endl;
+
+    DRW_BlockCache cache;
+    std::string dxf = drawing(valveDxf("VALVE", 0x20) + valveDxf("OTHER", 0x30));
+    TestInterface plain, cached;
+    dxfRW in("plain");
+    if (!in.read(dxf.data(), dxf.size(), &plain, false)) {
+        std::cout << "✗ Read failed" << std::endl;
+        return false;
+    }
+    dxfRW in2("cached");
+    in2.setBlockCache(&cache);
+    if (!in2.read(dxf.data(), dxf.size(), &cached, false)) {
+        std::cout << "✗ Read with cache failed" << std::endl;
+        return false;
+    }
+    // interfaces without takeBlockDefinition() get the same entities
+    if (cached.lineCount != plain.lineCount || cached.circleCount != plain.circleCount
+            || cached.lwPolylineCount != plain.lwPolylineCount || plain.lineCount != 5
+            || cache.size() != 1 || cache.hits() != 1) {
+        std::cout << "✗ Replayed " << cached.lineCount << " lines, read " << plain.lineCount << std::endl;
+        return false;
+    }
+    std::cout << "✓ Default replay test passed" << std::endl;
+    return true;
+}
+
+bool testSaveAndLoad() {
+    std::cout << "\n=== Test: Save And Load ===" << std::endl;
+
+    const char *filename = "test_blockcache.dxf";
+    DRW_BlockCache cache;
+    std::string dxf = drawing(valveDxf("VALVE", 0x20) + valveDxf("BIG", 0x30, 4));
+    SharingReader a;
+    dxfRW in("first");
+    in.setBlockCache(&cache);
+    if (!in.read(dxf.data(), dxf.size(), &a, false) || !cache.save(filename)) {
+        std::cout << "✗ Cache not saved" << std::endl;
+        std::remove(filename);
+        return false;
+    }
+
+    // another session starts with the saved blocks
+    DRW_BlockCache loaded;
+    bool ok = loaded.load(filename);
+    std::remove(filename);
+    if (!ok || loaded.size() != 2) {
+        std::cout << "✗ Expected 2 blocks loaded, got " << loaded.size() << std::endl;
+        return false;
+    }
+    std::shared_ptr<const DRW_BlockDef> valve = loaded.find(a.defs[0]->key);
+    if (!valve || valve->entities.size() != 4 || valve->basePoint.x != 1.0) {
+        std::cout << "✗ Block loaded with other content" << std::endl;
+        return false;
+    }
+    SharingReader b;
+    dxfRW in2("second");
+    in2.setBlockCache(&loaded);
+    if (!in2.read(dxf.data(), dxf.size(), &b, false) || b.defs.size() != 2 || b.defs[0] != valve
+            || loaded.hits() != 2 || loaded.misses() != 0) {
+        std::cout << "✗ Loaded blocks not shared, " << loaded.hits() << " hits" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Save and load test passed" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "libdxfrw Block Cache Tests" << std::endl;
+    std::cout << "==========================" << std::endl;
+
+    int failedTests = 0;
+    int totalTests = 0;
+
+    totalTests++;
+    if (!testShareAcrossReads()) failedTests++;
+
+    totalTests++;
+    if (!testExtendedDataNotShared()) failedTests++;
+
+    totalTests++;
+    if (!testDefaultReplay()) failedTests++;
+
+    totalTests++;
+    if (!testSaveAndLoad()) failedTests++;
+
+    std::cout << "\n==========================" << std::endl;
+    std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
+
+    if (failedTests > 0) {
+        std::cout << "✗ " << failedTests << " test(s) failed" << std::endl;
+        return 1;
+    } else {
+        std::cout << "✓ All block cache tests passed!" << std::endl;
+        return 0;
+    }
+}
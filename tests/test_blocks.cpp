@@ -12,8 +12,12 @@
 
 #include "libdxfrw.h"
 #include "test_interface.h"
+#include "drw_expand.h"
 #include <iostream>
+#include <sstream>
 #include <cstdio>
+#include <cmath>
+#include <vector>
 
 bool testBasicBlock() {
     std::cout << "\n=== Test: Basic Block Definition ===" << std::endl;
@@ -329,6 +333,176 @@ bool testRotatedAndScaledBlocks() {
     return true;
 }
 
+static bool nearly(double a, double b) {
+    return fabs(a - b) < 1e-9;
+}
+
+// Feeds the blocks and entities read to an expander
+class ExpanderFeed : public TestInterface {
+public:
+    ExpanderFeed(DRW_BlockExpander *e) : expander(e) {}
+    virtual void addBlock(const DRW_Block& data) { expander->beginBlock(data); }
+    virtual void endBlock() { expander->endBlock(); }
+    virtual void addLine(const DRW_Line& data) { expander->addEntity(data); }
+    virtual void addCircle(const DRW_Circle& data) { expander->addEntity(data); }
+    virtual void addInsert(const DRW_Insert& data) { expander->addEntity(data); }
+    virtual void addHatch(const DRW_Hatch* data) { expander->addEntity(*data); }
+
+    DRW_BlockExpander *expander;
+};
+
+// Keeps the expanded entities
+class ExpandedEntities : public TestInterface {
+public:
+    virtual void addLine(const DRW_Line& data) { lines.push_back(data); }
+    virtual void addCircle(const DRW_Circle& data) { circles.push_back(data); }
+    virtual void addEllipse(const DRW_Ellipse& data) { ellipses.push_back(data); }
+
+    std::vector<DRW_Line> lines;
+    std::vector<DRW_Circle> circles;
+    std::vector<DRW_Ellipse> ellipses;
+};
+
+static std::string expansionDxf(int extraInserts) {
+    std::ostringstream dxf;
+    dxf << "0\nSECTION\n2\nBLOCKS\n"
+        // LEAF: a line by block and a circle
+        "0\nBLOCK\n8\n0\n2\nLEAF\n70\n0\n10\n0.0\n20\n0.0\n30\n0.0\n"
+        "0\nLINE\n8\n0\n62\n0\n10\n0.0\n20\n0.0\n30\n0.0\n11\n1.0\n21\n0.0\n31\n0.0\n"
+        "0\nCIRCLE\n8\nFIXED\n10\n0.0\n20\n0.0\n30\n0.0\n40\n1.0\n"
+        "0\nHATCH\n8\n0\n10\n0.0\n20\n0.0\n30\n0.0\n2\nSOLID\n70\n1\n71\n0\n91\n0\n"
+        "0\nENDBLK\n8\n0\n"
+        // GROUP: two LEAF, one turned 90 degrees and by block
+        "0\nBLOCK\n8\n0\n2\nGROUP\n70\n0\n10\n10.0\n20\n0.0\n30\n0.0\n"
+        "0\nINSERT\n8\n0\n2\nLEAF\n10\n10.0\n20\n0.0\n30\n0.0\n"
+        "0\nINSERT\n8\n0\n62\n0\n2\nLEAF\n10\n12.0\n20\n0.0\n30\n0.0\n50\n90.0\n"
+        "0\nENDBLK\n8\n0\n"
+        // SELF inserts itself
+        "0\nBLOCK\n8\n0\n2\nSELF\n70\n0\n10\n0.0\n20\n0.0\n30\n0.0\n"
+        "0\nINSERT\n8\n0\n2\nSELF\n10\n1.0\n20\n0.0\n30\n0.0\n"
+        "0\nENDBLK\n8\n0\n"
+        "0\nENDSEC\n"
+        "0\nSECTION\n2\nENTITIES\n"
+        "0\nINSERT\n5\n10\n8\nL1\n62\n1\n2\nGROUP\n10\n100.0\n20\n0.0\n30\n0.0\n41\n2.0\n42\n2.0\n43\n2.0\n"
+        // 3 columns by 2 rows
+        "0\nINSERT\n5\n11\n8\nM\n2\nLEAF\n10\n0.0\n20\n50.0\n30\n0.0\n70\n3\n71\n2\n44\n5.0\n45\n7.0\n"
+        // uneven scale, the circle becomes an ellipse
+        "0\nINSERT\n5\n12\n8\nS\n2\nLEAF\n10\n-20.0\n20\n0.0\n30\n0.0\n41\n2.0\n42\n1.0\n43\n1.0\n"
+        "0\nINSERT\n5\n13\n8\n0\n2\nSELF\n10\n0.0\n20\n0.0\n30\n0.0\n"
+        "0\nINSERT\n5\n14\n8\n0\n2\nNONE\n10\n0.0\n20\n0.0\n30\n0.0\n";
+    for (int i = 0; i < extraInserts; ++i)
+        dxf << "0\nINSERT\n8\nX\n2\nLEAF\n10\n" << i << ".0\n20\n-100.0\n30\n0.0\n";
+    dxf << "0\nENDSEC\n0\nEOF\n";
+    return dxf.str();
+}
+
+bool testBlockExpansion() {
+    std::cout << "\n=== Test: Block Expansion ===" << std::endl;
+
+    std::string dxf = expansionDxf(0);
+    DRW_BlockExpander expander;
+    ExpanderFeed feed(&expander);
+    dxfRW in("expand");
+    if (!in.read(dxf.data(), dxf.size(), &feed, false)) {
+        std::cout << "✗ Failed to read" << std::endl;
+        return false;
+    }
+
+    std::vector<DRW_BlockInstance> instances;
+    expander.instances(&instances);
+    //GROUP and its 2 LEAF, 6 LEAF of the array, the scaled LEAF and SELF once
+    if (instances.size() != 11 || expander.missing != 2 || expander.skipped != 1) {
+        std::cout << "✗ " << instances.size() << " instances, " << expander.missing
+                  << " missing, " << expander.skipped << " skipped" << std::endl;
+        return false;
+    }
+    //the turned LEAF of GROUP: (1,0) -> (12,1) in GROUP -> (104,2)
+    DRW_Coord p = instances[2].transform.apply(DRW_Coord(1, 0, 0));
+    if (instances[2].block != "LEAF" || instances[2].insert != 0x10 || !nearly(p.x, 104) || !nearly(p.y, 2)) {
+        std::cout << "✗ Nested instance at (" << p.x << ", " << p.y << ")" << std::endl;
+        return false;
+    }
+    //last element of the array, column 2 & row 1
+    p = instances[8].transform.apply(DRW_Coord(1, 0, 0));
+    if (instances[8].insert != 0x11 || !nearly(p.x, 11) || !nearly(p.y, 57)) {
+        std::cout << "✗ Array instance at (" << p.x << ", " << p.y << ")" << std::endl;
+        return false;
+    }
+
+    ExpandedEntities out;
+    expander.expand(&out);
+    if (out.lines.size() != 9 || out.circles.size() != 8 || out.ellipses.size() != 1) {
+        std::cout << "✗ " << out.lines.size() << " lines, " << out.circles.size() << " circles, "
+                  << out.ellipses.size() << " ellipses" << std::endl;
+        return false;
+    }
+    //layer 0 and by block color come from the top insert
+    const DRW_Line &nested = out.lines[1];
+    if (!nearly(nested.basePoint.x, 104) || !nearly(nested.basePoint.y, 0)
+            || !nearly(nested.secPoint.x, 104) || !nearly(nested.secPoint.y, 2)
+            || nested.layer != "L1" || nested.color != 1 || out.lines[2].layer != "M"
+            || out.lines[2].color != DRW::ColorByLayer || out.circles[0].layer != "FIXED"
+            || !nearly(out.circles[0].radious, 2)) {
+        std::cout << "✗ Wrong nested line or properties" << std::endl;
+        return false;
+    }
+    const DRW_Ellipse &el = out.ellipses[0];
+    if (!nearly(el.basePoint.x, -20) || !nearly(fabs(el.secPoint.x), 2) || !nearly(el.ratio, 0.5)
+            || !nearly(el.endparam - el.staparam, M_PIx2)) {
+        std::cout << "✗ Wrong ellipse" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Nested inserts, arrays and properties expanded" << std::endl;
+    return true;
+}
+
+bool testParallelExpansion() {
+    std::cout << "\n=== Test: Parallel Block Expansion ===" << std::endl;
+
+    std::string dxf = expansionDxf(3000);
+    DRW_BlockExpander expander;
+    ExpanderFeed feed(&expander);
+    dxfRW in("expand");
+    if (!in.read(dxf.data(), dxf.size(), &feed, false)) {
+        std::cout << "✗ Failed to read" << std::endl;
+        return false;
+    }
+    ExpandedEntities serial, parallel;
+    std::vector<DRW_BlockInstance> serialList, parallelList;
+    expander.setThreads(1);
+    expander.expand(&serial);
+    expander.instances(&serialList);
+    expander.setThreads(4);
+    expander.expand(&parallel);
+    expander.instances(&parallelList);
+    if (serial.lines.size() != 3009 || parallel.lines.size() != serial.lines.size()
+            || parallelList.size() != serialList.size()) {
+        std::cout << "✗ " << parallel.lines.size() << " lines" << std::endl;
+        return false;
+    }
+    //same entities in the same order
+    for (size_t i = 0; i < serial.lines.size(); ++i) {
+        if (serial.lines[i].basePoint.x != parallel.lines[i].basePoint.x
+                || serial.lines[i].basePoint.y != parallel.lines[i].basePoint.y) {
+            std::cout << "✗ Line " << i << " differs" << std::endl;
+            return false;
+        }
+    }
+    for (size_t i = 0; i < serialList.size(); ++i) {
+        if (serialList[i].block != parallelList[i].block
+                || serialList[i].transform.m[0][3] != parallelList[i].transform.m[0][3]) {
+            std::cout << "✗ Instance " << i << " differs" << std::endl;
+            return false;
+        }
+    }
+    if (!nearly(parallel.lines.back().basePoint.x, 2999) || !nearly(parallel.lines.back().basePoint.y, -100)) {
+        std::cout << "✗ Wrong order" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Same result with 1 and 4 threads" << std::endl;
+    return true;
+}
+
 int main(int argc, char* argv[]) {
     std::cout << "libdxfrw Block Tests" << std::endl;
     std::cout << "====================" << std::endl;
@@ -345,6 +519,12 @@ int main(int argc, char* argv[]) {
     totalTests++;
     if (!testRotatedAndScaledBlocks()) failedTests++;
 
+    totalTests++;
+    if (!testBlockExpansion()) failedTests++;
+
+    totalTests++;
+    if (!testParallelExpansion()) failedTests++;
+
     std::cout << "\n====================" << std::endl;
     std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
 
@@ -0,0 +1,384 @@
+/******************************************************************************
+**  libDXFrw - Text Codec Tests                                             **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "intern/drw_textcodec.h"
+#include "intern/drw_cptable936.h"
+#include "intern/drw_cptable949.h"
+#include "intern/drw_cptable950.h"
+#include "intern/dwgbuffer.h"
+#include "drw_base.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <map>
+
+//"nihongo" in utf-8, 9 bytes, 6 bytes in SJIS
+static const char *NIHONGO = "\xE6\x97\xA5\xE6\x9C\xAC\xE8\xAA\x9E";
+
+bool testIconvLongText() {
+    std::cout << "\n=== Test: iconv Conversion Of Long Text ===" << std::endl;
+
+    //pre 2007 dxf with utf-8 codepage goes through iconv (SJIS)
+    DRW_TextCodec codec;
+    codec.setVersion(DRW::AC1015, true);
+    codec.setCodePage("UTF-8", true);
+
+    std::string utf8;
+    for (int i = 0; i < 1000; ++i)
+        utf8 += NIHONGO;
+    utf8 += " end";
+    std::string sjis = codec.fromUtf8(utf8);
+    if (sjis.size() != 6000 + 4) {
+        std::cout << "✗ Expected 6004 bytes in SJIS, got " << sjis.size() << std::endl;
+        return false;
+    }
+    if (codec.toUtf8(sjis) != utf8) {
+        std::cout << "✗ Long text round trip failed" << std::endl;
+        return false;
+    }
+    std::cout << "✓ " << utf8.size() << " bytes converted without truncation" << std::endl;
+    return true;
+}
+
+bool testIconvRepeated() {
+    std::cout << "\n=== Test: iconv Repeated Conversions ===" << std::endl;
+
+    DRW_TextCodec codec;
+    codec.setVersion(DRW::AC1015, true);
+    codec.setCodePage("UTF-8", true);
+
+    //the descriptor and buffer are reused, the results must not mix
+    for (int i = 0; i < 1000; ++i) {
+        std::ostringstream ss;
+        ss << NIHONGO << " " << i;
+        std::string utf8 = ss.str();
+        std::string back = codec.toUtf8(codec.fromUtf8(utf8));
+        if (back != utf8) {
+            std::cout << "✗ Conversion " << i << " returned '" << back << "'" << std::endl;
+            return false;
+        }
+    }
+    if (!codec.fromUtf8(std::string()).empty()) {
+        std::cout << "✗ Empty string not converted to empty" << std::endl;
+        return false;
+    }
+    std::cout << "✓ 1000 conversions ok" << std::endl;
+    return true;
+}
+
+static bool checkBatch(DRW_TextCodec &codec, const std::vector<std::string> &utf8) {
+    std::vector<std::string> encoded = utf8;
+    codec.fromUtf8(encoded);
+    for (size_t i = 0; i < utf8.size(); ++i) {
+        if (encoded[i] != codec.fromUtf8(utf8[i]))
+            return false;
+    }
+    codec.toUtf8(encoded);
+    return encoded == utf8;
+}
+
+bool testBatchConversion() {
+    std::cout << "\n=== Test: Batch Conversion ===" << std::endl;
+
+    std::vector<std::string> strs;
+    for (int i = 0; i < 100; ++i) {
+        std::ostringstream ss;
+        ss << "layer " << i << (i % 3 == 0 ? " \xD0\xB4\xD0\xB0" : ""); //cyrillic "da"
+        strs.push_back(ss.str());
+    }
+    strs.push_back(std::string());
+
+    DRW_TextCodec table;
+    table.setVersion(DRW::AC1015, true);
+    table.setCodePage("ANSI_1251", true);
+    if (!checkBatch(table, strs)) {
+        std::cout << "✗ Table codec batch differs from single conversions" << std::endl;
+        return false;
+    }
+
+    for (size_t i = 0; i < strs.size(); i += 2)
+        strs[i] = NIHONGO + strs[i];
+    DRW_TextCodec ext;
+    ext.setVersion(DRW::AC1015, true);
+    ext.setCodePage("UTF-8", true);
+    if (!checkBatch(ext, strs)) {
+        std::cout << "✗ iconv codec batch differs from single conversions" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Batch of " << strs.size() << " strings converted" << std::endl;
+    return true;
+}
+
+static std::string utf8Char(int c) {
+    std::string r;
+    if (c < 0x800) {
+        r += (char)(0xC0 | (c >> 6));
+    } else {
+        r += (char)(0xE0 | (c >> 12));
+        r += (char)(0x80 | ((c >> 6) & 0x3F));
+    }
+    r += (char)(0x80 | (c & 0x3F));
+    return r;
+}
+
+//every code point of the table must encode to its first entry
+static bool checkDBCSTable(const char *cp, const int dt[][2], int len) {
+    DRW_TextCodec codec;
+    codec.setVersion(DRW::AC1015, true);
+    codec.setCodePage(cp, true);
+
+    std::map<int, int> first;
+    std::string utf8, expected;
+    for (int k = 0; k < len; ++k) {
+        if (dt[k][1] < 0x80)
+            continue;
+        first.insert(std::make_pair(dt[k][1], dt[k][0]));
+        int data = first[dt[k][1]];
+        utf8 += utf8Char(dt[k][1]);
+        expected += (char)(data >> 8);
+        expected += (char)(data & 0xFF);
+    }
+    std::string encoded = codec.fromUtf8(utf8);
+    if (encoded != expected) {
+        std::cout << "✗ " << cp << " encoding differs from table" << std::endl;
+        return false;
+    }
+    if (codec.fromUtf8("a\xE2\x98\x83" "b") != "a\\U+2603b") { //snowman, not in table
+        std::cout << "✗ " << cp << " missing code point not escaped" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool testDBCSEncoding() {
+    std::cout << "\n=== Test: DBCS Code Page Encoding ===" << std::endl;
+
+    if (!checkDBCSTable("ANSI_936", DRW_DoubleTable936, CPLENGHT936)
+            || !checkDBCSTable("ANSI_949", DRW_DoubleTable949, CPLENGHT949)
+            || !checkDBCSTable("ANSI_950", DRW_DoubleTable950, CPLENGHT950))
+        return false;
+
+    DRW_TextCodec codec;
+    codec.setVersion(DRW::AC1015, true);
+    codec.setCodePage("ANSI_932", true);
+    //"nihongo" and half width katakana "a"
+    std::string utf8 = std::string(NIHONGO) + " \xEF\xBD\xB1";
+    std::string sjis = codec.fromUtf8(utf8);
+    if (sjis != "\x93\xFA\x96\x7B\x8C\xEA \xB1" || codec.toUtf8(sjis) != utf8) {
+        std::cout << "✗ ANSI_932 encoding failed" << std::endl;
+        return false;
+    }
+    std::cout << "✓ ANSI_932, 936, 949 and 950 encode as their tables" << std::endl;
+    return true;
+}
+
+bool testAsciiFastPath() {
+    std::cout << "\n=== Test: ASCII Fast Path ===" << std::endl;
+
+    //every length and position around the 8 and 16 bytes blocks
+    for (size_t len = 0; len < 40; ++len) {
+        std::string plain(len, 'x');
+        if (!DRW_TextCodec::isPlainAscii(plain.data(), len, true)) {
+            std::cout << "✗ Plain text of " << len << " bytes not detected" << std::endl;
+            return false;
+        }
+        for (size_t pos = 0; pos < len; ++pos) {
+            std::string high = plain;
+            high[pos] = (char)0xC3;
+            std::string esc = plain;
+            esc[pos] = '\\';
+            bool escaped = pos + 6 < len;
+            if (escaped)
+                esc.replace(pos, 7, "\\U+00E9");
+            if (DRW_TextCodec::isPlainAscii(high.data(), len, false)
+                    || !DRW_TextCodec::isPlainAscii(esc.data(), len, false)
+                    || DRW_TextCodec::isPlainAscii(esc.data(), len, true) == escaped) {
+                std::cout << "✗ Bad detection at " << pos << " of " << len << std::endl;
+                return false;
+            }
+        }
+    }
+
+    const char *pages[] = {"ANSI_1251", "ANSI_932", "ANSI_936", "UTF-8"};
+    for (int i = 0; i < 4; ++i) {
+        DRW_TextCodec codec;
+        codec.setVersion(i < 3 ? DRW::AC1015 : DRW::AC1021, true);
+        codec.setCodePage(pages[i], true);
+        std::string text = "LAYER_0 path\\to 1.25";
+        std::string out = "> ";
+        codec.toUtf8(text, &out);
+        codec.fromUtf8(text, &out);
+        if (codec.toUtf8(text) != text || codec.fromUtf8(text) != text || out != "> " + text + text) {
+            std::cout << "✗ Plain text changed by " << pages[i] << std::endl;
+            return false;
+        }
+        //escapes still go to the converter
+        if (codec.toUtf8("caf\\U+00E9 ") != "caf\xC3\xA9 ") {
+            std::cout << "✗ Escape not decoded by " << pages[i] << std::endl;
+            return false;
+        }
+    }
+    std::cout << "✓ Plain ascii detected and kept" << std::endl;
+    return true;
+}
+
+//previous DRW_ConvUTF16::toUtf8, one char at a time
+static std::string referenceUtf16(const std::string &s) {
+    DRW_Converter conv(NULL, 0);
+    std::string res;
+    for (size_t i = 0; i + 1 < s.size(); i += 2) {
+        int ch = (unsigned char)s[i] | ((unsigned char)s[i + 1] << 8);
+        res += conv.encodeNum(ch);
+    }
+    return res;
+}
+
+static std::string utf16(const std::vector<int> &units) {
+    std::string r;
+    for (size_t i = 0; i < units.size(); ++i) {
+        r += (char)(units[i] & 0xFF);
+        r += (char)(units[i] >> 8);
+    }
+    return r;
+}
+
+static std::string toUtf8(const std::string &s) {
+    std::string res;
+    DRW_ConvUTF16::utf16ToUtf8(reinterpret_cast<const unsigned char*>(s.data()), s.size(), &res);
+    return res;
+}
+
+bool testUtf16Transcoding() {
+    std::cout << "\n=== Test: UTF-16 To UTF-8 Transcoding ===" << std::endl;
+
+    //every non surrogate char, alone and inside ascii runs crossing 8 char blocks
+    for (int c = 1; c < 0x10000; ++c) {
+        if (c >= 0xD800 && c <= 0xDFFF)
+            continue;
+        std::vector<int> units;
+        for (int k = 0; k < c % 19; ++k)
+            units.push_back('a' + k);
+        units.push_back(c);
+        for (int k = 0; k < 9; ++k)
+            units.push_back('0' + k);
+        std::string in = utf16(units);
+        if (toUtf8(in) != referenceUtf16(in)) {
+            std::cout << "✗ Char 0x" << std::hex << c << std::dec << " differs from previous converter" << std::endl;
+            return false;
+        }
+    }
+
+    //surrogate pair, U+1F600 and U+10FFFF
+    std::vector<int> pair;
+    pair.push_back('x'); pair.push_back(0xD83D); pair.push_back(0xDE00);
+    pair.push_back(0xDBFF); pair.push_back(0xDFFF);
+    if (toUtf8(utf16(pair)) != "x\xF0\x9F\x98\x80\xF4\x8F\xBF\xBF") {
+        std::cout << "✗ Surrogate pairs not joined" << std::endl;
+        return false;
+    }
+    //unpaired surrogates, NULL chars and odd length
+    std::vector<int> bad;
+    bad.push_back(0xD83D); bad.push_back('a'); bad.push_back(0xDE00);
+    bad.push_back(0); bad.push_back('b'); bad.push_back(0xD800);
+    std::string in = utf16(bad) + "c";
+    if (toUtf8(in) != "\xEF\xBF\xBD" "a" "\xEF\xBF\xBD" "b" "\xEF\xBF\xBD") {
+        std::cout << "✗ Invalid data not replaced" << std::endl;
+        return false;
+    }
+    //appends to the output
+    std::string out = "prefix ";
+    DRW_ConvUTF16::utf16ToUtf8(reinterpret_cast<const unsigned char*>("h\0i\0"), 4, &out);
+    if (out != "prefix hi") {
+        std::cout << "✗ Output not appended, got '" << out << "'" << std::endl;
+        return false;
+    }
+    std::cout << "✓ UTF-16 conversion matches previous converter" << std::endl;
+    return true;
+}
+
+bool testDwgBufferUtf16() {
+    std::cout << "\n=== Test: DWG Buffer UTF-16 Text ===" << std::endl;
+
+    DRW_TextCodec codec;
+    codec.setVersion(DRW::AC1021, false);
+    std::vector<int> units;
+    for (int i = 0; i < 300; ++i)
+        units.push_back(i % 5 == 0 ? 0x65E5 : 'A' + i % 26);
+    std::string text = utf16(units);
+    std::string expected = toUtf8(text);
+
+    //aligned, decoded from the buffer memory
+    std::vector<duint8> data(text.begin(), text.end());
+    dwgBuffer aligned(&data[0], data.size(), &codec);
+    if (aligned.getUCSStr(data.size()) != expected) {
+        std::cout << "✗ Aligned text differs" << std::endl;
+        return false;
+    }
+
+    //BS prefix "00" + 16 bits, the text is not byte aligned
+    std::vector<duint8> packed;
+    std::string raw = std::string() + (char)(units.size() & 0xFF) + (char)(units.size() >> 8) + text + std::string(2, '\0');
+    duint8 prev = 0; //2 zero bits
+    for (size_t i = 0; i < raw.size(); ++i) {
+        duint8 b = raw[i];
+        packed.push_back(prev | (b >> 2));
+        prev = b << 6;
+    }
+    packed.push_back(prev);
+    dwgBuffer unaligned(&packed[0], packed.size(), &codec);
+    if (unaligned.getUCSText(true) != expected) {
+        std::cout << "✗ Unaligned text differs" << std::endl;
+        return false;
+    }
+    std::cout << "✓ " << units.size() << " chars read aligned and unaligned" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "libdxfrw Text Codec Tests" << std::endl;
+    std::cout << "=========================" << std::endl;
+
+    int failedTests = 0;
+    int totalTests = 0;
+
+    totalTests++;
+    if (!testIconvLongText()) failedTests++;
+
+    totalTests++;
+    if (!testIconvRepeated()) failedTests++;
+
+    totalTests++;
+    if (!testBatchConversion()) failedTests++;
+
+    totalTests++;
+    if (!testDBCSEncoding()) failedTests++;
+
+    totalTests++;
+    if (!testUtf16Transcoding()) failedTests++;
+
+    totalTests++;
+    if (!testAsciiFastPath()) failedTests++;
+
+    totalTests++;
+    if (!testDwgBufferUtf16()) failedTests++;
+
+    std::cout << "\n=========================" << std::endl;
+    std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
+
+    if (failedTests > 0) {
+        std::cout << "✗ " << failedTests << " test(s) failed" << std::endl;
+        return 1;
+    } else {
+        std::cout << "✓ All text codec tests passed!" << std::endl;
+        return 0;
+    }
+}
@@ -0,0 +1,261 @@
+/******************************************************************************
+**  libDXFrw - Compressed I/O Tests                                         **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+// gzip tests are skipped when the library is built without zlib.
+
+#include "libdxfrw.h"
+#include "intern/drw_compress.h"
+#include "test_interface.h"
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+
+static const int LINES = 20000; //several compression blocks
+
+class QuietInterface : public TestInterface {
+public:
+    virtual void addHeader(const DRW_Header* data) {}
+    virtual void addLine(const DRW_Line& data) {
+        if (data.secPoint.x != lineCount)
+            badLines++;
+        lineCount++;
+    }
+    virtual void addCircle(const DRW_Circle& data) { circleCount++; }
+    QuietInterface() : badLines(0) {}
+    int badLines;
+};
+
+class LineWriter : public QuietInterface {
+public:
+    virtual void writeEntities() {
+        for (int i = 0; i < LINES; ++i) {
+            DRW_Line line;
+            line.basePoint.y = 1.0;
+            line.secPoint.x = i;
+            dxfWriter->writeLine(&line);
+        }
+        DRW_Circle circle;
+        circle.radious = 5.0;
+        dxfWriter->writeCircle(&circle);
+    }
+    dxfRW* dxfWriter;
+};
+
+static bool writeSample(const char* filename, DRW::Compression c) {
+    dxfRW dxf(filename);
+    if (!dxf.setCompression(c))
+        return false;
+    LineWriter writer;
+    writer.dxfWriter = &dxf;
+    return dxf.write(&writer, DRW::AC1015, false);
+}
+
+static std::string readAll(const char* filename) {
+    std::ifstream in(filename, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+//gives the data in small pieces, as a network source
+class ChunkSource : public DRW_InputSource {
+public:
+    ChunkSource(const std::string &d, size_t c) : data(d), pos(0), chunk(c) {}
+    virtual size_t read(char *buf, size_t n) {
+        size_t len = std::min(std::min(n, chunk), data.size() - pos);
+        data.copy(buf, len, pos);
+        pos += len;
+        return len;
+    }
+    std::string data;
+    size_t pos;
+    size_t chunk;
+};
+
+static bool checkReader(const QuietInterface &reader, const char *what) {
+    if (reader.lineCount != LINES || reader.badLines != 0 || reader.circleCount != 1) {
+        std::cout << "✗ " << what << ": " << reader.lineCount << " lines, "
+                  << reader.badLines << " wrong" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool testGzipRoundTrip() {
+    std::cout << "\n=== Test: Gzip Write And Read ===" << std::endl;
+    if (!DRW::compressionSupported(DRW::GZIP_COMPRESSION)) {
+        std::cout << "✓ Skipped, built without zlib" << std::endl;
+        return true;
+    }
+
+    const char* filename = "test_compress.dxf.gz";
+    if (!writeSample(filename, DRW::GZIP_COMPRESSION)) {
+        std::cout << "✗ Failed to write compressed file" << std::endl;
+        return false;
+    }
+    std::string content = readAll(filename);
+    QuietInterface reader;
+    dxfRW dxf(filename);
+    bool ok = dxf.read(&reader, false);
+    std::remove(filename);
+
+    if (content.size() < 2 || (unsigned char)content[0] != 0x1f || (unsigned char)content[1] != 0x8b) {
+        std::cout << "✗ Output is not gzip" << std::endl;
+        return false;
+    }
+    if (!ok || !checkReader(reader, "Read by name"))
+        return false;
+    const DRW_ReadStats &st = dxf.getStats();
+    if (st.bytesIn != content.size() || st.bytesOut < 5 * st.bytesIn) {
+        std::cout << "✗ Bad byte counts " << st.bytesIn << " -> " << st.bytesOut << std::endl;
+        return false;
+    }
+    std::cout << "✓ " << st.bytesOut << " bytes stored in " << st.bytesIn << std::endl;
+    return true;
+}
+
+bool testGzipSources() {
+    std::cout << "\n=== Test: Gzip From Memory, Stream And Source ===" << std::endl;
+    if (!DRW::compressionSupported(DRW::GZIP_COMPRESSION)) {
+        std::cout << "✓ Skipped, built without zlib" << std::endl;
+        return true;
+    }
+
+    const char* filename = "test_compress_src.dxf.gz";
+    if (!writeSample(filename, DRW::GZIP_COMPRESSION)) {
+        std::cout << "✗ Failed to write compressed file" << std::endl;
+        return false;
+    }
+    std::string content = readAll(filename);
+    std::remove(filename);
+
+    QuietInterface memReader;
+    dxfRW memDxf("memory");
+    if (!memDxf.read(content.data(), content.size(), &memReader, false)
+            || !checkReader(memReader, "Read from memory"))
+        return false;
+
+    std::istringstream in(content);
+    QuietInterface streamReader;
+    dxfRW streamDxf("stream");
+    if (!streamDxf.read(&in, &streamReader, false) || !checkReader(streamReader, "Read from stream"))
+        return false;
+
+    ChunkSource source(content, 13);
+    QuietInterface sourceReader;
+    dxfRW sourceDxf("source");
+    if (!sourceDxf.read(&source, &sourceReader, false) || !checkReader(sourceReader, "Read from source"))
+        return false;
+
+    std::cout << "✓ Compressed data read from memory, stream and source" << std::endl;
+    return true;
+}
+
+bool testGzipMembers() {
+    std::cout << "\n=== Test: Concatenated And Truncated Gzip ===" << std::endl;
+    if (!DRW::compressionSupported(DRW::GZIP_COMPRESSION)) {
+        std::cout << "✓ Skipped, built without zlib" << std::endl;
+        return true;
+    }
+
+    const char* filename = "test_compress_plain.dxf";
+    if (!writeSample(filename, DRW::NO_COMPRESSION)) {
+        std::cout << "✗ Failed to write plain file" << std::endl;
+        return false;
+    }
+    std::string plain = readAll(filename);
+    std::remove(filename);
+
+    //two gzip members, as written by "cat a.gz b.gz"
+    std::ostringstream packed;
+    size_t half = plain.size() / 2;
+    for (int i = 0; i < 2; ++i) {
+        DRW_CompressStreamBuf member(&packed, DRW::GZIP_COMPRESSION, 1);
+        std::ostream out(&member);
+        out << (i == 0 ? plain.substr(0, half) : plain.substr(half));
+        if (!member.finish()) {
+            std::cout << "✗ Failed to compress member " << i << std::endl;
+            return false;
+        }
+    }
+    std::string members = packed.str();
+    QuietInterface reader;
+    dxfRW dxf("members");
+    if (!dxf.read(members.data(), members.size(), &reader, false) || !checkReader(reader, "Two members"))
+        return false;
+
+    //cut in the middle of the second member
+    std::string truncated = members.substr(0, members.size() - 100);
+    QuietInterface truncReader;
+    dxfRW truncDxf("truncated");
+    if (truncDxf.read(truncated.data(), truncated.size(), &truncReader, false)) {
+        std::cout << "✗ Truncated data accepted" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Members joined, truncation detected after "
+              << truncReader.lineCount << " lines" << std::endl;
+    return true;
+}
+
+bool testUnsupportedCompression() {
+    std::cout << "\n=== Test: Unsupported Compression ===" << std::endl;
+
+    //zstd magic followed by garbage
+    std::string zstd("\x28\xb5\x2f\xfd" "garbage data", 16);
+    QuietInterface reader;
+    dxfRW dxf("zstd");
+    if (dxf.read(zstd.data(), zstd.size(), &reader, false)) {
+        std::cout << "✗ Invalid zstd data accepted" << std::endl;
+        return false;
+    }
+    dxfRW writer("unused.dxf");
+    bool zstdOk = writer.setCompression(DRW::ZSTD_COMPRESSION);
+    if (zstdOk != DRW::compressionSupported(DRW::ZSTD_COMPRESSION)) {
+        std::cout << "✗ setCompression disagrees with compressionSupported" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Invalid data rejected, zstd " << (zstdOk ? "supported" : "not supported") << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "libdxfrw Compressed I/O Tests" << std::endl;
+    std::cout << "=============================" << std::endl;
+
+    int failedTests = 0;
+    int totalTests = 0;
+
+    totalTests++;
+    if (!testGzipRoundTrip()) failedTests++;
+
+    totalTests++;
+    if (!testGzipSources()) failedTests++;
+
+    totalTests++;
+    if (!testGzipMembers()) failedTests++;
+
+    totalTests++;
+    if (!testUnsupportedCompression()) failedTests++;
+
+    std::cout << "\n=============================" << std::endl;
+    std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
+
+    if (failedTests > 0) {
+        std::cout << "✗ " << failedTests << " test(s) failed" << std::endl;
+        return 1;
+    } else {
+        std::cout << "✓ All compressed I/O tests passed!" << std::endl;
+        return 0;
+    }
+}
@@ -15,6 +15,9 @@
 #include <iostream>
 #include <cstdio>
 #include <cmath>
+#include <string>
+#include <vector>
+#include <map>
 
 // Helper to compare doubles
 bool doubleEquals(double a, double b, double epsilon = 0.0001) {
@@ -415,6 +418,160 @@ bool testMultipleEntities() {
     return true;
 }
 
+class XDataInterface : public TestInterface {
+public:
+    virtual void addLine(const DRW_Line& data) { lines.push_back(data); }
+    std::vector<DRW_Line> lines;
+};
+
+bool testSharedExtData() {
+    std::cout << "\n=== Test: Shared XDATA And Header Vars ===" << std::endl;
+
+    const std::string dxf =
+        "0\nSECTION\n2\nENTITIES\n"
+        "0\nLINE\n8\n0\n10\n0.0\n20\n0.0\n11\n1.0\n21\n1.0\n"
+        "1001\nGIS\n1000\nparcel 42\n1010\n5.0\n1020\n6.0\n1030\n7.0\n1040\n12.5\n1070\n3\n"
+        "0\nENDSEC\n0\nEOF\n";
+    XDataInterface reader;
+    dxfRW in("xdata");
+    if (!in.read(dxf.data(), dxf.size(), &reader, false) || reader.lines.size() != 1) {
+        std::cout << "✗ Failed to read the line" << std::endl;
+        return false;
+    }
+    const DRW_Line &line = reader.lines[0];
+    if (line.extData.size() != 5 || *line.extData[1]->content.s != "parcel 42"
+            || line.extData[2]->content.v->z != 7.0 || line.extData[4]->content.i != 3) {
+        std::cout << "✗ Wrong XDATA, " << line.extData.size() << " items" << std::endl;
+        return false;
+    }
+
+    //copies share the items until one changes
+    DRW_Line copy(line);
+    const DRW_ExtData &copyData = copy.extData; //non-const access makes a private copy
+    if (!copyData.shared() || copyData[0] != line.extData[0]) {
+        std::cout << "✗ XDATA copied" << std::endl;
+        return false;
+    }
+    copy.extData.push_back(new DRW_Variant(1000, std::string("added")));
+    if (copy.extData.size() != 6 || line.extData.size() != 5 || copy.extData.shared()
+            || copy.extData[1] == line.extData[1] || *copy.extData[1]->content.s != "parcel 42") {
+        std::cout << "✗ Change of a copy not isolated" << std::endl;
+        return false;
+    }
+    DRW_Line edited(line);
+    edited.extData.at(2)->setCoordZ(8.0);
+    if (line.extData[2]->content.v->z != 7.0 || edited.extData.shared()) {
+        std::cout << "✗ Change of a copied item seen by the original" << std::endl;
+        return false;
+    }
+    DRW_Line assigned;
+    assigned = line;
+    assigned.reset();
+    if (!assigned.extData.empty() || line.extData.size() != 5) {
+        std::cout << "✗ Reset of a copy changed the original" << std::endl;
+        return false;
+    }
+
+    DRW_Header header;
+    header.addDouble("$TEXTSIZE", 2.5, 40);
+    header.addStr("$PROJECTNAME", "survey", 1);
+    DRW_Header other(header);
+    bool sharedCopy = other.vars.shared();
+    other.addDouble("$TEXTSIZE", 5.0, 40);
+    const DRW_HeaderVars &vars = header.vars;
+    DRW_HeaderVars::const_iterator it = vars.find("$TEXTSIZE");
+    if (!sharedCopy || it == vars.end() || it->second->content.d != 2.5
+            || other.vars.size() != 2 || other.vars["$TEXTSIZE"]->content.d != 5.0) {
+        std::cout << "✗ Header vars not shared or change not isolated" << std::endl;
+        return false;
+    }
+    std::cout << "✓ XDATA and header vars shared by copies, changes isolated" << std::endl;
+    return true;
+}
+
+class BoundsInterface : public TestInterface {
+public:
+    virtual void addLWPolyline(const DRW_LWPolyline& data) { boxes["LWPOLYLINE"] = data.bbox; }
+    virtual void addCircle(const DRW_Circle& data) { boxes["CIRCLE"] = data.bbox; }
+    virtual void addText(const DRW_Text& data) { boxes["TEXT"] = data.bbox; }
+    virtual void addRay(const DRW_Ray& data) { boxes["RAY"] = data.bbox; }
+    virtual void addInsert(const DRW_Insert& data) {
+        if (data.name == "INNER") boxes["INSERT"] = data.bbox;
+        else if (data.name == "OUTER") boxes["NESTED"] = data.bbox;
+    }
+    std::map<std::string, DRW_BBox> boxes;
+};
+
+bool boxEquals(const DRW_BBox &b, double x0, double y0, double x1, double y1) {
+    return b.isValid() && doubleEquals(b.minPoint.x, x0) && doubleEquals(b.minPoint.y, y0)
+        && doubleEquals(b.maxPoint.x, x1) && doubleEquals(b.maxPoint.y, y1);
+}
+
+bool testExtents() {
+    std::cout << "\n=== Test: Extents Computed While Reading ===" << std::endl;
+
+    //OUTER inserts INNER before it is defined, it is solved after the read
+    const std::string dxf =
+        "0\nSECTION\n2\nBLOCKS\n"
+        "0\nBLOCK\n8\n0\n2\nOUTER\n70\n0\n10\n0.0\n20\n0.0\n30\n0.0\n"
+        "0\nINSERT\n8\n0\n2\nINNER\n10\n10.0\n20\n0.0\n30\n0.0\n"
+        "0\nENDBLK\n8\n0\n"
+        "0\nBLOCK\n8\n0\n2\nINNER\n70\n0\n10\n1.0\n20\n1.0\n30\n0.0\n"
+        "0\nLINE\n8\n0\n10\n1.0\n20\n1.0\n30\n0.0\n11\n3.0\n21\n2.0\n31\n0.0\n"
+        "0\nENDBLK\n8\n0\n"
+        "0\nENDSEC\n"
+        "0\nSECTION\n2\nENTITIES\n"
+        //semicircle below the chord
+        "0\nLWPOLYLINE\n8\nL1\n90\n2\n70\n0\n10\n0.0\n20\n0.0\n42\n1.0\n10\n2.0\n20\n0.0\n"
+        "0\nARC\n8\nL2\n10\n10.0\n20\n10.0\n30\n0.0\n40\n2.0\n50\n0.0\n51\n90.0\n"
+        //mirrored OCS, the center is at x = 5 in WCS
+        "0\nCIRCLE\n8\nL2\n10\n-5.0\n20\n0.0\n30\n0.0\n40\n1.0\n210\n0.0\n220\n0.0\n230\n-1.0\n"
+        "0\nELLIPSE\n8\nE\n10\n50.0\n20\n-10.0\n30\n0.0\n11\n2.0\n21\n0.0\n31\n0.0\n40\n0.5\n41\n0.0\n42\n6.283185307179586\n"
+        "0\nINSERT\n8\n0\n2\nINNER\n10\n20.0\n20\n0.0\n30\n0.0\n41\n2.0\n42\n2.0\n43\n2.0\n50\n90.0\n"
+        "0\nINSERT\n8\n0\n2\nOUTER\n10\n0.0\n20\n30.0\n30\n0.0\n"
+        "0\nRAY\n8\n0\n10\n0.0\n20\n0.0\n30\n0.0\n11\n1.0\n21\n0.0\n31\n0.0\n"
+        "0\nLINE\n8\n0\n67\n1\n10\n0.0\n20\n0.0\n30\n0.0\n11\n100.0\n21\n50.0\n31\n0.0\n"
+        "0\nTEXT\n8\n0\n67\n1\n10\n10.0\n20\n10.0\n30\n0.0\n40\n1.0\n1\nABCD\n"
+        "0\nENDSEC\n0\nEOF\n";
+    BoundsInterface reader;
+    dxfRW in("extents");
+    in.setExtents(true);
+    if (!in.read(dxf.data(), dxf.size(), &reader, false)) {
+        std::cout << "✗ Failed to read" << std::endl;
+        return false;
+    }
+    const DRW_Extents &ext = in.getExtents();
+    std::map<std::string, DRW_BBox> &boxes = reader.boxes;
+    if (!boxEquals(boxes["LWPOLYLINE"], 0, -1, 2, 0) || !boxEquals(boxes["CIRCLE"], 4, -1, 6, 1)
+            || !boxEquals(boxes["INSERT"], 18, 0, 20, 4) || boxes["NESTED"].isValid()
+            || boxes["RAY"].isValid()) {
+        std::cout << "✗ Wrong entity bounds" << std::endl;
+        return false;
+    }
+    const DRW_BBox &text = boxes["TEXT"];
+    if (!text.isValid() || !doubleEquals(text.minPoint.x, 10) || !doubleEquals(text.minPoint.y, 10)
+            || text.maxPoint.x - text.minPoint.x < 2.0 || text.maxPoint.x - text.minPoint.x > 6.0) {
+        std::cout << "✗ Wrong text estimate" << std::endl;
+        return false;
+    }
+    if (!boxEquals(ext.blocks.at("INNER"), 1, 1, 3, 2) || !boxEquals(ext.blocks.at("OUTER"), 10, 0, 12, 1)) {
+        std::cout << "✗ Wrong block bounds" << std::endl;
+        return false;
+    }
+    if (!boxEquals(ext.model, 0, -11, 52, 31) || !boxEquals(ext.paper, 0, 0, 100, 50)) {
+        std::cout << "✗ Wrong space bounds" << std::endl;
+        return false;
+    }
+    if (ext.layers.size() != 4 || !boxEquals(ext.layers.at("L2"), 4, -1, 12, 12)
+            || !boxEquals(ext.layers.at("E"), 48, -11, 52, -9)
+            || !boxEquals(ext.layers.at("0"), 0, 0, 100, 50)) {
+        std::cout << "✗ Wrong layer bounds" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Entity, block, layer and space bounds" << std::endl;
+    return true;
+}
+
 int main(int argc, char* argv[]) {
     std::cout << "libdxfrw Entity Tests" << std::endl;
     std::cout << "=====================" << std::endl;
@@ -440,6 +597,12 @@ int main(int argc, char* argv[]) {
     totalTests++;
     if (!testMultipleEntities()) failedTests++;
 
+    totalTests++;
+    if (!testSharedExtData()) failedTests++;
+
+    totalTests++;
+    if (!testExtents()) failedTests++;
+
     std::cout << "\n=====================" << std::endl;
     std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
 
@@ -0,0 +1,231 @@
+/******************************************************************************
+**  libDXFrw - Fingerprint Tests                                            **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "libdxfrw.h"
+#include "drw_fingerprint.h"
+#include "test_interface.h"
+#include <iostream>
+#include <sstream>
+
+static DRW_Line makeLine(double x1, double y1, double x2, double y2) {
+    DRW_Line line;
+    line.basePoint = DRW_Coord(x1, y1, 0);
+    line.secPoint = DRW_Coord(x2, y2, 0);
+    return line;
+}
+
+bool testLineHashes() {
+    std::cout << "\n=== Test: Line Hashes ===" << std::endl;
+
+    DRW_Fingerprints fp;
+    DRW_Line a = makeLine(1, 2, 3, 4);
+    duint64 exactA, exactB;
+    duint64 ha = fp.hash(a, &exactA);
+    // the same hash in every read and platform
+    if (ha != 0xd4a54bc2ac7a7836ULL) {
+        std::cout << "✗ Hash changed: " << std::hex << ha << std::dec << std::endl;
+        return false;
+    }
+    DRW_Line reversed = makeLine(3, 4, 1, 2);
+    DRW_Line near = makeLine(1 + 1e-9, 2, 3, 4 - 1e-9);
+    duint64 hb = fp.hash(near, &exactB);
+    if (fp.hash(reversed) != ha || hb != ha || exactB == exactA) {
+        std::cout << "✗ Reversed or near line differs" << std::endl;
+        return false;
+    }
+    DRW_Line moved = makeLine(1.001, 2, 3, 4);
+    DRW_Line layered = a;
+    layered.layer = "walls";
+    if (fp.hash(moved) == ha || fp.hash(layered) == ha) {
+        std::cout << "✗ Moved line or other layer not told apart" << std::endl;
+        return false;
+    }
+    fp.setProperties(false);
+    if (fp.hash(layered) != fp.hash(a)) {
+        std::cout << "✗ Layer hashed without the properties" << std::endl;
+        return false;
+    }
+    fp.setQuantum(0);
+    if (fp.hash(near) == fp.hash(a)) {
+        std::cout << "✗ Near line equal without rounding" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Line hashes test passed" << std::endl;
+    return true;
+}
+
+bool testEntityTypes() {
+    std::cout << "\n=== Test: Entity Types ===" << std::endl;
+
+    DRW_Fingerprints fp;
+    DRW_Circle circle;
+    circle.radious = 5;
+    DRW_Arc arc;
+    arc.radious = 5;
+    arc.staangle = 0;
+    arc.endangle = 2 * M_PI;
+    if (fp.hash(circle) == 0 || fp.hash(circle) == fp.hash(arc)) {
+        std::cout << "✗ Circle and arc not told apart" << std::endl;
+        return false;
+    }
+
+    DRW_LWPolyline pl;
+    pl.addVertex(DRW_Vertex2D(0, 0, 0));
+    pl.addVertex(DRW_Vertex2D(10, 0, 0.5));
+    pl.addVertex(DRW_Vertex2D(10, 10, 0));
+    DRW_LWPolyline copy(pl);
+    duint64 h = fp.hash(pl);
+    bool ok = fp.hash(copy) == h;
+    copy.vertlist[1]->bulge = 0.25;
+    ok = ok && fp.hash(copy) != h;
+    for (size_t i = 0; i < 3; i++) {
+        delete pl.vertlist[i];
+        delete copy.vertlist[i];
+    }
+    pl.vertlist.clear();
+    copy.vertlist.clear();
+    if (!ok) {
+        std::cout << "✗ Polyline vertices not hashed" << std::endl;
+        return false;
+    }
+
+    DRW_Text text;
+    text.text = "A";
+    DRW_Text other(text);
+    other.text = "B";
+    DRW_Leader leader;
+    if (fp.hash(text) == fp.hash(other) || fp.hash(leader) != 0) {
+        std::cout << "✗ Text content or leader fingerprint wrong" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Entity types test passed" << std::endl;
+    return true;
+}
+
+class FingerprintReader : public TestInterface {
+public:
+    virtual void addLine(const DRW_Line& data) {
+        lineCount++;
+        handles.push_back(data.handle);
+        fingerprints.push_back(data.fingerprint);
+    }
+    virtual void addCircle(const DRW_Circle& data) {
+        circleCount++;
+        handles.push_back(data.handle);
+        fingerprints.push_back(data.fingerprint);
+    }
+    std::vector<duint32> handles;
+    std::vector<duint64> fingerprints;
+};
+
+static std::string lineDxf(int handle, double x1, double y1, double x2, double y2,
+                           const char *layer = "0", int space = 0) {
+    std::ostringstream s;
+    s.precision(17);
+    s << "0\nLINE\n5\n" << std::hex << std::uppercase << handle << std::dec << "\n8\n" << layer << "\n";
+    if (space)
+        s << "67\n1\n";
+    s << "10\n" << x1 << "\n20\n" << y1 << "\n30\n0\n11\n" << x2 << "\n21\n" << y2 << "\n31\n0\n";
+    return s.str();
+}
+
+bool testDuplicatesWhileReading() {
+    std::cout << "\n=== Test: Duplicates While Reading ===" << std::endl;
+
+    std::string dxf = "0\nSECTION\n2\nBLOCKS\n0\nBLOCK\n8\n0\n2\nB\n70\n0\n10\n0\n20\n0\n30\n0\n";
+    // the block has its own copy of the first line
+    dxf += lineDxf(0x10, 1, 2, 3, 4);
+    dxf += "0\nENDBLK\n8\n0\n0\nENDSEC\n0\nSECTION\n2\nENTITIES\n";
+    dxf += lineDxf(0x20, 1, 2, 3, 4);
+    dxf += lineDxf(0x21, 1, 2, 3, 4);           // exact
+    dxf += lineDxf(0x22, 3, 4, 1, 2);           // reversed
+    dxf += lineDxf(0x23, 1 + 1e-9, 2, 3, 4);    // near
+    dxf += lineDxf(0x24, 1, 2, 3, 4, "walls");  // other layer
+    dxf += lineDxf(0x25, 1, 2, 3, 4, "0", 1);   // paper space
+    dxf += "0\nCIRCLE\n5\n30\n8\n0\n10\n0\n20\n0\n30\n0\n40\n5\n";
+    dxf += "0\nCIRCLE\n5\n31\n8\n0\n10\n0\n20\n0\n30\n0\n40\n5\n";
+    dxf += "0\nENDSEC\n0\nEOF\n";
+
+    DRW_Fingerprints settings;
+    settings.setMode(DRW_Fingerprints::REPORT);
+    FingerprintReader reported;
+    dxfRW in("report");
+    in.setFingerprints(settings);
+    if (!in.read(dxf.data(), dxf.size(), &reported, false) || reported.handles.size() != 9) {
+        std::cout << "✗ Expected 9 entities reported, got " << reported.handles.size() << std::endl;
+        return false;
+    }
+    const DRW_Fingerprints &res = in.getFingerprints();
+    const duint32 dups[] = {0x21, 0x22, 0x23, 0x31};
+    const bool exact[] = {true, true, false, true};
+    bool ok = res.duplicates.size() == 4 && res.hashed == 9 && res.dropped == 0;
+    for (size_t i = 0; ok && i < 4; i++) {
+        ok = res.duplicates[i].handle == dups[i] && res.duplicates[i].exact == exact[i]
+                && res.duplicates[i].original == (i < 3 ? 0x20u : 0x30u);
+    }
+    if (!ok) {
+        std::cout << "✗ Wrong duplicates, " << res.duplicates.size() << " found" << std::endl;
+        return false;
+    }
+    if (reported.fingerprints[0] != reported.fingerprints[1] || reported.fingerprints[1] != reported.fingerprints[2]
+            || reported.fingerprints[0] == 0) {
+        std::cout << "✗ Fingerprints not set on the entities" << std::endl;
+        return false;
+    }
+
+    settings.setMode(DRW_Fingerprints::DROP);
+    FingerprintReader dropped;
+    dxfRW in2("drop");
+    in2.setFingerprints(settings);
+    in2.setExtents(true);
+    if (!in2.read(dxf.data(), dxf.size(), &dropped, false) || dropped.handles.size() != 5
+            || in2.getFingerprints().dropped != 4 || dropped.circleCount != 1) {
+        std::cout << "✗ Expected 5 entities kept, got " << dropped.handles.size() << std::endl;
+        return false;
+    }
+    // read again, the results start over
+    if (!in2.read(dxf.data(), dxf.size(), &dropped, false) || in2.getFingerprints().dropped != 4
+            || in2.getFingerprints().duplicates.size() != 4) {
+        std::cout << "✗ Results of the previous read kept" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Duplicates while reading test passed" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "libdxfrw Fingerprint Tests" << std::endl;
+    std::cout << "==========================" << std::endl;
+
+    int failedTests = 0;
+    int totalTests = 0;
+
+    totalTests++;
+    if (!testLineHashes()) failedTests++;
+
+    totalTests++;
+    if (!testEntityTypes()) failedTests++;
+
+    totalTests++;
+    if (!testDuplicatesWhileReading()) failedTests++;
+
+    std::cout << "\n==========================" << std::endl;
+    std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
+
+    if (failedTests > 0) {
+        std::cout << "✗ " << failedTests << " test(s) failed" << std::endl;
+        return 1;
+    } else {
+        std::cout << "✓ All fingerprint tests passed!" << std::endl;
+        return 0;
+    }
+}
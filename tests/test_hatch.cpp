@@ -0,0 +1,354 @@
+/******************************************************************************
+**  libDXFrw - Hatch Fill Tests                                             **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "libdxfrw.h"
+#include "drw_hatchfill.h"
+#include "test_interface.h"
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// A 10x10 square with a 2x2 island, dashes of 1 every 2 on horizontal lines
+static const char *squareHatch =
+    "0\nHATCH\n8\n0\n10\n0\n20\n0\n30\n0\n210\n0\n220\n0\n230\n1\n2\nUSER\n70\n0\n71\n0\n91\n2\n"
+    "92\n3\n72\n0\n73\n1\n93\n4\n10\n0\n20\n0\n10\n10\n20\n0\n10\n10\n20\n10\n10\n0\n20\n10\n97\n0\n"
+    "92\n16\n93\n4\n"
+    "72\n1\n10\n4\n20\n4\n11\n6\n21\n4\n"
+    "72\n1\n10\n6\n20\n4\n11\n6\n21\n6\n"
+    "72\n1\n10\n4\n20\n6\n11\n6\n21\n6\n"   // written backwards
+    "72\n1\n10\n4\n20\n6\n11\n4\n21\n4\n97\n0\n"
+    "75\n0\n76\n0\n52\n0\n41\n1\n77\n0\n78\n1\n"
+    "53\n0\n43\n0\n44\n0.5\n45\n0\n46\n1\n79\n2\n49\n1\n49\n-1\n98\n0\n";
+
+// A circle of radius 5 by two arcs, counterclockwise or not, lines at 45 degrees
+static std::string circleHatch(int ccw) {
+    std::string c = ccw ? "1" : "0";
+    return "0\nHATCH\n8\n0\n10\n0\n20\n0\n30\n2\n210\n0\n220\n0\n230\n1\n2\nUSER\n70\n0\n71\n0\n91\n1\n"
+           "92\n1\n93\n2\n"
+           "72\n2\n10\n0\n20\n0\n40\n5\n50\n0\n51\n180\n73\n" + c + "\n"
+           "72\n2\n10\n0\n20\n0\n40\n5\n50\n180\n51\n360\n73\n" + c + "\n97\n0\n"
+           "75\n0\n76\n0\n52\n45\n41\n1\n77\n0\n78\n1\n"
+           "53\n45\n43\n0\n44\n0\n45\n-0.5\n46\n0.5\n79\n0\n98\n0\n";
+}
+
+class HatchReader : public TestInterface {
+public:
+    ~HatchReader() {
+        for (size_t i = 0; i < hatches.size(); i++) {
+            for (size_t j = 0; j < hatches[i]->looplist.size(); j++) {
+                DRW_HatchLoop *loop = hatches[i]->looplist[j];
+                for (size_t k = 0; k < loop->objlist.size(); k++)
+                    delete loop->objlist[k];
+                loop->objlist.clear();
+                delete loop;
+            }
+            hatches[i]->looplist.clear();
+            delete hatches[i];
+        }
+    }
+    virtual void takeHatch(DRW_Hatch&& data) {
+        hatchCount++;
+        hatches.push_back(new DRW_Hatch(std::move(data)));
+    }
+    std::vector<DRW_Hatch *> hatches;
+};
+
+static bool readHatches(const std::string &entities, HatchReader *reader) {
+    std::string dxf = "0\nSECTION\n2\nENTITIES\n" + entities + "0\nENDSEC\n0\nEOF\n";
+    dxfRW in("hatch");
+    return in.read(dxf.data(), dxf.size(), reader, false);
+}
+
+static double signedArea(const std::vector<DRW_Coord> &pts) {
+    double a = 0;
+    for (size_t i = 0; i < pts.size(); i++) {
+        const DRW_Coord &p = pts[i], &q = pts[(i + 1) % pts.size()];
+        a += p.x * q.y - q.x * p.y;
+    }
+    return a / 2;
+}
+
+bool testPatternParsing() {
+    std::cout << "\n=== Test: Pattern Parsing ===" << std::endl;
+
+    HatchReader reader;
+    if (!readHatches(squareHatch, &reader) || reader.hatches.size() != 1) {
+        std::cout << "✗ Failed to read the hatch" << std::endl;
+        return false;
+    }
+    const DRW_Hatch *h = reader.hatches[0];
+    if (h->patternlines.size() != 1) {
+        std::cout << "✗ Expected 1 pattern line, got " << h->patternlines.size() << std::endl;
+        return false;
+    }
+    const DRW_HatchPatternLine &l = h->patternlines[0];
+    if (l.angle != 0 || l.base.y != 0.5 || l.offset.y != 1 || l.dashes.size() != 2 || l.dashes[1] != -1) {
+        std::cout << "✗ Pattern line data lost" << std::endl;
+        return false;
+    }
+    if (h->looplist.size() != 2 || h->looplist[1]->objlist.size() != 4) {
+        std::cout << "✗ Expected 2 loops" << std::endl;
+        return false;
+    }
+    // dash counts of malformed files are not trusted
+    std::string bad = squareHatch;
+    bad.replace(bad.find("79\n2\n"), 5, "79\n-1\n");
+    std::string huge = squareHatch;
+    huge.replace(huge.find("79\n2\n"), 5, "79\n2000000000\n");
+    HatchReader badReader, hugeReader;
+    if (!readHatches(bad, &badReader) || !readHatches(huge, &hugeReader)
+            || badReader.hatches[0]->patternlines[0].dashes.size() != 2
+            || hugeReader.hatches[0]->patternlines[0].dashes.size() != 2) {
+        std::cout << "✗ Wrong dash count not ignored" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Pattern parsing test passed" << std::endl;
+    return true;
+}
+
+bool testIslandFill() {
+    std::cout << "\n=== Test: Island Fill ===" << std::endl;
+
+    HatchReader reader;
+    if (!readHatches(squareHatch, &reader) || reader.hatches.size() != 1) {
+        std::cout << "✗ Failed to read the hatch" << std::endl;
+        return false;
+    }
+    DRW_HatchFill filler;
+    DRW_HatchGeometry g;
+    if (!filler.fill(*reader.hatches[0], &g) || g.loops.size() != 2 || g.truncated) {
+        std::cout << "✗ Fill failed" << std::endl;
+        return false;
+    }
+    if (g.loops[0].size() != 4 || g.loops[1].size() != 4) {
+        std::cout << "✗ Loops should be squares, got " << g.loops[0].size() << " and "
+                  << g.loops[1].size() << " points" << std::endl;
+        return false;
+    }
+    // 8 lines with 5 dashes, the 2 lines across the island with 4
+    size_t count = g.segments.size() / 2;
+    double length = 0;
+    for (size_t i = 0; i < g.segments.size(); i += 2) {
+        const DRW_Coord &a = g.segments[i], &b = g.segments[i + 1];
+        length += b.x - a.x;
+        if (a.y != b.y || (a.x > 4 && a.x < 6 && a.y > 4 && a.y < 6)) {
+            std::cout << "✗ Dash at (" << a.x << ", " << a.y << ") inside the island" << std::endl;
+            return false;
+        }
+    }
+    if (count != 48 || fabs(length - 48) > 1e-9) {
+        std::cout << "✗ Expected 48 dashes, got " << count << " of length " << length << std::endl;
+        return false;
+    }
+
+    // Ignore style: only the external loop
+    DRW_Hatch ignore(*reader.hatches[0]);
+    ignore.hstyle = 2;
+    filler.fill(ignore, &g);
+    if (g.loops.size() != 1 || g.segments.size() / 2 != 50) {
+        std::cout << "✗ Ignore style should fill over the island, got " << g.segments.size() / 2 << std::endl;
+        return false;
+    }
+
+    // Truncated at the maximum
+    filler.setMaxSegments(10);
+    filler.fill(*reader.hatches[0], &g);
+    if (!g.truncated || g.segments.size() / 2 != 10) {
+        std::cout << "✗ Fill should stop at 10 dashes" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Island fill test passed" << std::endl;
+    return true;
+}
+
+bool testArcBoundaries() {
+    std::cout << "\n=== Test: Arc Boundaries ===" << std::endl;
+
+    HatchReader reader;
+    if (!readHatches(circleHatch(1) + circleHatch(0), &reader) || reader.hatches.size() != 2) {
+        std::cout << "✗ Failed to read the hatches" << std::endl;
+        return false;
+    }
+    DRW_Tessellator tess;
+    tess.setTolerance(0.01);
+    DRW_HatchFill filler;
+    filler.setTessellator(tess);
+    for (int i = 0; i < 2; i++) {
+        DRW_HatchGeometry g;
+        filler.fill(*reader.hatches[i], &g);
+        if (g.loops.size() != 1 || g.loops[0].size() < 16) {
+            std::cout << "✗ Circle " << i << " not resolved" << std::endl;
+            return false;
+        }
+        const std::vector<DRW_Coord> &pts = g.loops[0];
+        for (size_t j = 0; j < pts.size(); j++) {
+            if (fabs(sqrt(pts[j].x*pts[j].x + pts[j].y*pts[j].y) - 5) > 1e-9 || pts[j].z != 2) {
+                std::cout << "✗ Boundary point off the circle" << std::endl;
+                return false;
+            }
+        }
+        double area = signedArea(pts);
+        if ((i == 0) != (area > 0) || fabs(fabs(area) - M_PI * 25) > 0.5) {
+            std::cout << "✗ Circle " << i << " has area " << area << std::endl;
+            return false;
+        }
+        // lines at 45 degrees every 0.5*sqrt(2)
+        if (g.segments.size() / 2 < 12) {
+            std::cout << "✗ Expected pattern lines, got " << g.segments.size() / 2 << std::endl;
+            return false;
+        }
+        for (size_t j = 0; j < g.segments.size(); j += 2) {
+            const DRW_Coord &a = g.segments[j], &b = g.segments[j + 1];
+            double ra = sqrt(a.x*a.x + a.y*a.y), rb = sqrt(b.x*b.x + b.y*b.y);
+            if (ra > 5 + 1e-9 || rb > 5 + 1e-9 || ra < 5 - 0.01 - 1e-9 || rb < 5 - 0.01 - 1e-9
+                    || fabs((b.y - a.y) - (b.x - a.x)) > 1e-9) {
+                std::cout << "✗ Line ends not on the boundary" << std::endl;
+                return false;
+            }
+        }
+    }
+    std::cout << "✓ Arc boundaries test passed" << std::endl;
+    return true;
+}
+
+bool testParallelFill() {
+    std::cout << "\n=== Test: Parallel Fill ===" << std::endl;
+
+    std::string entities;
+    for (int i = 0; i < 100; i++)
+        entities += std::string(squareHatch) + circleHatch(i % 2);
+    HatchReader reader;
+    if (!readHatches(entities, &reader) || reader.hatches.size() != 200) {
+        std::cout << "✗ Failed to read the hatches" << std::endl;
+        return false;
+    }
+    std::vector<const DRW_Hatch *> list(reader.hatches.begin(), reader.hatches.end());
+    DRW_HatchFill filler;
+    std::vector<DRW_HatchGeometry> serial, parallel;
+    filler.setThreads(1);
+    filler.fill(list, &serial);
+    filler.setThreads(4);
+    filler.fill(list, &parallel);
+    if (serial.size() != 200 || parallel.size() != 200) {
+        std::cout << "✗ Expected 200 results" << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < serial.size(); i++) {
+        const std::vector<DRW_Coord> &a = serial[i].segments, &b = parallel[i].segments;
+        bool same = a.size() == b.size() && !a.empty();
+        for (size_t j = 0; same && j < a.size(); j++)
+            same = a[j].x == b[j].x && a[j].y == b[j].y;
+        if (!same) {
+            std::cout << "✗ Hatch " << i << " differs between 1 and 4 threads" << std::endl;
+            return false;
+        }
+    }
+    std::cout << "✓ Parallel fill test passed" << std::endl;
+    return true;
+}
+
+bool testPatternRoundTrip() {
+    std::cout << "\n=== Test: Pattern Round Trip ===" << std::endl;
+
+    const char* filename = "test_hatch.dxf";
+    {
+        dxfRW dxf(filename);
+        class HatchWriter : public TestInterface {
+        public:
+            virtual void writeEntities() {
+                DRW_Hatch hatch;
+                hatch.name = "USER";
+                hatch.solid = 0;
+                hatch.scale = 1;
+                DRW_HatchLoop *loop = new DRW_HatchLoop(1);
+                double corners[] = {0, 0, 10, 0, 10, 10, 0, 10};
+                for (int i = 0; i < 4; i++) {
+                    DRW_Line *l = new DRW_Line();
+                    l->basePoint = DRW_Coord(corners[2*i], corners[2*i + 1], 0);
+                    l->secPoint = DRW_Coord(corners[(2*i + 2) % 8], corners[(2*i + 3) % 8], 0);
+                    loop->objlist.push_back(l);
+                }
+                hatch.appendLoop(loop);
+                DRW_HatchPatternLine line;
+                line.angle = 45;
+                line.offset = DRW_Coord(-0.5, 0.5, 0);
+                line.dashes.push_back(0.75);
+                line.dashes.push_back(-0.25);
+                hatch.patternlines.push_back(line);
+                dxfWriter->writeHatch(&hatch);
+                for (size_t i = 0; i < loop->objlist.size(); i++)
+                    delete loop->objlist[i];
+                loop->objlist.clear();
+                delete loop;
+                hatch.looplist.clear();
+            }
+            dxfRW* dxfWriter;
+        };
+        HatchWriter writer;
+        writer.dxfWriter = &dxf;
+        if (!dxf.write(&writer, DRW::AC1015, false)) {
+            std::cout << "✗ Failed to write hatch" << std::endl;
+            return false;
+        }
+    }
+    HatchReader reader;
+    dxfRW dxf(filename);
+    bool ok = dxf.read(&reader, false);
+    std::remove(filename);
+    if (!ok || reader.hatches.size() != 1 || reader.hatches[0]->patternlines.size() != 1) {
+        std::cout << "✗ Pattern not read back" << std::endl;
+        return false;
+    }
+    const DRW_HatchPatternLine &l = reader.hatches[0]->patternlines[0];
+    if (l.angle != 45 || l.offset.x != -0.5 || l.dashes.size() != 2 || l.dashes[0] != 0.75) {
+        std::cout << "✗ Pattern line changed" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Pattern round trip test passed" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "libdxfrw Hatch Fill Tests" << std::endl;
+    std::cout << "=========================" << std::endl;
+
+    int failedTests = 0;
+    int totalTests = 0;
+
+    totalTests++;
+    if (!testPatternParsing()) failedTests++;
+
+    totalTests++;
+    if (!testIslandFill()) failedTests++;
+
+    totalTests++;
+    if (!testArcBoundaries()) failedTests++;
+
+    totalTests++;
+    if (!testParallelFill()) failedTests++;
+
+    totalTests++;
+    if (!testPatternRoundTrip()) failedTests++;
+
+    std::cout << "\n=========================" << std::endl;
+    std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
+
+    if (failedTests > 0) {
+        std::cout << "✗ " << failedTests << " test(s) failed" << std::endl;
+        return 1;
+    } else {
+        std::cout << "✓ All hatch fill tests passed!" << std::endl;
+        return 0;
+    }
+}
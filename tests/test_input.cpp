@@ -0,0 +1,524 @@
+/******************************************************************************
+**  libDXFrw - Input Tests                                                  **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "libdxfrw.h"
+#include "libdwgr.h"
+#include "intern/drw_input.h"
+#include "test_interface.h"
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <algorithm>
+#include <vector>
+#include <fcntl.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static bool writeSample(const char* filename) {
+    dxfRW dxf(filename);
+    class SampleWriter : public TestInterface {
+    public:
+        virtual void writeEntities() {
+            for (int i = 0; i < 20; ++i) {
+                DRW_Line line;
+                line.secPoint.x = i;
+                dxfWriter->writeLine(&line);
+            }
+            DRW_Circle circle;
+            circle.radious = 5.0;
+            dxfWriter->writeCircle(&circle);
+        }
+        dxfRW* dxfWriter;
+    };
+    SampleWriter writer;
+    writer.dxfWriter = &dxf;
+    return dxf.write(&writer, DRW::AC1015, false);
+}
+
+bool testSniffFormat() {
+    std::cout << "\n=== Test: Format Detection ===" << std::endl;
+
+    DRW::Version ver;
+    std::string bin("AutoCAD Binary DXF\r\n\x1a", 22);
+    std::istringstream binStream(bin + "data");
+    if (DRW::sniffFormat(&binStream, &ver) != DRW::DXF_BINARY || binStream.tellg() != 22) {
+        std::cout << "✗ Binary dxf not detected" << std::endl;
+        return false;
+    }
+    std::istringstream dwgStream(std::string("AC1018\0\0\0\0\0\0", 12));
+    if (DRW::sniffFormat(&dwgStream, &ver) != DRW::DWG_FORMAT || ver != DRW::AC1018
+            || dwgStream.tellg() != 0) {
+        std::cout << "✗ Dwg 2004 not detected" << std::endl;
+        return false;
+    }
+    std::istringstream asciiStream("  0\nSECTION\n");
+    if (DRW::sniffFormat(&asciiStream, &ver) != DRW::DXF_ASCII || ver != DRW::UNKNOWNV) {
+        std::cout << "✗ Ascii dxf not detected" << std::endl;
+        return false;
+    }
+    std::string line;
+    std::getline(asciiStream, line);
+    if (line != "  0") {
+        std::cout << "✗ Ascii dxf not rewound, got '" << line << "'" << std::endl;
+        return false;
+    }
+    std::istringstream empty("");
+    if (DRW::sniffFormat(&empty, &ver) != DRW::UNKNOWN_FORMAT) {
+        std::cout << "✗ Empty stream not detected" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Ascii, binary, dwg and empty detected" << std::endl;
+    return true;
+}
+
+bool testFdStreamBuf() {
+    std::cout << "\n=== Test: File Descriptor Stream ===" << std::endl;
+
+    const char* filename = "test_input_fd.bin";
+    std::string content;
+    for (int i = 0; i < 200000; ++i)
+        content += (char)('a' + i % 26);
+    {
+        std::ofstream out(filename, std::ios::binary);
+        out << content;
+    }
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        std::cout << "✗ Failed to open " << filename << std::endl;
+        return false;
+    }
+    lseek(fd, 100, SEEK_SET); //positions are relative to this offset
+    bool ok = true;
+    {
+        DRW_FdStreamBuf buf(fd);
+        std::istream in(&buf);
+        char c[4];
+        in.read(c, 4);
+        ok = ok && std::string(c, 4) == content.substr(100, 4);
+        in.seekg(0, std::ios::end);
+        ok = ok && in.tellg() == std::streampos(content.size() - 100);
+        in.seekg(150000); //outside the buffer
+        in.read(c, 4);
+        ok = ok && std::string(c, 4) == content.substr(150100, 4);
+        in.seekg(10); //back, outside the buffer
+        in.read(c, 4);
+        ok = ok && std::string(c, 4) == content.substr(110, 4);
+        in.seekg(2, std::ios::cur); //inside the buffer
+        in.read(c, 4);
+        ok = ok && std::string(c, 4) == content.substr(116, 4) && in.tellg() == std::streampos(20);
+        in.seekg(-4, std::ios::end);
+        in.read(c, 4);
+        ok = ok && std::string(c, 4) == content.substr(content.size() - 4) && in.good();
+        in.read(c, 1);
+        ok = ok && in.eof();
+    }
+    close(fd);
+    std::remove(filename);
+    if (!ok) {
+        std::cout << "✗ Wrong data after seeks" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Reads and seeks ok" << std::endl;
+    return true;
+}
+
+bool testReadFromFd() {
+    std::cout << "\n=== Test: Read DXF From File Descriptor ===" << std::endl;
+
+    const char* filename = "test_input_read.dxf";
+    if (!writeSample(filename)) {
+        std::cout << "✗ Failed to write sample file" << std::endl;
+        return false;
+    }
+    int fd = open(filename, O_RDONLY);
+    TestInterface reader;
+    dxfRW dxf(filename);
+    bool ok = dxf.read(fd, &reader, false);
+    //a dwg reader on the same descriptor detects it is not dwg
+    lseek(fd, 0, SEEK_SET);
+    TestInterface dwgReader;
+    dwgR dwg(filename);
+    bool dwgOk = dwg.read(fd, &dwgReader, false);
+    close(fd);
+
+    //the file name path opens once and parses the same
+    TestInterface byName;
+    dxfRW dxf2(filename);
+    bool ok2 = dxf2.read(&byName, false);
+    std::remove(filename);
+
+    if (!ok || reader.lineCount != 20 || reader.circleCount != 1) {
+        std::cout << "✗ Read from descriptor failed, lines " << reader.lineCount << std::endl;
+        return false;
+    }
+    if (dwgOk || dwg.getError() != DRW::BAD_VERSION) {
+        std::cout << "✗ Dxf accepted by dwg reader" << std::endl;
+        return false;
+    }
+    if (!ok2 || byName.lineCount != 20 || dxf2.getStats().bytesIn != dxf.getStats().bytesIn) {
+        std::cout << "✗ Read by name differs" << std::endl;
+        return false;
+    }
+    if (dxf.read(-1, &reader, false)) {
+        std::cout << "✗ Invalid descriptor accepted" << std::endl;
+        return false;
+    }
+    std::cout << "✓ " << reader.lineCount << " lines read from descriptor" << std::endl;
+    return true;
+}
+
+static std::string readAll(const char* filename) {
+    std::ifstream in(filename, std::ios::binary);
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return ss.str();
+}
+
+//gives the data in small pieces, as a network source
+class ChunkSource : public DRW_InputSource {
+public:
+    ChunkSource(const std::string &d, size_t c) : data(d), pos(0), chunk(c) {}
+    virtual size_t read(char *buf, size_t n) {
+        size_t len = std::min(std::min(n, chunk), data.size() - pos);
+        data.copy(buf, len, pos);
+        pos += len;
+        return len;
+    }
+    std::string data;
+    size_t pos;
+    size_t chunk;
+};
+
+bool testReadFromMemory() {
+    std::cout << "\n=== Test: Read DXF From Memory, Stream And Source ===" << std::endl;
+
+    const char* filename = "test_input_mem.dxf";
+    if (!writeSample(filename)) {
+        std::cout << "✗ Failed to write sample file" << std::endl;
+        return false;
+    }
+    std::string content = readAll(filename);
+    std::remove(filename);
+
+    TestInterface memReader;
+    dxfRW memDxf("memory");
+    bool memOk = memDxf.read(content.data(), content.size(), &memReader, false);
+
+    std::istringstream in(content);
+    TestInterface streamReader;
+    dxfRW streamDxf("stream");
+    bool streamOk = streamDxf.read(&in, &streamReader, false);
+
+    ChunkSource source(content, 1000);
+    TestInterface sourceReader;
+    dxfRW sourceDxf("source");
+    bool sourceOk = sourceDxf.read(&source, &sourceReader, false);
+
+    if (!memOk || memReader.lineCount != 20 || memReader.circleCount != 1) {
+        std::cout << "✗ Read from memory failed" << std::endl;
+        return false;
+    }
+    if (!streamOk || streamReader.lineCount != 20 || streamReader.circleCount != 1) {
+        std::cout << "✗ Read from stream failed" << std::endl;
+        return false;
+    }
+    if (!sourceOk || sourceReader.lineCount != 20 || sourceReader.circleCount != 1) {
+        std::cout << "✗ Read from source failed" << std::endl;
+        return false;
+    }
+    if (memDxf.getStats().bytesIn != content.size() || sourceDxf.getStats().bytesIn != content.size()) {
+        std::cout << "✗ Expected " << content.size() << " bytes consumed, got "
+                  << memDxf.getStats().bytesIn << " and " << sourceDxf.getStats().bytesIn << std::endl;
+        return false;
+    }
+    std::cout << "✓ Same content read from memory, stream and source" << std::endl;
+    return true;
+}
+
+bool testDwgFromMemory() {
+    std::cout << "\n=== Test: Read DWG From Memory And Source ===" << std::endl;
+
+    TestInterface reader;
+    std::string notDwg = "  0\nSECTION\n";
+    dwgR dwg("memory");
+    if (dwg.read(notDwg.data(), notDwg.size(), &reader, false) || dwg.getError() != DRW::BAD_VERSION) {
+        std::cout << "✗ Dxf in memory accepted by dwg reader" << std::endl;
+        return false;
+    }
+    //truncated dwg 2000, the version is detected and the read fails cleanly
+    std::string truncated = std::string("AC1015") + std::string(64, '\0');
+    ChunkSource source(truncated, 7);
+    dwgR dwg2("source");
+    if (dwg2.read(&source, &reader, false) || dwg2.getVersion() != DRW::AC1015) {
+        std::cout << "✗ Truncated dwg from source not rejected" << std::endl;
+        return false;
+    }
+    ChunkSource empty("", 10);
+    dwgR dwg3("empty");
+    if (dwg3.read(&empty, &reader, false)) {
+        std::cout << "✗ Empty source accepted" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Dwg version detected from memory, error " << dwg2.getError() << std::endl;
+    return true;
+}
+
+//binary dxf with a 16 bit code 90 value, as written by old applications
+static std::string binaryWithShort90() {
+    std::string d("AutoCAD Binary DXF\r\n\x1a\0", 22);
+    struct Bin {
+        static void code(std::string &s, int c) { s += char(c & 0xFF); s += char(c >> 8); }
+        static void str(std::string &s, int c, const char *t) { code(s, c); s += t; s += '\0'; }
+        static void dbl(std::string &s, int c, double v) {
+            code(s, c);
+            s.append(reinterpret_cast<const char*>(&v), 8);
+        }
+    };
+    Bin::str(d, 0, "SECTION");
+    Bin::str(d, 2, "ENTITIES");
+    for (int i = 0; i < 3; ++i) {
+        Bin::str(d, 0, "LINE");
+        Bin::str(d, 8, "0");
+        Bin::code(d, 90);
+        Bin::code(d, 5); //2 bytes, the reader takes 4
+        Bin::dbl(d, 10, 1.1 + i);
+        Bin::dbl(d, 20, 2.0);
+        Bin::dbl(d, 11, 3.0);
+        Bin::dbl(d, 21, 4.0);
+    }
+    Bin::str(d, 0, "ENDSEC");
+    Bin::str(d, 0, "EOF");
+    return d;
+}
+
+class LineInterface : public TestInterface {
+public:
+    virtual void addLine(const DRW_Line& data) {
+        TestInterface::addLine(data);
+        xs.push_back(data.basePoint.x);
+        ys.push_back(data.basePoint.y);
+    }
+    bool check(int n) {
+        if (lineCount != n || (int)xs.size() != n)
+            return false;
+        for (int i = 0; i < n; ++i) {
+            if (xs[i] != 1.1 + i || ys[i] != 2.0)
+                return false;
+        }
+        return true;
+    }
+    std::vector<double> xs;
+    std::vector<double> ys;
+};
+
+//stream buffer that can not seek and delivers a few bytes each time, as a pipe
+class PipeStreamBuf : public std::streambuf {
+public:
+    PipeStreamBuf(const std::string &d, size_t c) : data(d), pos(0), chunk(c) {}
+protected:
+    virtual int_type underflow() {
+        if (pos >= data.size())
+            return traits_type::eof();
+        size_t len = std::min(chunk, data.size() - pos);
+        data.copy(buf, len, pos);
+        pos += len;
+        setg(buf, buf, buf + len);
+        return traits_type::to_int_type(buf[0]);
+    }
+    std::string data;
+    size_t pos;
+    size_t chunk;
+    char buf[16];
+};
+
+bool testForwardOnlyBinary() {
+    std::cout << "\n=== Test: Forward Only Binary DXF ===" << std::endl;
+
+    std::string content = binaryWithShort90();
+    LineInterface memReader;
+    dxfRW memDxf("memory");
+    bool memOk = memDxf.read(content.data(), content.size(), &memReader, false);
+
+    //source without seeks, 3 bytes at a time
+    ChunkSource source(content, 3);
+    LineInterface sourceReader;
+    dxfRW sourceDxf("source");
+    bool sourceOk = sourceDxf.read(&source, &sourceReader, false);
+
+    if (!memOk || !memReader.check(3)) {
+        std::cout << "✗ Bad lines from memory: " << memReader.lineCount << std::endl;
+        return false;
+    }
+    if (!sourceOk || !sourceReader.check(3)) {
+        std::cout << "✗ Bad lines from chunked source: " << sourceReader.lineCount << std::endl;
+        return false;
+    }
+    std::cout << "✓ 16 bit code 90 handled without seeking" << std::endl;
+    return true;
+}
+
+bool testForwardOnlyStreams() {
+    std::cout << "\n=== Test: Forward Only Streams And Pipes ===" << std::endl;
+
+    const char* filename = "test_input_pipe.dxf";
+    if (!writeSample(filename)) {
+        std::cout << "✗ Failed to write sample file" << std::endl;
+        return false;
+    }
+    std::string content = readAll(filename);
+    std::remove(filename);
+
+    PipeStreamBuf pipeBuf(content, 5);
+    std::istream in(&pipeBuf);
+    TestInterface streamReader;
+    dxfRW streamDxf("stream");
+    bool streamOk = streamDxf.read(&in, &streamReader, false);
+    if (!streamOk || streamReader.lineCount != 20 || streamReader.circleCount != 1
+            || streamDxf.getStats().bytesIn != content.size()) {
+        std::cout << "✗ Read from non seekable stream failed" << std::endl;
+        return false;
+    }
+
+    std::string bin = binaryWithShort90();
+    PipeStreamBuf binBuf(bin, 7);
+    std::istream binIn(&binBuf);
+    LineInterface binReader;
+    dxfRW binDxf("stream");
+    if (!binDxf.read(&binIn, &binReader, false) || !binReader.check(3)) {
+        std::cout << "✗ Binary read from non seekable stream failed" << std::endl;
+        return false;
+    }
+
+#ifndef _WIN32
+    int fds[2];
+    if (pipe(fds) != 0) {
+        std::cout << "✗ Failed to create pipe" << std::endl;
+        return false;
+    }
+    //fits in the pipe buffer, written before reading
+    bool written = write(fds[1], bin.data(), bin.size()) == (ssize_t)bin.size();
+    close(fds[1]);
+    LineInterface pipeReader;
+    dxfRW pipeDxf("pipe");
+    bool pipeOk = pipeDxf.read(fds[0], &pipeReader, false);
+    close(fds[0]);
+    if (!written || !pipeOk || !pipeReader.check(3)) {
+        std::cout << "✗ Read from pipe failed" << std::endl;
+        return false;
+    }
+#endif
+    std::cout << "✓ Non seekable streams read forward only" << std::endl;
+    return true;
+}
+
+bool testReadAhead() {
+    std::cout << "\n=== Test: Read-Ahead Thread ===" << std::endl;
+
+    const char* filename = "test_input_ahead.dxf";
+    if (!writeSample(filename)) {
+        std::cout << "✗ Failed to write sample file" << std::endl;
+        return false;
+    }
+    std::string content = readAll(filename);
+
+    TestInterface byName;
+    dxfRW dxf(filename);
+    dxf.setReadAhead(true);
+    bool nameOk = dxf.read(&byName, false);
+
+    int fd = open(filename, O_RDONLY);
+    TestInterface byFd;
+    dxfRW dxfFd(filename);
+    dxfFd.setReadAhead(true);
+    bool fdOk = dxfFd.read(fd, &byFd, false);
+    close(fd);
+
+    ChunkSource source(content, 5);
+    TestInterface bySource;
+    dxfRW dxfSource("source");
+    dxfSource.setReadAhead(true);
+    bool sourceOk = dxfSource.read(&source, &bySource, false);
+
+    dwgR dwg(filename);
+    dwg.setReadAhead(true);
+    TestInterface dwgReader;
+    bool dwgOk = dwg.read(&dwgReader, false);
+    std::remove(filename);
+
+    if (!nameOk || byName.lineCount != 20 || dxf.getStats().bytesIn != content.size()) {
+        std::cout << "✗ Read-ahead by name failed" << std::endl;
+        return false;
+    }
+    if (!fdOk || byFd.lineCount != 20 || !sourceOk || bySource.lineCount != 20) {
+        std::cout << "✗ Read-ahead from descriptor or source failed" << std::endl;
+        return false;
+    }
+    if (dwgOk || dwg.getError() != DRW::BAD_VERSION) {
+        std::cout << "✗ Dxf accepted by dwg reader with read-ahead" << std::endl;
+        return false;
+    }
+    dwgR missing("nonexistent_file.dwg");
+    missing.setReadAhead(true);
+    if (missing.read(&dwgReader, false) || missing.getError() != DRW::BAD_OPEN) {
+        std::cout << "✗ Missing file not reported" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Same content read with read-ahead" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "libdxfrw Input Tests" << std::endl;
+    std::cout << "====================" << std::endl;
+
+    int failedTests = 0;
+    int totalTests = 0;
+
+    totalTests++;
+    if (!testSniffFormat()) failedTests++;
+
+    totalTests++;
+    if (!testFdStreamBuf()) failedTests++;
+
+    totalTests++;
+    if (!testReadFromFd()) failedTests++;
+
+    totalTests++;
+    if (!testReadFromMemory()) failedTests++;
+
+    totalTests++;
+    if (!testDwgFromMemory()) failedTests++;
+
+    totalTests++;
+    if (!testForwardOnlyBinary()) failedTests++;
+
+    totalTests++;
+    if (!testForwardOnlyStreams()) failedTests++;
+
+    totalTests++;
+    if (!testReadAhead()) failedTests++;
+
+    std::cout << "\n====================" << std::endl;
+    std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
+
+    if (failedTests > 0) {
+        std::cout << "✗ " << failedTests << " test(s) failed" << std::endl;
+        return 1;
+    } else {
+        std::cout << "✓ All input tests passed!" << std::endl;
+        return 0;
+    }
+}
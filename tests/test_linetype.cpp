@@ -0,0 +1,256 @@
+/******************************************************************************
+**  libDXFrw - Line Type Pattern Tests                                      **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "drw_linetype.h"
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+class DashCollector : public DRW_DashSink {
+public:
+    virtual void dash(const DRW_Coord *points, size_t count) {
+        dashes.push_back(std::vector<DRW_Coord>(points, points + count));
+    }
+    double length(size_t i) const {
+        double len = 0;
+        for (size_t j = 1; j < dashes[i].size(); j++) {
+            double dx = dashes[i][j].x - dashes[i][j - 1].x, dy = dashes[i][j].y - dashes[i][j - 1].y;
+            len += sqrt(dx*dx + dy*dy);
+        }
+        return len;
+    }
+    std::vector<std::vector<DRW_Coord> > dashes;
+};
+
+static std::vector<double> pattern(double a, double b) {
+    std::vector<double> p;
+    p.push_back(a);
+    p.push_back(b);
+    return p;
+}
+
+static bool near(const DRW_Coord &p, double x, double y) {
+    return fabs(p.x - x) < 1e-9 && fabs(p.y - y) < 1e-9;
+}
+
+bool testLineDashes() {
+    std::cout << "\n=== Test: Line Dashes ===" << std::endl;
+
+    DashCollector sink;
+    DRW_Dasher dasher;
+    dasher.setSink(&sink);
+    dasher.setPattern(pattern(1, -1));
+    DRW_Line line;
+    line.basePoint = DRW_Coord(0, 0, 0);
+    line.secPoint = DRW_Coord(10, 0, 0);
+    dasher.entity(line);
+    if (sink.dashes.size() != 5) {
+        std::cout << "✗ Expected 5 dashes, got " << sink.dashes.size() << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < sink.dashes.size(); i++) {
+        if (sink.dashes[i].size() != 2 || !near(sink.dashes[i][0], 2.0 * i, 0)
+                || !near(sink.dashes[i][1], 2.0 * i + 1, 0)) {
+            std::cout << "✗ Dash " << i << " misplaced" << std::endl;
+            return false;
+        }
+    }
+
+    // The global scale by the ltypeScale of the entity
+    sink.dashes.clear();
+    dasher.setPattern(pattern(1, -1), 0.5);
+    line.ltypeScale = 2.0;
+    dasher.entity(line);
+    if (sink.dashes.size() != 5 || !near(sink.dashes[4][1], 9, 0)) {
+        std::cout << "✗ Scaled pattern differs" << std::endl;
+        return false;
+    }
+
+    // Dots
+    sink.dashes.clear();
+    dasher.setPattern(pattern(0, -1));
+    line.ltypeScale = 1.0;
+    line.secPoint = DRW_Coord(3.5, 0, 0);
+    dasher.entity(line);
+    if (sink.dashes.size() != 4 || sink.dashes[3].size() != 1 || !near(sink.dashes[3][0], 3, 0)) {
+        std::cout << "✗ Expected 4 dots, got " << sink.dashes.size() << std::endl;
+        return false;
+    }
+    std::cout << "✓ Line dashes test passed" << std::endl;
+    return true;
+}
+
+bool testPhaseAcrossVertices() {
+    std::cout << "\n=== Test: Phase Across Vertices ===" << std::endl;
+
+    DashCollector sink;
+    DRW_Dasher dasher;
+    dasher.setSink(&sink);
+    dasher.setPattern(pattern(2, -1));
+    DRW_LWPolyline pl;
+    pl.addVertex(DRW_Vertex2D(0, 0, 0));
+    pl.addVertex(DRW_Vertex2D(1, 0, 0));
+    pl.addVertex(DRW_Vertex2D(1, 5, 0));
+    dasher.entity(pl);
+    for (size_t i = 0; i < pl.vertlist.size(); i++)
+        delete pl.vertlist[i];
+    pl.vertlist.clear();
+
+    // 2 over the corner, then from y 2 to 4, then from 5 to the end
+    if (sink.dashes.size() != 2 || sink.dashes[0].size() != 3 || !near(sink.dashes[0][1], 1, 0)
+            || !near(sink.dashes[0][2], 1, 1) || !near(sink.dashes[1][0], 1, 2) || !near(sink.dashes[1][1], 1, 4)) {
+        std::cout << "✗ Pattern does not go on across the corner, " << sink.dashes.size() << " dashes" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Phase across vertices test passed" << std::endl;
+    return true;
+}
+
+bool testCurveDashes() {
+    std::cout << "\n=== Test: Curve Dashes ===" << std::endl;
+
+    DashCollector sink;
+    DRW_Dasher dasher;
+    DRW_Tessellator tess;
+    tess.setTolerance(0.001);
+    dasher.setTessellator(tess);
+    dasher.setSink(&sink);
+    dasher.setPattern(pattern(1, -1));
+    DRW_Circle circle;
+    circle.basePoint = DRW_Coord(5, 5, 0);
+    circle.radious = 10;
+    dasher.entity(circle);
+
+    double total = 0;
+    for (size_t i = 0; i < sink.dashes.size(); i++) {
+        total += sink.dashes[i].size() > 1 ? sink.length(i) : 0;
+        for (size_t j = 0; j < sink.dashes[i].size(); j++) {
+            const DRW_Coord &p = sink.dashes[i][j];
+            double r = sqrt((p.x - 5)*(p.x - 5) + (p.y - 5)*(p.y - 5));
+            if (r > 10 + 1e-9 || r < 10 - 0.001 - 1e-9) {
+                std::cout << "✗ Dash point off the circle" << std::endl;
+                return false;
+            }
+        }
+    }
+    double half = M_PI * 10;
+    if (sink.dashes.size() != 32 || fabs(total - half) > 1.0) {
+        std::cout << "✗ Expected 32 dashes of half the circle, got " << sink.dashes.size()
+                  << " of " << total << std::endl;
+        return false;
+    }
+    std::cout << "✓ Curve dashes test passed" << std::endl;
+    return true;
+}
+
+bool testStreaming() {
+    std::cout << "\n=== Test: Streaming ===" << std::endl;
+
+    // A solid path of 10000 vertices comes in pieces
+    DashCollector sink;
+    DRW_Dasher dasher;
+    dasher.setSink(&sink);
+    dasher.begin(DRW_Coord(0, 0, 0));
+    for (int i = 1; i < 10000; i++)
+        dasher.lineTo(DRW_Coord(i, (i % 2) * 0.5, 0));
+    dasher.end();
+    size_t total = 0;
+    for (size_t i = 0; i < sink.dashes.size(); i++) {
+        if (sink.dashes[i].size() > 256 || (i > 0 && !near(sink.dashes[i][0], sink.dashes[i - 1].back().x,
+                                                                  sink.dashes[i - 1].back().y))) {
+            std::cout << "✗ Piece " << i << " too large or not joined" << std::endl;
+            return false;
+        }
+        total += sink.dashes[i].size();
+    }
+    if (sink.dashes.size() < 40 || total != 10000 + sink.dashes.size() - 1) {
+        std::cout << "✗ Expected the 10000 vertices, got " << total << std::endl;
+        return false;
+    }
+
+    // Too many dashes, the rest is solid
+    sink.dashes.clear();
+    dasher.setPattern(pattern(0.001, -0.001));
+    dasher.setMaxDashes(100);
+    dasher.begin(DRW_Coord(0, 0, 0));
+    dasher.lineTo(DRW_Coord(1000, 0, 0));
+    dasher.end();
+    if (sink.dashes.size() != 101 || !near(sink.dashes.back()[0], 0.199, 0)
+            || !near(sink.dashes.back().back(), 1000, 0)) {
+        std::cout << "✗ Expected 100 dashes and a solid rest, got " << sink.dashes.size() << std::endl;
+        return false;
+    }
+    std::cout << "✓ Streaming test passed (" << sink.dashes.size() << " dashes)" << std::endl;
+    return true;
+}
+
+bool testBatch() {
+    std::cout << "\n=== Test: Batch ===" << std::endl;
+
+    DashCollector sink;
+    DRW_Dasher dasher;
+    dasher.setSink(&sink);
+    DRW_LType lt;
+    lt.path = pattern(3, -1);
+    dasher.setPattern(lt);
+    std::vector<DRW_Line> lines(3);
+    std::vector<const DRW_Entity *> list;
+    for (size_t i = 0; i < lines.size(); i++) {
+        lines[i].basePoint = DRW_Coord(0, i, 0);
+        lines[i].secPoint = DRW_Coord(5, i, 0);
+        list.push_back(&lines[i]);
+    }
+    DRW_Text text;
+    list.push_back(&text);
+    // each line starts the pattern: a dash of 3 and one of 1
+    if (dasher.entities(list) != 3 || sink.dashes.size() != 6 || !near(sink.dashes[2][0], 0, 1)
+            || !near(sink.dashes[5][1], 5, 2)) {
+        std::cout << "✗ Expected 2 dashes for each line, got " << sink.dashes.size() << std::endl;
+        return false;
+    }
+    std::cout << "✓ Batch test passed" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "libdxfrw Line Type Pattern Tests" << std::endl;
+    std::cout << "================================" << std::endl;
+
+    int failedTests = 0;
+    int totalTests = 0;
+
+    totalTests++;
+    if (!testLineDashes()) failedTests++;
+
+    totalTests++;
+    if (!testPhaseAcrossVertices()) failedTests++;
+
+    totalTests++;
+    if (!testCurveDashes()) failedTests++;
+
+    totalTests++;
+    if (!testStreaming()) failedTests++;
+
+    totalTests++;
+    if (!testBatch()) failedTests++;
+
+    std::cout << "\n================================" << std::endl;
+    std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
+
+    if (failedTests > 0) {
+        std::cout << "✗ " << failedTests << " test(s) failed" << std::endl;
+        return 1;
+    } else {
+        std::cout << "✓ All line type pattern tests passed!" << std::endl;
+        return 0;
+    }
+}
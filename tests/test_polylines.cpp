@@ -15,6 +15,9 @@
 #include <iostream>
 #include <cstdio>
 #include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
 
 bool testLWPolyline() {
     std::cout << "\n=== Test: LWPolyline (Lightweight Polyline) ===" << std::endl;
@@ -336,6 +339,191 @@ bool testPolylineWithBulge() {
     return true;
 }
 
+//keeps the entities given by the reader, checks that nothing was copied
+class OwningInterface : public TestInterface {
+public:
+    OwningInterface() : pl(NULL), lw(NULL), firstVertex(NULL), firstVertex2D(NULL), leftOver(0) {}
+    ~OwningInterface() {
+        if (pl) {
+            for (size_t i = 0; i < pl->vertlist.size(); i++)
+                delete pl->vertlist[i];
+        }
+        if (lw) {
+            for (size_t i = 0; i < lw->vertlist.size(); i++)
+                delete lw->vertlist[i];
+        }
+        delete pl;
+        delete lw;
+    }
+    virtual void takePolyline(DRW_Polyline&& data) {
+        firstVertex = data.vertlist.empty() ? NULL : data.vertlist[0];
+        pl = new DRW_Polyline(std::move(data));
+        leftOver += data.vertlist.size();
+    }
+    virtual void takeLWPolyline(DRW_LWPolyline&& data) {
+        firstVertex2D = data.vertlist.empty() ? NULL : data.vertlist[0];
+        lw = new DRW_LWPolyline(std::move(data));
+        leftOver += data.vertlist.size();
+    }
+    DRW_Polyline *pl;
+    DRW_LWPolyline *lw;
+    DRW_Vertex *firstVertex;
+    DRW_Vertex2D *firstVertex2D;
+    size_t leftOver;
+};
+
+bool testOwnershipTransfer() {
+    std::cout << "\n=== Test: Ownership Transfer Callbacks ===" << std::endl;
+
+    const char* filename = "test_take.dxf";
+    {
+        dxfRW dxf(filename);
+        class TakeWriter : public TestInterface {
+        public:
+            virtual void writeEntities() {
+                DRW_Polyline poly;
+                poly.flags = 8;
+                poly.vertlist.push_back(new DRW_Vertex(0.0, 0.0, 0.0, 0.0));
+                poly.vertlist.push_back(new DRW_Vertex(50.0, 0.0, 10.0, 0.0));
+                poly.vertlist.push_back(new DRW_Vertex(50.0, 50.0, 20.0, 0.0));
+                dxfWriter->writePolyline(&poly);
+                for (size_t i = 0; i < poly.vertlist.size(); i++)
+                    delete poly.vertlist[i];
+
+                DRW_LWPolyline lwpoly;
+                lwpoly.layer = "outline";
+                lwpoly.vertlist.push_back(new DRW_Vertex2D(0.0, 0.0, 0.0));
+                lwpoly.vertlist.push_back(new DRW_Vertex2D(10.0, 0.0, 0.5));
+                lwpoly.vertlist.push_back(new DRW_Vertex2D(10.0, 10.0, 0.0));
+                lwpoly.vertlist.push_back(new DRW_Vertex2D(0.0, 10.0, 0.0));
+                dxfWriter->writeLWPolyline(&lwpoly);
+                for (size_t i = 0; i < lwpoly.vertlist.size(); i++)
+                    delete lwpoly.vertlist[i];
+            }
+            dxfRW* dxfWriter;
+        };
+        TakeWriter writer;
+        writer.dxfWriter = &dxf;
+        if (!dxf.write(&writer, DRW::AC1015, false)) {
+            std::cout << "✗ Failed to write file" << std::endl;
+            return false;
+        }
+    }
+
+    OwningInterface owner;
+    TestInterface counter;
+    dxfRW dxf(filename);
+    bool ok = dxf.read(&owner, false);
+    dxfRW dxf2(filename);
+    bool ok2 = dxf2.read(&counter, false);
+    std::remove(filename);
+
+    if (!ok || owner.pl == NULL || owner.lw == NULL) {
+        std::cout << "✗ Entities not given to the owning interface" << std::endl;
+        return false;
+    }
+    if (owner.pl->vertlist.size() != 3 || owner.lw->vertlist.size() != 4 || owner.leftOver != 0) {
+        std::cout << "✗ Wrong vertex counts " << owner.pl->vertlist.size() << ", "
+                  << owner.lw->vertlist.size() << std::endl;
+        return false;
+    }
+    if (owner.pl->vertlist[0] != owner.firstVertex || owner.lw->vertlist[0] != owner.firstVertex2D) {
+        std::cout << "✗ Vertex lists were copied" << std::endl;
+        return false;
+    }
+    if (owner.lw->layer != "outline" || owner.lw->vertlist[1]->bulge != 0.5
+            || owner.pl->vertlist[2]->basePoint.z != 20.0) {
+        std::cout << "✗ Entity data lost in the transfer" << std::endl;
+        return false;
+    }
+    if (!ok2 || counter.polylineCount != 1 || counter.lwPolylineCount != 1) {
+        std::cout << "✗ Default callbacks not called" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Vertex lists taken without copy, default callbacks still called" << std::endl;
+    return true;
+}
+
+class ExtrudedReader : public TestInterface {
+public:
+    virtual void addLWPolyline(const DRW_LWPolyline& data) {
+        lwPolylineCount++;
+        std::vector<DRW_Coord> pts;
+        for (size_t i = 0; i < data.vertlist.size(); i++)
+            pts.push_back(DRW_Coord(data.vertlist[i]->x, data.vertlist[i]->y, 0));
+        polylines.push_back(pts);
+    }
+    virtual void addTrace(const DRW_Trace& data) {
+        traceCount++;
+        trace = data.thirdPoint;
+    }
+    std::vector<std::vector<DRW_Coord> > polylines;
+    DRW_Coord trace;
+};
+
+// OCS to WCS with the arbitrary axis algorithm of the DXF reference
+static DRW_Coord ocsToWcs(const DRW_Coord &n, const DRW_Coord &p) {
+    DRW_Coord ax = (fabs(n.x) < 1.0/64 && fabs(n.y) < 1.0/64) ? DRW_Coord(n.z, 0, -n.x)
+                                                              : DRW_Coord(-n.y, n.x, 0);
+    ax.unitize();
+    DRW_Coord ay(n.y*ax.z - ax.y*n.z, n.z*ax.x - ax.z*n.x, n.x*ax.y - ax.x*n.y);
+    ay.unitize();
+    return DRW_Coord(ax.x*p.x + ay.x*p.y + n.x*p.z, ax.y*p.x + ay.y*p.y + n.y*p.z,
+                     ax.z*p.x + ay.z*p.y + n.z*p.z);
+}
+
+bool testExtrudedLWPolylines() {
+    std::cout << "\n=== Test: Extruded LWPolylines ===" << std::endl;
+
+    // 1001 vertices, more than a batch and an odd count; the first extrusion comes back
+    const DRW_Coord normals[] = {DRW_Coord(0, 0, -1), DRW_Coord(0.6, 0, 0.8), DRW_Coord(0, 0, -1)};
+    const int vertices = 1001;
+    std::ostringstream dxf;
+    dxf.precision(17);
+    dxf << "0\nSECTION\n2\nENTITIES\n";
+    for (int p = 0; p < 3; p++) {
+        dxf << "0\nLWPOLYLINE\n8\n0\n90\n" << vertices << "\n70\n0\n38\n" << 2.5 * p << "\n";
+        for (int i = 0; i < vertices; i++)
+            dxf << "10\n" << i * 0.5 << "\n20\n" << (i % 7) - 3.0 << "\n";
+        dxf << "210\n" << normals[p].x << "\n220\n" << normals[p].y << "\n230\n" << normals[p].z << "\n";
+    }
+    dxf << "0\nTRACE\n8\n0\n10\n0\n20\n0\n30\n1\n11\n1\n21\n0\n31\n1\n"
+           "12\n1\n22\n2\n32\n1\n13\n0\n23\n1\n33\n1\n210\n0.6\n220\n0\n230\n0.8\n";
+    dxf << "0\nENDSEC\n0\nEOF\n";
+    std::string data = dxf.str();
+
+    ExtrudedReader reader;
+    dxfRW in("extruded");
+    if (!in.read(data.data(), data.size(), &reader, true) || reader.polylines.size() != 3) {
+        std::cout << "✗ Failed to read the polylines" << std::endl;
+        return false;
+    }
+    for (int p = 0; p < 3; p++) {
+        const std::vector<DRW_Coord> &pts = reader.polylines[p];
+        if (pts.size() != static_cast<size_t>(vertices)) {
+            std::cout << "✗ Polyline " << p << " has " << pts.size() << " vertices" << std::endl;
+            return false;
+        }
+        for (int i = 0; i < vertices; i++) {
+            DRW_Coord w = ocsToWcs(normals[p], DRW_Coord(i * 0.5, (i % 7) - 3.0, 2.5 * p));
+            if (fabs(pts[i].x - w.x) > 1e-12 || fabs(pts[i].y - w.y) > 1e-12) {
+                std::cout << "✗ Vertex " << i << " of polyline " << p << " at (" << pts[i].x
+                          << ", " << pts[i].y << "), expected (" << w.x << ", " << w.y << ")" << std::endl;
+                return false;
+            }
+        }
+    }
+    DRW_Coord t = ocsToWcs(normals[1], DRW_Coord(1, 2, 1));
+    if (reader.traceCount != 1 || fabs(reader.trace.x - t.x) > 1e-12 || fabs(reader.trace.y - t.y) > 1e-12
+            || fabs(reader.trace.z - t.z) > 1e-12) {
+        std::cout << "✗ Trace corner not in WCS" << std::endl;
+        return false;
+    }
+
+    std::cout << "✓ Extruded vertices match the arbitrary axis algorithm" << std::endl;
+    return true;
+}
+
 int main(int argc, char* argv[]) {
     std::cout << "libdxfrw Polyline and Spline Tests" << std::endl;
     std::cout << "===================================" << std::endl;
@@ -358,6 +546,12 @@ int main(int argc, char* argv[]) {
     totalTests++;
     if (!testPolylineWithBulge()) failedTests++;
 
+    totalTests++;
+    if (!testOwnershipTransfer()) failedTests++;
+
+    totalTests++;
+    if (!testExtrudedLWPolylines()) failedTests++;
+
     std::cout << "\n===================================" << std::endl;
     std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
 
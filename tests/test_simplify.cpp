@@ -0,0 +1,304 @@
+/******************************************************************************
+**  libDXFrw - Polyline Simplification Tests                                **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "libdxfrw.h"
+#include "drw_simplify.h"
+#include "test_interface.h"
+#include <iostream>
+#include <sstream>
+#include <cmath>
+
+// Survey like line: 1 unit steps with noise below 0.001 and a spike in the middle
+static void noisyLine(DRW_LWPolyline *pl, int vertices) {
+    for (int i = 0; i < vertices; i++) {
+        double y = 0.001 * (((i * 7919) % 11) - 5) / 5.0;
+        if (i == vertices / 2)
+            y = 5.0;
+        pl->addVertex(DRW_Vertex2D(i, y, 0));
+    }
+}
+
+static void freeVertices(DRW_LWPolyline *pl) {
+    for (size_t i = 0; i < pl->vertlist.size(); i++)
+        delete pl->vertlist[i];
+    pl->vertlist.clear();
+}
+
+// largest distance of the vertices of 'orig' to 'simple', both growing in x
+static double deviation(const DRW_LWPolyline &orig, const DRW_LWPolyline &simple) {
+    double worst = 0;
+    size_t s = 0;
+    for (size_t i = 0; i < orig.vertlist.size(); i++) {
+        const DRW_Vertex2D *p = orig.vertlist[i];
+        while (s + 2 < simple.vertlist.size() && simple.vertlist[s + 1]->x < p->x)
+            s++;
+        const DRW_Vertex2D *a = simple.vertlist[s], *b = simple.vertlist[s + 1];
+        double dx = b->x - a->x, dy = b->y - a->y;
+        double t = ((p->x - a->x) * dx + (p->y - a->y) * dy) / (dx*dx + dy*dy);
+        t = std::max(0.0, std::min(1.0, t));
+        worst = std::max(worst, hypot(p->x - a->x - dx * t, p->y - a->y - dy * t));
+    }
+    return worst;
+}
+
+static bool hasVertex(const DRW_LWPolyline &pl, double x, double y) {
+    for (size_t i = 0; i < pl.vertlist.size(); i++) {
+        if (pl.vertlist[i]->x == x && pl.vertlist[i]->y == y)
+            return true;
+    }
+    return false;
+}
+
+bool testDouglasPeucker() {
+    std::cout << "\n=== Test: Douglas-Peucker ===" << std::endl;
+
+    DRW_LWPolyline orig, pl;
+    noisyLine(&orig, 10001);
+    pl = DRW_LWPolyline(orig);
+    DRW_Simplifier simplifier;
+    if (simplifier.simplify(&pl) != 0 || pl.vertlist.size() != 10001) {
+        std::cout << "✗ Disabled simplifier changed the polyline" << std::endl;
+        return false;
+    }
+    simplifier.setTolerance(0.01);
+    size_t removed = simplifier.simplify(&pl);
+    double dev = deviation(orig, pl);
+    bool ok = true;
+    if (removed + pl.vertlist.size() != 10001 || pl.vertlist.size() > 6 || pl.vertexnum != static_cast<int>(pl.vertlist.size())
+            || !hasVertex(pl, 0, orig.vertlist[0]->y) || !hasVertex(pl, 5000, 5.0) || !hasVertex(pl, 10000, orig.vertlist[10000]->y)) {
+        std::cout << "✗ Expected the ends and the spike, got " << pl.vertlist.size() << " vertices" << std::endl;
+        ok = false;
+    } else if (dev > 0.01) {
+        std::cout << "✗ Deviation " << dev << " over the tolerance" << std::endl;
+        ok = false;
+    }
+    freeVertices(&orig);
+    freeVertices(&pl);
+    if (ok)
+        std::cout << "✓ Douglas-Peucker test passed (" << removed << " removed, deviation " << dev << ")" << std::endl;
+    return ok;
+}
+
+bool testKeptVertices() {
+    std::cout << "\n=== Test: Kept Vertices ===" << std::endl;
+
+    // collinear but for the arc after vertex 3 and the tapered segment after 6
+    DRW_LWPolyline pl;
+    for (int i = 0; i < 10; i++)
+        pl.addVertex(DRW_Vertex2D(i, 0, i == 3 ? 0.5 : 0));
+    pl.vertlist[6]->stawidth = 0.2;
+    pl.vertlist[6]->endwidth = 0.4;
+    DRW_Simplifier simplifier;
+    simplifier.setTolerance(0.1);
+    simplifier.simplify(&pl);
+    const double expected[] = {0, 3, 4, 6, 7, 9};
+    bool ok = pl.vertlist.size() == 6;
+    for (size_t i = 0; ok && i < 6; i++)
+        ok = pl.vertlist[i]->x == expected[i];
+    if (!ok)
+        std::cout << "✗ Arc or width vertices removed, " << pl.vertlist.size() << " left" << std::endl;
+    freeVertices(&pl);
+
+    // closed square of 40 vertices keeps its corners
+    DRW_LWPolyline square;
+    square.flags = 1;
+    for (int side = 0; side < 4; side++) {
+        for (int i = 0; i < 10; i++) {
+            double t = i;
+            const double xs[] = {t, 10, 10 - t, 0}, ys[] = {0, t, 10, 10 - t};
+            square.addVertex(DRW_Vertex2D(xs[side], ys[side], 0));
+        }
+    }
+    simplifier.setMethod(DRW_Simplifier::VISVALINGAM);
+    simplifier.simplify(&square);
+    if (square.vertlist.size() != 4 || !hasVertex(square, 10, 0) || !hasVertex(square, 10, 10) || !hasVertex(square, 0, 10)) {
+        std::cout << "✗ Expected the 4 corners, got " << square.vertlist.size() << " vertices" << std::endl;
+        ok = false;
+    }
+    freeVertices(&square);
+    if (ok)
+        std::cout << "✓ Kept vertices test passed" << std::endl;
+    return ok;
+}
+
+bool testVisvalingam() {
+    std::cout << "\n=== Test: Visvalingam ===" << std::endl;
+
+    DRW_LWPolyline orig;
+    noisyLine(&orig, 10001);
+    DRW_LWPolyline pl(orig);
+    DRW_Simplifier simplifier;
+    simplifier.setMethod(DRW_Simplifier::VISVALINGAM);
+    simplifier.setTolerance(0.1);
+    size_t removed = simplifier.simplify(&pl);
+    double dev = deviation(orig, pl);
+    bool ok = true;
+    if (pl.vertlist.size() > 2000 || !hasVertex(pl, 5000, 5.0) || !hasVertex(pl, 0, orig.vertlist[0]->y)
+            || !hasVertex(pl, 10000, orig.vertlist[10000]->y) || dev > 0.01) {
+        std::cout << "✗ Got " << pl.vertlist.size() << " vertices, deviation " << dev << std::endl;
+        ok = false;
+    }
+    freeVertices(&orig);
+    freeVertices(&pl);
+    if (ok)
+        std::cout << "✓ Visvalingam test passed (" << removed << " removed)" << std::endl;
+    return ok;
+}
+
+bool testLevels() {
+    std::cout << "\n=== Test: Levels of Detail ===" << std::endl;
+
+    bool ok = true;
+    for (int m = 0; m < 2 && ok; m++) {
+        DRW_LWPolyline orig;
+        for (int i = 0; i < 2000; i++)
+            orig.addVertex(DRW_Vertex2D(i * 0.01, sin(i * 0.01) + 0.01 * sin(i * 0.7), 0));
+        DRW_Simplifier simplifier;
+        simplifier.setMethod(m == 0 ? DRW_Simplifier::DOUGLASPEUCKER : DRW_Simplifier::VISVALINGAM);
+        std::vector<double> tolerances;
+        tolerances.push_back(0.0001);
+        tolerances.push_back(0.001);
+        tolerances.push_back(0.01);
+        tolerances.push_back(0.1);
+        std::vector<DRW_LWPolyline> lods;
+        simplifier.levels(orig, tolerances, &lods);
+        if (lods.size() != 4 || orig.vertlist.size() != 2000) {
+            std::cout << "✗ Expected 4 levels" << std::endl;
+            ok = false;
+        }
+        for (size_t l = 1; ok && l < lods.size(); l++) {
+            if (lods[l].vertlist.size() >= lods[l - 1].vertlist.size()) {
+                std::cout << "✗ Level " << l << " not coarser" << std::endl;
+                ok = false;
+            }
+            for (size_t i = 0; ok && i < lods[l].vertlist.size(); i++) {
+                if (!hasVertex(lods[l - 1], lods[l].vertlist[i]->x, lods[l].vertlist[i]->y)) {
+                    std::cout << "✗ Level " << l << " not nested" << std::endl;
+                    ok = false;
+                }
+            }
+        }
+        // a level is the polyline simplified with its tolerance
+        DRW_LWPolyline pl(orig);
+        simplifier.setTolerance(0.01);
+        simplifier.simplify(&pl);
+        if (ok && pl.vertlist.size() != lods[2].vertlist.size()) {
+            std::cout << "✗ Level with " << lods[2].vertlist.size() << " vertices, simplify "
+                      << pl.vertlist.size() << std::endl;
+            ok = false;
+        }
+        if (ok)
+            std::cout << "  method " << m << ": " << lods[0].vertlist.size() << " " << lods[1].vertlist.size()
+                      << " " << lods[2].vertlist.size() << " " << lods[3].vertlist.size() << " vertices" << std::endl;
+        freeVertices(&pl);
+        freeVertices(&orig);
+        for (size_t l = 0; l < lods.size(); l++)
+            freeVertices(&lods[l]);
+    }
+    if (ok)
+        std::cout << "✓ Levels of detail test passed" << std::endl;
+    return ok;
+}
+
+class VertexCounter : public TestInterface {
+public:
+    virtual void addLWPolyline(const DRW_LWPolyline& data) {
+        lwPolylineCount++;
+        sizes.push_back(data.vertlist.size());
+    }
+    virtual void addPolyline(const DRW_Polyline& data) {
+        polylineCount++;
+        sizes.push_back(data.vertlist.size());
+    }
+    std::vector<size_t> sizes;
+};
+
+bool testReadTime() {
+    std::cout << "\n=== Test: Simplification While Reading ===" << std::endl;
+
+    std::ostringstream dxf;
+    dxf.precision(17);
+    dxf << "0\nSECTION\n2\nENTITIES\n";
+    dxf << "0\nLWPOLYLINE\n8\n0\n90\n2001\n70\n0\n";
+    for (int i = 0; i <= 2000; i++)
+        dxf << "10\n" << i * 0.5 << "\n20\n" << 0.0001 * (i % 3) << "\n";
+    // a 3d polyline climbing along a line and a mesh
+    dxf << "0\nPOLYLINE\n8\n0\n66\n1\n70\n8\n10\n0\n20\n0\n30\n0\n";
+    for (int i = 0; i <= 500; i++)
+        dxf << "0\nVERTEX\n8\n0\n10\n" << i << "\n20\n" << 2 * i << "\n30\n" << 3 * i << "\n70\n32\n";
+    dxf << "0\nSEQEND\n8\n0\n";
+    dxf << "0\nPOLYLINE\n8\n0\n66\n1\n70\n16\n71\n3\n72\n3\n10\n0\n20\n0\n30\n0\n";
+    for (int i = 0; i < 9; i++)
+        dxf << "0\nVERTEX\n8\n0\n10\n" << i % 3 << "\n20\n" << i / 3 << "\n30\n0\n70\n64\n";
+    dxf << "0\nSEQEND\n8\n0\n";
+    dxf << "0\nENDSEC\n0\nEOF\n";
+    std::string data = dxf.str();
+
+    VertexCounter plain, simplified;
+    dxfRW in("plain");
+    bool ok = in.read(data.data(), data.size(), &plain, false);
+    dxfRW in2("simplified");
+    DRW_Simplifier simplifier;
+    simplifier.setTolerance(0.01);
+    in2.setSimplifier(simplifier);
+    ok = ok && in2.read(data.data(), data.size(), &simplified, false);
+    if (!ok || plain.sizes.size() != 3 || simplified.sizes.size() != 3) {
+        std::cout << "✗ Failed to read the polylines" << std::endl;
+        return false;
+    }
+    if (plain.sizes[0] != 2001 || plain.sizes[1] != 501 || plain.sizes[2] != 9) {
+        std::cout << "✗ Unexpected vertices without simplification" << std::endl;
+        return false;
+    }
+    if (simplified.sizes[0] != 2 || simplified.sizes[1] != 2 || simplified.sizes[2] != 9
+            || in2.getStats().removedVertices != 1999 + 499 || in.getStats().removedVertices != 0) {
+        std::cout << "✗ Got " << simplified.sizes[0] << ", " << simplified.sizes[1] << " & "
+                  << simplified.sizes[2] << " vertices, " << in2.getStats().removedVertices << " removed" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Simplification while reading test passed" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "libdxfrw Polyline Simplification Tests" << std::endl;
+    std::cout << "======================================" << std::endl;
+
+    int failedTests = 0;
+    int totalTests = 0;
+
+    totalTests++;
+    if (!testDouglasPeucker()) failedTests++;
+
+    totalTests++;
+    if (!testKeptVertices()) failedTests++;
+
+    totalTests++;
+    if (!testVisvalingam()) failedTests++;
+
+    totalTests++;
+    if (!testLevels()) failedTests++;
+
+    totalTests++;
+    if (!testReadTime()) failedTests++;
+
+    std::cout << "\n======================================" << std::endl;
+    std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
+
+    if (failedTests > 0) {
+        std::cout << "✗ " << failedTests << " test(s) failed" << std::endl;
+        return 1;
+    } else {
+        std::cout << "✓ All polyline simplification tests passed!" << std::endl;
+        return 0;
+    }
+}
@@ -0,0 +1,235 @@
+/******************************************************************************
+**  libDXFrw - Spatial Index Tests                                          **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "libdxfrw.h"
+#include "test_interface.h"
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+// Deterministic pseudo random numbers in [0, 1)
+static double nextRandom(unsigned int *seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return ((*seed >> 8) & 0xFFFF) / 65536.0;
+}
+
+static std::vector<DRW_BBox> randomBoxes(int count) {
+    unsigned int seed = 42;
+    std::vector<DRW_BBox> boxes;
+    for (int i = 0; i < count; ++i) {
+        double x = nextRandom(&seed) * 1000.0;
+        double y = nextRandom(&seed) * 1000.0;
+        double w = nextRandom(&seed) * 10.0;
+        double h = nextRandom(&seed) * 10.0;
+        boxes.push_back(DRW_BBox(DRW_Coord(x, y, 0), DRW_Coord(x + w, y + h, 0)));
+    }
+    return boxes;
+}
+
+static DRW_BBox window(double x0, double y0, double x1, double y1) {
+    return DRW_BBox(DRW_Coord(x0, y0, -1), DRW_Coord(x1, y1, 1));
+}
+
+static double distance2(const DRW_BBox &b, const DRW_Coord &p) {
+    double dx = std::max(std::max(b.minPoint.x - p.x, p.x - b.maxPoint.x), 0.0);
+    double dy = std::max(std::max(b.minPoint.y - p.y, p.y - b.maxPoint.y), 0.0);
+    return dx*dx + dy*dy;
+}
+
+bool testWindowQuery() {
+    std::cout << "\n=== Test: Window Query ===" << std::endl;
+
+    std::vector<DRW_BBox> boxes = randomBoxes(20000);
+    DRW_SpatialIndex index;
+    for (size_t i = 0; i < boxes.size(); ++i)
+        index.add(i + 1, boxes[i]);
+    index.build();
+
+    DRW_BBox windows[] = {window(100, 100, 200, 150), window(0, 0, 1000, 1000),
+                          window(500, 500, 500, 500), window(2000, 2000, 3000, 3000)};
+    for (int w = 0; w < 4; ++w) {
+        std::vector<duint32> found;
+        index.query(windows[w], &found);
+        std::vector<duint32> expected;
+        for (size_t i = 0; i < boxes.size(); ++i) {
+            if (boxes[i].intersects(windows[w]))
+                expected.push_back(i + 1);
+        }
+        std::sort(found.begin(), found.end());
+        if (found != expected) {
+            std::cout << "✗ Window " << w << ": " << found.size() << " handles, expected "
+                      << expected.size() << std::endl;
+            return false;
+        }
+    }
+    if (index.size() != boxes.size() || !index.bounds().isValid()) {
+        std::cout << "✗ Wrong size or bounds" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Window queries match a linear scan" << std::endl;
+    return true;
+}
+
+bool testNearestQuery() {
+    std::cout << "\n=== Test: Nearest Query ===" << std::endl;
+
+    std::vector<DRW_BBox> boxes = randomBoxes(5000);
+    DRW_SpatialIndex index;
+    for (size_t i = 0; i < boxes.size(); ++i)
+        index.add(i, boxes[i]);
+    index.build();
+
+    unsigned int seed = 7;
+    for (int q = 0; q < 50; ++q) {
+        DRW_Coord p(nextRandom(&seed) * 1200.0 - 100.0, nextRandom(&seed) * 1200.0 - 100.0, 0);
+        std::vector<duint32> found;
+        index.nearest(p, 8, &found);
+        std::vector<double> expected;
+        for (size_t i = 0; i < boxes.size(); ++i)
+            expected.push_back(distance2(boxes[i], p));
+        std::sort(expected.begin(), expected.end());
+        if (found.size() != 8) {
+            std::cout << "✗ " << found.size() << " handles" << std::endl;
+            return false;
+        }
+        for (size_t i = 0; i < found.size(); ++i) {
+            if (distance2(boxes[found[i]], p) != expected[i]) {
+                std::cout << "✗ Result " << i << " of query " << q << " is not the nearest" << std::endl;
+                return false;
+            }
+        }
+    }
+    std::cout << "✓ Nearest queries match a linear scan" << std::endl;
+    return true;
+}
+
+bool testSerialization() {
+    std::cout << "\n=== Test: Index Serialization ===" << std::endl;
+
+    std::vector<DRW_BBox> boxes = randomBoxes(3000);
+    DRW_SpatialIndex index;
+    for (size_t i = 0; i < boxes.size(); ++i)
+        index.add(i + 100, boxes[i]);
+    index.build();
+
+    std::stringstream stream;
+    if (!index.write(stream)) {
+        std::cout << "✗ Write failed" << std::endl;
+        return false;
+    }
+    std::string data = stream.str();
+    DRW_SpatialIndex loaded;
+    std::istringstream in(data);
+    if (!loaded.read(in) || loaded.size() != index.size()) {
+        std::cout << "✗ Read failed" << std::endl;
+        return false;
+    }
+    std::vector<duint32> a, b;
+    index.query(window(250, 250, 400, 300), &a);
+    loaded.query(window(250, 250, 400, 300), &b);
+    if (a.empty() || a != b) {
+        std::cout << "✗ Loaded index answers differently" << std::endl;
+        return false;
+    }
+
+    //truncated or damaged data is rejected
+    std::istringstream truncated(data.substr(0, data.size() / 2));
+    std::string damaged = data;
+    damaged[damaged.size() - 52] = '\x7f'; //child count of the root
+    std::istringstream bad(damaged);
+    std::istringstream notIndex("not an index");
+    if (loaded.read(truncated) || !loaded.empty() || loaded.read(bad) || loaded.read(notIndex)) {
+        std::cout << "✗ Invalid data accepted" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Index saved and loaded, invalid data rejected" << std::endl;
+    return true;
+}
+
+bool testIndexDuringRead() {
+    std::cout << "\n=== Test: Index Filled While Reading ===" << std::endl;
+
+    std::ostringstream dxf;
+    dxf << "0\nSECTION\n2\nENTITIES\n";
+    for (int i = 0; i < 30; ++i) {
+        //one row of short lines in model space, handles 0x100 up
+        dxf << "0\nLINE\n5\n" << std::hex << (0x100 + i) << std::dec << "\n8\n0\n"
+            << "10\n" << i * 10 << ".0\n20\n0.0\n30\n0.0\n11\n" << i * 10 + 5 << ".0\n21\n0.0\n31\n0.0\n";
+    }
+    dxf << "0\nCIRCLE\n5\nAAA\n8\n0\n67\n1\n10\n5.0\n20\n5.0\n30\n0.0\n40\n1.0\n";
+    dxf << "0\nENDSEC\n0\nEOF\n";
+    std::string data = dxf.str();
+
+    TestInterface reader;
+    dxfRW in("index");
+    in.setSpatialIndex(true);
+    if (!in.read(data.data(), data.size(), &reader, false)) {
+        std::cout << "✗ Failed to read" << std::endl;
+        return false;
+    }
+    const DRW_Extents &ext = in.getExtents();
+    std::vector<duint32> found;
+    ext.modelIndex.query(window(200, -1, 231, 1), &found);
+    std::sort(found.begin(), found.end());
+    if (ext.modelIndex.size() != 30 || found.size() != 4 || found[0] != 0x114 || found[3] != 0x117) {
+        std::cout << "✗ Model space query: " << found.size() << " handles" << std::endl;
+        return false;
+    }
+    found.clear();
+    ext.paperIndex.nearest(DRW_Coord(0, 0, 0), 1, &found);
+    if (ext.paperIndex.size() != 1 || found.size() != 1 || found[0] != 0xAAA) {
+        std::cout << "✗ Paper space index" << std::endl;
+        return false;
+    }
+    //without the index the extents go back off
+    in.setSpatialIndex(false);
+    if (!in.read(data.data(), data.size(), &reader, false) || in.getExtents().bounded != 0
+            || in.getExtents().modelIndex.size() != 0) {
+        std::cout << "✗ Extents still computed without the index" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Model and paper space indexed by handle" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "libdxfrw Spatial Index Tests" << std::endl;
+    std::cout << "============================" << std::endl;
+
+    int failedTests = 0;
+    int totalTests = 0;
+
+    totalTests++;
+    if (!testWindowQuery()) failedTests++;
+
+    totalTests++;
+    if (!testNearestQuery()) failedTests++;
+
+    totalTests++;
+    if (!testSerialization()) failedTests++;
+
+    totalTests++;
+    if (!testIndexDuringRead()) failedTests++;
+
+    std::cout << "\n============================" << std::endl;
+    std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
+
+    if (failedTests > 0) {
+        std::cout << "✗ " << failedTests << " test(s) failed" << std::endl;
+        return 1;
+    } else {
+        std::cout << "✓ All spatial index tests passed!" << std::endl;
+        return 0;
+    }
+}
@@ -14,6 +14,7 @@
 #include "test_interface.h"
 #include <iostream>
 #include <cstdio>
+#include <vector>
 
 bool testLayerDefinitions() {
     std::cout << "\n=== Test: Layer Definitions ===" << std::endl;
@@ -291,6 +292,96 @@ bool testLayersAndLineTypes() {
     return true;
 }
 
+//keeps a copy of every line
+class KeepLines : public TestInterface {
+public:
+    virtual void takeLine(DRW_Line&& data) { lines.push_back(std::move(data)); }
+    std::vector<DRW_Line> lines;
+};
+
+bool testSharedNames() {
+    std::cout << "\n=== Test: Shared Layer And Style Names ===" << std::endl;
+
+    const char* filename = "test_names.dxf";
+    static const char *layers[] = {"A-WALL-FULL-HEIGHT-EXTERIOR", "A-DOOR-FRAME-ELEVATION", "0"};
+    {
+        dxfRW dxf(filename);
+        class NameWriter : public TestInterface {
+        public:
+            virtual void writeEntities() {
+                for (int i = 0; i < 30; ++i) {
+                    DRW_Line line;
+                    line.layer = layers[i % 3];
+                    line.lineType = (i % 2) ? "DASHED" : "BYLAYER";
+                    line.secPoint.x = i;
+                    dxfWriter->writeLine(&line);
+                }
+                DRW_Text text;
+                text.text = "named";
+                text.style = "NOTES";
+                text.height = 1.0;
+                dxfWriter->writeText(&text);
+            }
+            dxfRW* dxfWriter;
+        };
+        NameWriter writer;
+        writer.dxfWriter = &dxf;
+        if (!dxf.write(&writer, DRW::AC1015, false)) {
+            std::cout << "✗ Failed to write file" << std::endl;
+            return false;
+        }
+    }
+
+    KeepLines reader;
+    {
+        dxfRW dxf(filename);
+        if (!dxf.read(&reader, false) || reader.lines.size() != 30) {
+            std::cout << "✗ Failed to read the lines" << std::endl;
+            std::remove(filename);
+            return false;
+        }
+    }
+    std::remove(filename);
+
+    //the reader is gone, the names must stay valid
+    for (size_t i = 0; i < reader.lines.size(); ++i) {
+        const DRW_Line &line = reader.lines[i];
+        const DRW_Line &first = reader.lines[i % 3];
+        if (line.layer != layers[i % 3] || line.lineType != ((i % 2) ? "DASHED" : "BYLAYER")) {
+            std::cout << "✗ Line " << i << " has layer " << line.layer << std::endl;
+            return false;
+        }
+        if (!line.layer.sameAs(first.layer)) {
+            std::cout << "✗ Layer name of line " << i << " not shared" << std::endl;
+            return false;
+        }
+    }
+
+    //copies share, assignment replaces only the copy
+    DRW_Line copy = reader.lines[0];
+    std::string layer = copy.layer;
+    copy.layer = "moved";
+    if (!copy.lineType.sameAs(reader.lines[0].lineType) || layer != layers[0]
+            || copy.layer != std::string("moved") || reader.lines[0].layer != layer) {
+        std::cout << "✗ Copy or assignment of names is wrong" << std::endl;
+        return false;
+    }
+    DRW_Name a("NOTES"), b(std::string("NOTES"));
+    if (a != b || a.sameAs(b) || a < b || b < a) {
+        std::cout << "✗ Names from different sources compare wrong" << std::endl;
+        return false;
+    }
+    DRW_Name c = a;
+    c += "-OLD";
+    c.append("!");
+    if (c != "NOTES-OLD!" || a != "NOTES") {
+        std::cout << "✗ Appending to a name is wrong" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Names shared by " << reader.lines.size() << " lines, valid after the read" << std::endl;
+    return true;
+}
+
 int main(int argc, char* argv[]) {
     std::cout << "libdxfrw Table Objects Tests" << std::endl;
     std::cout << "=============================" << std::endl;
@@ -307,6 +398,9 @@ int main(int argc, char* argv[]) {
     totalTests++;
     if (!testLayersAndLineTypes()) failedTests++;
 
+    totalTests++;
+    if (!testSharedNames()) failedTests++;
+
     std::cout << "\n=============================" << std::endl;
     std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
 
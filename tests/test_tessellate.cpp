@@ -0,0 +1,385 @@
+/******************************************************************************
+**  libDXFrw - Tessellation Tests                                           **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "libdxfrw.h"
+#include "drw_tessellate.h"
+#include "test_interface.h"
+#include <iostream>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+// Distance from p to the segment a-b
+static double segmentDistance(const DRW_Coord &p, const DRW_Coord &a, const DRW_Coord &b) {
+    double dx = b.x - a.x, dy = b.y - a.y, dz = b.z - a.z;
+    double len2 = dx*dx + dy*dy + dz*dz;
+    double t = len2 > 0 ? ((p.x - a.x)*dx + (p.y - a.y)*dy + (p.z - a.z)*dz) / len2 : 0;
+    t = std::max(0.0, std::min(1.0, t));
+    double ex = a.x + t*dx - p.x, ey = a.y + t*dy - p.y, ez = a.z + t*dz - p.z;
+    return sqrt(ex*ex + ey*ey + ez*ez);
+}
+
+static double polylineDistance(const DRW_Coord &p, const std::vector<DRW_Coord> &pts) {
+    double best = 1e300;
+    for (size_t i = 1; i < pts.size(); ++i)
+        best = std::min(best, segmentDistance(p, pts[i - 1], pts[i]));
+    return best;
+}
+
+static DRW_Spline *quadraticSpline() {
+    DRW_Spline *s = new DRW_Spline();
+    s->degree = 2;
+    double knots[] = {0, 0, 0, 1, 1, 1};
+    s->knotslist.assign(knots, knots + 6);
+    s->controllist.push_back(new DRW_Coord(0, 0, 0));
+    s->controllist.push_back(new DRW_Coord(1, 2, 0));
+    s->controllist.push_back(new DRW_Coord(2, 0, 0));
+    s->nknots = 6;
+    s->ncontrol = 3;
+    return s;
+}
+
+static void freeSpline(DRW_Spline *s) {
+    for (size_t i = 0; i < s->controllist.size(); ++i)
+        delete s->controllist[i];
+    s->controllist.clear();
+    delete s;
+}
+
+bool testArcSegments() {
+    std::cout << "\n=== Test: Arc Segments ===" << std::endl;
+
+    DRW_Tessellator tess;
+    tess.setTolerance(0.01);
+    std::vector<DRW_Coord> small, large;
+    tess.arc(DRW_Coord(0, 0, 0), 1.0, 0.0, 0.0, &small);
+    tess.arc(DRW_Coord(0, 0, 5), 100.0, 0.0, 0.0, &large);
+    if (!(large.size() > small.size() * 5)) {
+        std::cout << "✗ Segments should grow with the radius: " << small.size()
+                  << " vs " << large.size() << std::endl;
+        return false;
+    }
+    for (size_t i = 1; i < large.size(); ++i) {
+        DRW_Coord mid((large[i - 1].x + large[i].x) / 2, (large[i - 1].y + large[i].y) / 2, 0);
+        double sagitta = 100.0 - sqrt(mid.x*mid.x + mid.y*mid.y);
+        if (sagitta > 0.01 + 1e-9 || large[i].z != 5.0) {
+            std::cout << "✗ Chord error " << sagitta << " over the tolerance" << std::endl;
+            return false;
+        }
+    }
+
+    // The ellipse parts of dxfRW: the same count whatever the radius
+    tess.setTolerance(1.0 - cos(M_PI / 64), true);
+    if (tess.arcSegments(1.0, 2 * M_PI) != 64 || tess.arcSegments(1000.0, 2 * M_PI) != 64 ||
+        tess.arcSegments(1000.0, M_PI_2) != 16) {
+        std::cout << "✗ Relative tolerance should give 64 parts per turn" << std::endl;
+        return false;
+    }
+
+    std::cout << "✓ Arc segments test passed (" << small.size() << ", " << large.size() << " points)" << std::endl;
+    return true;
+}
+
+bool testEllipseTolerance() {
+    std::cout << "\n=== Test: Ellipse Tolerance ===" << std::endl;
+
+    DRW_Tessellator tess;
+    tess.setTolerance(0.01);
+    std::vector<DRW_Coord> pts;
+    DRW_Coord c(3, 4, 0), major(6, 8, 0), normal(0, 0, 1);
+    tess.ellipse(c, major, 0.3, normal, 0.5, 4.0, &pts);
+
+    double worst = 0;
+    for (int i = 0; i <= 5000; ++i) {
+        double t = 0.5 + 3.5 * i / 5000;
+        // minor axis = ratio * (normal x major) = 0.3 * (-8, 6)
+        DRW_Coord p(c.x + major.x*cos(t) - 2.4*sin(t), c.y + major.y*cos(t) + 1.8*sin(t), 0);
+        worst = std::max(worst, polylineDistance(p, pts));
+    }
+    if (worst > 0.01 + 1e-9) {
+        std::cout << "✗ Deviation " << worst << " over the tolerance" << std::endl;
+        return false;
+    }
+    DRW_Coord end(c.x + major.x*cos(4.0) - 2.4*sin(4.0), c.y + major.y*cos(4.0) + 1.8*sin(4.0), 0);
+    if (fabs(pts.back().x - end.x) > 1e-9 || fabs(pts.back().y - end.y) > 1e-9) {
+        std::cout << "✗ Last point should be the end of the arc" << std::endl;
+        return false;
+    }
+
+    std::cout << "✓ Ellipse tolerance test passed (" << pts.size() << " points, deviation "
+              << worst << ")" << std::endl;
+    return true;
+}
+
+bool testBulge() {
+    std::cout << "\n=== Test: Bulge ===" << std::endl;
+
+    DRW_Tessellator tess;
+    tess.setTolerance(0.001);
+    DRW_LWPolyline lw;
+    lw.addVertex(DRW_Vertex2D(0, 0, 1.0));
+    lw.addVertex(DRW_Vertex2D(2, 0, 0.0));
+    std::vector<DRW_Coord> pts;
+    bool closed = true;
+    bool ok = tess.points(lw, &pts, &closed);
+    for (size_t i = 0; i < lw.vertlist.size(); ++i)
+        delete lw.vertlist[i];
+    lw.vertlist.clear();
+    if (!ok || closed || pts.size() < 10) {
+        std::cout << "✗ Expected an open half circle, got " << pts.size() << " points" << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < pts.size(); ++i) {
+        double r = sqrt((pts[i].x - 1)*(pts[i].x - 1) + pts[i].y*pts[i].y);
+        if (fabs(r - 1.0) > 1e-9 || pts[i].y > 1e-9) {
+            std::cout << "✗ Point " << i << " not on the lower half circle" << std::endl;
+            return false;
+        }
+    }
+    if (pts.front().x != 0 || pts.back().x != 2) {
+        std::cout << "✗ The arc should go from the first vertex to the second" << std::endl;
+        return false;
+    }
+
+    std::cout << "✓ Bulge test passed (" << pts.size() << " points)" << std::endl;
+    return true;
+}
+
+bool testSplineEvaluation() {
+    std::cout << "\n=== Test: Spline Evaluation ===" << std::endl;
+
+    DRW_Tessellator tess;
+    tess.setTolerance(0.001);
+
+    // Quadratic bezier: x = 2u, y = 4u(1-u)
+    DRW_Spline *s = quadraticSpline();
+    std::vector<DRW_Coord> pts;
+    tess.spline(*s, &pts);
+    freeSpline(s);
+    if (pts.size() < 3 || pts.front().x != 0 || fabs(pts.back().x - 2) > 1e-12) {
+        std::cout << "✗ Bad spline ends, " << pts.size() << " points" << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < pts.size(); ++i) {
+        double u = pts[i].x / 2;
+        if (fabs(pts[i].y - 4*u*(1 - u)) > 1e-12) {
+            std::cout << "✗ Point " << i << " not on the curve" << std::endl;
+            return false;
+        }
+    }
+    double worst = 0;
+    for (int i = 0; i <= 2000; ++i) {
+        double u = i / 2000.0;
+        worst = std::max(worst, polylineDistance(DRW_Coord(2*u, 4*u*(1 - u), 0), pts));
+    }
+    if (worst > 0.001 + 1e-9) {
+        std::cout << "✗ Deviation " << worst << " over the tolerance" << std::endl;
+        return false;
+    }
+
+    // Rational quarter circle
+    DRW_Spline arc;
+    arc.degree = 2;
+    double knots[] = {0, 0, 0, 1, 1, 1};
+    arc.knotslist.assign(knots, knots + 6);
+    DRW_Coord cp[] = {DRW_Coord(1, 0, 0), DRW_Coord(1, 1, 0), DRW_Coord(0, 1, 0)};
+    for (int i = 0; i < 3; ++i)
+        arc.controllist.push_back(&cp[i]);
+    double weights[] = {1, sqrt(2.0) / 2, 1};
+    arc.weightlist.assign(weights, weights + 3);
+    std::vector<DRW_Coord> circle;
+    tess.spline(arc, &circle);
+    arc.controllist.clear();
+    for (size_t i = 0; i < circle.size(); ++i) {
+        double r = sqrt(circle[i].x*circle[i].x + circle[i].y*circle[i].y);
+        if (fabs(r - 1) > 1e-12) {
+            std::cout << "✗ Rational point " << i << " at radius " << r << std::endl;
+            return false;
+        }
+        if (i > 0) {
+            double dot = circle[i - 1].x*circle[i].x + circle[i - 1].y*circle[i].y;
+            double sagitta = 1 - cos(acos(std::min(1.0, dot)) / 2);
+            if (sagitta > 0.001 + 1e-9) {
+                std::cout << "✗ Rational chord error " << sagitta << " over the tolerance" << std::endl;
+                return false;
+            }
+        }
+    }
+
+    std::cout << "✓ Spline evaluation test passed (" << pts.size() << ", " << circle.size()
+              << " points)" << std::endl;
+    return true;
+}
+
+class CurveWriter : public TestInterface {
+public:
+    virtual void writeEntities() {
+        DRW_Ellipse ellipse;
+        ellipse.basePoint = DRW_Coord(50, 50, 2);
+        ellipse.secPoint = DRW_Coord(30, 0, 0);
+        ellipse.extPoint = DRW_Coord(0, 0, 1);
+        ellipse.ratio = 0.5;
+        ellipse.staparam = 0.0;
+        ellipse.endparam = 2.0 * M_PI;
+        dxf->writeEllipse(&ellipse);
+
+        DRW_Spline *s = quadraticSpline();
+        s->weightlist.push_back(1.0);
+        s->weightlist.push_back(0.5);
+        s->weightlist.push_back(1.0);
+        dxf->writeSpline(s);
+        freeSpline(s);
+    }
+    dxfRW *dxf;
+};
+
+class CurveReader : public TestInterface {
+public:
+    virtual void addPolyline(const DRW_Polyline& data) {
+        polylineCount++;
+        std::vector<DRW_Coord> pts;
+        for (size_t i = 0; i < data.vertlist.size(); ++i)
+            pts.push_back(data.vertlist[i]->basePoint);
+        polylines.push_back(pts);
+        flags.push_back(data.flags);
+        elevations.push_back(data.basePoint.z);
+    }
+    virtual void addSpline(const DRW_Spline* data) {
+        splineCount++;
+        weights = data->weightlist;
+    }
+    std::vector<std::vector<DRW_Coord> > polylines;
+    std::vector<int> flags;
+    std::vector<double> elevations;
+    std::vector<double> weights;
+};
+
+bool testCurvesToR12() {
+    std::cout << "\n=== Test: Curves to R12 ===" << std::endl;
+
+    const char* filename = "test_tessellate.dxf";
+    {
+        dxfRW dxf(filename);
+        dxf.setTessellationTolerance(0.05);
+        CurveWriter writer;
+        writer.dxf = &dxf;
+        if (!dxf.write(&writer, DRW::AC1009, false)) {
+            std::cout << "✗ Failed to write R12" << std::endl;
+            return false;
+        }
+    }
+    CurveReader reader;
+    {
+        dxfRW dxf(filename);
+        if (!dxf.read(&reader, false)) {
+            std::cout << "✗ Failed to read R12" << std::endl;
+            std::remove(filename);
+            return false;
+        }
+    }
+    std::remove(filename);
+    if (reader.ellipseCount != 0 || reader.splineCount != 0 || reader.polylineCount != 2) {
+        std::cout << "✗ Expected 2 polylines, got " << reader.polylineCount << std::endl;
+        return false;
+    }
+    const std::vector<DRW_Coord> &el = reader.polylines[0];
+    if (reader.flags[0] != 1 || reader.elevations[0] != 2 || el.size() < 20) {
+        std::cout << "✗ Ellipse should be a closed 2d polyline at z 2, flags "
+                  << reader.flags[0] << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < el.size(); ++i) {
+        double x = (el[i].x - 50) / 30, y = (el[i].y - 50) / 15;
+        if (fabs(x*x + y*y - 1) > 1e-6) {
+            std::cout << "✗ Vertex " << i << " not on the ellipse" << std::endl;
+            return false;
+        }
+    }
+    const std::vector<DRW_Coord> &sp = reader.polylines[1];
+    if (sp.size() < 3 || sp.front().x != 0 || fabs(sp.back().x - 2) > 1e-9) {
+        std::cout << "✗ Spline polyline has " << sp.size() << " vertices" << std::endl;
+        return false;
+    }
+
+    std::cout << "✓ Curves to R12 test passed (" << el.size() << ", " << sp.size()
+              << " vertices)" << std::endl;
+    return true;
+}
+
+bool testSplineWeights() {
+    std::cout << "\n=== Test: Spline Weights ===" << std::endl;
+
+    const char* filename = "test_weights.dxf";
+    {
+        dxfRW dxf(filename);
+        CurveWriter writer;
+        writer.dxf = &dxf;
+        if (!dxf.write(&writer, DRW::AC1015, false)) {
+            std::cout << "✗ Failed to write spline" << std::endl;
+            return false;
+        }
+    }
+    CurveReader reader;
+    {
+        dxfRW dxf(filename);
+        if (!dxf.read(&reader, false)) {
+            std::cout << "✗ Failed to read spline" << std::endl;
+            std::remove(filename);
+            return false;
+        }
+    }
+    std::remove(filename);
+    if (reader.splineCount != 1 || reader.weights.size() != 3 || reader.weights[1] != 0.5) {
+        std::cout << "✗ Expected 3 weights, got " << reader.weights.size() << std::endl;
+        return false;
+    }
+
+    std::cout << "✓ Spline weights test passed" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "libdxfrw Tessellation Tests" << std::endl;
+    std::cout << "===========================" << std::endl;
+
+    int failedTests = 0;
+    int totalTests = 0;
+
+    totalTests++;
+    if (!testArcSegments()) failedTests++;
+
+    totalTests++;
+    if (!testEllipseTolerance()) failedTests++;
+
+    totalTests++;
+    if (!testBulge()) failedTests++;
+
+    totalTests++;
+    if (!testSplineEvaluation()) failedTests++;
+
+    totalTests++;
+    if (!testCurvesToR12()) failedTests++;
+
+    totalTests++;
+    if (!testSplineWeights()) failedTests++;
+
+    std::cout << "\n===========================" << std::endl;
+    std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
+
+    if (failedTests > 0) {
+        std::cout << "✗ " << failedTests << " test(s) failed" << std::endl;
+        return 1;
+    } else {
+        std::cout << "✓ All tessellation tests passed!" << std::endl;
+        return 0;
+    }
+}
@@ -0,0 +1,196 @@
+/******************************************************************************
+**  libDXFrw - Concurrency Tests                                            **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+// Independent dxfRW / codec instances must be usable from several threads at
+// once. Build with -DLIBDXFRW_SANITIZE_THREAD=ON to run it under ThreadSanitizer.
+
+#include "libdxfrw.h"
+#include "intern/drw_textcodec.h"
+#include "intern/drw_dbg.h"
+#include "test_interface.h"
+#include <iostream>
+#include <sstream>
+#include <cstdio>
+#include <thread>
+#include <vector>
+#include <atomic>
+
+static const int NUM_THREADS = 8;
+static const int NUM_ROUNDS = 10;
+
+class QuietInterface : public TestInterface {
+public:
+    virtual void addHeader(const DRW_Header* data) {}
+    virtual void addPoint(const DRW_Point& data) { pointCount++; }
+    virtual void addLine(const DRW_Line& data) { lineCount++; }
+    virtual void addCircle(const DRW_Circle& data) { circleCount++; }
+    virtual void addText(const DRW_Text& data) {
+        textCount++;
+        lastText = data.text;
+    }
+    std::string lastText;
+};
+
+static bool writeFile(const std::string &filename, int id) {
+    dxfRW dxf(filename.c_str());
+    class Writer : public QuietInterface {
+    public:
+        virtual void writeEntities() {
+            for (int i = 0; i < 50 + id; ++i) {
+                DRW_Line line;
+                line.basePoint.x = i;
+                line.secPoint.x = i + id;
+                dxfWriter->writeLine(&line);
+            }
+            DRW_Circle circle;
+            circle.radious = id + 1.0;
+            dxfWriter->writeCircle(&circle);
+            DRW_Text text;
+            std::ostringstream ss;
+            ss << "thread " << id << " text";
+            text.text = ss.str();
+            text.height = 1.0;
+            dxfWriter->writeText(&text);
+        }
+        dxfRW* dxfWriter;
+        int id;
+    };
+    Writer writer;
+    writer.dxfWriter = &dxf;
+    writer.id = id;
+    return dxf.write(&writer, DRW::AC1015, false);
+}
+
+bool testConcurrentReads() {
+    std::cout << "\n=== Test: Concurrent DXF Reads ===" << std::endl;
+
+    std::vector<std::string> files;
+    for (int i = 0; i < NUM_THREADS; ++i) {
+        std::ostringstream ss;
+        ss << "test_threads_" << i << ".dxf";
+        files.push_back(ss.str());
+        if (!writeFile(files.back(), i)) {
+            std::cout << "✗ Failed to write " << files.back() << std::endl;
+            return false;
+        }
+    }
+
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.push_back(std::thread([&files, &failures, t]() {
+            for (int r = 0; r < NUM_ROUNDS; ++r) {
+                //every thread reads every file, in a different order
+                int id = (t + r) % NUM_THREADS;
+                dxfRW dxf(files[id].c_str());
+                QuietInterface reader;
+                std::ostringstream expected;
+                expected << "thread " << id << " text";
+                if (!dxf.read(&reader, false) || reader.lineCount != 50 + id
+                        || reader.circleCount != 1 || reader.lastText != expected.str()) {
+                    failures++;
+                }
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+    for (size_t i = 0; i < files.size(); ++i)
+        std::remove(files[i].c_str());
+
+    if (failures != 0) {
+        std::cout << "✗ " << failures << " concurrent reads returned wrong data" << std::endl;
+        return false;
+    }
+    std::cout << "✓ " << NUM_THREADS * NUM_ROUNDS << " concurrent reads ok" << std::endl;
+    return true;
+}
+
+bool testConcurrentCodecs() {
+    std::cout << "\n=== Test: Concurrent Text Codecs ===" << std::endl;
+
+    std::atomic<int> failures(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < NUM_THREADS; ++t) {
+        threads.push_back(std::thread([&failures, t]() {
+            //pre 2007 dxf with utf-8 codepage goes through iconv (SJIS)
+            DRW_TextCodec codec;
+            codec.setVersion(DRW::AC1015, true);
+            codec.setCodePage("UTF-8", true);
+            std::ostringstream ss;
+            ss << "\xE6\x97\xA5\xE6\x9C\xAC " << t; //"nihon"
+            std::string utf8 = ss.str();
+            for (int r = 0; r < 200; ++r) {
+                std::string sjis = codec.fromUtf8(utf8);
+                if (sjis.size() != utf8.size() - 2 || codec.toUtf8(sjis) != utf8)
+                    failures++;
+            }
+        }));
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+        threads[i].join();
+
+    if (failures != 0) {
+        std::cout << "✗ " << failures << " concurrent conversions failed" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Concurrent conversions ok" << std::endl;
+    return true;
+}
+
+bool testDebugLevelPerThread() {
+    std::cout << "\n=== Test: Debug Level Per Thread ===" << std::endl;
+
+    dxfRW dxf("unused.dxf");
+    dxf.setDebug(DRW::DEBUG);
+    bool otherDebug = true;
+    std::thread th([&otherDebug]() {
+        otherDebug = (DRW_DBGGL == DRW_dbg::DEBUG);
+    });
+    th.join();
+    dxf.setDebug(DRW::NONE);
+
+    if (otherDebug) {
+        std::cout << "✗ Debug level leaked to another thread" << std::endl;
+        return false;
+    }
+    std::cout << "✓ Debug level is thread local" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "libdxfrw Concurrency Tests" << std::endl;
+    std::cout << "==========================" << std::endl;
+
+    int failedTests = 0;
+    int totalTests = 0;
+
+    totalTests++;
+    if (!testConcurrentReads()) failedTests++;
+
+    totalTests++;
+    if (!testConcurrentCodecs()) failedTests++;
+
+    totalTests++;
+    if (!testDebugLevelPerThread()) failedTests++;
+
+    std::cout << "\n==========================" << std::endl;
+    std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
+
+    if (failedTests > 0) {
+        std::cout << "✗ " << failedTests << " test(s) failed" << std::endl;
+        return 1;
+    } else {
+        std::cout << "✓ All concurrency tests passed!" << std::endl;
+        return 0;
+    }
+}
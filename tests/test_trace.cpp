@@ -0,0 +1,272 @@
+/******************************************************************************
+**  libDXFrw - Trace Tests                                                  **
+**                                                                           **
+**  Copyright (C) 2025 libdxfrw contributors                                **
+**                                                                           **
+**  This library is free software, licensed under the terms of the GNU       **
+**  General Public License as published by the Free Software Foundation,     **
+**  either version 2 of the License, or (at your option) any later version.  **
+**  You should have received a copy of the GNU General Public License        **
+**  along with this program.  If not, see <http://www.gnu.org/licenses/>.    **
+******************************************************************************/
+
+#include "libdxfrw.h"
+#include "libdwgr.h"
+#include "drw_trace.h"
+#include "intern/drw_dbg.h"
+#include "test_interface.h"
+#include <iostream>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+#include <iterator>
+
+class CountingSink : public DRW_TraceSink {
+public:
+    CountingSink() : starts(0), ends(0), decoded(0), failed(0), consumed(0) {}
+    virtual void traceEvent(const DRW_TraceRecord &rec) {
+        switch (rec.event) {
+        case DRW::SECTION_START:
+            starts++;
+            sections.push_back(rec.name);
+            break;
+        case DRW::SECTION_END:
+            ends++;
+            break;
+        case DRW::OBJECT_DECODED:
+            decoded++;
+            objects.push_back(rec.name);
+            break;
+        case DRW::OBJECT_FAILED:
+            failed++;
+            break;
+        case DRW::BYTES_CONSUMED:
+            consumed = rec.bytes;
+            break;
+        }
+    }
+    int starts;
+    int ends;
+    int decoded;
+    int failed;
+    duint64 consumed;
+    std::vector<std::string> sections;
+    std::vector<std::string> objects;
+};
+
+static bool writeSample(const char* filename) {
+    dxfRW dxf(filename);
+    class SampleWriter : public TestInterface {
+    public:
+        virtual void writeEntities() {
+            DRW_Line line;
+            line.secPoint.x = 10.0;
+            dxfWriter->writeLine(&line);
+            DRW_Circle circle;
+            circle.radious = 5.0;
+            dxfWriter->writeCircle(&circle);
+            DRW_Point point;
+            dxfWriter->writePoint(&point);
+        }
+        dxfRW* dxfWriter;
+    };
+    SampleWriter writer;
+    writer.dxfWriter = &dxf;
+    return dxf.write(&writer, DRW::AC1015, false);
+}
+
+static bool checkTrace(const char* filename) {
+    if (!writeSample(filename)) {
+        std::cout << "✗ Failed to write sample file" << std::endl;
+        return false;
+    }
+
+    std::ifstream in(filename, std::ios::binary | std::ios::ate);
+    duint64 fileSize = in.tellg();
+    in.close();
+
+    dxfRW dxf(filename);
+    TestInterface reader;
+    CountingSink sink;
+    dxf.setTraceSink(&sink);
+    bool ok = dxf.read(&reader, false);
+    std::remove(filename);
+
+    if (!ok) {
+        std::cout << "✗ Failed to read sample file" << std::endl;
+        return false;
+    }
+    if (sink.starts == 0 || sink.starts != sink.ends) {
+        std::cout << "✗ Unbalanced sections, start=" << sink.starts << " end=" << sink.ends << std::endl;
+        return false;
+    }
+    if (sink.sections.front() != "HEADER") {
+        std::cout << "✗ Expected HEADER as first section, got " << sink.sections.front() << std::endl;
+        return false;
+    }
+    if (sink.decoded != 3 || sink.objects[0] != "LINE" || sink.objects[1] != "CIRCLE"
+            || sink.objects[2] != "POINT") {
+        std::cout << "✗ Expected LINE, CIRCLE, POINT decoded, got " << sink.decoded << " objects" << std::endl;
+        return false;
+    }
+    if (sink.failed != 0) {
+        std::cout << "✗ Unexpected failed objects: " << sink.failed << std::endl;
+        return false;
+    }
+    if (sink.consumed == 0 || sink.consumed > fileSize) {
+        std::cout << "✗ Bad consumed bytes " << sink.consumed << " of " << fileSize << std::endl;
+        return false;
+    }
+    std::cout << "✓ " << sink.starts << " sections, " << sink.decoded << " objects, "
+              << sink.consumed << " bytes traced" << std::endl;
+    return true;
+}
+
+bool testAsciiTrace() {
+    std::cout << "\n=== Test: ASCII DXF Trace Events ===" << std::endl;
+    return checkTrace("test_trace_ascii.dxf");
+}
+
+bool testNoSink() {
+    std::cout << "\n=== Test: Read Without Trace Sink ===" << std::endl;
+
+    const char* filename = "test_trace_nosink.dxf";
+    if (!writeSample(filename)) {
+        std::cout << "✗ Failed to write sample file" << std::endl;
+        return false;
+    }
+    CountingSink sink;
+    dxfRW dxf(filename);
+    dxf.setTraceSink(&sink);
+    dxf.setTraceSink(NULL);
+    TestInterface reader;
+    bool ok = dxf.read(&reader, false);
+    std::remove(filename);
+
+    if (!ok || reader.lineCount != 1 || sink.starts != 0 || sink.decoded != 0) {
+        std::cout << "✗ Events delivered after removing the sink" << std::endl;
+        return false;
+    }
+    std::cout << "✓ No events without sink" << std::endl;
+    return true;
+}
+
+bool testReadStats() {
+    std::cout << "\n=== Test: Read Statistics ===" << std::endl;
+
+    const char* filename = "test_trace_stats.dxf";
+    if (!writeSample(filename)) {
+        std::cout << "✗ Failed to write sample file" << std::endl;
+        return false;
+    }
+    duint32 baseSkipped = 0;
+    {
+        dxfRW dxf(filename);
+        TestInterface reader;
+        dxf.read(&reader, false);
+        baseSkipped = dxf.getStats().skipped; //unsupported objects
+    }
+    //append an unsupported entity before ENDSEC of ENTITIES
+    {
+        std::ifstream in(filename);
+        std::string content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        in.close();
+        std::string::size_type pos = content.find("ENTITIES");
+        pos = content.find("ENDSEC", pos);
+        pos = content.rfind("  0", pos);
+        content.insert(pos, "  0\nSHAPE\n  8\n0\n");
+        std::ofstream out(filename);
+        out << content;
+    }
+
+    dxfRW dxf(filename);
+    TestInterface reader;
+    bool ok = dxf.read(&reader, false);
+    std::remove(filename);
+    const DRW_ReadStats &st = dxf.getStats();
+
+    if (!ok) {
+        std::cout << "✗ Failed to read sample file" << std::endl;
+        return false;
+    }
+    if (st.objectCount("LINE") != 1 || st.objectCount("CIRCLE") != 1 || st.objectCount("POINT") != 1
+            || st.totalObjects() != 3) {
+        std::cout << "✗ Bad object counts, total " << st.totalObjects() << std::endl;
+        return false;
+    }
+    if (st.skipped != baseSkipped + 1 || st.failed != 0) {
+        std::cout << "✗ Expected 1 more skipped and 0 failed, got " << st.skipped - baseSkipped
+                  << " and " << st.failed << std::endl;
+        return false;
+    }
+    if (st.bytesIn == 0 || st.totalTime <= 0.0 || st.phaseTime[DRW_ReadStats::ENTITIES] > st.totalTime) {
+        std::cout << "✗ Bad bytes or timings" << std::endl;
+        return false;
+    }
+    for (int i = 0; i < DRW_ReadStats::PHASES; ++i) {
+        DRW_ReadStats::Phase p = static_cast<DRW_ReadStats::Phase>(i);
+        std::cout << "  " << DRW_ReadStats::phaseName(p) << ": " << st.phaseTime[i] << " s" << std::endl;
+    }
+
+    //a failed read starts from clean statistics
+    dwgR dwg("nonexistent_file.dwg");
+    if (dwg.read(&reader, false) || dwg.getStats().totalObjects() != 0) {
+        std::cout << "✗ Bad statistics for a missing dwg" << std::endl;
+        return false;
+    }
+
+    std::cout << "✓ Statistics: " << st.totalObjects() << " objects, " << st.bytesIn << " bytes" << std::endl;
+    return true;
+}
+
+static int evaluated = 0;
+static int countEval() {
+    return ++evaluated;
+}
+
+bool testDebugArgsEvaluatedOnce() {
+    std::cout << "\n=== Test: Debug Arguments Evaluated Once ===" << std::endl;
+
+    //dwg parsers read stream fields inside debug calls, they must not be skipped
+    DRW_DBGSL(DRW_dbg::NONE);
+    DRW_DBG(countEval());
+    DRW_DBGH(countEval());
+    DRW_DBGPT(countEval(), countEval(), countEval());
+    if (evaluated != 5) {
+        std::cout << "✗ Expected 5 evaluations with level NONE, got " << evaluated << std::endl;
+        return false;
+    }
+    std::cout << "✓ Debug arguments evaluated once with level NONE" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "libdxfrw Trace Tests" << std::endl;
+    std::cout << "====================" << std::endl;
+
+    int failedTests = 0;
+    int totalTests = 0;
+
+    totalTests++;
+    if (!testAsciiTrace()) failedTests++;
+
+    totalTests++;
+    if (!testNoSink()) failedTests++;
+
+    totalTests++;
+    if (!testReadStats()) failedTests++;
+
+    totalTests++;
+    if (!testDebugArgsEvaluatedOnce()) failedTests++;
+
+    std::cout << "\n====================" << std::endl;
+    std::cout << "Tests: " << (totalTests - failedTests) << "/" << totalTests << " passed" << std::endl;
+
+    if (failedTests > 0) {
+        std::cout << "✗ " << failedTests << " test(s) failed" << std::endl;
+        return 1;
+    } else {
+        std::cout << "✓ All trace tests passed!" << std::endl;
+        return 0;
+    }
+}